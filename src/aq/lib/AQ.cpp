@@ -155,6 +155,46 @@ uint32_t AQ::claimContentionCount(void) const
     return m_ctrl->claimContention;
 }
 
+//------------------------------------------------------------------------------
+AQStats AQ::stats(void) const
+{
+    CtrlOverlay *c = ctrlThrowOnUnformatted(__FUNCTION__);
+    AQStats s;
+
+    // Read the free counter before the commit counter, and the tail before the
+    // head, so that each difference can only be overstated by a concurrent
+    // update and never wraps negative.  Extendable items commit one segment
+    // at a time so only their first segments are counted.
+    uint32_t freeItems = Atomic::read(&c->freeItemCounter);
+    if (c->options & OPTION_EXTENDABLE)
+    {
+        s.m_itemCount = Atomic::read(&c->commitItemCounter) - freeItems;
+    }
+    else
+    {
+        s.m_itemCount = Atomic::read(&c->commitCounter) - freeItems;
+    }
+
+    uint32_t tailIdx = c->queueRefToIndex(Atomic::read(&c->tailRef));
+    uint32_t headIdx = c->queueRefToIndex(Atomic::read(&c->headRef));
+    s.m_usedPageCount = c->usedPages(headIdx, tailIdx);
+    s.m_usedSize = (size_t)s.m_usedPageCount << c->pageSizeShift;
+
+    // The reader only samples the used pages when it walks the queue; include 
+    // the value just read.
+    s.m_usedPageHighWater = Atomic::read(&c->usedPageHighWater);
+    if (s.m_usedPageCount > s.m_usedPageHighWater)
+    {
+        s.m_usedPageHighWater = s.m_usedPageCount;
+    }
+
+    s.m_claimFullCount = Atomic::read(&c->claimFullCounter);
+    s.m_skipPageCount = Atomic::read(&c->skipPageCounter);
+    s.m_commitTimeoutCount = Atomic::read(&c->commitTimeoutCounter);
+    s.m_crcFailureCount = Atomic::read(&c->crcFailureCounter);
+    return s;
+}
+
 //------------------------------------------------------------------------------
 aq::CtrlOverlay *AQ::ctrlThrowOnUnformatted(const char *func) const
 {
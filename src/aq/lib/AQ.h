@@ -11,6 +11,8 @@
 // Includes
 //------------------------------------------------------------------------------
 
+#include "AQStats.h"
+
 #include <stdint.h>
 #include <string>
 
@@ -189,6 +191,16 @@ public:
      */
     uint32_t claimContentionCount(void) const;
 
+    /**
+     * Obtains the statistics of this queue.  The statistics are read from the
+     * queue memory without taking a lock or an AQSnapshot, so they may be
+     * called from any thread or process that has the queue memory mapped.
+     *
+     * @returns The statistics of the queue.
+     * @throws AQUnformattedException If the queue is not formatted.
+     */
+    AQStats stats(void) const;
+
 protected:
 
     // Throws an AQUnformattedException if this queue is not headerXref; if
@@ -71,6 +71,8 @@ class AQItem
 
     // Used internally for testing.
     friend class AQStrawManBase;
+    friend class DisruptorRing;
+    friend class VyukovRing;
 
 public:
     /**
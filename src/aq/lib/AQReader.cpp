@@ -34,7 +34,7 @@ using namespace aqosa;
 // Private Macros
 //------------------------------------------------------------------------------
 
-#ifdef AQ_TEST_TRACE
+#ifdef AQ_TRACE
 
 // Used to trace the processor state for index 'idx' using the display 'code'.
 #define TRACE_PSTATE(idx, code)                                                 \
@@ -217,6 +217,13 @@ bool AQReader::format(uint32_t pageSizeShift, uint32_t commitTimeoutMs,
     c->claimContention = 0;
     c->commitCounter = 0;
     c->freeCounter = 0;
+    c->commitItemCounter = 0;
+    c->freeItemCounter = 0;
+    c->claimFullCounter = 0;
+    c->skipPageCounter = 0;
+    c->commitTimeoutCounter = 0;
+    c->crcFailureCounter = 0;
+    c->usedPageHighWater = 0;
     c->headRef = 0;
     c->tailRef = 0;
     memset((void *)c->ctrlq, 0, ctrlqMultiplier * pageCount * sizeof(c->ctrlq[0]));
@@ -228,7 +235,7 @@ bool AQReader::format(uint32_t pageSizeShift, uint32_t commitTimeoutMs,
 
     // Make the control overlay valid.
     Atomic::write(&c->options, options);
-    Atomic::write(&c->formatVersion, CtrlOverlay::FORMAT_VERSION_1);
+    Atomic::write(&c->formatVersion, CtrlOverlay::FORMAT_VERSION_2);
 
     // Create the page state queue.
     if (m_pstate)
@@ -436,6 +443,13 @@ bool AQReader::walk(AQItem *item)
         c->queueRefToIndex(currHeadRef), pstateIdx);
     uint32_t limitPages = ((pageCount() + 3) >> 2);
 
+    // Record the largest number of used pages for the statistics.
+    uint32_t usedPages = c->usedPages(c->queueRefToIndex(currHeadRef), pstateIdx);
+    if (usedPages > c->usedPageHighWater)
+    {
+        Atomic::write(&c->usedPageHighWater, usedPages);
+    }
+
     while (currHeadRef != currTailRef)
     {
         // Determine the state of this item.
@@ -490,6 +504,7 @@ bool AQReader::walk(AQItem *item)
         // We know how many pages to advance the current tail; now we must determine if
         // the next tail should also be advanced as we are discarding items.
         bool discard = false;
+        bool reclaim = false;
         if (   (ctrlFlags & CtrlOverlay::CTRLQ_DISCARD_MASK) 
             && (ctrlFlags != CtrlOverlay::CTRLQ_DISCARD_MASK))
         {
@@ -546,6 +561,7 @@ bool AQReader::walk(AQItem *item)
                             currTail, currTail + ctrlPageCount - 1,
                             availPages, limitPages, pageCount());
                         discard = true;
+                        reclaim = true;
                     }
                 }
                 else if (!m_pstate[currTail].retrieved)
@@ -559,6 +575,10 @@ bool AQReader::walk(AQItem *item)
                         m_pstate[pstateIdx].skipCount += m_pstate[currTail].skipCount;
                         TRACE_PSTATE(pstateIdx, "->");
                     }
+                    if (item != NULL)
+                    {
+                        Atomic::write(&c->commitTimeoutCounter, c->commitTimeoutCounter + 1);
+                    }
                     return walkEnd(item, currTailRef, ctrlSize);
                 }
             }
@@ -611,6 +631,23 @@ bool AQReader::walk(AQItem *item)
                 Atomic::write(&c->tailRef, advanceTailRef);
                 Atomic::increment(&c->freeCounter);
 
+                // Only the reader updates these statistics so no interlocked 
+                // increment is needed.
+                if (ctrlFlags == (CtrlOverlay::CTRLQ_COMMIT_MASK | CtrlOverlay::CTRLQ_DISCARD_MASK))
+                {
+                    Atomic::write(&c->skipPageCounter, c->skipPageCounter + ctrlPageCount);
+                }
+                else if (   ctrlFlags == CtrlOverlay::CTRLQ_FLAGS_MASK
+                         && (   (c->options & AQ::OPTION_EXTENDABLE) == 0
+                             || (c->ctrlq[currTail + c->pageCount] & AQItem::LINK_IDENTIFIER_FIRST)))
+                {
+                    Atomic::write(&c->freeItemCounter, c->freeItemCounter + 1);
+                }
+                if (reclaim)
+                {
+                    Atomic::write(&c->commitTimeoutCounter, c->commitTimeoutCounter + 1);
+                }
+
                 // Move the skip count to the next pstate entry if any remains then clear the
                 // current pstate entry.
                 pstateIdx = c->queueRefToIndex(advanceTailRef);
@@ -694,6 +731,7 @@ bool AQReader::walkEnd(AQItem *item, uint32_t ref, size_t memSize)
         {
             TRACE_1ITEMDATA(m_ctrl, item, "crc[%08X] ERROR expect[%08X]", 
                 calcCrc, m_ctrl->ctrlq[pageNum]);
+            Atomic::write(&m_ctrl->crcFailureCounter, m_ctrl->crcFailureCounter + 1);
         }
     }
     else
@@ -0,0 +1,95 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "AQStats.h"
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+AQStats::AQStats(void)
+    : m_itemCount(0)
+    , m_usedPageCount(0)
+    , m_usedSize(0)
+    , m_usedPageHighWater(0)
+    , m_claimFullCount(0)
+    , m_skipPageCount(0)
+    , m_commitTimeoutCount(0)
+    , m_crcFailureCount(0)
+{
+}
+
+//------------------------------------------------------------------------------
+AQStats::AQStats(const AQStats& other)
+{
+    *this = other;
+}
+
+//------------------------------------------------------------------------------
+AQStats& AQStats::operator=(const AQStats& other)
+{
+    if (this != &other)
+    {
+        m_itemCount = other.m_itemCount;
+        m_usedPageCount = other.m_usedPageCount;
+        m_usedSize = other.m_usedSize;
+        m_usedPageHighWater = other.m_usedPageHighWater;
+        m_claimFullCount = other.m_claimFullCount;
+        m_skipPageCount = other.m_skipPageCount;
+        m_commitTimeoutCount = other.m_commitTimeoutCount;
+        m_crcFailureCount = other.m_crcFailureCount;
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+AQStats::~AQStats(void)
+{
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,188 @@
+#ifndef AQSTATS_H
+#define AQSTATS_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+/**
+ * Holds the statistics of a queue, as returned by AQ::stats().  The statistics
+ * are kept in the queue memory so they can be read by any process that has the
+ * queue mapped - including a monitoring process that attaches an AQWriter and
+ * never claims from it.
+ *
+ * Each value is read individually without any lock, so the set of values is
+ * not an exact point-in-time view of a queue that is in use.  The counters
+ * are monotonic; when one reaches its limit (4,294,967,295) it wraps back to 0.
+ */
+class AQStats
+{
+    // The queue fills in the statistics.
+    friend class AQ;
+
+public:
+
+    /**
+     * Constructs a new set of statistics with all values zero.
+     */
+    AQStats(void);
+
+    /**
+     * Constructs a set of statistics as an exact copy of another.
+     *
+     * @param other The other statistics to copy.
+     */
+    AQStats(const AQStats& other);
+
+    /**
+     * Assigns these statistics to exactly match another.
+     *
+     * @param other The other statistics to copy.
+     * @return A reference to this object.
+     */
+    AQStats& operator=(const AQStats& other);
+
+    /**
+     * Destroys these statistics.
+     */
+    ~AQStats(void);
+
+    /**
+     * Obtains the number of items that have been committed but not yet free'd
+     * by the reader.  An extendable item counts once however many segments
+     * it has.
+     *
+     * @returns The number of committed items in the queue.
+     */
+    uint32_t itemCount(void) const { return m_itemCount; }
+
+    /**
+     * Obtains the number of pages between the tail and head of the queue.  This
+     * includes items that are claimed but not yet committed, items retrieved but
+     * not yet free'd, and waste pages skipped at the end of the queue.
+     *
+     * @returns The number of pages in use.
+     */
+    uint32_t usedPageCount(void) const { return m_usedPageCount; }
+
+    /**
+     * Obtains the number of bytes in use; that is usedPageCount() multiplied by
+     * the page size.
+     *
+     * @returns The number of bytes in use.
+     */
+    size_t usedSize(void) const { return m_usedSize; }
+
+    /**
+     * Obtains the largest number of pages that have been in use.  The reader
+     * updates this each time it walks the queue.
+     *
+     * @returns The high-water mark of usedPageCount().
+     */
+    uint32_t usedPageHighWater(void) const { return m_usedPageHighWater; }
+
+    /**
+     * Obtains the number of times AQWriter::claim() failed because the queue
+     * was full.
+     *
+     * @returns The monotonically increasing claim failure counter.
+     */
+    uint32_t claimFullCount(void) const { return m_claimFullCount; }
+
+    /**
+     * Obtains the number of pages that have been wasted because a claim did not
+     * fit at the end of the queue and so was taken from the start.  Pages are
+     * counted as the reader frees them.
+     *
+     * @returns The monotonically increasing skipped page counter.
+     */
+    uint32_t skipPageCount(void) const { return m_skipPageCount; }
+
+    /**
+     * Obtains the number of items the reader has reclaimed because they were
+     * not committed within the commit timeout.  This counts both the items
+     * returned incomplete and the items free'd before they were claimed.
+     *
+     * @returns The monotonically increasing commit timeout counter.
+     */
+    uint32_t commitTimeoutCount(void) const { return m_commitTimeoutCount; }
+
+    /**
+     * Obtains the number of items the reader has retrieved with an invalid
+     * CRC-32 checksum.  This is always 0 unless the queue was formatted with
+     * AQ::OPTION_CRC32.
+     *
+     * @returns The monotonically increasing CRC failure counter.
+     */
+    uint32_t crcFailureCount(void) const { return m_crcFailureCount; }
+
+private:
+
+    // The number of committed items not yet free'd.
+    uint32_t m_itemCount;
+
+    // The number of pages in use.
+    uint32_t m_usedPageCount;
+
+    // The number of bytes in use.
+    size_t m_usedSize;
+
+    // The largest number of pages in use.
+    uint32_t m_usedPageHighWater;
+
+    // The number of claims that failed as the queue was full.
+    uint32_t m_claimFullCount;
+
+    // The number of waste pages skipped at the end of the queue.
+    uint32_t m_skipPageCount;
+
+    // The number of items reclaimed after the commit timeout.
+    uint32_t m_commitTimeoutCount;
+
+    // The number of items retrieved with an invalid CRC.
+    uint32_t m_crcFailureCount;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
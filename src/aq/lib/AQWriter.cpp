@@ -195,6 +195,7 @@ bool AQWriter::claim(AQWriterItem& item, size_t memSize)
                     // not met.  TODO: further investigation.
                     TRACE_CTRL_EXIT(c, "out of space H[%u]->T[%u]: %u of %u",
                         currHead, currTail, availPages, requiredPages);
+                    Atomic::increment(&c->claimFullCounter);
                     item.clear();
                     return false;
                 }
@@ -213,6 +214,7 @@ bool AQWriter::claim(AQWriterItem& item, size_t memSize)
                     {
                         TRACE_CTRL_EXIT(c, "out of space H[%u]->T[%u]: (%u or %u - 1) of %u",
                             currHead, currTail, endPages, currTail, requiredPages);
+                        Atomic::increment(&c->claimFullCounter);
                         item.clear();
                         return false;
                     }
@@ -364,6 +366,11 @@ bool AQWriter::commitSingle(AQItem& item)
     if (res)
     {
         Atomic::increment(&c->commitCounter);
+        if (   (c->options & AQ::OPTION_EXTENDABLE)
+            && (item.linkIdentifier() & AQItem::LINK_IDENTIFIER_FIRST))
+        {
+            Atomic::increment(&c->commitItemCounter);
+        }
         if (m_ctrl->options & OPTION_CRC32)
         {
             TRACE_1ITEMDATA_ENTRYEXIT(c, &item, "crc[%08X]", crc);
@@ -61,7 +61,7 @@ bool CtrlOverlay::isFormatted(size_t memSize) const
             | (pageCount));
     return memSize >= size 
         && magic == headerXref 
-        && formatVersion == FORMAT_VERSION_1 
+        && formatVersion == FORMAT_VERSION_2 
         && !(options & OPTION_INVALID_MASK);
 }
 
@@ -171,6 +171,19 @@ uint32_t CtrlOverlay::availableSequentialPages(uint32_t headIdx, uint32_t tailId
     }
 }
 
+//------------------------------------------------------------------------------
+uint32_t CtrlOverlay::usedPages(uint32_t headIdx, uint32_t tailIdx) const
+{
+    if (headIdx >= tailIdx)
+    {
+        return headIdx - tailIdx;
+    }
+    else
+    {
+        return pageCount - tailIdx + headIdx;
+    }
+}
+
 
 
 
@@ -172,6 +172,36 @@ public:
     // Monotonic counter increments by 1 each time a page is free'd.
     uint32_t freeCounter;
 
+    // Monotonic counter increments by 1 each time the first segment of an
+    // extendable item is committed.  Unused by other queues, where every 
+    // commit is a whole item.
+    uint32_t commitItemCounter;
+
+    // Monotonic counter increments by 1 each time a committed item is free'd;
+    // for extendable queues only the first segment of each item is counted.
+    // Written only by the reader.
+    uint32_t freeItemCounter;
+
+    // Monotonic counter increments by 1 each time a claim fails because the
+    // queue is full.
+    uint32_t claimFullCounter;
+
+    // Monotonic counter increments by the number of waste pages skipped at the
+    // end of the queue each time they are free'd.  Written only by the reader.
+    uint32_t skipPageCounter;
+
+    // Monotonic counter increments by 1 each time the reader reclaims an item
+    // whose commit timer has expired.  Written only by the reader.
+    uint32_t commitTimeoutCounter;
+
+    // Monotonic counter increments by 1 each time the reader retrieves an 
+    // item with an invalid CRC.  Written only by the reader.
+    uint32_t crcFailureCounter;
+
+    // The largest number of used pages seen by the reader.  Written only by
+    // the reader.
+    uint32_t usedPageHighWater;
+
     // The following volatile fields must be placed here - they are handled
     // specially when taking a snapshot.  New header fields must be placed
     // above this position.
@@ -206,6 +236,10 @@ public:
 
     // Used in the 'formatVersion' field to indicate the V1 format.
     static const uint32_t FORMAT_VERSION_1 = 0x00000001;
+
+    // Used in the 'formatVersion' field to indicate the V2 format, which adds
+    // the statistics counters to the V1 header.
+    static const uint32_t FORMAT_VERSION_2 = 0x00000002;
     
     // The shift for the page size field in the headerXref mask.
     static const int HEADER_XREF_PAGE_SIZE_SHIFT = 26;
@@ -280,6 +314,10 @@ public:
     // the passed head index and tail index values.
     uint32_t availableSequentialPages(uint32_t headIdx, uint32_t tailIdx) const;
 
+    // Returns the number of pages in use, including any waste pages, given
+    // the passed head index and tail index values.
+    uint32_t usedPages(uint32_t headIdx, uint32_t tailIdx) const;
+
 }; }
 
 
@@ -17,6 +17,8 @@
 #include "CtrlOverlay.h"
 #include "TraceManager.h"
 
+#include "Timestamp.h"
+
 #include <iomanip>
 #include <stdarg.h>
 #include <stdio.h>
@@ -39,6 +41,37 @@ using namespace aqosa;
 // Private Type Definitions
 //------------------------------------------------------------------------------
 
+// The kinds of argument recorded for a binary trace point.
+enum ArgKind
+{
+    // A "%%" that takes no argument.
+    ArgPercent,
+
+    // A conversion that is not supported; no further arguments are recorded.
+    ArgInvalid,
+
+    // An int or smaller integer, including characters.
+    ArgInt,
+
+    // A long integer ("l").
+    ArgLong,
+
+    // A long long integer ("ll" or "j").
+    ArgLongLong,
+
+    // A size_t integer ("z" or "t").
+    ArgSize,
+
+    // A double.
+    ArgDouble,
+
+    // A pointer ("p").
+    ArgPointer,
+
+    // A nul terminated string ("s"); the characters are recorded.
+    ArgString,
+};
+
 
 
 
@@ -46,6 +79,15 @@ using namespace aqosa;
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
+// Parses the conversion specification starting with the '%' at 'spec' and
+// stores the kind of its argument in 'kind'.  Returns a pointer to the first
+// character after the specification.
+static const char *parseSpec(const char *spec, ArgKind& kind);
+
+// Parses the argument kinds of trace point 'point' from its format 'fmt' then
+// publishes them, unless another thread has already done so.
+static void parsePoint(TraceBuffer::Point& point, const char *fmt);
+
 
 
 
@@ -60,23 +102,153 @@ using namespace aqosa;
 // Function and Class Implementation
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+static const char *parseSpec(const char *spec, ArgKind& kind)
+{
+    const char *p = spec + 1;
+    if (*p == '%')
+    {
+        kind = ArgPercent;
+        return p + 1;
+    }
+
+    // Flags, width and precision.
+    while (*p != '\0' && strchr("-+ #0", *p) != NULL)
+    {
+        p++;
+    }
+    while (*p >= '0' && *p <= '9')
+    {
+        p++;
+    }
+    if (*p == '.')
+    {
+        p++;
+        while (*p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+
+    // Length.
+    ArgKind intKind = ArgInt;
+    if (*p == 'h')
+    {
+        p += (p[1] == 'h') ? 2 : 1;
+    }
+    else if (*p == 'l')
+    {
+        intKind = (p[1] == 'l') ? ArgLongLong : ArgLong;
+        p += (p[1] == 'l') ? 2 : 1;
+    }
+    else if (*p == 'j')
+    {
+        intKind = ArgLongLong;
+        p++;
+    }
+    else if (*p == 'z' || *p == 't')
+    {
+        intKind = ArgSize;
+        p++;
+    }
+
+    switch (*p)
+    {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'c':
+        kind = intKind;
+        return p + 1;
+
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+        kind = ArgDouble;
+        return p + 1;
+
+    case 's':
+        kind = ArgString;
+        return p + 1;
+
+    case 'p':
+        kind = ArgPointer;
+        return p + 1;
+
+    default:
+        kind = ArgInvalid;
+        return p;
+    }
+}
+
+//------------------------------------------------------------------------------
+static void parsePoint(TraceBuffer::Point& point, const char *fmt)
+{
+    // The first thread to reach the point parses it; any other waits until 
+    // the parsed fields are published.
+    if (Atomic::cmpXchg(&point.state, TRACE_POINT_PARSING, TRACE_POINT_UNPARSED) != TRACE_POINT_UNPARSED)
+    {
+        while (Atomic::read(&point.state) != TRACE_POINT_PARSED)
+        {
+        }
+        return;
+    }
+
+    int argCount = 0;
+    for (const char *p = strchr(fmt, '%'); p != NULL && argCount < TRACE_POINT_ARG_MAX; p = strchr(p, '%'))
+    {
+        ArgKind kind;
+        p = parseSpec(p, kind);
+        if (kind == ArgInvalid)
+        {
+            break;
+        }
+        else if (kind != ArgPercent)
+        {
+            point.argKinds[argCount++] = (unsigned char)kind;
+        }
+    }
+    point.fmt = fmt;
+    point.argCount = argCount;
+
+    Atomic::write(&point.state, TRACE_POINT_PARSED);
+}
+
 namespace aq {
 
 //------------------------------------------------------------------------------
 TraceBuffer::TraceBuffer(TraceManager& mgr, const string &id, size_t recordCapacity)
     : m_mgr(mgr)
     , m_id(id)
+    , m_records(NULL)
+    , m_events(NULL)
+    , m_eventNext(0)
+    , m_eventCount(0)
     , m_recordCapacity(recordCapacity == 0 ? mgr.bufferSize() : recordCapacity)
     , m_recordFirst(0)
     , m_recordCount(0)
 {
-    m_records = new Record[m_recordCapacity];
+    if (mgr.format() == TraceManager::Binary)
+    {
+        m_events = new Event[m_recordCapacity];
+    }
+    else
+    {
+        m_records = new Record[m_recordCapacity];
+    }
 }
 
 //------------------------------------------------------------------------------
 TraceBuffer::~TraceBuffer(void)
 {
     delete[] m_records;
+    delete[] m_events;
 }
 
 //------------------------------------------------------------------------------
@@ -84,6 +256,9 @@ void TraceBuffer::clear(void)
 {
     m_recordFirst = 0;
     m_recordCount = 0;
+    m_eventNext = 0;
+    m_eventCount = 0;
+    m_eventIndex.clear();
 }
 //------------------------------------------------------------------------------
 void TraceBuffer::write(const char *function, int line, Record::Context context,
@@ -94,6 +269,11 @@ void TraceBuffer::write(const char *function, int line, Record::Context context,
     Record *rec = NULL;
     size_t idx;
 
+    if (m_records == NULL)
+    {
+        return;
+    }
+
     // Don't try to log items when the control overlay was not provided.
     if (ctrl == NULL)
     {
@@ -206,6 +386,264 @@ void TraceBuffer::write(const char *function, int line, Record::Context context,
     }
 }
 
+//------------------------------------------------------------------------------
+void TraceBuffer::event(Point& point, aq::CtrlOverlay *ctrl, const AQItem *item, 
+                        const char *fmt, ...)
+{
+    if (m_events == NULL)
+    {
+        return;
+    }
+
+    if (Atomic::read(&point.state) != TRACE_POINT_PARSED)
+    {
+        parsePoint(point, fmt);
+    }
+
+    Event *ev = nextEvent();
+    ev->timestamp = Timestamp::now();
+    ev->point = &point;
+    ev->flags = 0;
+    if (ctrl != NULL)
+    {
+        ev->flags |= EVENT_HAS_CTRL;
+        ev->headRef = Atomic::read(&ctrl->headRef);
+        ev->tailRef = Atomic::read(&ctrl->tailRef);
+        if (item != NULL && item->isAllocated())
+        {
+            ev->flags |= EVENT_HAS_ITEM;
+            ev->itemCtrl = item->ctrl();
+            ev->itemQuid = item->queueIdentifier();
+        }
+    }
+
+    size_t pos = 0;
+    va_list argp;
+    va_start(argp, fmt);
+    for (int i = 0; i < point.argCount; ++i)
+    {
+        uint64_t v;
+        switch (point.argKinds[i])
+        {
+        case ArgInt:
+            putWord(ev, pos, (uint32_t)va_arg(argp, int));
+            continue;
+
+        case ArgLong:
+            v = (uint64_t)va_arg(argp, long);
+            break;
+
+        case ArgLongLong:
+            v = (uint64_t)va_arg(argp, long long);
+            break;
+
+        case ArgSize:
+            v = (uint64_t)va_arg(argp, size_t);
+            break;
+
+        case ArgDouble:
+        {
+            double d = va_arg(argp, double);
+            memcpy(&v, &d, sizeof(v));
+            break;
+        }
+
+        case ArgPointer:
+            v = (uint64_t)(uintptr_t)va_arg(argp, void *);
+            break;
+
+        default:
+        {
+            // Copy the string four characters to a word up to and including
+            // the nul terminator.
+            const char *str = va_arg(argp, const char *);
+            if (str == NULL)
+            {
+                str = "(null)";
+            }
+            for (size_t n = 0; n < TRACE_EVENT_STRING_MAX; n += sizeof(uint32_t))
+            {
+                char c[sizeof(uint32_t)] = { 0, 0, 0, 0 };
+                size_t k = 0;
+                while (k < sizeof(c) && n + k < TRACE_EVENT_STRING_MAX - 1 && str[n + k] != '\0')
+                {
+                    c[k] = str[n + k];
+                    k++;
+                }
+                uint32_t w;
+                memcpy(&w, c, sizeof(w));
+                putWord(ev, pos, w);
+                if (k < sizeof(c))
+                {
+                    break;
+                }
+            }
+            continue;
+        }
+        }
+        putWord(ev, pos, (uint32_t)v);
+        putWord(ev, pos, (uint32_t)(v >> 32));
+    }
+    va_end(argp);
+}
+
+//------------------------------------------------------------------------------
+TraceBuffer::Event *TraceBuffer::nextEvent(void)
+{
+    Event *ev = &m_events[m_eventNext];
+    if (++m_eventNext == m_recordCapacity)
+    {
+        m_eventNext = 0;
+    }
+    if (m_eventCount < m_recordCapacity)
+    {
+        m_eventCount++;
+    }
+    return ev;
+}
+
+//------------------------------------------------------------------------------
+void TraceBuffer::putWord(Event *& ev, size_t& pos, uint32_t word)
+{
+    if (pos == TRACE_EVENT_WORD_COUNT)
+    {
+        ev = nextEvent();
+        ev->point = NULL;
+        pos = 0;
+    }
+    ev->words[pos++] = word;
+}
+
+//------------------------------------------------------------------------------
+uint32_t TraceBuffer::getWord(size_t& idx, size_t& pos) const
+{
+    if (pos == TRACE_EVENT_WORD_COUNT)
+    {
+        size_t next = idx + 1 == m_recordCapacity ? 0 : idx + 1;
+        if (next == m_eventNext || m_events[next].point != NULL)
+        {
+            return 0;
+        }
+        idx = next;
+        pos = 0;
+    }
+    return m_events[idx].words[pos++];
+}
+
+//------------------------------------------------------------------------------
+void TraceBuffer::indexEvents(void)
+{
+    m_eventIndex.clear();
+    if (m_events == NULL)
+    {
+        return;
+    }
+
+    // Records continuing an event that has been replaced are skipped.
+    size_t idx = m_eventCount < m_recordCapacity ? 0 : m_eventNext;
+    for (size_t i = 0; i < m_eventCount; ++i)
+    {
+        if (m_events[idx].point != NULL)
+        {
+            m_eventIndex.push_back(idx);
+        }
+        if (++idx == m_recordCapacity)
+        {
+            idx = 0;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void TraceBuffer::printEvent(size_t& pos, Record *rec, size_t idx) const
+{
+    const Point *point = m_events[idx].point;
+    size_t wordPos = 0;
+    int arg = 0;
+
+    const char *p = point->fmt;
+    while (*p != '\0')
+    {
+        const char *spec = strchr(p, '%');
+        if (spec == NULL)
+        {
+            sprintfRecord(pos, rec, "%s", p);
+            break;
+        }
+        sprintfRecord(pos, rec, "%.*s", (int)(spec - p), p);
+
+        ArgKind kind;
+        const char *end = parseSpec(spec, kind);
+        char specFmt[16];
+        if (kind == ArgPercent)
+        {
+            sprintfRecord(pos, rec, "%%");
+            p = end;
+            continue;
+        }
+        else if (arg >= point->argCount || (size_t)(end - spec) >= sizeof(specFmt))
+        {
+            sprintfRecord(pos, rec, "%s", spec);
+            break;
+        }
+        memcpy(specFmt, spec, end - spec);
+        specFmt[end - spec] = '\0';
+
+        uint64_t v = 0;
+        if (kind == ArgInt)
+        {
+            sprintfRecord(pos, rec, specFmt, (int)getWord(idx, wordPos));
+        }
+        else if (kind == ArgString)
+        {
+            char str[TRACE_EVENT_STRING_MAX];
+            for (size_t n = 0; n < TRACE_EVENT_STRING_MAX; n += sizeof(uint32_t))
+            {
+                uint32_t w = getWord(idx, wordPos);
+                memcpy(&str[n], &w, sizeof(w));
+                if (memchr(&str[n], '\0', sizeof(w)) != NULL)
+                {
+                    break;
+                }
+            }
+            str[TRACE_EVENT_STRING_MAX - 1] = '\0';
+            sprintfRecord(pos, rec, specFmt, str);
+        }
+        else
+        {
+            v = getWord(idx, wordPos);
+            v |= (uint64_t)getWord(idx, wordPos) << 32;
+            switch (kind)
+            {
+            case ArgLong:
+                sprintfRecord(pos, rec, specFmt, (long)v);
+                break;
+
+            case ArgLongLong:
+                sprintfRecord(pos, rec, specFmt, (long long)v);
+                break;
+
+            case ArgSize:
+                sprintfRecord(pos, rec, specFmt, (size_t)v);
+                break;
+
+            case ArgDouble:
+            {
+                double d;
+                memcpy(&d, &v, sizeof(d));
+                sprintfRecord(pos, rec, specFmt, d);
+                break;
+            }
+
+            default:
+                sprintfRecord(pos, rec, specFmt, (void *)(uintptr_t)v);
+                break;
+            }
+        }
+        arg++;
+        p = end;
+    }
+}
 
 //------------------------------------------------------------------------------
 void TraceBuffer::printItem(size_t& pos, aq::CtrlOverlay *ctrl,
@@ -292,6 +730,44 @@ void TraceBuffer::vsprintfRecord(size_t& pos, Record *rec, const char *fmt,
     }
 }
 
+//------------------------------------------------------------------------------
+void TraceBuffer::writeRecord(ostream& os, size_t idx) const
+{
+    if (!isBinary())
+    {
+        writeRecord(os, record(idx));
+        return;
+    }
+
+    // Format the event as a record.
+    const Event& ev = m_events[m_eventIndex[idx]];
+    Record rec;
+    rec.order = ev.timestamp;
+    rec.function = ev.point->function;
+    rec.line = ev.point->line;
+    rec.context = ev.point->context;
+    rec.hasCtrl = (ev.flags & EVENT_HAS_CTRL) != 0;
+    rec.headRef = ev.headRef;
+    rec.tailRef = ev.tailRef;
+    rec.data = NULL;
+    rec.dataSize = 0;
+    rec.dataTruncated = false;
+
+    size_t pos = 0;
+    rec.msg[0] = '\0';
+    if (ev.flags & EVENT_HAS_ITEM)
+    {
+        sprintfRecord(pos, &rec, "itm[%08X:%c%c%cQ%uL%u] ", ev.itemQuid,
+            (ev.itemCtrl & CtrlOverlay::CTRLQ_CLAIM_MASK) ? 'c' : '-',
+            (ev.itemCtrl & CtrlOverlay::CTRLQ_COMMIT_MASK) ? 'C' : '-',
+            (ev.itemCtrl & CtrlOverlay::CTRLQ_DISCARD_MASK) ? 'D' : '-',
+            (ev.itemCtrl & CtrlOverlay::CTRLQ_SEQ_MASK) >> CtrlOverlay::REF_SEQ_SHIFT,
+            ev.itemCtrl & CtrlOverlay::CTRLQ_SIZE_MASK);
+    }
+    printEvent(pos, &rec, m_eventIndex[idx]);
+    writeRecord(os, rec);
+}
+
 //------------------------------------------------------------------------------
 void TraceBuffer::writeRecord(ostream& os, const TraceBuffer::Record& rec) const
 {
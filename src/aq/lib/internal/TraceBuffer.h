@@ -15,6 +15,7 @@
 
 #include <string>
 #include <stdarg.h>
+#include <vector>
 
 
 
@@ -26,18 +27,69 @@
 // The number of bytes allocated to each trace buffer message.
 #define TRACE_BUFFER_MSG_SIZE           250
 
-#ifdef AQ_TEST_TRACE
+// The maximum number of arguments recorded for a binary trace point.
+#define TRACE_POINT_ARG_MAX             12
 
-// Baseline tracing macro used to build all other macro types.
+// The states of a binary trace point: its format has not been parsed, is 
+// being parsed by one thread, or has been parsed and published.
+#define TRACE_POINT_UNPARSED            0
+#define TRACE_POINT_PARSING             1
+#define TRACE_POINT_PARSED              2
+
+// The number of 32-bit argument words held in each binary event record.  This
+// makes each record 64 bytes on 64-bit platforms.
+#define TRACE_EVENT_WORD_COUNT          7
+
+// The maximum number of bytes, including the nul terminator, recorded for a 
+// string argument of a binary event.
+#define TRACE_EVENT_STRING_MAX          64
+
+// Records a binary event for a trace point.  Each use declares a static trace
+// point so only the argument values are stored with the event; the text is
+// formatted when the trace manager is written.
+#define TRACE_EVENT_TYPE(__type, __ctrl, __item, ...)                           \
+do                                                                              \
+{                                                                               \
+    if (m_trace != NULL)                                                        \
+    {                                                                           \
+        static TraceBuffer::Point tracePoint =                                  \
+            { __FUNCTION__, __LINE__, TraceBuffer::Record::__type,              \
+              TRACE_POINT_UNPARSED, NULL, 0, { 0 } };                           \
+        m_trace->event(tracePoint, (__ctrl), (__item), "" __VA_ARGS__);         \
+    }                                                                           \
+} while(0)
+
+// The trace points are compiled in by the test builds, or by defining AQ_TRACE
+// for any other build.
+#if defined(AQ_TEST_TRACE) && !defined(AQ_TRACE)
+#define AQ_TRACE
+#endif
+
+#ifdef AQ_TRACE
+
+// Baseline tracing macro used to build all other macro types.  The format is
+// that of the trace buffer; in binary mode the item chain and data are not 
+// recorded.
 #define TRACE_ITEM_TYPE(__type, __ctrl, __item, __logAllItems, __logItemData,  \
                         __data, __dataSize, ...)                                \
 do                                                                              \
 {                                                                               \
     if (m_trace != NULL)                                                        \
     {                                                                           \
-        m_trace->write(__FUNCTION__, __LINE__, TraceBuffer::Record::__type,     \
-                       (__ctrl), (__item), (__logAllItems), (__logItemData),    \
-                       (__data), (__dataSize), "" __VA_ARGS__);                 \
+        if (m_trace->isBinary())                                                \
+        {                                                                       \
+            static TraceBuffer::Point tracePoint =                              \
+                { __FUNCTION__, __LINE__, TraceBuffer::Record::__type,          \
+                  TRACE_POINT_UNPARSED, NULL, 0, { 0 } };                       \
+            m_trace->event(tracePoint, (__ctrl), (__item), "" __VA_ARGS__);     \
+        }                                                                       \
+        else                                                                    \
+        {                                                                       \
+            m_trace->write(__FUNCTION__, __LINE__, TraceBuffer::Record::__type, \
+                           (__ctrl), (__item), (__logAllItems),                 \
+                           (__logItemData), (__data), (__dataSize),             \
+                           "" __VA_ARGS__);                                     \
+        }                                                                       \
     }                                                                           \
 } while(0)
 
@@ -144,6 +196,17 @@ namespace aq
 
 // Contains a buffer used to capture trace information for a particular queue
 // access.
+//
+// A buffer holds either text records or binary events, as set by the format of
+// its manager.  Text records are formatted by write() at each trace point and 
+// are only suitable for testing.  Binary events are recorded by event() as a
+// timestamp, the trace point and the raw argument values, so that tracing can
+// stay enabled in production at a cost of a few nanoseconds per event.  An 
+// event with more argument words than fit in one record continues into the 
+// following records.
+//
+// A buffer is only written by the thread that owns it, so neither form takes
+// a lock.
 namespace aq { class TraceBuffer
 {
 public:
@@ -233,6 +296,35 @@ public:
 
     };
 
+    // Defines a point in the code that records binary events.  Each point is
+    // a static variable declared by TRACE_EVENT_TYPE(); the types of its 
+    // arguments are parsed from the format on its first event.
+    struct Point
+    {
+        // The function containing this trace point.
+        const char *function;
+
+        // The line of this trace point.
+        int line;
+
+        // The context for the events of this trace point.
+        Record::Context context;
+
+        // One of TRACE_POINT_UNPARSED, TRACE_POINT_PARSING or
+        // TRACE_POINT_PARSED.  The fields below are only valid once this is
+        // read as TRACE_POINT_PARSED.
+        volatile uint32_t state;
+
+        // The format of the message; set on the first event.
+        const char *fmt;
+
+        // The number of arguments in 'argKinds'.
+        int argCount;
+
+        // The kind of each argument.
+        unsigned char argKinds[TRACE_POINT_ARG_MAX];
+    };
+
     // Writes a record into this record buffer for the function 'function' at line
     // 'line'.  The record has a context of 'context' and a message given by 'fmt' 
     // with arguments '...'.
@@ -253,8 +345,63 @@ public:
                bool logItemData, const void *data, size_t dataSize,
                const char *fmt, ...);
 
+    // Records a binary event for the trace point 'point' with the arguments 
+    // '...' of the format 'fmt'.  Of the 'ctrl' and 'item' only the head and 
+    // tail references and the control word and identifier of 'item' are kept.
+    //
+    // Events are only recorded when the manager has the binary format.
+    void event(Point& point, aq::CtrlOverlay *ctrl, const AQItem *item, 
+               const char *fmt, ...);
+
 private:
 
+    // Defines a binary event record.
+    struct Event
+    {
+        // The time of the event in nanoseconds; see aqosa::Timestamp::now().
+        uint64_t timestamp;
+
+        // The trace point of the event, or NULL if this record holds more
+        // argument words for the event before it.
+        const Point *point;
+
+        // Set of EVENT_* flags.
+        uint32_t flags;
+
+        // The head and tail references when EVENT_HAS_CTRL is set.
+        uint32_t headRef;
+        uint32_t tailRef;
+
+        // The control word and queue identifier of the item when 
+        // EVENT_HAS_ITEM is set.
+        uint32_t itemCtrl;
+        uint32_t itemQuid;
+
+        // The argument words.
+        uint32_t words[TRACE_EVENT_WORD_COUNT];
+    };
+
+    // Set in Event::flags when a control overlay was provided.
+    static const uint32_t EVENT_HAS_CTRL = 1 << 0;
+
+    // Set in Event::flags when an allocated item was provided.
+    static const uint32_t EVENT_HAS_ITEM = 1 << 1;
+
+    // Returns the next event record, replacing the oldest when full.
+    Event *nextEvent(void);
+
+    // Appends the argument word 'word' to the event at 'ev' where 'pos' is the
+    // next word, moving 'ev' to a new continuation record when it is full.
+    void putWord(Event *& ev, size_t& pos, uint32_t word);
+
+    // Reads the next argument word of the event record at 'idx' where 'pos' is
+    // the next word, moving 'idx' to the continuation record when needed.  
+    // Returns 0 if the event has no more words.
+    uint32_t getWord(size_t& idx, size_t& pos) const;
+
+    // Prints the message of the event at 'idx' into the log record.
+    void printEvent(size_t& pos, Record *rec, size_t idx) const;
+
     // Prints the passed item into the log record.
     void printItem(size_t& pos, aq::CtrlOverlay *ctrl, Record *rec, int idx,
                    const AQItem *item);
@@ -264,12 +411,25 @@ private:
     //
     // 'pos' tracks the current append position in the buffer.  It must start at 0.
     // On return it points to the nul terminator.
-    void sprintfRecord(size_t& pos, Record *rec, const char *fmt, ...);
-    void vsprintfRecord(size_t& pos, Record *rec, const char *fmt, va_list argp);
+    static void sprintfRecord(size_t& pos, Record *rec, const char *fmt, ...);
+    static void vsprintfRecord(size_t& pos, Record *rec, const char *fmt, va_list argp);
 
-    // The array of records.
+    // The array of records, or NULL if this buffer has the binary format.
     Record *m_records;
 
+    // The array of event records, or NULL if this buffer has the text format.
+    Event *m_events;
+
+    // The index of the next event record to write.
+    size_t m_eventNext;
+
+    // The number of event records in the array.
+    size_t m_eventCount;
+
+    // The index of the first record of each event, oldest first, as found by
+    // the last call to indexEvents().
+    std::vector<size_t> m_eventIndex;
+
     // The capacity of the record array.
     const size_t m_recordCapacity;
 
@@ -284,13 +444,32 @@ public:
     // Writes the passed record 'rec' to the output stream 'os'.
     void writeRecord(std::ostream& os, const TraceBuffer::Record& rec) const;
 
+    // Writes the record or event at index 'idx' to the output stream 'os'.
+    void writeRecord(std::ostream& os, size_t idx) const;
+
     // Returns the identifier for this trace buffer.
     const std::string &id(void) const { return m_id; }
 
-    // Returns the number of records in this buffer.
-    size_t recordCount(void) const { return m_recordCount; }
+    // Returns true if this buffer holds binary events rather than text records.
+    bool isBinary(void) const { return m_events != NULL; }
+
+    // Finds the events in this buffer.  Must be called before the events are
+    // counted or written and while the buffer is not being written.
+    void indexEvents(void);
+
+    // Returns the number of records in this buffer; for a binary buffer this
+    // is the number of events found by indexEvents().
+    size_t recordCount(void) const { return isBinary() ? m_eventIndex.size() : m_recordCount; }
+
+    // Returns the order of the record at index 'idx'; for a binary buffer this
+    // is the timestamp of the event.
+    uint64_t recordOrder(size_t idx) const
+    {
+        return isBinary() ? m_events[m_eventIndex[idx]].timestamp : record(idx).order;
+    }
 
-    // Returns one of the records from this record array at index 'idx'.
+    // Returns one of the records from this record array at index 'idx'.  Only
+    // valid for a text buffer.
     const Record &record(size_t idx) const { return m_records[(m_recordFirst + idx) % m_recordCapacity]; }
 
 };}
@@ -57,9 +57,11 @@ namespace aq {
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-TraceManager::TraceManager(LogContentMode logContent, size_t bufferSize)
+TraceManager::TraceManager(LogContentMode logContent, size_t bufferSize,
+                           Format format)
     : m_logContent(logContent)
     , m_bufferSize(bufferSize)
+    , m_format(format)
     , m_order(0)
 {
 }
@@ -98,6 +100,7 @@ void TraceManager::write(ostream& os) const
     vector<size_t> index;
     for (size_t i = 0; i < m_buffers.size(); ++i)
     {
+        m_buffers[i]->indexEvents();
         index.push_back(0);
     }
 
@@ -112,11 +115,11 @@ void TraceManager::write(ostream& os) const
         {
             if (index[i] < m_buffers[i]->recordCount())
             {
-                const TraceBuffer::Record& rec = m_buffers[i]->record(index[i]);
+                uint64_t recOrder = m_buffers[i]->recordOrder(index[i]);
 
-                if (nextBuffer == m_buffers.size() || rec.order < order)
+                if (nextBuffer == m_buffers.size() || recOrder < order)
                 {
-                    order = rec.order;
+                    order = recOrder;
                     nextBuffer = i;
                 }
             }
@@ -128,12 +131,9 @@ void TraceManager::write(ostream& os) const
             break;
         }
 
-        // Extract the record
-        const TraceBuffer::Record& rec = m_buffers[nextBuffer]->record(index[nextBuffer]);
-        index[nextBuffer]++;
-
         // Log the record.
-        m_buffers[nextBuffer]->writeRecord(os, rec);
+        m_buffers[nextBuffer]->writeRecord(os, index[nextBuffer]);
+        index[nextBuffer]++;
     }
 }
 
@@ -28,6 +28,14 @@
 // The default buffer size for the trace buffers.
 #define TRACE_MANAGER_BUFFER_SIZE_DEFAULT   1000
 
+// The default format for the trace buffers; binary when AQ_TRACE_BINARY is
+// defined.
+#ifdef AQ_TRACE_BINARY
+#define TRACE_MANAGER_FORMAT_DEFAULT        aq::TraceManager::Binary
+#else
+#define TRACE_MANAGER_FORMAT_DEFAULT        aq::TraceManager::Text
+#endif
+
 
 
 
@@ -67,13 +75,27 @@ public:
         Bytes,
     };
 
+    // The possible trace buffer formats.
+    enum Format
+    {
+        // Each trace point formats a text record.
+        Text,
+
+        // Each trace point records a binary event that is only formatted 
+        // when the manager is written.
+        Binary,
+    };
+
     // Constructs a new trace manager specifying the maximum number of records 
     // to keep in each trace buffer.
     //
     // The queueControlSize is the number of bytes to allocate to capturing queue
     // state; if set to 0 queue state is not captured.
+    //
+    // The 'format' sets the format of each trace buffer.
     TraceManager(LogContentMode logContent = None,
-                 size_t bufferSize = TRACE_MANAGER_BUFFER_SIZE_DEFAULT);
+                 size_t bufferSize = TRACE_MANAGER_BUFFER_SIZE_DEFAULT,
+                 Format format = TRACE_MANAGER_FORMAT_DEFAULT);
 
     // Not defined; trace managers cannot be copied or assigned.
     TraceManager(const TraceManager& other);
@@ -90,6 +112,9 @@ private:
     // The size of each trace buffer.
     const size_t m_bufferSize;
 
+    // The format of each trace buffer.
+    const Format m_format;
+
     // The tracing order number.
     volatile uint64_t m_order;
 
@@ -107,6 +132,9 @@ public:
     // Returns the size of the buffers for this trace manager.
     size_t bufferSize(void) const { return m_bufferSize; }
 
+    // Returns the format of the buffers for this trace manager.
+    Format format(void) const { return m_format; }
+
     // Creates a new trace buffer with the passed 'id'.
     TraceBuffer *createBuffer(const std::string &id, size_t recordCapacity = 0);
 
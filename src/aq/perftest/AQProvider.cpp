@@ -15,6 +15,7 @@
 #include "AQReader.h"
 #include "AQWriter.h"
 
+#include "Atomic.h"
 #include "CtrlOverlay.h"
 
 #include "IAQReader.h"
@@ -24,6 +25,7 @@
 
 using namespace std;
 using namespace aq;
+using namespace aqosa;
 
 
 
@@ -135,6 +137,40 @@ std::string AQProvider::results(void)
     return ss.str();
 }
 
+//------------------------------------------------------------------------------
+size_t AQProvider::ringPageCount(void) const
+{
+    return m_aqReader->pageCount();
+}
+
+//------------------------------------------------------------------------------
+size_t AQProvider::ringPage(const AQItem& item) const
+{
+    const CtrlOverlay *ctrl = (const CtrlOverlay *)m_mem->baseAddress();
+
+    return ctrl->memToPage(&item[0]);
+}
+
+//------------------------------------------------------------------------------
+size_t AQProvider::freeSize(void) const
+{
+    CtrlOverlay *ctrl = (CtrlOverlay *)m_mem->baseAddress();
+
+    // One page is always left unused so that a full queue can be told apart
+    // from an empty one.
+    uint32_t headIdx = ctrl->queueRefToIndex(Atomic::read(&ctrl->headRef));
+    uint32_t tailIdx = ctrl->queueRefToIndex(Atomic::read(&ctrl->tailRef));
+    uint32_t freePages = (tailIdx + ctrl->pageCount - headIdx - 1) % ctrl->pageCount;
+
+    return (size_t)freePages << m_pageSizeShift;
+}
+
+//------------------------------------------------------------------------------
+size_t AQProvider::availableSize(void) const
+{
+    return m_aqReader->availableSize();
+}
+
 
 
 
@@ -83,6 +83,21 @@ public:
     // Obtains a string description of the queue state.
     virtual std::string results(void);
 
+    // AQ places each item in consecutive pages of a single ring.
+    virtual bool hasPageRing(void) const { return true; }
+
+    // Returns the total number of pages in the ring.
+    virtual size_t ringPageCount(void) const;
+
+    // Returns the ring page that holds the start of 'item'.
+    virtual size_t ringPage(const AQItem& item) const;
+
+    // Returns the number of bytes in the free pages of the ring.
+    virtual size_t freeSize(void) const;
+
+    // Returns the largest number of bytes that can be claimed as one item.
+    virtual size_t availableSize(void) const;
+
 private:
 
     // The page size shift that has been configured.
@@ -58,7 +58,7 @@ ClaimTest::ClaimTest(const std::string& name, IQueueProvider& queueProvider,
 {
     for (int i = 0; i < threadCount; ++i)
     {
-        addThread<ClaimTest>(&ClaimTest::threadClaim);
+        addThread<ClaimTest, LatencyHistogram>(&ClaimTest::threadClaim, addLatencyHistogram());
     }
 }
 
@@ -68,13 +68,25 @@ ClaimTest::~ClaimTest(void)
 }
 
 //------------------------------------------------------------------------------
-void ClaimTest::threadClaim(void)
+void ClaimTest::threadClaim(LatencyHistogram& latency)
 {
     AQWriterItem item;
     IAQWriter& writer = queueProvider().writer();
-    for (size_t i = 0; i < m_claimPerThread; ++i)
+    if (latencySampling())
     {
-        writer.claim(item, 1);
+        for (size_t i = 0; i < m_claimPerThread; ++i)
+        {
+            uint64_t start = LatencyHistogram::ticks();
+            writer.claim(item, 1);
+            latency.record(LatencyHistogram::ticks() - start);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < m_claimPerThread; ++i)
+        {
+            writer.claim(item, 1);
+        }
     }
 }
 
@@ -71,8 +71,9 @@ private:
     // The number of claim operations to perform per thread.
     const size_t m_claimPerThread;
 
-    // Takes no action.
-    void threadClaim(void);
+    // Claims pages from the queue, recording the latency of each claim into
+    // 'latency' when sampling is enabled.
+    void threadClaim(LatencyHistogram& latency);
 
 };
 
@@ -62,7 +62,7 @@ CommitTest::CommitTest(const std::string& name, IQueueProvider& queueProvider,
     for (int i = 0; i < threadCount; ++i)
     {
         m_items[i].resize(m_commitPerThread);
-        addThread<CommitTest, vector<AQWriterItem> >(&CommitTest::threadCommit, m_items[i]);
+        addThread<CommitTest, vector<AQWriterItem>, LatencyHistogram>(&CommitTest::threadCommit, m_items[i], addLatencyHistogram());
     }
 }
 
@@ -88,13 +88,25 @@ void CommitTest::beforeIteration(void)
 }
 
 //------------------------------------------------------------------------------
-void CommitTest::threadCommit(vector<AQWriterItem>& items)
+void CommitTest::threadCommit(vector<AQWriterItem>& items, LatencyHistogram& latency)
 {
     AQWriterItem item;
     IAQWriter& writer = queueProvider().writer();
-    for (size_t i = 0; i < items.size(); ++i)
+    if (latencySampling())
     {
-        writer.commit(items[i]); 
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            uint64_t start = LatencyHistogram::ticks();
+            writer.commit(items[i]);
+            latency.record(LatencyHistogram::ticks() - start);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            writer.commit(items[i]); 
+        }
     }
 }
 
@@ -81,8 +81,9 @@ private:
     // The list of items.
     std::vector<AQWriterItem> *m_items;
 
-    // Takes no action.
-    void threadCommit(std::vector<AQWriterItem>& items);
+    // Commits each of 'items', recording the latency of each commit into
+    // 'latency' when sampling is enabled.
+    void threadCommit(std::vector<AQWriterItem>& items, LatencyHistogram& latency);
 
 };
 
@@ -0,0 +1,367 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "CrossProcessTest.h"
+
+#include "AQExternMemory.h"
+#include "AQItem.h"
+#include "AQReader.h"
+#include "AQWriter.h"
+#include "AQWriterItem.h"
+
+#include "CtrlOverlay.h"
+
+#include "Atomic.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace aq;
+using namespace aqosa;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The commit timeout to use.
+#define COMMIT_TIMEOUT_MS               30000
+
+// The number of bytes reserved for the control block at the start of the
+// shared memory; a whole cache line so that the queue does not share it.
+#define CONTROL_BLOCK_SIZE              64
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+// The block at the start of the shared memory used to run the producers.
+struct ControlBlock
+{
+    // Incremented by the consumer to start the producers on an iteration.
+    volatile uint32_t generation;
+
+    // The number of producers that have finished the current iteration.
+    volatile uint32_t finished;
+
+    // Set to 1 to make the producers exit.
+    volatile uint32_t exit;
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Throws a runtime_error describing the failure of 'func' with 'errno'.
+static void throwErrno(const char *func);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// Used to give each shared memory region a unique name.
+static unsigned int ShmSequence = 0;
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+CrossProcessTest::CrossProcessTest(const std::string& name, int producerCount,
+    int pageSizeShift, size_t pageCount)
+    : PerfTest(name)
+    , m_producerCount((size_t)producerCount)
+    , m_pageSizeShift(pageSizeShift)
+    , m_pageCount(pageCount)
+    , m_claimPerProducer(0)
+    , m_claimSize(1)
+    , m_shm(NULL)
+    , m_shmSize(0)
+    , m_mem(NULL)
+    , m_reader(NULL)
+{
+    mapSharedMemory();
+    addThread<CrossProcessTest, LatencyHistogram>(&CrossProcessTest::threadConsume, addLatencyHistogram());
+}
+
+//------------------------------------------------------------------------------
+CrossProcessTest::~CrossProcessTest(void)
+{
+    stopProducers();
+    delete m_reader;
+    delete m_mem;
+    munmap(m_shm, m_shmSize);
+}
+
+//------------------------------------------------------------------------------
+static void throwErrno(const char *func)
+{
+    ostringstream ss;
+    ss << func << "() failed: " << strerror(errno);
+    throw runtime_error(ss.str());
+}
+
+//------------------------------------------------------------------------------
+void CrossProcessTest::mapSharedMemory(void)
+{
+    ostringstream ss;
+    ss << "/aq_perftest." << getpid() << "." << ShmSequence++;
+    string shmName = ss.str();
+
+    size_t memSize = sizeof(CtrlOverlay) + sizeof(uint32_t) * m_pageCount
+                                         + (m_pageCount << m_pageSizeShift);
+    size_t i = 1;
+    for (;;)
+    {
+        // The region is unlinked as soon as it is mapped; the producers
+        // inherit the mapping when they are forked.
+        int fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+        if (fd < 0)
+        {
+            throwErrno("shm_open");
+        }
+        shm_unlink(shmName.c_str());
+
+        m_shmSize = CONTROL_BLOCK_SIZE + memSize;
+        if (ftruncate(fd, (off_t)m_shmSize) != 0)
+        {
+            close(fd);
+            throwErrno("ftruncate");
+        }
+        m_shm = mmap(NULL, m_shmSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (m_shm == MAP_FAILED)
+        {
+            m_shm = NULL;
+            throwErrno("mmap");
+        }
+
+        m_mem = new AQExternMemory((char *)m_shm + CONTROL_BLOCK_SIZE, memSize);
+        m_reader = new AQReader(*m_mem);
+        if (!m_reader->format(m_pageSizeShift, COMMIT_TIMEOUT_MS))
+        {
+            throw runtime_error("Cannot format the shared memory queue");
+        }
+        if (m_reader->pageCount() >= m_pageCount)
+        {
+            break;
+        }
+
+        delete m_reader;
+        m_reader = NULL;
+        delete m_mem;
+        m_mem = NULL;
+        munmap(m_shm, m_shmSize);
+        m_shm = NULL;
+        memSize += i << m_pageSizeShift;
+        i++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void CrossProcessTest::before(void)
+{
+    // To measure the end-to-end latency each item carries the low 32 bits
+    // of the tick count when it was committed, so it must fill a page.
+    size_t pageSize = (size_t)1 << m_pageSizeShift;
+    if (latencySampling() && pageSize >= sizeof(uint32_t))
+    {
+        m_claimSize = sizeof(uint32_t);
+    }
+    else
+    {
+        m_claimSize = 1;
+    }
+    m_claimPerProducer = (m_reader->pageCount() - 1) / m_producerCount;
+
+    // No other threads are running so it is safe to fork.
+    for (size_t i = 0; i < m_producerCount; ++i)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            throwErrno("fork");
+        }
+        else if (pid == 0)
+        {
+            int status = 0;
+            try
+            {
+                CpuAffinity::pinCurrentThread(affinityCpu(i));
+                runProducer();
+            }
+            catch (...)
+            {
+                status = 1;
+            }
+            _exit(status);
+        }
+        m_producers.push_back(pid);
+    }
+}
+
+//------------------------------------------------------------------------------
+void CrossProcessTest::beforeIteration(void)
+{
+    m_reader->format(m_pageSizeShift, COMMIT_TIMEOUT_MS);
+
+    ControlBlock *ctrl = (ControlBlock *)m_shm;
+    Atomic::write(&ctrl->finished, 0);
+}
+
+//------------------------------------------------------------------------------
+void CrossProcessTest::after(void)
+{
+    if (!stopProducers())
+    {
+        throw runtime_error("A producer process failed");
+    }
+}
+
+//------------------------------------------------------------------------------
+bool CrossProcessTest::stopProducers(void)
+{
+    ControlBlock *ctrl = (ControlBlock *)m_shm;
+    Atomic::write(&ctrl->exit, 1);
+
+    bool success = true;
+    for (size_t i = 0; i < m_producers.size(); ++i)
+    {
+        int status;
+        if (waitpid(m_producers[i], &status, 0) != m_producers[i]
+            || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            success = false;
+        }
+    }
+    m_producers.clear();
+    Atomic::write(&ctrl->exit, 0);
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+void CrossProcessTest::runProducer(void)
+{
+    ControlBlock *ctrl = (ControlBlock *)m_shm;
+    pid_t parent = getppid();
+    AQWriter writer(*m_mem);
+    AQWriterItem item;
+
+    uint32_t generation = Atomic::read(&ctrl->generation);
+    for (;;)
+    {
+        // Wait for the next iteration, giving up if the consumer has gone.
+        uint32_t next;
+        while ((next = Atomic::read(&ctrl->generation)) == generation)
+        {
+            if (Atomic::read(&ctrl->exit) || getppid() != parent)
+            {
+                return;
+            }
+            sched_yield();
+        }
+        generation = next;
+
+        for (size_t i = 0; i < m_claimPerProducer; ++i)
+        {
+            while (!writer.claim(item, m_claimSize))
+            {
+                sched_yield();
+            }
+            if (m_claimSize == sizeof(uint32_t))
+            {
+                uint32_t stamp = (uint32_t)LatencyHistogram::ticks();
+                memcpy(&item[0], &stamp, sizeof(stamp));
+            }
+            writer.commit(item);
+        }
+
+        Atomic::increment(&ctrl->finished);
+    }
+}
+
+//------------------------------------------------------------------------------
+void CrossProcessTest::threadConsume(LatencyHistogram& latency)
+{
+    ControlBlock *ctrl = (ControlBlock *)m_shm;
+    AQItem item;
+
+    Atomic::increment(&ctrl->generation);
+
+    size_t count = m_claimPerProducer * m_producerCount;
+    while (count > 0)
+    {
+        if (m_reader->retrieve(item))
+        {
+            if (m_claimSize == sizeof(uint32_t) && item.size() >= sizeof(uint32_t))
+            {
+                uint32_t now = (uint32_t)LatencyHistogram::ticks();
+                uint32_t stamp;
+                memcpy(&stamp, &item[0], sizeof(stamp));
+                latency.record(now - stamp);
+            }
+            m_reader->release(item);
+            count--;
+        }
+    }
+
+    // Every item has been retrieved so the producers are about to finish.
+    while (Atomic::read(&ctrl->finished) < m_producerCount)
+    {
+        sched_yield();
+    }
+}
+
+//------------------------------------------------------------------------------
+string CrossProcessTest::config(void) const
+{
+    ostringstream ss;
+    ss << m_reader->pageCount() << " pages @ " << m_reader->pageSize() << " bytes";
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+string CrossProcessTest::results(void) const
+{
+    ostringstream ss;
+    ss << "contention[" << m_reader->claimContentionCount() << "]";
+    return ss.str();
+}
+
+
+
+
+//=============================== End of File ==================================
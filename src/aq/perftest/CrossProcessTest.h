@@ -0,0 +1,171 @@
+#ifndef CROSSPROCESSTEST_H
+#define CROSSPROCESSTEST_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PerfTest.h"
+
+#include <sys/types.h>
+
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class AQExternMemory;
+class AQReader;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Tests the performance of a queue in POSIX shared memory with a number of
+// producer processes performing claim()/commit() and the consumer performing
+// retrieve()/release() in this process.  Unlike the other tests every access
+// to the queue control structures crosses a process boundary, as it does when
+// the queue is used in production.
+//
+// The producers take the first CPUs from the test's affinity and the consumer
+// thread the CPU that follows them, as in the other tests.
+//
+// The shared memory is mapped when the test is constructed.  The producer
+// processes are forked when the test starts and live until it ends; each
+// iteration they are started through a control block at the head of the
+// shared memory and the consumer thread measures the time taken for their
+// items to be retrieved.  When latency sampling is enabled each item
+// carries the tick count when it was committed so the consumer can record
+// the end-to-end latency.
+//
+// This test is only available on POSIX systems.
+class CrossProcessTest : public PerfTest
+{
+public:
+
+    // Constructs a new cross process test with 'producerCount' producer
+    // processes using a queue with pages of 1 << 'pageSizeShift' bytes and
+    // at least 'pageCount' pages.
+    CrossProcessTest(const std::string& name, int producerCount,
+        int pageSizeShift, size_t pageCount);
+
+private:
+    // No copy or assignment permitted.
+    CrossProcessTest(const CrossProcessTest& other);
+    CrossProcessTest& operator=(const CrossProcessTest& other);
+public:
+
+    // Destroys this cross process test.
+    virtual ~CrossProcessTest(void);
+
+    // Gets the number of processes in this test, including the consumer.
+    virtual size_t threadCount(void) const { return m_producerCount + 1; }
+
+    // The total number of operations that were performed.
+    virtual unsigned long totalOperationCount(void) const
+    {
+        return iterationCount() * m_claimPerProducer * m_producerCount;
+    }
+
+protected:
+
+    // Forks the producer processes.
+    virtual void before(void);
+
+    // Called before each iteration of the test.
+    virtual void beforeIteration(void);
+
+    // Stops the producer processes.
+    virtual void after(void);
+
+    // Places the consumer thread after the producer processes.
+    virtual int threadAffinityCpu(size_t threadNum) const { return affinityCpu(m_producerCount + threadNum); }
+
+public:
+
+    // Gets a description of the configuration of this test.
+    virtual std::string config(void) const;
+
+    // Gets a description of the resultant state for this test.
+    virtual std::string results(void) const;
+
+private:
+
+    // The number of producer processes.
+    const size_t m_producerCount;
+
+    // The page size shift for the queue.
+    const int m_pageSizeShift;
+
+    // The minimum number of pages in the queue.
+    const size_t m_pageCount;
+
+    // The number of claim operations each producer performs per iteration.
+    size_t m_claimPerProducer;
+
+    // The number of bytes claimed for each item.
+    size_t m_claimSize;
+
+    // The shared memory mapping.
+    void *m_shm;
+
+    // The size of the shared memory mapping.
+    size_t m_shmSize;
+
+    // The queue memory within the shared memory.
+    AQExternMemory *m_mem;
+
+    // The queue reader used by the consumer.
+    AQReader *m_reader;
+
+    // The process identifiers of the producers.
+    std::vector<pid_t> m_producers;
+
+    // Maps the shared memory and formats a queue with at least m_pageCount
+    // pages in it.
+    void mapSharedMemory(void);
+
+    // Stops the producer processes and waits for them to exit.  Returns
+    // false if any of them failed.
+    bool stopProducers(void);
+
+    // Runs in each producer process until the test ends.
+    void runProducer(void);
+
+    // Runs the retrieve/release operations in the consumer.
+    void threadConsume(LatencyHistogram& latency);
+
+};
+
+
+
+#endif
+//=============================== End of File ==================================
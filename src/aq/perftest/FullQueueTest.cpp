@@ -63,12 +63,13 @@ FullQueueTest::FullQueueTest(const std::string& name, IQueueProvider& queueProvi
     , m_claimPerThread(queueProvider.usablePageCount() / (size_t)claimCommitThreadCount)
     , m_performMemcpy(performMemcpy)
     , m_dataMaxOffset(queueProvider.pageSize())
+    , m_claimSize(1)
 {
     for (int i = 0; i < claimCommitThreadCount; ++i)
     {
         addThread<FullQueueTest>(&FullQueueTest::threadClaimCommit);
     }
-    addThread<FullQueueTest>(&FullQueueTest::threadRetrieveRelease);
+    addThread<FullQueueTest, LatencyHistogram>(&FullQueueTest::threadRetrieveRelease, addLatencyHistogram());
 
     size_t dataSize = queueProvider.pageSize() + m_dataMaxOffset;
     m_data = new unsigned char[dataSize];
@@ -85,6 +86,23 @@ FullQueueTest::~FullQueueTest(void)
     delete[] m_data;
 }
 
+//------------------------------------------------------------------------------
+void FullQueueTest::before(void)
+{
+    QueueTest::before();
+
+    // To measure the end-to-end latency each item carries the low 32 bits 
+    // of the tick count when it was committed, so it must fill a page.
+    if (latencySampling() && queueProvider().pageSize() >= sizeof(uint32_t))
+    {
+        m_claimSize = sizeof(uint32_t);
+    }
+    else
+    {
+        m_claimSize = 1;
+    }
+}
+
 //------------------------------------------------------------------------------
 void FullQueueTest::threadClaimCommit(void)
 {
@@ -92,19 +110,24 @@ void FullQueueTest::threadClaimCommit(void)
     IAQWriter& writer = queueProvider().writer();
     for (size_t i = 0; i < m_claimPerThread; ++i)
     {
-        if (writer.claim(item, 1))
+        if (writer.claim(item, m_claimSize))
         {
             if (m_performMemcpy)
             {
                 memcpy(&item[0], &m_data[i % m_dataMaxOffset], item.size());
             }
+            if (m_claimSize == sizeof(uint32_t))
+            {
+                uint32_t stamp = (uint32_t)LatencyHistogram::ticks();
+                memcpy(&item[0], &stamp, sizeof(stamp));
+            }
             writer.commit(item);
         }
     }
 }
 
 //------------------------------------------------------------------------------
-void FullQueueTest::threadRetrieveRelease(void)
+void FullQueueTest::threadRetrieveRelease(LatencyHistogram& latency)
 {
     AQItem item;
     IAQReader& reader = queueProvider().reader();
@@ -113,6 +136,13 @@ void FullQueueTest::threadRetrieveRelease(void)
     {
         if (reader.retrieve(item))
         {
+            if (m_claimSize == sizeof(uint32_t) && item.size() >= sizeof(uint32_t))
+            {
+                uint32_t now = (uint32_t)LatencyHistogram::ticks();
+                uint32_t stamp;
+                memcpy(&stamp, &item[0], sizeof(stamp));
+                latency.record(now - stamp);
+            }
             if (m_performMemcpy)
             {
                 memcpy(&m_data[count % m_dataMaxOffset], &item[0], item.size());
@@ -68,6 +68,11 @@ public:
         return iterationCount() * m_claimPerThread * (threadCount() - 1);
     }
 
+protected:
+
+    // Called before the test is run to setup the test.
+    virtual void before(void);
+
 private:
 
     // Random data used for memory copies.
@@ -82,11 +87,16 @@ private:
     // The maximum offset into the data buffer to use.
     const size_t m_dataMaxOffset;
 
+    // The number of bytes claimed for each item.
+    size_t m_claimSize;
+
     // Runs the claim/commit operation per thread.
     void threadClaimCommit(void);
 
-    // Runs the retrieve/release operation per thread.
-    void threadRetrieveRelease(void);
+    // Runs the retrieve/release operation per thread.  When latency sampling
+    // is enabled the time from each item being committed to it being
+    // retrieved is recorded into 'latency'.
+    void threadRetrieveRelease(LatencyHistogram& latency);
 
 };
 
@@ -28,6 +28,7 @@
 //------------------------------------------------------------------------------
 
 // Forward declarations.
+class AQItem;
 class IAQReader;
 class IAQWriter;
 
@@ -87,6 +88,25 @@ public:
     // Obtains a string description of the queue state.
     virtual std::string results(void) { return std::string(""); }
 
+    // Returns true if this provider places each item in consecutive pages of
+    // a single ring, as AQ does, so that the functions below describe how the
+    // ring is being used.  Providers that give each item its own page return
+    // false.
+    virtual bool hasPageRing(void) const { return false; }
+
+    // Returns the total number of pages in the ring.
+    virtual size_t ringPageCount(void) const { return 0; }
+
+    // Returns the ring page that holds the start of 'item'.
+    virtual size_t ringPage(const AQItem& item) const { (void)item; return 0; }
+
+    // Returns the number of bytes in the free pages of the ring, whether or
+    // not they are contiguous.
+    virtual size_t freeSize(void) const { return 0; }
+
+    // Returns the largest number of bytes that can be claimed as one item.
+    virtual size_t availableSize(void) const { return 0; }
+
 };
 
 
@@ -0,0 +1,199 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "LatencyHistogram.h"
+
+#include "Timer.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+using namespace aqosa;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The time in milliseconds over which the tick rate is measured.
+#define CALIBRATION_MS                  250
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Measures and returns the number of ticks per nanosecond.
+static double measureTicksPerNs(void);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const uint32_t LatencyHistogram::SUB_BUCKET_BITS;
+const size_t LatencyHistogram::SUB_BUCKET_COUNT;
+const size_t LatencyHistogram::BUCKET_COUNT;
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+LatencyHistogram::LatencyHistogram(void)
+    : m_counts(BUCKET_COUNT, 0)
+    , m_count(0)
+    , m_max(0)
+{
+}
+
+//------------------------------------------------------------------------------
+LatencyHistogram::~LatencyHistogram(void)
+{
+}
+
+//------------------------------------------------------------------------------
+static double measureTicksPerNs(void)
+{
+#ifdef LATENCY_HISTOGRAM_RDTSC
+    // The system timer is coarse so start and end the measurement on one of
+    // its ticks.
+    uint32_t edge = Timer::start();
+    while (Timer::start() == edge)
+    {
+    }
+    uint64_t startTicks = LatencyHistogram::ticks();
+    uint32_t startMs = Timer::start();
+    uint32_t ms;
+    while ((ms = Timer::elapsed(startMs)) < CALIBRATION_MS)
+    {
+    }
+    uint64_t endTicks = LatencyHistogram::ticks();
+
+    return (double)(endTicks - startTicks) / ((double)ms * 1000000.0);
+#else
+    return 1.0;
+#endif
+}
+
+//------------------------------------------------------------------------------
+double LatencyHistogram::ticksToNs(uint64_t ticks)
+{
+    static double ticksPerNs = 0.0;
+    if (ticksPerNs == 0.0)
+    {
+        ticksPerNs = measureTicksPerNs();
+    }
+    return (double)ticks / ticksPerNs;
+}
+
+//------------------------------------------------------------------------------
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    if (other.m_max > m_max)
+    {
+        m_max = other.m_max;
+    }
+}
+
+//------------------------------------------------------------------------------
+void LatencyHistogram::clear(void)
+{
+    m_counts.assign(BUCKET_COUNT, 0);
+    m_count = 0;
+    m_max = 0;
+}
+
+//------------------------------------------------------------------------------
+uint64_t LatencyHistogram::percentile(double percentile) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    // The number of latencies that must be no greater than the result.
+    uint64_t target = (uint64_t)((double)m_count * percentile / 100.0 + 0.5);
+    if (target < 1)
+    {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= target)
+        {
+            uint64_t value = bucketMax(i);
+            return value < m_max ? value : m_max;
+        }
+    }
+    return m_max;
+}
+
+//------------------------------------------------------------------------------
+std::string LatencyHistogram::summary(void) const
+{
+    ostringstream ss;
+
+    ss << fixed << setprecision(0)
+       << "p50=" << ticksToNs(percentile(50.0)) << "ns"
+       << " p99=" << ticksToNs(percentile(99.0)) << "ns"
+       << " p99.9=" << ticksToNs(percentile(99.9)) << "ns"
+       << " max=" << ticksToNs(m_max) << "ns"
+       << " (" << m_count << " samples)";
+
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+uint64_t LatencyHistogram::bucketMax(size_t idx)
+{
+    if (idx < 2 * SUB_BUCKET_COUNT)
+    {
+        return idx;
+    }
+
+    uint32_t shift = (uint32_t)(idx / SUB_BUCKET_COUNT) - 1;
+    uint64_t sub = (idx % SUB_BUCKET_COUNT) + SUB_BUCKET_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,189 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LATENCY_HISTOGRAM_RDTSC
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define LATENCY_HISTOGRAM_RDTSC
+#else
+#include <time.h>
+#endif
+
+#include <string>
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Records the distribution of operation latencies in the manner of an HDR
+// histogram: values below 2 * SUB_BUCKET_COUNT are counted exactly and each
+// power of two above that is split into SUB_BUCKET_COUNT linear buckets, so
+// every value is held to within 1 / SUB_BUCKET_COUNT of its true value using
+// a fixed amount of memory.
+//
+// Latencies are measured in ticks of the time stamp counter where the
+// processor has one (rdtsc) and in nanoseconds otherwise.  The time stamp
+// counter is assumed to be invariant and synchronised across processors, as
+// it is on all current x86 processors.
+//
+// A histogram is not thread safe; each thread records into its own and the
+// results are merged once the threads have finished.
+class LatencyHistogram
+{
+public:
+
+    // The number of bits of precision kept for each value.
+    static const uint32_t SUB_BUCKET_BITS = 5;
+
+    // The number of buckets each power of two is divided into.
+    static const size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+
+    // The total number of buckets; enough for any 64-bit value.
+    static const size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    // Constructs a new empty histogram.
+    LatencyHistogram(void);
+
+    // Destroys this histogram.
+    ~LatencyHistogram(void);
+
+    // Returns the current tick count, used to start and end a measurement.
+    static uint64_t ticks(void)
+    {
+#ifdef LATENCY_HISTOGRAM_RDTSC
+        return __rdtsc();
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+    }
+
+    // Converts a number of ticks into nanoseconds.  The tick rate is
+    // measured against the system timer the first time this is called,
+    // which takes a fraction of a second.
+    static double ticksToNs(uint64_t ticks);
+
+    // Records a single latency of 'ticks'.
+    void record(uint64_t ticks)
+    {
+        m_counts[bucket(ticks)]++;
+        m_count++;
+        if (ticks > m_max)
+        {
+            m_max = ticks;
+        }
+    }
+
+    // Adds all the latencies recorded in 'other' to this histogram.
+    void merge(const LatencyHistogram& other);
+
+    // Removes all recorded latencies.
+    void clear(void);
+
+    // Returns the number of latencies recorded.
+    uint64_t count(void) const { return m_count; }
+
+    // Returns the largest latency recorded in ticks.
+    uint64_t max(void) const { return m_max; }
+
+    // Returns the latency in ticks that 'percentile' percent of the recorded
+    // latencies do not exceed, or 0 if there are none.
+    uint64_t percentile(double percentile) const;
+
+    // Describes the p50, p99, p99.9 and maximum latencies in nanoseconds.
+    std::string summary(void) const;
+
+    // Returns the number of latencies recorded in bucket 'idx', where 'idx'
+    // is less than BUCKET_COUNT.
+    uint64_t bucketCount(size_t idx) const { return m_counts[idx]; }
+
+    // Returns the largest latency in ticks held by bucket 'idx'.
+    static uint64_t bucketMax(size_t idx);
+
+private:
+
+    // Returns the bucket that holds 'value'.
+    static size_t bucket(uint64_t value)
+    {
+        if (value < 2 * SUB_BUCKET_COUNT)
+        {
+            return (size_t)value;
+        }
+
+        uint32_t shift = highestBit(value) - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKET_COUNT + (size_t)(value >> shift) - SUB_BUCKET_COUNT;
+    }
+
+    // Returns the index of the most significant set bit in 'value', which
+    // must not be 0.
+    static uint32_t highestBit(uint64_t value)
+    {
+#ifdef __GNUC__
+        return 63 - (uint32_t)__builtin_clzll(value);
+#else
+        uint32_t bit = 0;
+        while (value > 1)
+        {
+            value >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    // The number of latencies in each bucket.
+    std::vector<uint64_t> m_counts;
+
+    // The number of latencies recorded.
+    uint64_t m_count;
+
+    // The largest latency recorded.
+    uint64_t m_max;
+
+};
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -14,18 +14,33 @@
 #include "ClaimTest.h"
 #include "ClaimCommitTest.h"
 #include "CommitTest.h"
+#ifndef _WIN32
+#include "CrossProcessTest.h"
+#endif
 #include "FullQueueTest.h"
 #include "ReleaseTest.h"
 #include "RetrieveReleaseTest.h"
 #include "RetrieveTest.h"
 #include "AQStrawManProvider.h"
 #include "AQProvider.h"
+#include "DisruptorRing.h"
+#ifndef _WIN32
+#include "FutexMutex.h"
+#endif
+#include "PerfTestReport.h"
+#include "RingProvider.h"
 #include "ThreadOverheadTest.h"
+#include "VyukovRing.h"
+#include "WorkloadTest.h"
 
 #include "Optarg.h"
+#include "PerfCounters.h"
+
+#include <stdlib.h>
 
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 
 using namespace std;
 
@@ -48,6 +63,10 @@ using namespace std;
 // Default enable option for the straw-man queue with a CriticalSection used for concurrency protection.
 #define DEFAULT_STRAW_CRITSEC           false
 
+// The default percentage that a result may be worse than the baseline before it
+// is reported as a regression.
+#define DEFAULT_REGRESSION_PERCENT      10
+
 // The widths of each column.
 #define THREAD_COUNT_WIDTH              3
 #define CONFIG_WIDTH                    24
@@ -64,6 +83,20 @@ using namespace std;
 // Private Type Definitions
 //------------------------------------------------------------------------------
 
+// A queue provider to run the tests against, with the suffix added to the
+// name of each of its tests.
+struct Provider
+{
+    // Constructs an entry for 'p' whose tests have the suffix 's'.
+    Provider(const char *s, IQueueProvider& p) : suffix(s), provider(&p) { }
+
+    // The suffix added to the test names; empty for the AQ provider.
+    std::string suffix;
+
+    // The queue provider.
+    IQueueProvider *provider;
+};
+
 
 
 
@@ -83,9 +116,16 @@ static void printTestConfig(size_t nameWidth, PerfTest& test);
 // Prints the test results.
 static void printTestResults(PerfTest& test);
 
+// Separates the tests of one configuration from the next when there is more
+// than one provider to compare.
+static void addSeparator(std::vector<PerfTest *>& tests, const std::vector<Provider>& providers);
+
 // Configures the performance test run using the passed options.
 static void configure(Optarg &cfg);
 
+// Sets the HITM event and prints the hardware counters that can be opened.
+static void configureCounters(void);
+
 
 
 
@@ -105,6 +145,25 @@ static bool StrawMutex = DEFAULT_STRAW_MUTEX;
 // If true, enable the CriticalSection-based Straw Man for performance comparison.
 static bool StrawCritSec = DEFAULT_STRAW_CRITSEC;
 
+// If true, enable the Vyukov bounded MPMC ring for performance comparison.
+static bool RefVyukov = false;
+
+// If true, enable the LMAX disruptor style ring for performance comparison.
+static bool RefDisruptor = false;
+
+// If true, enable the straw-man queue with a futex-based mutex for performance comparison.
+static bool RefFutex = false;
+
+// The item size profile for the workload test, empty to disable the test.
+static std::string WorkloadProfileSpec;
+
+// The number of items in each producer burst and the pause after each burst
+// in microseconds for the workload test.
+static std::vector<unsigned int> WorkloadBurst;
+
+// The time the workload test consumer spends on each item in nanoseconds.
+static unsigned int WorkloadThinkNs = 0;
+
 // The thread overhead test thread count, 0 to disable.
 static uint32_t ThreadOverheadThreadCount = 0;
 
@@ -117,6 +176,28 @@ static bool TestRelease = false;
 static bool TestRetrieveRelease = false;
 static bool TestFull = false;
 static bool TestFullMemcpy = false;
+static bool TestCrossProcess = false;
+
+// If true, sample the latency of each queue operation.
+static bool LatencySampling = false;
+
+// If true, count the hardware events of each test thread.
+static bool CountEvents = false;
+
+// The raw HITM event in hexadecimal, or empty to pick it from the CPU vendor.
+static std::string HitmEvent;
+
+// The file to write the JSON report to, or empty for no report.
+static std::string JsonReportPath;
+
+// The file holding the JSON report to compare against, or empty for none.
+static std::string BaselinePath;
+
+// The percentage that a result may be worse than the baseline.
+static unsigned int RegressionPercent = DEFAULT_REGRESSION_PERCENT;
+
+// The CPU affinity policy for the test threads.
+static std::string AffinityPolicy = "none";
 
 
 
@@ -162,14 +243,51 @@ static int internalMain(int argc, char *argv[])
         cout << nProcessors << " processors available";
     }
     cout << endl;
+    CpuAffinity affinity(AffinityPolicy);
+    cout << "CPU topology: " << affinity.description() << endl;
+    if (CountEvents)
+    {
+        configureCounters();
+    }
 
 
     std::vector<PerfTest *> m_tests;
 
-    // Queue providers.
+    // Queue providers; the AQ provider comes first, followed by each
+    // enabled comparison provider.
     AQProvider aqProvider(2, (1 << 20) - 1);
     AQStrawManProvider<CriticalSection> aqReferenceCS(2, (1 << 20) - 1);
     AQStrawManProvider<Mutex> aqReferenceMutex(2, (1 << 20) - 1);
+    RingProvider<VyukovRing> aqReferenceVyukov(2, (1 << 20) - 1);
+    RingProvider<DisruptorRing> aqReferenceDisruptor(2, (1 << 20) - 1);
+    AQProvider aqWorkloadProvider(6, (1 << 16) - 1);
+#ifndef _WIN32
+    AQStrawManProvider<FutexMutex> aqReferenceFutex(2, (1 << 20) - 1);
+#endif
+    std::vector<Provider> providers;
+    providers.push_back(Provider("", aqProvider));
+    if (StrawCritSec)
+    {
+        providers.push_back(Provider("[Ref-CS]", aqReferenceCS));
+    }
+    if (StrawMutex)
+    {
+        providers.push_back(Provider("[Ref-Mutex]", aqReferenceMutex));
+    }
+    if (RefVyukov)
+    {
+        providers.push_back(Provider("[Ref-Vyukov]", aqReferenceVyukov));
+    }
+    if (RefDisruptor)
+    {
+        providers.push_back(Provider("[Ref-Disruptor]", aqReferenceDisruptor));
+    }
+#ifndef _WIN32
+    if (RefFutex)
+    {
+        providers.push_back(Provider("[Ref-Futex]", aqReferenceFutex));
+    }
+#endif
 
     // Build the list of tests.
     if (ThreadOverheadThreadCount > 0)
@@ -182,128 +300,72 @@ static int internalMain(int argc, char *argv[])
     {
         for (size_t i = 0; i < ThreadCounts.size(); ++i)
         {
-            m_tests.push_back(new ClaimTest("AQ-Claim", aqProvider, ThreadCounts[i]));
-            if (StrawCritSec)
-            {
-                m_tests.push_back(new ClaimTest("AQ-Claim[Ref-CS]", aqReferenceCS, ThreadCounts[i]));
-            }
-            if (StrawMutex)
+            for (size_t j = 0; j < providers.size(); ++j)
             {
-                m_tests.push_back(new ClaimTest("AQ-Claim[Ref-Mutex]", aqReferenceMutex, ThreadCounts[i]));
-            }
-            if (StrawCritSec || StrawMutex)
-            {
-                m_tests.push_back(NULL);
+                m_tests.push_back(new ClaimTest("AQ-Claim" + providers[j].suffix, *providers[j].provider, ThreadCounts[i]));
             }
+            addSeparator(m_tests, providers);
         }
     }
     if (TestCommit)
     {
         for (size_t i = 0; i < ThreadCounts.size(); ++i)
         {
-            m_tests.push_back(new CommitTest("AQ-Commit", aqProvider, ThreadCounts[i]));
-            if (StrawCritSec)
-            {
-                m_tests.push_back(new CommitTest("AQ-Commit[Ref-CS]", aqReferenceCS, ThreadCounts[i]));
-            }
-            if (StrawMutex)
+            for (size_t j = 0; j < providers.size(); ++j)
             {
-                m_tests.push_back(new CommitTest("AQ-Commit[Ref-Mutex]", aqReferenceMutex, ThreadCounts[i]));
-            }
-            if (StrawCritSec || StrawMutex)
-            {
-                m_tests.push_back(NULL);
+                m_tests.push_back(new CommitTest("AQ-Commit" + providers[j].suffix, *providers[j].provider, ThreadCounts[i]));
             }
+            addSeparator(m_tests, providers);
         }
     }
     if (TestClaimCommit)
     {
         for (size_t i = 0; i < ThreadCounts.size(); ++i)
         {
-            m_tests.push_back(new ClaimCommitTest("AQ-ClaimCommit", aqProvider, ThreadCounts[i]));
-            if (StrawCritSec)
+            for (size_t j = 0; j < providers.size(); ++j)
             {
-                m_tests.push_back(new ClaimCommitTest("AQ-ClaimCommit[Ref-CS]", aqReferenceCS, ThreadCounts[i]));
-            }
-            if (StrawMutex)
-            {
-                m_tests.push_back(new ClaimCommitTest("AQ-ClaimCommit[Ref-Mutex]", aqReferenceMutex, ThreadCounts[i]));
-            }
-            if (StrawCritSec || StrawMutex)
-            {
-                m_tests.push_back(NULL);
+                m_tests.push_back(new ClaimCommitTest("AQ-ClaimCommit" + providers[j].suffix, *providers[j].provider, ThreadCounts[i]));
             }
+            addSeparator(m_tests, providers);
         }
     }
 
     if (TestRetrieve)
     {
-        m_tests.push_back(new RetrieveTest("AQ-Retrieve", aqProvider));
-        if (StrawCritSec)
-        {
-            m_tests.push_back(new RetrieveTest("AQ-Retrieve[Ref-CS]", aqReferenceCS));
-        }
-        if (StrawMutex)
-        {
-            m_tests.push_back(new RetrieveTest("AQ-Retrieve[Ref-Mutex]", aqReferenceMutex));
-        }
-        if (StrawCritSec || StrawMutex)
+        for (size_t j = 0; j < providers.size(); ++j)
         {
-            m_tests.push_back(NULL);
+            m_tests.push_back(new RetrieveTest("AQ-Retrieve" + providers[j].suffix, *providers[j].provider));
         }
+        addSeparator(m_tests, providers);
     }
 
     if (TestRelease)
     {
-        m_tests.push_back(new ReleaseTest("AQ-Release", aqProvider));
-        if (StrawCritSec)
+        for (size_t j = 0; j < providers.size(); ++j)
         {
-            m_tests.push_back(new ReleaseTest("AQ-Release[Ref-CS]", aqReferenceCS));
-        }
-        if (StrawMutex)
-        {
-            m_tests.push_back(new ReleaseTest("AQ-Release[Ref-Mutex]", aqReferenceMutex));
-        }
-        if (StrawCritSec || StrawMutex)
-        {
-            m_tests.push_back(NULL);
+            m_tests.push_back(new ReleaseTest("AQ-Release" + providers[j].suffix, *providers[j].provider));
         }
+        addSeparator(m_tests, providers);
     }
 
     if (TestRetrieveRelease)
     {
-        m_tests.push_back(new RetrieveReleaseTest("AQ-RetrieveRelease", aqProvider));
-        if (StrawCritSec)
-        {
-            m_tests.push_back(new RetrieveReleaseTest("AQ-RetrieveRelease[Ref-CS]", aqReferenceCS));
-        }
-        if (StrawMutex)
+        for (size_t j = 0; j < providers.size(); ++j)
         {
-            m_tests.push_back(new RetrieveReleaseTest("AQ-RetrieveRelease[Ref-Mutex]", aqReferenceMutex));
-        }
-        if (StrawCritSec || StrawMutex)
-        {
-            m_tests.push_back(NULL);
+            m_tests.push_back(new RetrieveReleaseTest("AQ-RetrieveRelease" + providers[j].suffix, *providers[j].provider));
         }
+        addSeparator(m_tests, providers);
     }
 
     if (TestFull)
     {
         for (size_t i = 0; i < ThreadCounts.size(); ++i)
         {
-            m_tests.push_back(new FullQueueTest("AQ-Full", aqProvider, ThreadCounts[i]));
-            if (StrawCritSec)
-            {
-                m_tests.push_back(new FullQueueTest("AQ-Full[Ref-CS]", aqReferenceCS, ThreadCounts[i]));
-            }
-            if (StrawMutex)
+            for (size_t j = 0; j < providers.size(); ++j)
             {
-                m_tests.push_back(new FullQueueTest("AQ-Full[Ref-Mutex]", aqReferenceMutex, ThreadCounts[i]));
-            }
-            if (StrawCritSec || StrawMutex)
-            {
-                m_tests.push_back(NULL);
+                m_tests.push_back(new FullQueueTest("AQ-Full" + providers[j].suffix, *providers[j].provider, ThreadCounts[i]));
             }
+            addSeparator(m_tests, providers);
         }
     }
 
@@ -311,22 +373,37 @@ static int internalMain(int argc, char *argv[])
     {
         for (size_t i = 0; i < ThreadCounts.size(); ++i)
         {
-            m_tests.push_back(new FullQueueTest("AQ-FullMemCpy", aqProvider, ThreadCounts[i], true));
-            if (StrawCritSec)
-            {
-                m_tests.push_back(new FullQueueTest("AQ-FullMemCpy[Ref-CS]", aqReferenceCS, ThreadCounts[i], true));
-            }
-            if (StrawMutex)
-            {
-                m_tests.push_back(new FullQueueTest("AQ-FullMemCpy[Ref-Mutex]", aqReferenceMutex, ThreadCounts[i], true));
-            }
-            if (StrawCritSec || StrawMutex)
+            for (size_t j = 0; j < providers.size(); ++j)
             {
-                m_tests.push_back(NULL);
+                m_tests.push_back(new FullQueueTest("AQ-FullMemCpy" + providers[j].suffix, *providers[j].provider, ThreadCounts[i], true));
             }
+            addSeparator(m_tests, providers);
         }
     }
 
+    // The comparison providers give each item a single fixed-size page so
+    // only AQ can hold the variable-size items of the workload test.
+    if (!WorkloadProfileSpec.empty())
+    {
+        unsigned int burstSize = WorkloadBurst.size() > 0 ? WorkloadBurst[0] : 0;
+        unsigned int burstPauseUs = WorkloadBurst.size() > 1 ? WorkloadBurst[1] : 0;
+        for (size_t i = 0; i < ThreadCounts.size(); ++i)
+        {
+            m_tests.push_back(new WorkloadTest("AQ-Workload", aqWorkloadProvider, ThreadCounts[i],
+                WorkloadProfileSpec, burstSize, burstPauseUs, WorkloadThinkNs));
+        }
+    }
+
+#ifndef _WIN32
+    if (TestCrossProcess)
+    {
+        for (size_t i = 0; i < ThreadCounts.size(); ++i)
+        {
+            m_tests.push_back(new CrossProcessTest("AQ-CrossProcess", ThreadCounts[i], 2, (1 << 20) - 1));
+        }
+    }
+#endif
+
     // Run each test, then publish its results.
     size_t nameWidth = 4;
     for (size_t i = 0; i < m_tests.size(); ++i)
@@ -334,6 +411,9 @@ static int internalMain(int argc, char *argv[])
         if (m_tests[i])
         {
             m_tests[i]->setDurationMs(TestDurationSecs * 1000);
+            m_tests[i]->setLatencySampling(LatencySampling);
+            m_tests[i]->setCounters(CountEvents);
+            m_tests[i]->setAffinity(&affinity);
             size_t width = m_tests[i]->name().size();
             if (width > nameWidth)
             {
@@ -342,6 +422,7 @@ static int internalMain(int argc, char *argv[])
         }
     }
     printTestHeader(nameWidth);
+    PerfTestReport report(nProcessors, TestDurationSecs, affinity.description());
     for (size_t i = 0; i < m_tests.size(); ++i)
     {
         if (m_tests[i] == NULL)
@@ -353,6 +434,7 @@ static int internalMain(int argc, char *argv[])
             printTestConfig(nameWidth, *m_tests[i]);
             m_tests[i]->run();
             printTestResults(*m_tests[i]);
+            report.add(*m_tests[i]);
         }
     }
 
@@ -365,9 +447,28 @@ static int internalMain(int argc, char *argv[])
     }
     m_tests.clear();
 
+    if (!JsonReportPath.empty())
+    {
+        report.write(JsonReportPath);
+    }
+    if (!BaselinePath.empty() 
+        && report.compare(BaselinePath, (double)RegressionPercent, cout) > 0)
+    {
+        return 2;
+    }
+
     return 0;
 }
 
+//------------------------------------------------------------------------------
+static void addSeparator(std::vector<PerfTest *>& tests, const std::vector<Provider>& providers)
+{
+    if (providers.size() > 1)
+    {
+        tests.push_back(NULL);
+    }
+}
+
 //------------------------------------------------------------------------------
 static void printTestHeader(size_t nameWidth)
 {
@@ -403,6 +504,47 @@ static void printTestResults(PerfTest& test)
          << right << setw(OPERATION_COUNT_WIDTH) << test.totalOperationCount() << setw(1) << "|"
          << right << setw(OPERATIONS_PER_SEC_WIDTH) << fixed << setprecision(0) << opsPerSec << setw(1) << "|"
          << left << setw(RESULTS_WIDTH) << test.results() << setw(1) << "|" << endl;
+
+    if (test.hasLatency())
+    {
+        cout << "|  latency: " << test.latency().summary() << endl;
+    }
+    if (test.usage() != NULL)
+    {
+        cout << "|  usage: " << test.usage()->summary() << endl;
+    }
+    PerfCounters counters = test.counters();
+    if (counters.hasTotals())
+    {
+        cout << "|  counters: " << counters.summary(test.totalOperationCount()) << endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+static void configureCounters(void)
+{
+    if (!HitmEvent.empty())
+    {
+        char *end;
+        uint64_t event = strtoull(HitmEvent.c_str(), &end, 16);
+        if (*end != '\0')
+        {
+            throw invalid_argument("Invalid HITM event '" + HitmEvent + "'");
+        }
+        PerfCounters::setHitmEvent(event);
+    }
+
+    PerfCounters probe;
+    probe.open();
+    cout << "Hardware counters:";
+    for (int i = 0; i < PerfCounters::COUNTER_COUNT; ++i)
+    {
+        if (probe.isOpen((PerfCounters::Counter)i))
+        {
+            cout << " " << PerfCounters::name((PerfCounters::Counter)i);
+        }
+    }
+    cout << endl;
 }
 
 //------------------------------------------------------------------------------
@@ -412,6 +554,11 @@ static void configure(Optarg &cfg)
     cfg.opt('t', ThreadCounts, "A comma-separated list of thread counts; that is the number of concurrent producers threads to use for each test case.  Test cases are run separatly for each entry in the list.");
     cfg.opt('c', StrawCritSec, "Enables a straw-man comparison queue that uses critical sections for concurrency protection.");
     cfg.opt('m', StrawMutex, "Enables a straw-man comparison queue that uses mutexes for concurrency protection.");
+    cfg.opt('v', RefVyukov, "Enables a comparison queue built from two Vyukov bounded multi-producer / multi-consumer rings, one of free pages and one of committed pages.");
+    cfg.opt('l', RefDisruptor, "Enables a comparison queue in the style of the LMAX disruptor, with producers claiming slots of a ring by sequence number and the consumer reading them in sequence order.");
+#ifndef _WIN32
+    cfg.opt('f', RefFutex, "Enables a straw-man comparison queue that uses a mutex built directly on the futex system call for concurrency protection.");
+#endif
     cfg.opt('T', ThreadOverheadThreadCount, "Enables the thread overhead test with a configured number of threads or 0 to disable the test.");
 
     cfg.opt('A', TestClaim, "Enables the AQWriter::claim() test.");
@@ -422,6 +569,19 @@ static void configure(Optarg &cfg)
     cfg.opt('R', TestRetrieveRelease, "Enables the AQReader::retrieve() followed by AQReader::release() combination test.");
     cfg.opt('F', TestFull, "Enables the full multi-producer / single consumer queue test.");
     cfg.opt('M', TestFullMemcpy, "Enables the full multi-producer / single consumer queue test with additional memcpy() over all data regions.");
+    cfg.opt('W', WorkloadProfileSpec, "Enables the workload test, where the producers write items with sizes from a profile: 'fixed:<bytes>', 'lognormal:<median>,<sigma>', 'bimodal:<small>,<large>,<percent large>' or 'trace:<file of sizes>'.  The use of the queue memory is sampled as the test runs.");
+    cfg.opt('B', WorkloadBurst, "The burstiness of the workload test producers as '<items>,<pause us>'; each producer pauses for the given number of microseconds after writing the given number of items.");
+    cfg.opt('K', WorkloadThinkNs, "The time in nanoseconds that the workload test consumer spends on each item before releasing it.");
+#ifndef _WIN32
+    cfg.opt('P', TestCrossProcess, "Enables the multi-producer / single consumer queue test with each producer in a separate process writing to a queue in POSIX shared memory.");
+#endif
+    cfg.opt('j', JsonReportPath, "Writes the configuration and results of every test, including the latency histograms, as JSON to the named file.");
+    cfg.opt('b', BaselinePath, "Compares the results against the JSON report in the named file, written by an earlier run with -j, and exits with status 2 if any test regressed.");
+    cfg.opt('r', RegressionPercent, "The percentage that the operations per second may fall, or the p99 latency rise, compared to the baseline before a test is reported as a regression.");
+    cfg.opt('a', AffinityPolicy, "The CPU affinity policy for the test threads: 'none', 'compact' (one thread per core, filling each socket in turn), 'scatter' (one thread per core, alternating sockets), 'smt' (pairs threads on the SMT siblings of each core) or a comma-separated list of CPUs.  Producers take CPUs in order and the consumer takes the next.");
+    cfg.opt('e', CountEvents, "Counts the cycles, instructions, last level cache misses, branch misses and HITM loads (loads of a cache line modified by another core) of every test thread with the hardware performance counters, and reports them per operation.  Only the counters the kernel and CPU provide are reported.");
+    cfg.opt('x', HitmEvent, "The raw hardware event, in hexadecimal, counted as HITM loads with -e.  By default 0x04d2 is used on Intel CPUs and HITM is not counted on others.");
+    cfg.opt('H', LatencySampling, "Samples the latency of every claim(), commit(), retrieve() and release() operation, and the commit() to retrieve() latency in the full queue tests, and reports the p50/p99/p99.9/max latencies of each test.");
 
     if (cfg.hasOpt('h', "Show the command line option help."))
     {
@@ -65,6 +65,9 @@ PerfTest::PerfTest(const std::string& name, uint32_t minDurationMs)
     , m_lastThreadExitMs(0)
     , m_iterationCount(0)
     , m_totalDurationMs(0)
+    , m_latencySampling(false)
+    , m_affinity(NULL)
+    , m_countersEnabled(false)
 {
 }
 
@@ -75,6 +78,14 @@ PerfTest::~PerfTest(void)
     {
         delete m_threads[i];
     }
+    for (size_t i = 0; i < m_latency.size(); ++i)
+    {
+        delete m_latency[i];
+    }
+    for (size_t i = 0; i < m_counters.size(); ++i)
+    {
+        delete m_counters[i];
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -83,11 +94,25 @@ void PerfTest::addExecutor(Thread *executor)
     m_threads.push_back(new PerfThread(*this, executor, m_threads.size()));
 }
 
+//------------------------------------------------------------------------------
+LatencyHistogram& PerfTest::addLatencyHistogram(void)
+{
+    m_latency.push_back(new LatencyHistogram());
+    return *m_latency.back();
+}
+
 //------------------------------------------------------------------------------
 void PerfTest::runThread(size_t threadNum)
 {
     PerfThread *thread = m_threads[threadNum];
 
+    // The counters must be opened by the thread they count.
+    PerfCounters *counters = m_countersEnabled ? m_counters[threadNum] : NULL;
+    if (counters != NULL)
+    {
+        counters->open();
+    }
+
     for (;;)
     {
         thread->finishEvent().set();
@@ -103,7 +128,15 @@ void PerfTest::runThread(size_t threadNum)
         }
         m_lock.unlock();
 
+        if (counters != NULL)
+        {
+            counters->start();
+        }
         thread->exector()->execute();
+        if (counters != NULL)
+        {
+            counters->stop();
+        }
 
         m_lock.lock();
         m_lastThreadExitMs = Timer::start();
@@ -115,12 +148,29 @@ void PerfTest::runThread(size_t threadNum)
 //------------------------------------------------------------------------------
 void PerfTest::run(void)
 {
+    for (size_t i = 0; i < m_latency.size(); ++i)
+    {
+        m_latency[i]->clear();
+    }
+    if (m_countersEnabled)
+    {
+        while (m_counters.size() < m_threads.size())
+        {
+            m_counters.push_back(new PerfCounters());
+        }
+        for (size_t i = 0; i < m_counters.size(); ++i)
+        {
+            m_counters[i]->clear();
+        }
+    }
+
     before();
 
     // Start all threads and wait for them to be ready to run.
     for (size_t i = 0; i < m_threads.size(); ++i)
     {
         m_threads[i]->finishEvent().reset();
+        m_threads[i]->setAffinity(threadAffinityCpu(i));
         m_threads[i]->start();
     }
     m_iterationCount = 0;
@@ -170,10 +220,49 @@ void PerfTest::run(void)
             abort();
         }
     }
+    for (size_t i = 0; i < m_counters.size(); ++i)
+    {
+        m_counters[i]->close();
+    }
 
     after();
 }
 
+//------------------------------------------------------------------------------
+bool PerfTest::hasLatency(void) const
+{
+    for (size_t i = 0; i < m_latency.size(); ++i)
+    {
+        if (m_latency[i]->count() > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+LatencyHistogram PerfTest::latency(void) const
+{
+    LatencyHistogram merged;
+    for (size_t i = 0; i < m_latency.size(); ++i)
+    {
+        merged.merge(*m_latency[i]);
+    }
+    return merged;
+}
+
+//------------------------------------------------------------------------------
+PerfCounters PerfTest::counters(void) const
+{
+    PerfCounters total;
+    for (size_t i = 0; i < m_counters.size(); ++i)
+    {
+        total.add(*m_counters[i]);
+    }
+    return total;
+}
+
 //------------------------------------------------------------------------------
 string PerfTest::config(void) const
 {
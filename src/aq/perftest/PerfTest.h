@@ -11,11 +11,15 @@
 // Includes
 //------------------------------------------------------------------------------
 
+#include "CpuAffinity.h"
 #include "Event.h"
+#include "PerfCounters.h"
 #include "WorkerThread.h"
 
 #include "Timer.h"
 
+#include "LatencyHistogram.h"
+
 #include <string>
 #include <vector>
 
@@ -36,6 +40,9 @@
 // Exported Type Definitions
 //------------------------------------------------------------------------------
 
+// Forward declarations.
+class QueueUsage;
+
 
 
 
@@ -119,6 +126,26 @@ private:
         U& m_arg;
     };
 
+    // Encapsulates a callback used to run a particular thread with 2 arguments.
+    template<typename T, typename U, typename V> class Thread2 : public Thread
+    {
+    public:
+        // Constructs this Thread with a callback and two arguments.
+        Thread2(T *obj, void (T::*func)(U&, V&), U& arg1, V& arg2) : m_obj(obj), m_func(func), m_arg1(arg1), m_arg2(arg2) { };
+    private:
+        // No copy or assignment permitted.
+        Thread2<T,U,V>(const Thread2<T,U,V>& other);
+        Thread2<T,U,V>& operator=(const Thread2<T,U,V>& other);
+    public:
+        virtual ~Thread2(void) { };
+        virtual void execute(void) { ((*m_obj).*(m_func))(m_arg1, m_arg2); }
+    private:
+        T *m_obj;
+        void (T::*m_func)(U&, V&);
+        U& m_arg1;
+        V& m_arg2;
+    };
+
     // The thread that runs the performance tests.
     class PerfThread : public WorkerThread
     {
@@ -195,6 +222,17 @@ protected:
         addExecutor(new Thread1<X, Y>((X *)this, func, arg)); 
     };
 
+    // Adds a function called in a thread with two arguments.
+    template<typename X, typename Y, typename Z> void addThread(void (X::*func)(Y& arg1, Z& arg2), Y& arg1, Z& arg2) 
+    { 
+        addExecutor(new Thread2<X, Y, Z>((X *)this, func, arg1, arg2)); 
+    };
+
+    // Adds a latency histogram that a thread records its operation latencies
+    // into when latency sampling is enabled.  The histogram is owned by this
+    // test and is cleared each time the test is run.
+    LatencyHistogram& addLatencyHistogram(void);
+
 private:
 
     // The name of this test.
@@ -225,6 +263,21 @@ private:
     // The total duration from all iterations.
     uint32_t m_totalDurationMs;
 
+    // Set to true if the threads sample the latency of each operation.
+    bool m_latencySampling;
+
+    // The latency histograms recorded by the threads.
+    std::vector<LatencyHistogram *> m_latency;
+
+    // The placement of the threads on CPUs, or NULL if they are not pinned.
+    const CpuAffinity *m_affinity;
+
+    // Set to true if the threads count hardware events.
+    bool m_countersEnabled;
+
+    // The hardware events counted by each thread.
+    std::vector<PerfCounters *> m_counters;
+
     // Called in the thread 'threadNum' to run the test for that thread.
     void runThread(size_t threadNum);
 
@@ -233,6 +286,20 @@ public:
     // Sets the test duration in milliseconds.
     void setDurationMs(uint32_t ms) { m_minDurationMs = ms; }
 
+    // Sets whether the latency of each operation is sampled.  Sampling adds
+    // the cost of reading the time stamp counter to every operation so the
+    // throughput figures are lower when it is enabled.
+    void setLatencySampling(bool sample) { m_latencySampling = sample; }
+
+    // Sets whether each thread counts hardware events over each iteration.
+    void setCounters(bool enable) { m_countersEnabled = enable; }
+
+    // Sets the placement of this test's threads on CPUs; thread 'i', in the
+    // order the threads were added, is pinned to 'affinity->cpu(i)'.  Pass
+    // NULL to leave the placement to the scheduler.  The affinity must
+    // outlive this test.
+    void setAffinity(const CpuAffinity *affinity) { m_affinity = affinity; }
+
     // Runs this test.
     void run(void);
 
@@ -247,13 +314,21 @@ protected:
     // Called after the test is run to clean-up the test in the sub-class.
     virtual void after(void) { }
 
+    // Returns the CPU for the 'index'th thread or process of this test, or -1
+    // if it is not to be pinned.
+    int affinityCpu(size_t index) const { return m_affinity == NULL ? -1 : m_affinity->cpu(index); }
+
+    // Returns the CPU that thread 'threadNum' is pinned to, or -1 if it is not
+    // to be pinned.  Override if the threads are not the first to be placed.
+    virtual int threadAffinityCpu(size_t threadNum) const { return affinityCpu(threadNum); }
+
 public:
 
     // Gets the name of this performance test.
     const std::string& name(void) const { return m_name; }
 
     // Gets the thread count for this test.
-    size_t threadCount(void) const { return m_threads.size(); }
+    virtual size_t threadCount(void) const { return m_threads.size(); }
 
     // Gets the number of iterations performed for this test.
     unsigned long iterationCount(void) const { return m_iterationCount; }
@@ -264,6 +339,22 @@ public:
     // Gets the total duration of all runs in this test.
     uint32_t totalDurationMs(void) const { return m_totalDurationMs; }
 
+    // Returns true if the latency of each operation is sampled.
+    bool latencySampling(void) const { return m_latencySampling; }
+
+    // Returns true if this test recorded any operation latencies.
+    bool hasLatency(void) const;
+
+    // Gets the operation latencies recorded by all threads in this test.
+    LatencyHistogram latency(void) const;
+
+    // Gets the hardware events counted by all threads in this test.
+    PerfCounters counters(void) const;
+
+    // Gets the use of the queue memory sampled while this test ran, or NULL
+    // if this test does not sample it.
+    virtual const QueueUsage *usage(void) const { return NULL; }
+
     // Gets a description of the configuration of this test.
     virtual std::string config(void) const;
 
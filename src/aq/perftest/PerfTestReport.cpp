@@ -0,0 +1,309 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PerfTestReport.h"
+
+#include "LatencyHistogram.h"
+#include "PerfTest.h"
+#include "QueueUsage.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The version of the report document layout.
+#define REPORT_VERSION                  1
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Returns 'ticks' in whole nanoseconds.
+static Json::UInt64 toNs(uint64_t ticks);
+
+// Returns the percentage change from 'base' to 'value'.
+static double percentChange(double base, double value);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+PerfTestReport::PerfTestReport(int processorCount, uint32_t durationSecs,
+    const std::string& topology)
+    : m_root(Json::objectValue)
+{
+    m_root["version"] = REPORT_VERSION;
+    m_root["processors"] = processorCount;
+    m_root["topology"] = topology;
+    m_root["durationSecs"] = durationSecs;
+    m_root["tests"] = Json::Value(Json::arrayValue);
+}
+
+//------------------------------------------------------------------------------
+PerfTestReport::~PerfTestReport(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void PerfTestReport::add(const PerfTest& test)
+{
+    double ms = (double)test.totalDurationMs();
+
+    Json::Value t(Json::objectValue);
+    t["name"] = test.name();
+    t["threads"] = (Json::UInt64)test.threadCount();
+    t["config"] = test.config();
+    t["iterations"] = (Json::UInt64)test.iterationCount();
+    t["durationMs"] = test.totalDurationMs();
+    t["operations"] = (Json::UInt64)test.totalOperationCount();
+    t["opsPerSec"] = ms > 0.0 ? (double)test.totalOperationCount() / (ms / 1000.0) : 0.0;
+    t["results"] = test.results();
+
+    if (test.hasLatency())
+    {
+        LatencyHistogram latency = test.latency();
+
+        Json::Value l(Json::objectValue);
+        l["samples"] = (Json::UInt64)latency.count();
+        l["p50Ns"] = toNs(latency.percentile(50.0));
+        l["p99Ns"] = toNs(latency.percentile(99.0));
+        l["p999Ns"] = toNs(latency.percentile(99.9));
+        l["maxNs"] = toNs(latency.max());
+
+        // Each non-empty bucket as the largest latency it holds and its count.
+        Json::Value buckets(Json::arrayValue);
+        for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+        {
+            if (latency.bucketCount(i) > 0)
+            {
+                Json::Value bucket(Json::arrayValue);
+                bucket.append(toNs(LatencyHistogram::bucketMax(i)));
+                bucket.append((Json::UInt64)latency.bucketCount(i));
+                buckets.append(bucket);
+            }
+        }
+        l["histogram"] = buckets;
+
+        t["latency"] = l;
+    }
+
+    const QueueUsage *usage = test.usage();
+    if (usage != NULL)
+    {
+        Json::Value u(Json::objectValue);
+        u["itemBytes"] = (Json::UInt64)usage->itemBytes();
+        u["roundingWastePercent"] = usage->roundingWastePercent();
+        u["skipWastePercent"] = usage->skipWastePercent();
+
+        // Each sample as its time, the items and bytes in flight, and the
+        // free and claimable bytes.
+        Json::Value samples(Json::arrayValue);
+        for (size_t i = 0; i < usage->samples().size(); ++i)
+        {
+            const QueueUsage::Sample& s = usage->samples()[i];
+            Json::Value sample(Json::arrayValue);
+            sample.append(s.timeMs);
+            sample.append((Json::UInt64)s.items);
+            sample.append((Json::UInt64)s.bytes);
+            sample.append((Json::UInt64)s.freeBytes);
+            sample.append((Json::UInt64)s.availableBytes);
+            samples.append(sample);
+        }
+        u["samples"] = samples;
+
+        t["usage"] = u;
+    }
+
+    PerfCounters counters = test.counters();
+    if (counters.hasTotals())
+    {
+        // Each counted event as its total and its count per operation.
+        double n = test.totalOperationCount() > 0 ? (double)test.totalOperationCount() : 1.0;
+        Json::Value c(Json::objectValue);
+        for (int i = 0; i < PerfCounters::COUNTER_COUNT; ++i)
+        {
+            PerfCounters::Counter counter = (PerfCounters::Counter)i;
+            if (counters.hasTotal(counter))
+            {
+                Json::Value event(Json::objectValue);
+                event["total"] = (Json::UInt64)counters.total(counter);
+                event["perOp"] = (double)counters.total(counter) / n;
+                c[PerfCounters::name(counter)] = event;
+            }
+        }
+        t["counters"] = c;
+    }
+
+    m_root["tests"].append(t);
+}
+
+//------------------------------------------------------------------------------
+void PerfTestReport::write(const std::string& path) const
+{
+    ofstream out(path.c_str());
+    if (!out)
+    {
+        throw runtime_error("Cannot open '" + path + "' to write the performance test report");
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    out << Json::writeString(builder, m_root) << endl;
+    if (!out)
+    {
+        throw runtime_error("Cannot write the performance test report to '" + path + "'");
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t PerfTestReport::compare(const std::string& path, double thresholdPercent,
+    std::ostream& os) const
+{
+    ifstream in(path.c_str());
+    if (!in)
+    {
+        throw runtime_error("Cannot open the baseline report '" + path + "'");
+    }
+
+    Json::CharReaderBuilder builder;
+    Json::Value baseline;
+    string errors;
+    if (!Json::parseFromStream(builder, in, &baseline, &errors))
+    {
+        throw runtime_error("Cannot parse the baseline report '" + path + "': " + errors);
+    }
+    if (!baseline.isObject() || !baseline["tests"].isArray())
+    {
+        throw runtime_error("The baseline report '" + path + "' does not contain any tests");
+    }
+
+    const Json::Value& baseTests = baseline["tests"];
+    const Json::Value& tests = m_root["tests"];
+    size_t regressions = 0;
+
+    os << endl << "Comparison with baseline '" << path << "' (threshold "
+       << fixed << setprecision(1) << thresholdPercent << "%):" << endl;
+    for (Json::ArrayIndex i = 0; i < tests.size(); ++i)
+    {
+        const Json::Value& test = tests[i];
+        string testKey = key(test);
+
+        const Json::Value *base = NULL;
+        for (Json::ArrayIndex j = 0; j < baseTests.size() && base == NULL; ++j)
+        {
+            if (key(baseTests[j]) == testKey)
+            {
+                base = &baseTests[j];
+            }
+        }
+        if (base == NULL)
+        {
+            os << "  " << testKey << ": not in baseline" << endl;
+            continue;
+        }
+
+        bool regressed = false;
+        double baseOps = (*base)["opsPerSec"].asDouble();
+        double ops = test["opsPerSec"].asDouble();
+        double opsChange = percentChange(baseOps, ops);
+        if (opsChange < -thresholdPercent)
+        {
+            regressed = true;
+        }
+        os << "  " << testKey << ": ops/sec " << setprecision(0) << baseOps
+           << " -> " << ops << " (" << showpos << setprecision(1) << opsChange
+           << noshowpos << "%)";
+
+        if (test.isMember("latency") && base->isMember("latency"))
+        {
+            double baseP99 = (*base)["latency"]["p99Ns"].asDouble();
+            double p99 = test["latency"]["p99Ns"].asDouble();
+            double p99Change = percentChange(baseP99, p99);
+            if (p99Change > thresholdPercent)
+            {
+                regressed = true;
+            }
+            os << ", p99 " << setprecision(0) << baseP99 << "ns -> " << p99
+               << "ns (" << showpos << setprecision(1) << p99Change
+               << noshowpos << "%)";
+        }
+
+        if (regressed)
+        {
+            os << " REGRESSION";
+            regressions++;
+        }
+        os << endl;
+    }
+    os << regressions << " regression(s) found" << endl;
+
+    return regressions;
+}
+
+//------------------------------------------------------------------------------
+std::string PerfTestReport::key(const Json::Value& test)
+{
+    ostringstream ss;
+    ss << test["name"].asString() << "/" << test["threads"].asUInt64();
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+static Json::UInt64 toNs(uint64_t ticks)
+{
+    return (Json::UInt64)(LatencyHistogram::ticksToNs(ticks) + 0.5);
+}
+
+//------------------------------------------------------------------------------
+static double percentChange(double base, double value)
+{
+    if (base <= 0.0)
+    {
+        return 0.0;
+    }
+    return (value - base) * 100.0 / base;
+}
+
+
+
+
+//=============================== End of File ==================================
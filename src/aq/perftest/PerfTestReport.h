@@ -0,0 +1,107 @@
+#ifndef PERFTESTREPORT_H
+#define PERFTESTREPORT_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "json/json.h"
+
+#include <stdint.h>
+
+#include <ostream>
+#include <string>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class PerfTest;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Collects the configuration and results of a set of performance tests in a
+// machine-readable JSON document.  The document can be written to a file and
+// compared against one written by an earlier run to find regressions.
+//
+// Each test is identified by its name and thread count; the document holds
+// its throughput, its results and, where latency was sampled, the percentile
+// latencies and the non-empty buckets of its latency histogram and, where the
+// use of the queue memory was sampled, the wasted space and the samples.
+class PerfTestReport
+{
+public:
+
+    // Constructs a new empty report for a run on 'processorCount' processors
+    // with each test lasting at least 'durationSecs' seconds and its threads
+    // placed as described by 'topology'.
+    PerfTestReport(int processorCount, uint32_t durationSecs,
+        const std::string& topology);
+
+private:
+    // No copy or assignment permitted.
+    PerfTestReport(const PerfTestReport& other);
+    PerfTestReport& operator=(const PerfTestReport& other);
+public:
+
+    // Destroys this report.
+    ~PerfTestReport(void);
+
+    // Adds the configuration and results of 'test', which must have been run.
+    void add(const PerfTest& test);
+
+    // Writes this report to the file at 'path'.  Throws a runtime_error if
+    // the file cannot be written.
+    void write(const std::string& path) const;
+
+    // Compares this report against the baseline report in the file at 'path',
+    // describing each test found in both to 'os'.  A test has regressed if its
+    // operations per second fell, or its p99 latency rose, by more than
+    // 'thresholdPercent' percent.  Returns the number of regressed tests.
+    // Throws a runtime_error if the baseline cannot be read.
+    size_t compare(const std::string& path, double thresholdPercent,
+        std::ostream& os) const;
+
+private:
+
+    // The report document.
+    Json::Value m_root;
+
+    // Returns the key used to match 'test' with the same test in a baseline.
+    static std::string key(const Json::Value& test);
+
+};
+
+
+
+#endif
+//=============================== End of File ==================================
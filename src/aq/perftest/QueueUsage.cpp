@@ -0,0 +1,143 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "QueueUsage.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+QueueUsage::QueueUsage(void)
+    : m_itemBytes(0)
+    , m_pageBytes(0)
+    , m_skipBytes(0)
+{
+}
+
+//------------------------------------------------------------------------------
+QueueUsage::~QueueUsage(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void QueueUsage::clear(void)
+{
+    m_samples.clear();
+    m_itemBytes = 0;
+    m_pageBytes = 0;
+    m_skipBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+double QueueUsage::roundingWastePercent(void) const
+{
+    uint64_t used = m_pageBytes + m_skipBytes;
+    return used == 0 ? 0.0 : 100.0 * (double)(m_pageBytes - m_itemBytes) / (double)used;
+}
+
+//------------------------------------------------------------------------------
+double QueueUsage::skipWastePercent(void) const
+{
+    uint64_t used = m_pageBytes + m_skipBytes;
+    return used == 0 ? 0.0 : 100.0 * (double)m_skipBytes / (double)used;
+}
+
+//------------------------------------------------------------------------------
+double QueueUsage::fragmentationPercent(const Sample& sample)
+{
+    if (sample.freeBytes == 0 || sample.availableBytes >= sample.freeBytes)
+    {
+        return 0.0;
+    }
+    return 100.0 * (double)(sample.freeBytes - sample.availableBytes) / (double)sample.freeBytes;
+}
+
+//------------------------------------------------------------------------------
+std::string QueueUsage::summary(void) const
+{
+    uint64_t bytesMax = 0;
+    double bytesTotal = 0.0;
+    uint64_t availableMin = 0;
+    double fragTotal = 0.0;
+    double fragMax = 0.0;
+    for (size_t i = 0; i < m_samples.size(); ++i)
+    {
+        const Sample& s = m_samples[i];
+        if (s.bytes > bytesMax)
+        {
+            bytesMax = s.bytes;
+        }
+        bytesTotal += (double)s.bytes;
+        if (i == 0 || s.availableBytes < availableMin)
+        {
+            availableMin = s.availableBytes;
+        }
+        double frag = fragmentationPercent(s);
+        fragTotal += frag;
+        if (frag > fragMax)
+        {
+            fragMax = frag;
+        }
+    }
+    double n = m_samples.empty() ? 1.0 : (double)m_samples.size();
+
+    ostringstream ss;
+    ss << fixed << setprecision(0)
+       << "in-flight avg=" << bytesTotal / n << "B max=" << bytesMax << "B"
+       << " available min=" << availableMin << "B"
+       << setprecision(1)
+       << " frag avg=" << fragTotal / n << "% max=" << fragMax << "%"
+       << " waste round=" << roundingWastePercent() << "% skip=" << skipWastePercent() << "%"
+       << " (" << m_samples.size() << " samples)";
+    return ss.str();
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,138 @@
+#ifndef QUEUEUSAGE_H
+#define QUEUEUSAGE_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Records how the memory of a queue was used over the run of a test: the
+// items and bytes in flight, the free and largest claimable space sampled at
+// regular intervals, and the bytes lost to rounding items up to whole pages
+// and to skipping the pages at the end of the ring when an item does not fit
+// before the wrap.
+class QueueUsage
+{
+public:
+
+    // The state of the queue at one instant.
+    struct Sample
+    {
+        // The time of the sample, in milliseconds since the test started.
+        double timeMs;
+
+        // The number of items claimed but not yet retrieved.
+        uint64_t items;
+
+        // The number of bytes claimed in those items.
+        uint64_t bytes;
+
+        // The number of bytes in the free pages of the queue.
+        uint64_t freeBytes;
+
+        // The largest number of bytes that could be claimed as one item.
+        uint64_t availableBytes;
+    };
+
+    // Constructs a new empty record.
+    QueueUsage(void);
+
+    // Destroys this record.
+    ~QueueUsage(void);
+
+    // Records 'sample'.
+    void record(const Sample& sample) { m_samples.push_back(sample); }
+
+    // Records a retrieved item of 'bytes' bytes that took 'pageBytes' bytes
+    // of whole pages, and was preceded by 'skipBytes' bytes of skipped pages.
+    void recordItem(uint64_t bytes, uint64_t pageBytes, uint64_t skipBytes)
+    {
+        m_itemBytes += bytes;
+        m_pageBytes += pageBytes;
+        m_skipBytes += skipBytes;
+    }
+
+    // Removes everything recorded.
+    void clear(void);
+
+    // Returns the samples in the order they were recorded.
+    const std::vector<Sample>& samples(void) const { return m_samples; }
+
+    // Returns the total number of bytes in the retrieved items.
+    uint64_t itemBytes(void) const { return m_itemBytes; }
+
+    // Returns the percentage of the queue memory used by the retrieved items
+    // that was lost to rounding them up to whole pages.
+    double roundingWastePercent(void) const;
+
+    // Returns the percentage of the queue memory used by the retrieved items
+    // that was lost to skipped pages.
+    double skipWastePercent(void) const;
+
+    // Returns the fragmentation of the free space in 'sample' as the
+    // percentage of the free bytes that could not be claimed as one item.
+    static double fragmentationPercent(const Sample& sample);
+
+    // Describes the bytes in flight, the claimable space, the fragmentation
+    // and the wasted space.
+    std::string summary(void) const;
+
+private:
+
+    // The samples.
+    std::vector<Sample> m_samples;
+
+    // The total number of bytes in the retrieved items.
+    uint64_t m_itemBytes;
+
+    // The total number of bytes in the pages of the retrieved items.
+    uint64_t m_pageBytes;
+
+    // The total number of bytes in skipped pages.
+    uint64_t m_skipBytes;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
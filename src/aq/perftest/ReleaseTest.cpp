@@ -59,7 +59,7 @@ ReleaseTest::ReleaseTest(const std::string& name, IQueueProvider& queueProvider)
     : QueueTest(name, queueProvider)
 {
     m_items.resize(queueProvider.usablePageCount());
-    addThread<ReleaseTest>(&ReleaseTest::threadRelease);
+    addThread<ReleaseTest, LatencyHistogram>(&ReleaseTest::threadRelease, addLatencyHistogram());
 }
 
 //------------------------------------------------------------------------------
@@ -85,12 +85,24 @@ void ReleaseTest::beforeIteration(void)
 }
 
 //------------------------------------------------------------------------------
-void ReleaseTest::threadRelease(void)
+void ReleaseTest::threadRelease(LatencyHistogram& latency)
 {
     IAQReader& reader = queueProvider().reader();
-    for (size_t i = 0; i < m_items.size(); ++i)
+    if (latencySampling())
+    {
+        for (size_t i = 0; i < m_items.size(); ++i)
+        {
+            uint64_t start = LatencyHistogram::ticks();
+            reader.release(m_items[i]);
+            latency.record(LatencyHistogram::ticks() - start);
+        }
+    }
+    else
     {
-        reader.release(m_items[i]);
+        for (size_t i = 0; i < m_items.size(); ++i)
+        {
+            reader.release(m_items[i]);
+        }
     }
 }
 
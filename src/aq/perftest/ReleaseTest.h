@@ -77,8 +77,9 @@ private:
     // The items to release.
     std::vector<AQItem> m_items;
 
-    // Runs the retrieve test.
-    void threadRelease(void);
+    // Runs the release test, recording the latency of each release into
+    // 'latency' when sampling is enabled.
+    void threadRelease(LatencyHistogram& latency);
 
 };
 
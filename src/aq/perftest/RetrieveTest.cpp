@@ -59,7 +59,7 @@ RetrieveTest::RetrieveTest(const std::string& name, IQueueProvider& queueProvide
     : QueueTest(name, queueProvider)
     , m_retrieveCount(queueProvider.usablePageCount())
 {
-    addThread<RetrieveTest>(&RetrieveTest::threadRetrieve);
+    addThread<RetrieveTest, LatencyHistogram>(&RetrieveTest::threadRetrieve, addLatencyHistogram());
 }
 
 //------------------------------------------------------------------------------
@@ -82,13 +82,25 @@ void RetrieveTest::beforeIteration(void)
 }
 
 //------------------------------------------------------------------------------
-void RetrieveTest::threadRetrieve(void)
+void RetrieveTest::threadRetrieve(LatencyHistogram& latency)
 {
     AQItem item;
     IAQReader& reader = queueProvider().reader();
-    for (size_t i = 0; i < m_retrieveCount; ++i)
+    if (latencySampling())
+    {
+        for (size_t i = 0; i < m_retrieveCount; ++i)
+        {
+            uint64_t start = LatencyHistogram::ticks();
+            reader.retrieve(item);
+            latency.record(LatencyHistogram::ticks() - start);
+        }
+    }
+    else
     {
-        reader.retrieve(item);
+        for (size_t i = 0; i < m_retrieveCount; ++i)
+        {
+            reader.retrieve(item);
+        }
     }
 }
 
@@ -77,8 +77,9 @@ private:
     // The number of retrieve operations to perform.
     const size_t m_retrieveCount;
 
-    // Runs the retrieve test.
-    void threadRetrieve(void);
+    // Runs the retrieve test, recording the latency of each retrieve into
+    // 'latency' when sampling is enabled.
+    void threadRetrieve(LatencyHistogram& latency);
 
 };
 
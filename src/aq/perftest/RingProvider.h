@@ -0,0 +1,123 @@
+#ifndef RINGPROVIDER_H
+#define RINGPROVIDER_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "IQueueProvider.h"
+
+#include "IAQReader.h"
+#include "IAQWriter.h"
+
+
+#include <sstream>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Defines a queue provider for one of the lock-free reference rings,
+// VyukovRing or DisruptorRing.
+template <typename TRing> class RingProvider : public IQueueProvider
+{
+public:
+
+    // Creates a ring provider with each page being 1 << 'pageSizeShift'
+    // bytes in size with at least 'pageCount' pages available.
+    RingProvider(int pageSizeShift, size_t pageCount)
+        : m_ring(pageSizeShift, pageCount)
+        , m_reader(m_ring)
+        , m_writer(m_ring)
+    {
+    }
+
+    // Destructor for the queue provider.
+    virtual ~RingProvider(void) { }
+
+    // Returns the one reader object for the queue.
+    virtual IAQReader& reader(void) { return m_reader; }
+
+    // Returns the one writer object for the queue.
+    virtual IAQWriter& writer(void) { return m_writer; }
+
+    // Returns the number of pages that can be used at the same time from this provider.
+    virtual size_t usablePageCount(void) const { return m_ring.pageCount(); }
+
+    // Returns the size of each page in this provider.
+    virtual size_t pageSize(void) const { return m_ring.pageSize(); }
+
+    // Called before the test is run to setup the test data, format the queues, and
+    // so forth.
+    virtual void before(void) { }
+
+    // Called before each iteration of the test.  This must reset the queue to its
+    // empty state.
+    virtual void beforeIteration(void) { m_ring.reset(); }
+
+    // Obtains a string description of this configuration.
+    virtual std::string config(void)
+    {
+        std::ostringstream ss;
+
+        ss << m_ring.pageCount() << " pages @ " << m_ring.pageSize() << " bytes";
+
+        return ss.str();
+    }
+
+    // Obtains a string description of the queue state.
+    virtual std::string results(void)
+    {
+        std::ostringstream ss;
+
+        ss << "contention[" << m_ring.contentionCount() << "]";
+
+        return ss.str();
+    }
+
+private:
+
+    // The ring.
+    TRing m_ring;
+
+    // The reader and writer interfaces.
+    TAQReader<TRing> m_reader;
+    TAQWriter<TRing> m_writer;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
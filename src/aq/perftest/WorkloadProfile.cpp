@@ -0,0 +1,245 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "WorkloadProfile.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The number of values the PRNG can return.
+#define PRNG_RANGE                      2147483648.0
+
+// Pi, for the Box-Muller transform.
+#define PI                              3.14159265358979323846
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+WorkloadProfile::WorkloadProfile(const std::string& spec, size_t maxSize)
+    : m_kind(KindFixed)
+    , m_maxSize(maxSize)
+{
+    size_t colon = spec.find(':');
+    string kind = spec.substr(0, colon);
+    string args = colon == string::npos ? string("") : spec.substr(colon + 1);
+
+    if (kind == "fixed")
+    {
+        m_kind = KindFixed;
+        parseParams(spec, args, 1);
+    }
+    else if (kind == "lognormal")
+    {
+        m_kind = KindLogNormal;
+        parseParams(spec, args, 2);
+    }
+    else if (kind == "bimodal")
+    {
+        m_kind = KindBimodal;
+        parseParams(spec, args, 3);
+        if (m_params[2] > 100.0)
+        {
+            throw invalid_argument("The large item percentage in workload profile '" + spec + "' is over 100");
+        }
+    }
+    else if (kind == "trace")
+    {
+        m_kind = KindTrace;
+        m_tracePath = args;
+        readTrace();
+    }
+    else
+    {
+        throw invalid_argument("Unknown workload profile '" + spec + "'");
+    }
+}
+
+//------------------------------------------------------------------------------
+WorkloadProfile::~WorkloadProfile(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void WorkloadProfile::parseParams(const std::string& spec, const std::string& text, size_t count)
+{
+    istringstream ss(text);
+    string item;
+    while (getline(ss, item, ','))
+    {
+        char *end;
+        double value = strtod(item.c_str(), &end);
+        if (item.empty() || *end != '\0' || value < 0.0)
+        {
+            throw invalid_argument("Invalid parameter '" + item + "' in workload profile '" + spec + "'");
+        }
+        m_params.push_back(value);
+    }
+    if (m_params.size() != count)
+    {
+        throw invalid_argument("Wrong number of parameters in workload profile '" + spec + "'");
+    }
+}
+
+//------------------------------------------------------------------------------
+void WorkloadProfile::readTrace(void)
+{
+    ifstream is(m_tracePath.c_str());
+    if (!is)
+    {
+        throw runtime_error("Cannot open the size trace '" + m_tracePath + "'");
+    }
+
+    size_t size;
+    while (is >> size)
+    {
+        m_trace.push_back(clamp((double)size));
+    }
+    if (!is.eof() || m_trace.empty())
+    {
+        throw runtime_error("The size trace '" + m_tracePath + "' does not hold a list of sizes");
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t WorkloadProfile::clamp(double size) const
+{
+    if (size < 1.0)
+    {
+        return 1;
+    }
+    if (size > (double)m_maxSize)
+    {
+        return m_maxSize;
+    }
+    return (size_t)size;
+}
+
+//------------------------------------------------------------------------------
+std::string WorkloadProfile::description(void) const
+{
+    ostringstream ss;
+
+    switch (m_kind)
+    {
+    case KindFixed:
+        ss << "fixed " << m_params[0] << "B";
+        break;
+
+    case KindLogNormal:
+        ss << "lognormal " << m_params[0] << "B/" << m_params[1];
+        break;
+
+    case KindBimodal:
+        ss << "bimodal " << m_params[0] << "B/" << m_params[1] << "B@" << m_params[2] << "%";
+        break;
+
+    case KindTrace:
+        ss << "trace " << m_trace.size() << " sizes";
+        break;
+    }
+
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+WorkloadProfile::Generator::Generator(const WorkloadProfile& profile, unsigned int stream)
+    : m_profile(&profile)
+    , m_prng(stream + 1)
+    , m_position(0)
+{
+    // Each stream of a trace starts at a different point so that the
+    // producers do not write the same sizes in step.
+    if (!profile.m_trace.empty())
+    {
+        m_position = (stream * 7919) % profile.m_trace.size();
+    }
+}
+
+//------------------------------------------------------------------------------
+double WorkloadProfile::Generator::uniform(void)
+{
+    return ((double)m_prng.next() + 1.0) / PRNG_RANGE;
+}
+
+//------------------------------------------------------------------------------
+size_t WorkloadProfile::Generator::next(void)
+{
+    const vector<double>& p = m_profile->m_params;
+
+    switch (m_profile->m_kind)
+    {
+    case KindFixed:
+        return m_profile->clamp(p[0]);
+
+    case KindLogNormal:
+        {
+            // Box-Muller transform from two uniform values to a normal one.
+            double z = sqrt(-2.0 * log(uniform())) * cos(2.0 * PI * uniform());
+            return m_profile->clamp(p[0] * exp(p[1] * z));
+        }
+
+    case KindBimodal:
+        return m_profile->clamp(uniform() * 100.0 <= p[2] ? p[1] : p[0]);
+
+    case KindTrace:
+        {
+            size_t size = m_profile->m_trace[m_position];
+            m_position = (m_position + 1) % m_profile->m_trace.size();
+            return size;
+        }
+    }
+
+    return 1;
+}
+
+
+
+
+//=============================== End of File ==================================
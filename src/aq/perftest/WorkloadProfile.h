@@ -0,0 +1,147 @@
+#ifndef WORKLOADPROFILE_H
+#define WORKLOADPROFILE_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Prng.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Describes the distribution of the item sizes written by the producers of a
+// workload test.  A profile is given as a string in one of these forms:
+//
+//   fixed:<bytes>                       Every item is the same size.
+//   lognormal:<median>,<sigma>          Sizes follow a log-normal
+//                                       distribution, as message sizes in
+//                                       real traffic usually do.
+//   bimodal:<small>,<large>,<percent>   'percent' percent of the items are
+//                                       'large' bytes and the rest 'small'.
+//   trace:<path>                        Sizes are replayed in order from the
+//                                       file at 'path', which holds sizes
+//                                       separated by white space.
+class WorkloadProfile
+{
+public:
+
+    // Generates the item sizes for one producer.
+    class Generator
+    {
+    public:
+
+        // Constructs a generator for 'profile' that produces the sequence
+        // of sizes numbered 'stream'.
+        Generator(const WorkloadProfile& profile, unsigned int stream);
+
+        // Returns the size of the next item, between 1 and the maximum size
+        // of the profile.
+        size_t next(void);
+
+    private:
+
+        // The profile being generated.
+        const WorkloadProfile *m_profile;
+
+        // The random number generator for this stream.
+        Prng m_prng;
+
+        // The next position in the size trace.
+        size_t m_position;
+
+        // Returns a random value in the range (0, 1].
+        double uniform(void);
+
+    };
+
+    // Constructs the profile described by 'spec' with no item larger than
+    // 'maxSize' bytes.  Throws an invalid_argument if 'spec' is not valid or
+    // a runtime_error if the trace file cannot be read.
+    WorkloadProfile(const std::string& spec, size_t maxSize);
+
+    // Destroys this profile.
+    ~WorkloadProfile(void);
+
+    // Returns a short description of this profile.
+    std::string description(void) const;
+
+private:
+
+    // The kinds of distribution.
+    enum Kind
+    {
+        KindFixed,
+        KindLogNormal,
+        KindBimodal,
+        KindTrace
+    };
+
+    // The kind of distribution.
+    Kind m_kind;
+
+    // The largest item size.
+    size_t m_maxSize;
+
+    // The parameters of the distribution; their meaning depends on the kind.
+    std::vector<double> m_params;
+
+    // The sizes in the trace.
+    std::vector<size_t> m_trace;
+
+    // The path of the trace file.
+    std::string m_tracePath;
+
+    // Parses the comma-separated numbers in 'text' into 'm_params', which
+    // must then hold 'count' values.
+    void parseParams(const std::string& spec, const std::string& text, size_t count);
+
+    // Reads the sizes from the trace file.
+    void readTrace(void);
+
+    // Limits 'size' to the range 1 to 'm_maxSize'.
+    size_t clamp(double size) const;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
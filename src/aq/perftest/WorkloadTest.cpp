@@ -0,0 +1,305 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "WorkloadTest.h"
+
+#include "IQueueProvider.h"
+#include "IAQReader.h"
+#include "IAQWriter.h"
+#include "AQItem.h"
+
+#include <string.h>
+
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The number of items written by all producers in each iteration.
+#define ITEMS_PER_ITERATION             (1 << 18)
+
+// The largest item is this fraction of the queue memory.
+#define MAX_ITEM_FRACTION               8
+
+// The interval between usage samples in milliseconds.
+#define SAMPLE_INTERVAL_MS              10
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Busy-waits for 'count' ticks.
+static void spinTicks(uint64_t count);
+
+// Converts 'ns' nanoseconds into ticks.
+static uint64_t nsToTicks(double ns);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+WorkloadTest::WorkloadTest(const std::string& name, IQueueProvider& queueProvider,
+    int producerCount, const std::string& profileSpec,
+    unsigned int burstSize, unsigned int burstPauseUs, unsigned int thinkNs)
+    : QueueTest(name, queueProvider)
+    , m_profile(profileSpec, queueProvider.usablePageCount() * queueProvider.pageSize() / MAX_ITEM_FRACTION)
+    , m_itemsPerThread(ITEMS_PER_ITERATION / (size_t)producerCount)
+    , m_burstSize(burstSize)
+    , m_burstPauseUs(burstPauseUs)
+    , m_thinkNs(thinkNs)
+    , m_startTicks(0)
+    , m_burstPauseTicks(0)
+    , m_thinkTicks(0)
+    , m_sampleTicks(0)
+    , m_stampLatency(false)
+{
+    if (!queueProvider.hasPageRing())
+    {
+        throw invalid_argument("The workload test needs a queue that places items in a page ring");
+    }
+
+    for (int i = 0; i < producerCount; ++i)
+    {
+        Producer *producer = new Producer;
+        producer->items = 0;
+        producer->bytes = 0;
+        producer->fullCount = 0;
+        producer->stream = (unsigned int)i;
+        m_producers.push_back(producer);
+        addThread<WorkloadTest, Producer>(&WorkloadTest::threadProduce, *producer);
+    }
+    addThread<WorkloadTest, LatencyHistogram>(&WorkloadTest::threadConsume, addLatencyHistogram());
+}
+
+//------------------------------------------------------------------------------
+WorkloadTest::~WorkloadTest(void)
+{
+    for (size_t i = 0; i < m_producers.size(); ++i)
+    {
+        delete m_producers[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+static uint64_t nsToTicks(double ns)
+{
+    return (uint64_t)(ns * 1000000.0 / LatencyHistogram::ticksToNs(1000000));
+}
+
+//------------------------------------------------------------------------------
+static void spinTicks(uint64_t count)
+{
+    if (count > 0)
+    {
+        uint64_t end = LatencyHistogram::ticks() + count;
+        while (LatencyHistogram::ticks() < end)
+        {
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void WorkloadTest::before(void)
+{
+    QueueTest::before();
+
+    m_burstPauseTicks = nsToTicks((double)m_burstPauseUs * 1000.0);
+    m_thinkTicks = nsToTicks((double)m_thinkNs);
+    m_sampleTicks = nsToTicks(SAMPLE_INTERVAL_MS * 1000000.0);
+    m_stampLatency = latencySampling();
+    m_usage.clear();
+    for (size_t i = 0; i < m_producers.size(); ++i)
+    {
+        m_producers[i]->fullCount = 0;
+    }
+    m_startTicks = LatencyHistogram::ticks();
+}
+
+//------------------------------------------------------------------------------
+void WorkloadTest::beforeIteration(void)
+{
+    QueueTest::beforeIteration();
+
+    for (size_t i = 0; i < m_producers.size(); ++i)
+    {
+        m_producers[i]->items = 0;
+        m_producers[i]->bytes = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void WorkloadTest::threadProduce(Producer& producer)
+{
+    AQWriterItem item;
+    IAQWriter& writer = queueProvider().writer();
+    WorkloadProfile::Generator sizes(m_profile, producer.stream);
+    for (size_t i = 0; i < m_itemsPerThread; ++i)
+    {
+        size_t size = sizes.next();
+        while (!writer.claim(item, size))
+        {
+            producer.fullCount++;
+        }
+        producer.items = producer.items + 1;
+        producer.bytes = producer.bytes + size;
+
+        if (m_stampLatency && size >= sizeof(uint32_t))
+        {
+            uint32_t stamp = (uint32_t)LatencyHistogram::ticks();
+            memcpy(&item[0], &stamp, sizeof(stamp));
+        }
+        writer.commit(item);
+
+        if (m_burstSize > 0 && (i + 1) % m_burstSize == 0)
+        {
+            spinTicks(m_burstPauseTicks);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void WorkloadTest::threadConsume(LatencyHistogram& latency)
+{
+    AQItem item;
+    IQueueProvider& provider = queueProvider();
+    IAQReader& reader = provider.reader();
+    size_t pageSize = provider.pageSize();
+    size_t ringPages = provider.ringPageCount();
+
+    // The queue is empty at the start of each iteration so the first item
+    // is in the first page.
+    size_t expectedPage = 0;
+    uint64_t items = 0;
+    uint64_t bytes = 0;
+    uint64_t nextSample = 0;
+    size_t count = m_itemsPerThread * m_producers.size();
+    while (items < count)
+    {
+        uint64_t now = LatencyHistogram::ticks();
+        if (now >= nextSample)
+        {
+            sample(now, items, bytes);
+            nextSample = now + m_sampleTicks;
+        }
+
+        if (reader.retrieve(item))
+        {
+            if (m_stampLatency && item.size() >= sizeof(uint32_t))
+            {
+                uint32_t stamp;
+                memcpy(&stamp, &item[0], sizeof(stamp));
+                latency.record((uint32_t)LatencyHistogram::ticks() - stamp);
+            }
+
+            // Any gap between the end of the previous item and the start of
+            // this one is made of skipped pages.
+            size_t page = provider.ringPage(item);
+            size_t pages = (item.size() + pageSize - 1) / pageSize;
+            size_t skipped = (page + ringPages - expectedPage) % ringPages;
+            expectedPage = (page + pages) % ringPages;
+            m_usage.recordItem(item.size(), pages * pageSize, skipped * pageSize);
+
+            items++;
+            bytes += item.size();
+            spinTicks(m_thinkTicks);
+            reader.release(item);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void WorkloadTest::sample(uint64_t now, uint64_t items, uint64_t bytes)
+{
+    IQueueProvider& provider = queueProvider();
+
+    QueueUsage::Sample s;
+    s.timeMs = LatencyHistogram::ticksToNs(now - m_startTicks) / 1000000.0;
+    s.items = 0;
+    s.bytes = 0;
+    for (size_t i = 0; i < m_producers.size(); ++i)
+    {
+        s.items += m_producers[i]->items;
+        s.bytes += m_producers[i]->bytes;
+    }
+    s.items = s.items > items ? s.items - items : 0;
+    s.bytes = s.bytes > bytes ? s.bytes - bytes : 0;
+    s.freeBytes = provider.freeSize();
+    s.availableBytes = provider.availableSize();
+    m_usage.record(s);
+}
+
+//------------------------------------------------------------------------------
+std::string WorkloadTest::config(void) const
+{
+    ostringstream ss;
+
+    ss << m_profile.description();
+    if (m_burstSize > 0)
+    {
+        ss << ", burst " << m_burstSize << "/" << m_burstPauseUs << "us";
+    }
+    if (m_thinkNs > 0)
+    {
+        ss << ", think " << m_thinkNs << "ns";
+    }
+    ss << ", " << QueueTest::config();
+
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+std::string WorkloadTest::results(void) const
+{
+    uint64_t fullCount = 0;
+    for (size_t i = 0; i < m_producers.size(); ++i)
+    {
+        fullCount += m_producers[i]->fullCount;
+    }
+
+    ostringstream ss;
+
+    ss << QueueTest::results() << " full[" << fullCount << "]";
+
+    return ss.str();
+}
+
+
+
+
+//=============================== End of File ==================================
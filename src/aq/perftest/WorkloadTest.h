@@ -0,0 +1,173 @@
+#ifndef WORKLOADTEST_H
+#define WORKLOADTEST_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "QueueTest.h"
+#include "QueueUsage.h"
+#include "WorkloadProfile.h"
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Tests the performance of a queue under a realistic workload: the producers
+// write items whose sizes follow a WorkloadProfile, optionally in bursts
+// separated by pauses, and the consumer optionally spends some time on each
+// item before releasing it.  While the test runs the consumer samples how the
+// queue memory is being used, which is reported through usage().
+//
+// The queue provider must place items in a page ring (see
+// IQueueProvider::hasPageRing()); providers that give each item a single
+// fixed-size page cannot hold items of varying size.
+class WorkloadTest : public QueueTest
+{
+public:
+
+    // Constructs a new workload test with 'producerCount' threads writing
+    // items with sizes from the profile given by 'profileSpec', and one
+    // thread reading them.  Each producer pauses for 'burstPauseUs'
+    // microseconds after every 'burstSize' items, if 'burstSize' is not 0,
+    // and the consumer spends 'thinkNs' nanoseconds on each item.  Throws an
+    // invalid_argument if the provider has no page ring or the profile is not
+    // valid.
+    WorkloadTest(const std::string& name, IQueueProvider& queueProvider,
+        int producerCount, const std::string& profileSpec,
+        unsigned int burstSize, unsigned int burstPauseUs, unsigned int thinkNs);
+
+private:
+    // No copy or assignment permitted.
+    WorkloadTest(const WorkloadTest& other);
+    WorkloadTest& operator=(const WorkloadTest& other);
+public:
+
+    // Destroys this workload test.
+    virtual ~WorkloadTest(void);
+
+    // The total number of operations that were performed.
+    virtual unsigned long totalOperationCount(void) const
+    {
+        return iterationCount() * m_itemsPerThread * m_producers.size();
+    }
+
+    // Gets the queue usage sampled while the test ran.
+    virtual const QueueUsage *usage(void) const { return &m_usage; }
+
+    // Gets a description of the configuration of this test.
+    virtual std::string config(void) const;
+
+    // Gets a description of the results for this test.
+    virtual std::string results(void) const;
+
+protected:
+
+    // Called before the test is run to setup the test.
+    virtual void before(void);
+
+    // Called before each iteration of the test.
+    virtual void beforeIteration(void);
+
+private:
+
+    // The state of one producer, kept on its own cache line.
+    struct Producer
+    {
+        // The number of items claimed in this iteration.
+        volatile uint64_t items;
+
+        // The number of bytes claimed in this iteration.
+        volatile uint64_t bytes;
+
+        // The number of claims that failed because the queue was full.
+        uint64_t fullCount;
+
+        // The stream of item sizes this producer writes.
+        unsigned int stream;
+
+        // Keeps the next producer off this cache line.
+        unsigned char pad[36];
+    };
+
+    // The item size profile.
+    WorkloadProfile m_profile;
+
+    // The number of items written by each producer per iteration.
+    const size_t m_itemsPerThread;
+
+    // The number of items in each burst, or 0 for no bursts.
+    const unsigned int m_burstSize;
+
+    // The pause after each burst in microseconds.
+    const unsigned int m_burstPauseUs;
+
+    // The time the consumer spends on each item in nanoseconds.
+    const unsigned int m_thinkNs;
+
+    // The producers.
+    std::vector<Producer *> m_producers;
+
+    // The queue usage.
+    QueueUsage m_usage;
+
+    // The tick count when the test started.
+    uint64_t m_startTicks;
+
+    // The burst pause, the consumer time per item and the sampling interval
+    // in ticks.
+    uint64_t m_burstPauseTicks;
+    uint64_t m_thinkTicks;
+    uint64_t m_sampleTicks;
+
+    // Set to true to stamp each item with the time it was committed.
+    bool m_stampLatency;
+
+    // Runs the producer 'producer'.
+    void threadProduce(Producer& producer);
+
+    // Runs the consumer.  When latency sampling is enabled the time from each
+    // item being committed to it being retrieved is recorded into 'latency'.
+    void threadConsume(LatencyHistogram& latency);
+
+    // Records a usage sample at 'now' ticks when 'items' items holding
+    // 'bytes' bytes have been retrieved in this iteration.
+    void sample(uint64_t now, uint64_t items, uint64_t bytes);
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -22,6 +22,7 @@
 #include "Timer.h"
 #include "TraceManager.h"
 
+#include "CpuAffinity.h"
 #include "Optarg.h"
 
 #include <string.h>
@@ -165,6 +166,9 @@ static int ProducerCount = DEFAULT_PRODUCER_COUNT;
 // The number of snapshot threads to run.
 static int SnapshotTakerCount = DEFAULT_SNAPSHOT_TAKER_COUNT;
 
+// The CPU affinity policy for the producers, consumer and snapshot takers.
+static std::string AffinityPolicy = "none";
+
 // The shared memory size.
 static size_t ShmSize = DEFAULT_SHM_SIZE;
 
@@ -272,6 +276,8 @@ static int internalMain(int argc, char *argv[])
         cout << nProcessors << " processors available";
     }
     cout << endl;
+    CpuAffinity affinity(AffinityPolicy);
+    cout << "CPU topology: " << affinity.description() << endl;
 
 
     // Create the shared memory region and initialize.
@@ -304,6 +310,7 @@ static int internalMain(int argc, char *argv[])
         Producers.push_back(new Producer(consumer, i + 1, sm, 
             PageSizeAlloc, checkLinkId, MaxOutstanding, MaxPagesPerAppend,
             TraceEnableProducer ? Trace : NULL));
+        Producers[i]->setAffinity(affinity.cpu(i));
 #ifdef AQ_TEST_POINT
         if (TpDelayClaimBeforeWriteHeadRef)
         {
@@ -325,9 +332,13 @@ static int internalMain(int argc, char *argv[])
     for (int i = 0; i < SnapshotTakerCount; ++i)
     {
         SnapshotTakers.push_back(new SnapshotTaker(consumer, i + 1 + ProducerCount, MaxSnapshotPeriodMs, Trace));
+        SnapshotTakers[i]->setAffinity(affinity.cpu(i + 1 + ProducerCount));
     }
     assertShmGuard();
 
+    // The consumer runs in this thread, on the CPU after the producers.
+    CpuAffinity::pinCurrentThread(affinity.cpu(ProducerCount));
+
     // All producers ready but not running; now we run the produce/consume
     // logic for the number of requested loops.
     size_t runLoop = 0;
@@ -769,6 +780,7 @@ static void configure(Optarg &cfg)
     cfg.opt('t', RunTimeSecs, "The duration of each stress loop in seconds.");
     cfg.opt('l', RunLoops, "The number of test loops to perform; a value of 0 loops forever.");
     cfg.opt('p', ProducerCount, "The number of producer threads to create and write into the queue.");
+    cfg.opt('a', AffinityPolicy, "The CPU affinity policy: 'none', 'compact' (one thread per core, filling each socket in turn), 'scatter' (one thread per core, alternating sockets), 'smt' (pairs threads on the SMT siblings of each core) or a comma-separated list of CPUs.  Producers take CPUs in order, then the consumer, then the snapshot takers.");
     cfg.opt('s', SnapshotTakerCount, "The number of snapshot taking threads to create and write into the queue.");
     cfg.opt('M', ShmSize, "The size of the shared memory region.");
     cfg.opt('P', PageSizeShift, "The size of each AQ page expressed as 2^(this value).");
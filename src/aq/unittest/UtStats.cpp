@@ -0,0 +1,255 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQTest.h"
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtStats);
+
+//------------------------------------------------------------------------------
+AQTEST(given_Unformatted_when_Stats_then_ThrowsUnformatted)
+{
+    aq.ctrl->formatVersion = 0;
+    REQUIRE_EXCEPTION(aq.writer.stats(), AQUnformattedException);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_NewQueue_when_Stats_then_AllZero)
+{
+    AQStats s = aq.writer.stats();
+    REQUIRE(s.itemCount() == 0);
+    REQUIRE(s.usedPageCount() == 0);
+    REQUIRE(s.usedSize() == 0);
+    REQUIRE(s.usedPageHighWater() == 0);
+    REQUIRE(s.claimFullCount() == 0);
+    REQUIRE(s.skipPageCount() == 0);
+    REQUIRE(s.commitTimeoutCount() == 0);
+    REQUIRE(s.crcFailureCount() == 0);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_CommittedItems_when_Stats_then_ItemsAndBytesInUse)
+{
+    aq.enqueue(2);
+    aq.enqueue(1, aq.pageSize() * 2);
+
+    AQStats s = aq.writer.stats();
+    REQUIRE(s.itemCount() == 3);
+    REQUIRE(s.usedPageCount() == 4);
+    REQUIRE(s.usedSize() == 4 * aq.pageSize());
+}
+
+//------------------------------------------------------------------------------
+AQTEST_FORMAT(given_ExtendableItems_when_CommittedAndReleased_then_EachItemCountedOnce, AQ::OPTION_EXTENDABLE)
+{
+    AQWriterItem witem0, witem1;
+    REQUIRE(aq.writer.claim(witem0, aq.pageSize()));
+    REQUIRE(aq.appendData(witem0, 0, 3 * aq.pageSize()));
+    REQUIRE(aq.writer.claim(witem1, aq.pageSize()));
+    REQUIRE(aq.appendData(witem1, 10, aq.pageSize()));
+    REQUIRE(aq.writer.commit(witem0));
+    REQUIRE(aq.writer.commit(witem1));
+
+    AQStats s = aq.writer.stats();
+    REQUIRE(s.itemCount() == 2);
+    REQUIRE(s.usedPageCount() == 4);
+
+    AQItem ritem;
+    REQUIRE(aq.reader.retrieve(ritem));
+    REQUIRE(aq.isItemData(ritem, 0, 3 * aq.pageSize()));
+    aq.reader.release(ritem);
+    REQUIRE(aq.writer.stats().itemCount() == 1);
+
+    REQUIRE(aq.reader.retrieve(ritem));
+    aq.reader.release(ritem);
+    s = aq.writer.stats();
+    REQUIRE(s.itemCount() == 0);
+    REQUIRE(s.usedPageCount() == 0);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_ClaimedItem_when_Stats_then_PagesUsedButNoItem)
+{
+    AQWriterItem witem;
+    REQUIRE(aq.writer.claim(witem, aq.pageSize()));
+
+    AQStats s = aq.writer.stats();
+    REQUIRE(s.itemCount() == 0);
+    REQUIRE(s.usedPageCount() == 1);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_CommittedItems_when_ReleasedAndStats_then_ItemsFreedAndHighWaterKept)
+{
+    aq.enqueue(5);
+
+    AQItem ritem;
+    REQUIRE(aq.reader.retrieve(ritem));
+    aq.reader.release(ritem);
+
+    AQStats s = aq.writer.stats();
+    REQUIRE(s.itemCount() == 4);
+    REQUIRE(s.usedPageCount() == 4);
+    REQUIRE(s.usedPageHighWater() == 5);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        REQUIRE(aq.reader.retrieve(ritem));
+        aq.reader.release(ritem);
+    }
+
+    s = aq.writer.stats();
+    REQUIRE(s.itemCount() == 0);
+    REQUIRE(s.usedPageCount() == 0);
+    REQUIRE(s.usedSize() == 0);
+    REQUIRE(s.usedPageHighWater() == 5);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_HeadBeforeTail_when_Stats_then_UsedPagesWrap)
+{
+    aq.advance(9);
+    aq.enqueue(4);
+
+    AQStats s = aq.writer.stats();
+    REQUIRE(s.itemCount() == 4);
+    REQUIRE(s.usedPageCount() == 4);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_QueueFull_when_Claim_then_ClaimFullCounted)
+{
+    aq.enqueue(aq.pageCount() - 1);
+
+    AQWriterItem witem;
+    REQUIRE(!aq.writer.claim(witem, aq.pageSize()));
+    REQUIRE(!aq.writer.claim(witem, aq.pageSize()));
+
+    AQStats s = aq.writer.stats();
+    REQUIRE(s.claimFullCount() == 2);
+    REQUIRE(s.usedPageCount() == aq.pageCount() - 1);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_NotEnoughSpaceAtEnd_when_Claim_then_ClaimFullCounted)
+{
+    aq.advance(3);
+    aq.enqueue(5);
+
+    AQWriterItem witem;
+    REQUIRE(!aq.writer.claim(witem, aq.pageSize() * 4));
+    REQUIRE(aq.writer.stats().claimFullCount() == 1);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_ClaimSkipsEnd_when_WasteFreed_then_SkipPagesCounted)
+{
+    aq.advance(7);
+
+    AQWriterItem witem;
+    REQUIRE(aq.writer.claim(witem, aq.pageSize() * 5));
+    REQUIRE(aq.writer.commit(witem));
+    REQUIRE(aq.writer.stats().skipPageCount() == 0);
+    REQUIRE(aq.writer.stats().usedPageCount() == 9);
+
+    AQItem ritem;
+    REQUIRE(aq.reader.retrieve(ritem));
+
+    AQStats s = aq.writer.stats();
+    REQUIRE(s.skipPageCount() == 4);
+    REQUIRE(s.itemCount() == 1);
+    REQUIRE(s.usedPageCount() == 5);
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_IncompleteAtHead_when_CommitTimeout_then_CommitTimeoutCounted)
+{
+    aq.advance(3);
+    AQWriterItem witem;
+    REQUIRE(aq.writer.claim(witem, aq.pageSize()));
+    aq.enqueue(7);
+
+    AQItem ritem1, ritem2;
+    REQUIRE(aq.reader.retrieve(ritem1));
+    REQUIRE(aq.writer.stats().commitTimeoutCount() == 0);
+
+    Timer::sleep(AQTest::COMMIT_TIMEOUT_MS);
+    REQUIRE(aq.reader.retrieve(ritem2));
+    REQUIRE(!ritem2.isCommitted());
+    REQUIRE(aq.writer.stats().commitTimeoutCount() == 1);
+
+    // The incomplete item is only counted once.
+    AQItem ritem3;
+    REQUIRE(aq.reader.retrieve(ritem3));
+    REQUIRE(aq.writer.stats().commitTimeoutCount() == 1);
+}
+
+//------------------------------------------------------------------------------
+AQTEST_FORMAT(given_CommitItemMemoryChange_when_Retrieve_then_CrcFailureCounted, AQ::OPTION_CRC32)
+{
+    AQWriterItem witem;
+    REQUIRE(aq.writer.claim(witem, aq.pageSize()));
+    unsigned char *ptr = &witem[0];
+    ptr[2] = 0xF1;
+    REQUIRE(aq.writer.commit(witem));
+    aq.enqueue(1);
+
+    ptr[2] = 0xF2;
+
+    AQItem ritem1, ritem2;
+    REQUIRE(aq.reader.retrieve(ritem1));
+    REQUIRE(aq.reader.retrieve(ritem2));
+    REQUIRE(!ritem1.isChecksumValid());
+    REQUIRE(ritem2.isChecksumValid());
+    REQUIRE(aq.writer.stats().crcFailureCount() == 1);
+}
+
+
+
+
+//=============================== End of File ==================================
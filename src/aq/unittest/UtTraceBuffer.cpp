@@ -0,0 +1,333 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQTest.h"
+
+#include "AQHeapMemory.h"
+
+#include "Atomic.h"
+#include "WorkerThread.h"
+
+#include <sstream>
+
+using namespace aqosa;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The number of threads that record events at the same trace point.
+#define EVENT_WRITER_COUNT              4
+
+// The number of events each of those threads records.
+#define EVENT_WRITER_EVENTS             20
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Writes the trace buffers in 'tm' and returns the resulting text.
+static string writeTrace(const TraceManager& tm);
+
+// Returns the number of times 'str' occurs in 'text'.
+static size_t countOf(const string& text, const string& str);
+
+// Records event 'i' of writer 'id' into 'm_trace'.  Every call uses the same
+// trace point.
+static void traceWriterEvent(TraceBuffer *m_trace, int id, int i);
+
+// Records events into its own trace buffer from a single trace point once it
+// is released.
+class EventWriter : public WorkerThread
+{
+public:
+
+    EventWriter(TraceBuffer *trace, int id, volatile uint32_t& go) 
+        : m_trace(trace), m_id(id), m_go(go) 
+    { 
+    }
+
+    virtual void run(void)
+    {
+        while (Atomic::read(&m_go) == 0)
+        {
+        }
+        for (int i = 0; i < EVENT_WRITER_EVENTS; ++i)
+        {
+            traceWriterEvent(m_trace, m_id, i);
+        }
+    }
+
+private:
+    TraceBuffer *m_trace;
+    int m_id;
+    volatile uint32_t& m_go;
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static string writeTrace(const TraceManager& tm)
+{
+    ostringstream ss;
+    tm.write(ss);
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+static size_t countOf(const string& text, const string& str)
+{
+    size_t count = 0;
+    for (size_t pos = text.find(str); pos != string::npos; pos = text.find(str, pos + 1))
+    {
+        count++;
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+static void traceWriterEvent(TraceBuffer *m_trace, int id, int i)
+{
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "writer %d event %d", id, i);
+}
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtTraceBuffer);
+
+//------------------------------------------------------------------------------
+TEST(given_BinaryBuffer_when_Event_then_FormattedOnWrite)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Binary);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+    REQUIRE(m_trace->isBinary());
+
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "a %u b %s c %c d %5.1f%%", 5u, "xyz", 'q', 2.25);
+
+    string text = writeTrace(tm);
+    REQUIRE(text.find("a 5 b xyz c q d   2.2%") != string::npos);
+    REQUIRE(text.find("Q[") == string::npos);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_BinaryBuffer_when_EventWith64BitArgs_then_ValuesKept)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Binary);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+
+    unsigned long long ull = 0x123456789ABCDEF0ULL;
+    size_t sz = (size_t)-1;
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "%llX %zu %ld %d", ull, sz, -7L, -3);
+
+    ostringstream expected;
+    expected << "123456789ABCDEF0 " << sz << " -7 -3";
+    REQUIRE(writeTrace(tm).find(expected.str()) != string::npos);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_BinaryBuffer_when_EventWithLongString_then_StringTruncated)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Binary);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+
+    string str(100, 'x');
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "[%s] %d", str.c_str(), 42);
+
+    string text = writeTrace(tm);
+    REQUIRE(text.find("[" + string(TRACE_EVENT_STRING_MAX - 1, 'x') + "] 42") != string::npos);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_BinaryBuffer_when_Wrapped_then_OnlyWholeEventsWritten)
+{
+    TraceManager tm(TraceManager::None, 8, TraceManager::Binary);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+
+    for (int i = 0; i < 11; ++i)
+    {
+        TRACE_EVENT_TYPE(Log, NULL, NULL, "ev%d %s", i, "0123456789012345678901234567890123456789");
+    }
+
+    // Each event takes two records, so only the newest four are kept.
+    string text = writeTrace(tm);
+    REQUIRE(countOf(text, "0123456789012345678901234567890123456789") == 4);
+    REQUIRE(text.find("ev6 ") == string::npos);
+    REQUIRE(text.find("ev7 ") != string::npos);
+    REQUIRE(text.find("ev10 ") != string::npos);
+
+    m_trace->clear();
+    REQUIRE(countOf(writeTrace(tm), "ev") == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_BinaryBuffer_when_UnsupportedConversion_then_RestWrittenLiterally)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Binary);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "n=%d w=%*d", 1, 2, 3);
+
+    REQUIRE(writeTrace(tm).find("n=1 w=%*d") != string::npos);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_TextBuffer_when_Event_then_Ignored)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Text);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+    REQUIRE(!m_trace->isBinary());
+
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "event %d", 1);
+
+    REQUIRE(writeTrace(tm).find("event 1") == string::npos);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_BinaryBuffer_when_TraceMacro_then_EventRecorded)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Binary);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+
+    TRACE_ENTRY("entry %d", 1);
+    TRACE("log %s", "two");
+    TRACE_1ITEM_EXIT(NULL, NULL, "exit %u", 3u);
+
+    string text = writeTrace(tm);
+    REQUIRE(text.find("entry 1") < text.find("log two"));
+    REQUIRE(text.find("log two") < text.find("exit 3"));
+    REQUIRE(text.find("exit 3") != string::npos);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_TextBuffer_when_TraceMacro_then_RecordWritten)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Text);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+
+    TRACE("log %s", "two");
+
+    REQUIRE(writeTrace(tm).find("log two") != string::npos);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_BinaryBuffers_when_QueueUsed_then_LibraryTracePointsRecorded)
+{
+    TraceManager tm(TraceManager::None, 64, TraceManager::Binary);
+    AQHeapMemory mem(1024);
+    AQReader reader(mem, tm.createBuffer("rdr"));
+    AQWriter writer(mem, tm.createBuffer("wrt"));
+    REQUIRE(reader.format(4, 1000));
+
+    AQWriterItem witem;
+    REQUIRE(writer.claim(witem, 20));
+    REQUIRE(writer.commit(witem));
+
+    REQUIRE(writeTrace(tm).find("20 bytes -> 2 pgs") != string::npos);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_BinaryBuffers_when_Write_then_MergedInOrder)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Binary);
+    TraceBuffer *m_trace = tm.createBuffer("one");
+    TraceBuffer *other = tm.createBuffer("two");
+
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "first");
+    std::swap(m_trace, other);
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "second");
+    std::swap(m_trace, other);
+    TRACE_EVENT_TYPE(Log, NULL, NULL, "third");
+
+    string text = writeTrace(tm);
+    REQUIRE(text.find("first") < text.find("second"));
+    REQUIRE(text.find("second") < text.find("third"));
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ThreadsAtNewTracePoint_when_EventsRecordedConcurrently_then_AllFormatted)
+{
+    TraceManager tm(TraceManager::None, 2 * EVENT_WRITER_EVENTS, TraceManager::Binary);
+    volatile uint32_t go = 0;
+    vector<EventWriter *> writers;
+    for (int id = 0; id < EVENT_WRITER_COUNT; ++id)
+    {
+        ostringstream name;
+        name << "w" << id;
+        writers.push_back(new EventWriter(tm.createBuffer(name.str()), id, go));
+        writers.back()->start();
+    }
+
+    // The trace point is first reached by every writer at once.
+    Atomic::write(&go, 1);
+    for (size_t i = 0; i < writers.size(); ++i)
+    {
+        REQUIRE(writers[i]->join(5000));
+        delete writers[i];
+    }
+
+    string text = writeTrace(tm);
+    REQUIRE(countOf(text, " event ") == EVENT_WRITER_COUNT * EVENT_WRITER_EVENTS);
+    for (int id = 0; id < EVENT_WRITER_COUNT; ++id)
+    {
+        ostringstream last;
+        last << "writer " << id << " event " << (EVENT_WRITER_EVENTS - 1);
+        REQUIRE(text.find(last.str()) != string::npos);
+    }
+}
+
+//------------------------------------------------------------------------------
+AQTEST(given_BinaryBuffer_when_EventWithItem_then_QueueAndItemWritten)
+{
+    TraceManager tm(TraceManager::None, 16, TraceManager::Binary);
+    TraceBuffer *m_trace = tm.createBuffer("tst");
+
+    aq.enqueue(1);
+    AQItem ritem;
+    REQUIRE(aq.reader.retrieve(ritem));
+    TRACE_EVENT_TYPE(Log, aq.ctrl, &ritem, "retrieved");
+
+    string text = writeTrace(tm);
+    REQUIRE(text.find("Q[") != string::npos);
+    REQUIRE(text.find("itm[") != string::npos);
+    REQUIRE(text.find("] retrieved") != string::npos);
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -571,7 +571,7 @@ TEST(given_UsageExampleAtStep7_when_Retrieve1Page_then_ContentMatchesExpected)
 TEST(given_UsageExampleCode_when_Executed_then_Runs)
 {
     // EXAMPLE (1)
-    AQHeapMemory mem(146);
+    AQHeapMemory mem(174);
     AQWriter writer(mem);
     AQReader reader(mem);
     reader.format(1, 500);
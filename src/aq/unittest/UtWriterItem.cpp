@@ -172,7 +172,7 @@ TEST(given_WriterItemUnallocated_when_Write_then_DomainErrorException)
 TEST(given_WriterItemUnallocated_when_WriteOffset_then_DomainErrorException)
 {
     AQWriterItem witem;
-    char mem[5];
+    char mem[5] = { 0 };
 
     REQUIRE_EXCEPTION(witem.write(2, mem, sizeof(mem)), domain_error);
 }
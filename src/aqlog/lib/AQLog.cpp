@@ -14,7 +14,9 @@
 #include "AQLogRecord.h"
 
 #include "HashFunction.h"
+#include "DropCounters.h"
 #include "LogMemory.h"
+#include "StringTable.h"
 #include "Atomic.h"
 #include "ProcessIdentifier.h"
 #include "Timestamp.h"
@@ -35,8 +37,10 @@ using namespace std;
 // Private Macros
 //------------------------------------------------------------------------------
 
-// The mask used to set the lost flag bit.
-#define LOST_FLAG_MASK                  (1 << 0)
+// Combines the string table epoch with the initialisation count to give the
+// epoch stored in each call site; an odd multiplier keeps the two apart.
+#define STRING_EPOCH_MULTIPLIER         0x9E3779B1
+
 
 
 
@@ -51,9 +55,19 @@ using namespace std;
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
-// Calculates the hash value of a string str_ consisting of strLen characters
-// in the string.  The hash is returned.
-static AQLOG_HASH_EXTERN_ATTRIBUTE uint32_t AQLog_HashTierExtern(const char *str, size_t strLen);
+// Calculates the log level hash table index for lookup strings str1, str2,
+// and str3.
+static uint32_t hashIndex(const char *str1, size_t str1Size, 
+    const char *str2, size_t str2Size, const char *str3, size_t str3Size);
+
+// Returns the string table identifier for the process name, interning it
+// again if the string table epoch has changed to 'tableEpoch'.
+static uint32_t processNameId(uint32_t tableEpoch);
+
+// Claims 'reqSize' bytes from the queue into 'item' provided that at least
+// 'reserveSize' bytes would remain available afterwards.  Returns true if the
+// claim succeeded.
+static bool claimRecord(AQWriterItem& item, size_t reqSize, size_t reserveSize);
 
 
 
@@ -70,14 +84,28 @@ static uint32_t ProcessId = 0;
 // The name of the current process.
 static string ProcessName;
 
+// The string table identifier for the name of the current process.
+static volatile uint32_t ProcessNameId = StringTable::INVALID_ID;
+
+// The string table epoch that ProcessNameId was interned against.
+static volatile uint32_t ProcessNameEpoch = 0;
+
 // The region of shared memory used by the log.
 static LogMemory *SharedMemory = NULL;
 
 // The allocating queue used to write messages into the log.
 static AQWriter *Writer = NULL;
 
-// Set bit 0 to '1' when we have lost a record and not yet report it.
-static uint32_t LostFlag = 0;
+// The string table used to intern the static strings in each record.
+static StringTable *Strings = NULL;
+
+// Incremented each time the log is initialised.  This is combined with the
+// string table epoch so that call sites also intern their strings again when
+// the process attaches to a different log.
+static uint32_t InitCount = 0;
+
+// Counts the records that are dropped due to lack of queue space.
+static DropCounters *Drops = NULL;
 
 
 
@@ -91,17 +119,23 @@ extern "C" AQLOG_HASH_EXTERN_ATTRIBUTE bool AQLog_HashIsLevelExtern(int level,
     const char *str1, size_t str1Size, const char *str2, size_t str2Size, 
     const char *str3, size_t str3Size)
 {
-    uint32_t tier0Hash = HashFunction::standard(AQLOG_TIER_0_MASK, str1, str1Size, AQLOG_LOOKUP_TIER_TAGID == 0);
-    uint32_t tier1Hash = HashFunction::standard(AQLOG_TIER_1_MASK, str2, str2Size, AQLOG_LOOKUP_TIER_TAGID == 1);
-    uint32_t tier2Hash = HashFunction::standard(AQLOG_TIER_2_MASK, str3, str3Size, AQLOG_LOOKUP_TIER_TAGID == 2);
-
-    uint32_t index = (tier0Hash << AQLOG_TIER_0_BITNUM)
-        | (tier1Hash << AQLOG_TIER_1_BITNUM)
-        | (tier2Hash << AQLOG_TIER_2_BITNUM);
+    uint32_t index = hashIndex(str1, str1Size, str2, str2Size, str3, str3Size);
     uint32_t word = index >> AQLOG_HASH_INDEX_WORD_BITNUM;
     uint32_t bitnum = (index & AQLOG_HASH_INDEX_LEVEL_MASK) << AQLOG_HASH_LEVEL_BITS_MUL_SHIFT;
 
-    return (AQLog_LevelHashTable_g[word] & (AQLOG_HASH_LEVEL_MASK << bitnum)) >= ((uint32_t)level << bitnum);
+    return (AQLog_HashWord(word) & (AQLOG_HASH_LEVEL_MASK << bitnum)) >= ((uint32_t)level << bitnum);
+}
+
+//------------------------------------------------------------------------------
+extern "C" uint32_t AQLog_SiteHashIndex(AQLogCallSite_t *site, 
+    const char *str1, size_t str1Size, const char *str2, size_t str2Size, 
+    const char *str3, size_t str3Size)
+{
+    // Concurrent first calls all store the same value so no synchronisation
+    // is needed.
+    uint32_t siteIndex = hashIndex(str1, str1Size, str2, str2Size, str3, str3Size) + 1;
+    Atomic::write(&site->hashIndex, siteIndex);
+    return siteIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -134,9 +168,18 @@ extern "C" AQLogInitOutcome_t AQLog_InitSharedMemory(IAQSharedMemory& sm)
     ProcessId = ProcessIdentifier::currentProcessId();
     ProcessName = ProcessIdentifier::currentProcessName();
 
+    // Attach to the string table, all cached call site identifiers are now
+    // invalid.
+    StringTable *strings = new StringTable(sharedMemory->stringTableMemory());
+    DropCounters *drops = new DropCounters(sharedMemory->dropCountersMemory());
+    ProcessNameEpoch = 0;
+    InitCount++;
+
     // Now assign the new configuration.
     SharedMemory = sharedMemory;
     Writer = writer;
+    Strings = strings;
+    Drops = drops;
     AQLog_LevelHashTable_g = (uint32_t *)sharedMemory->logLevelHashMemory().baseAddress();
 
     return AQLOG_INITOUTCOME_SUCCESS;
@@ -150,6 +193,16 @@ extern "C" void AQLog_Deinit(void)
         delete Writer;
         Writer = NULL;
     }
+    if (Strings != NULL)
+    {
+        delete Strings;
+        Strings = NULL;
+    }
+    if (Drops != NULL)
+    {
+        delete Drops;
+        Drops = NULL;
+    }
     if (SharedMemory != NULL)
     {
         delete SharedMemory;
@@ -159,10 +212,11 @@ extern "C" void AQLog_Deinit(void)
 }
 
 //------------------------------------------------------------------------------
-extern "C" void __AQLog_Write(AQLogLevel_t level, const char *componentId,
-    size_t componentIdSize, const char *tagId, size_t tagIdSize,
-    const char *file, size_t fileSize, const char *func, size_t funcSize,
-    int line, const void *data, size_t dataSize, const char *msg, ...)
+extern "C" void __AQLog_Write(AQLogCallSite_t *site, AQLogLevel_t level,
+    const char *componentId, size_t componentIdSize, const char *tagId,
+    size_t tagIdSize, const char *file, size_t fileSize, const char *func,
+    size_t funcSize, int line, const void *data, size_t dataSize,
+    const char *msg, ...)
 {
     AQWriterItem item;
 
@@ -178,23 +232,75 @@ extern "C" void __AQLog_Write(AQLogLevel_t level, const char *componentId,
         fileSize -= i;
     }
 
+    // Collect the strings in the order they appear in the record.
+    const char *str[AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT];
+    size_t strSize[AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT];
+    str[AQLOG_LOOKUP_TIER_COMPONENTID] = componentId;
+    strSize[AQLOG_LOOKUP_TIER_COMPONENTID] = componentIdSize;
+    str[AQLOG_LOOKUP_TIER_TAGID] = tagId;
+    strSize[AQLOG_LOOKUP_TIER_TAGID] = tagIdSize;
+    str[AQLOG_LOOKUP_TIER_FILE] = file;
+    strSize[AQLOG_LOOKUP_TIER_FILE] = fileSize;
+    str[AQLOG_EXTRA_TIER_PROCESS_NAME] = ProcessName.c_str();
+    strSize[AQLOG_EXTRA_TIER_PROCESS_NAME] = ProcessName.size() + 1;
+    str[AQLOG_EXTRA_TIER_FUNCTION] = func;
+    strSize[AQLOG_EXTRA_TIER_FUNCTION] = funcSize;
+
+    // Obtain the string table identifiers; these are cached in the call site
+    // so the table is only searched the first time a statement is executed.
+    uint32_t strId[AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT];
+    if (site == NULL)
+    {
+        memset(strId, 0, sizeof(strId));
+    }
+    else
+    {
+        // The string table epoch changes each time a consumer formats the
+        // table, so identifiers cached before a consumer restart are interned
+        // again.  While the table is not formatted (epoch 0) nothing is cached.
+        uint32_t tableEpoch = Strings->epoch();
+        uint32_t epoch = tableEpoch * STRING_EPOCH_MULTIPLIER + InitCount;
+        if (tableEpoch == 0 || Atomic::read(&site->epoch) != epoch)
+        {
+            for (i = 0; i < AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT; ++i)
+            {
+                if (i != AQLOG_EXTRA_TIER_PROCESS_NAME)
+                {
+                    site->strId[i] = Strings->intern(str[i], strSize[i] - 1);
+                }
+            }
+            if (tableEpoch != 0)
+            {
+                Atomic::write(&site->epoch, epoch);
+            }
+        }
+        memcpy(strId, site->strId, sizeof(strId));
+        strId[AQLOG_EXTRA_TIER_PROCESS_NAME] = processNameId(tableEpoch);
+    }
+
+    // Only the strings without an identifier are copied into the record.
     size_t reqSize = sizeof(AQLogRecord::Overlay)
         + dataSize
-        + ProcessName.size() + 1
-        + componentIdSize
-        + tagIdSize
-        + fileSize
-        + funcSize
         + AQLOG_RESERVE_MESSAGE_SIZE;
+    for (i = 0; i < AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT; ++i)
+    {
+        if (strId[i] == StringTable::INVALID_ID)
+        {
+            reqSize += strSize[i];
+        }
+    }
+
+    // Less severe records may not use the space reserved for severe ones.
+    size_t reserveSize = Drops->reserveSize(level);
 
     bool dataTruncated = false;
-    if (!Writer->claim(item, reqSize))
+    if (!claimRecord(item, reqSize, reserveSize))
     {
         // Could not allocate - if we had data try to truncate it and retry.
         if (dataSize <= AQLOG_DATA_TRUNCATE_SIZE)
         {
             // Out of queue space - drop the log message.
-            Atomic::bitwiseOr(&LostFlag, LOST_FLAG_MASK);
+            Drops->increment(strId[AQLOG_LOOKUP_TIER_COMPONENTID], level);
             return;
         }
         else
@@ -202,10 +308,10 @@ extern "C" void __AQLog_Write(AQLogLevel_t level, const char *componentId,
             reqSize = reqSize - dataSize + AQLOG_DATA_TRUNCATE_SIZE;
             dataSize = AQLOG_DATA_TRUNCATE_SIZE;
             dataTruncated = true;
-            if (!Writer->claim(item, reqSize))
+            if (!claimRecord(item, reqSize, reserveSize))
             {
                 // Out of queue space even with data truncation enabled - drop the log message.
-                Atomic::bitwiseOr(&LostFlag, LOST_FLAG_MASK);
+                Drops->increment(strId[AQLOG_LOOKUP_TIER_COMPONENTID], level);
                 return;
             }
         }
@@ -213,11 +319,7 @@ extern "C" void __AQLog_Write(AQLogLevel_t level, const char *componentId,
 
     // Use the overlay to construct the record.
     AQLogRecord::Overlay *rec = (AQLogRecord::Overlay *)&item[0];
-    rec->dropped = Atomic::read(&LostFlag) & LOST_FLAG_MASK;
-    if (rec->dropped)
-    {
-        Atomic::bitwiseAnd(&LostFlag, (uint32_t)~LOST_FLAG_MASK);
-    }
+    rec->reservedDropped = 0;
     rec->truncatedStr = 0;
     rec->truncatedData = dataTruncated ? 1 : 0;
     rec->reservedFlag = 0;
@@ -238,21 +340,16 @@ extern "C" void __AQLog_Write(AQLogLevel_t level, const char *componentId,
         memcpy(ptr, data, dataSize);
         ptr += dataSize;
     }
-    
-    memcpy(ptr, componentId, componentIdSize);
-    ptr += componentIdSize;
 
-    memcpy(ptr, tagId, tagIdSize);
-    ptr += tagIdSize;
-
-    memcpy(ptr, file, fileSize);
-    ptr += fileSize;
-
-    memcpy(ptr, ProcessName.c_str(), ProcessName.size() + 1);
-    ptr += ProcessName.size() + 1;
-
-    memcpy(ptr, func, funcSize);
-    ptr += funcSize;
+    for (i = 0; i < AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT; ++i)
+    {
+        rec->strId[i] = strId[i];
+        if (strId[i] == StringTable::INVALID_ID)
+        {
+            memcpy(ptr, str[i], strSize[i]);
+            ptr += strSize[i];
+        }
+    }
 
     // Now the message - this could fail as we didn't know the length
     // up-front.
@@ -266,9 +363,49 @@ extern "C" void __AQLog_Write(AQLogLevel_t level, const char *componentId,
 
     if (!Writer->commit(item))
     {
-        // Commit error - set the lost mask.
-        Atomic::bitwiseOr(&LostFlag, LOST_FLAG_MASK);
+        // Commit error - the record has been lost.
+        Drops->increment(strId[AQLOG_LOOKUP_TIER_COMPONENTID], level);
+    }
+}
+
+//------------------------------------------------------------------------------
+static uint32_t hashIndex(const char *str1, size_t str1Size, 
+    const char *str2, size_t str2Size, const char *str3, size_t str3Size)
+{
+    uint32_t tier0Hash = HashFunction::standard(AQLOG_TIER_0_MASK, str1, str1Size, AQLOG_LOOKUP_TIER_TAGID == 0);
+    uint32_t tier1Hash = HashFunction::standard(AQLOG_TIER_1_MASK, str2, str2Size, AQLOG_LOOKUP_TIER_TAGID == 1);
+    uint32_t tier2Hash = HashFunction::standard(AQLOG_TIER_2_MASK, str3, str3Size, AQLOG_LOOKUP_TIER_TAGID == 2);
+
+    return (tier0Hash << AQLOG_TIER_0_BITNUM)
+        | (tier1Hash << AQLOG_TIER_1_BITNUM)
+        | (tier2Hash << AQLOG_TIER_2_BITNUM);
+}
+
+//------------------------------------------------------------------------------
+static uint32_t processNameId(uint32_t tableEpoch)
+{
+    if (tableEpoch == 0)
+    {
+        return StringTable::INVALID_ID;
+    }
+    if (Atomic::read(&ProcessNameEpoch) != tableEpoch)
+    {
+        // Concurrent callers all intern the same string and so store the same
+        // identifier.
+        Atomic::write(&ProcessNameId, Strings->intern(ProcessName.c_str(), ProcessName.size()));
+        Atomic::write(&ProcessNameEpoch, tableEpoch);
+    }
+    return Atomic::read(&ProcessNameId);
+}
+
+//------------------------------------------------------------------------------
+static bool claimRecord(AQWriterItem& item, size_t reqSize, size_t reserveSize)
+{
+    if (reserveSize > 0 && Writer->availableSize() < reqSize + reserveSize)
+    {
+        return false;
     }
+    return Writer->claim(item, reqSize);
 }
 
 
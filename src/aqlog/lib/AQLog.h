@@ -69,8 +69,25 @@
     #define AQLOG_HASH_EXTERN_ATTRIBUTE
 #endif
 
+// Marks an intended fall through to the next case label.  A comment cannot be
+// used as the case labels are generated by macros.
+#if defined(__GNUC__) && __GNUC__ >= 7
+    #define AQLOG_FALLTHROUGH           __attribute__((fallthrough))
+#else
+    #define AQLOG_FALLTHROUGH
+#endif
+
+// Compilers that support constexpr can calculate the hash as a compile time
+// constant in every build mode, so neither the optimizer nor the inline 
+// functions are relied on.
+#if (defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1900)
+    #define AQLOG_HASH_USE_CONSTEXPR
+#endif
+
 // Select the function used for inlining.
-#if defined(AQLOG_HASH_USE_INLINE)
+#if defined(AQLOG_HASH_USE_CONSTEXPR)
+    #define AQLOG_HASHISLEVEL(__level_, __str1_, __str2_, __str3_)  AQLOG_HASHISLEVEL_CONSTEXPR(__level_, __str1_, __str2_, __str3_)
+#elif defined(AQLOG_HASH_USE_INLINE)
     #define AQLOG_HASHISLEVEL(__level_, __str1_, __str2_, __str3_)  AQLOG_HASHISLEVEL_INLINE(__level_, __str1_, __str2_, __str3_)
 #else
     #define AQLOG_HASHISLEVEL(__level_, __str1_, __str2_, __str3_)  AQLOG_HASHISLEVEL_EXTERN(__level_, __str1_, __str2_, __str3_)
@@ -120,10 +137,73 @@
                                                + AQLOG_TIER_2_BITS              \
                                                - AQLOG_HASH_INDEX_WORD_BITNUM))
 
-// The minimum acceptable size for the logging shared memory region.
-#define AQLOG_SHM_MINIMUM_SIZE          (  10 * 1024 + AQLOG_HASH_TABLE_WORDS   \
+// The log level hash memory holds two generations of the hash table after a
+// header.  The first header word is the generation counter; the table in use
+// is selected by its lowest bit.  The writer only ever changes the inactive
+// table then advances the counter.  The counter is also a sequence lock: a
+// producer that sees it change while reading a table word may have read from
+// a table that was being rebuilt, so it reads the word again.  The header 
+// fills a cache line so that the counter does not share one with the table.
+#define AQLOG_HASH_HEADER_WORDS         16
+#define AQLOG_HASH_MEMORY_WORDS         (  AQLOG_HASH_HEADER_WORDS              \
+                                         + 2 * AQLOG_HASH_TABLE_WORDS)
+
+// Reads the generation counter from the log level hash memory __mem_.
+#define AQLOG_HASH_GENERATION(__mem_)   ((uint32_t)*(const volatile uint32_t *)(__mem_))
+
+// Obtains the table in use from the log level hash memory __mem_.  Only for
+// use where the table cannot be rebuilt concurrently; producers read words 
+// with AQLog_HashWord().
+#define AQLOG_HASH_ACTIVE_TABLE(__mem_) ((__mem_) + AQLOG_HASH_HEADER_WORDS     \
+                                         + (AQLOG_HASH_GENERATION(__mem_) & 1)  \
+                                         * AQLOG_HASH_TABLE_WORDS)
+
+// Obtains the table for generation __gen_ from the log level hash memory 
+// __mem_.
+#define AQLOG_HASH_TABLE(__mem_, __gen_) ((const volatile uint32_t *)(__mem_)   \
+                                          + AQLOG_HASH_HEADER_WORDS             \
+                                          + ((__gen_) & 1)                      \
+                                          * AQLOG_HASH_TABLE_WORDS)
+
+// The number of slots in the string table; this is the maximum number of
+// distinct component, tag, file, function and process name strings that can
+// be interned.  Strings that do not fit are written into each record instead.
+#define AQLOG_STRING_TABLE_SLOTS        1024
+
+// The number of bytes used for the string table.  This includes the table
+// header, the slots and the heap that holds the string text.
+#define AQLOG_STRING_TABLE_SIZE         (32 * 1024)
+
+// The number of log levels.
+#define AQLOG_LEVEL_COUNT               8
+
+// The number of words in the bitmap of components with dropped records.
+#define AQLOG_DROP_DIRTY_WORDS          ((AQLOG_STRING_TABLE_SLOTS + 1 + 31) / 32)
+
+// The number of bytes used for the dropped record counters.  There is one
+// counter per log level for each component in the string table plus one set
+// for components that could not be interned, following a four word header.
+// The counters are followed by a bitmap that marks the components with 
+// counts so the consumer does not have to read every counter.
+#define AQLOG_DROP_COUNTERS_SIZE        ((4 + (AQLOG_STRING_TABLE_SLOTS + 1)     \
+                                          * AQLOG_LEVEL_COUNT                   \
+                                          + AQLOG_DROP_DIRTY_WORDS)             \
                                          * sizeof(uint32_t))
 
+// Records at this level or more severe may use the reserved region of the 
+// queue; less severe records are dropped rather than consume it.
+#define AQLOG_RESERVE_LEVEL             AQLOG_LEVEL_ERROR
+
+// The default size of the reserved region of the queue as a fraction of
+// the queue memory.
+#define AQLOG_RESERVE_DEFAULT_DIVISOR   8
+
+// The minimum acceptable size for the logging shared memory region.
+#define AQLOG_SHM_MINIMUM_SIZE          (  10 * 1024 + AQLOG_HASH_MEMORY_WORDS  \
+                                         * sizeof(uint32_t)                     \
+                                         + AQLOG_STRING_TABLE_SIZE              \
+                                         + AQLOG_DROP_COUNTERS_SIZE)
+
 
 // When allocating a record in the queue, allow for at least this number
 // of bytes for the message text.  If the message is larger then the item will
@@ -169,7 +249,8 @@ case __index_:
         __hash_ = AQLOG_HASH_STEP(__hash_,                                      \
                       AQLOG_HASH_CHARMAP(                                       \
                           AQLOG_HASH_CHAR(__index_, __str_, __size_)));         \
-    }
+    }                                                                           \
+    AQLOG_FALLTHROUGH;
 
 // Calculates the hash value of a string __str_ consisting of __size_ characters
 // in the string.  The hash is stored in the variable __hash_.
@@ -247,18 +328,49 @@ case __index_:
                                       __str3_, sizeof(__str3_) - 1)
 
 
+// Calculates the log level hash value for lookup strings __str1_, __str2_, and
+// __str3_ using the constexpr calculation method.  The table index is always a
+// compile time constant.
+#define AQLOG_HASHISLEVEL_CONSTEXPR(__level_, __str1_, __str2_, __str3_)        \
+    AQLog_SiteIsLevel(__level_, AQLogHashConstant<1 + AQLog_HashIndexConstexpr(  \
+                                    __str1_, sizeof(__str1_) - 1,               \
+                                    __str2_, sizeof(__str2_) - 1,               \
+                                    __str3_, sizeof(__str3_) - 1)>::value)
+
+
+// Determines if the call site __site_ for lookup strings __str1_, __str2_, and
+// __str3_ is enabled at __level_.  With constexpr support the hash table index
+// is a compile time constant and __site_ is not used.  The cache in 
+// AQLogCallSite_t::hashIndex is only for builds before C++11: the index is 
+// calculated the first time the call site is reached and cached in it.
+#if defined(AQLOG_HASH_USE_CONSTEXPR)
+#define AQLOG_SITEISLEVEL(__site_, __level_, __str1_, __str2_, __str3_)         \
+    AQLOG_HASHISLEVEL_CONSTEXPR(__level_, __str1_, __str2_, __str3_)
+#else
+#define AQLOG_SITEISLEVEL(__site_, __level_, __str1_, __str2_, __str3_)         \
+    AQLog_SiteIsLevel(__level_, (__site_)->hashIndex != 0                       \
+        ? (__site_)->hashIndex                                                  \
+        : AQLog_SiteHashIndex(__site_, __str1_, sizeof(__str1_) - 1,            \
+                                       __str2_, sizeof(__str2_) - 1,            \
+                                       __str3_, sizeof(__str3_) - 1))
+#endif
+
+
 // Helper macros for generating calls to __AQLog_Write() with log level pre-check.
 #define AQLOG_WRITE(level, tagId, fmt, ...)                                     \
-    AQLOG_WRITEDATA(level, tagId, NULL, 0, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(level, tagId, NULL, 0, fmt, ##__VA_ARGS__)
 #define AQLOG_WRITEDATA(level, tagId, data, dataSize, fmt, ...)                 \
 do                                                                              \
 {                                                                               \
-    if (AQLOG_HASHISLEVEL(level, AQLOG_COMPONENT_ID, tagId, __FILE__))          \
+    static AQLogCallSite_t __aqlog_site_;                                       \
+    if (AQLOG_SITEISLEVEL(&__aqlog_site_, level,                                \
+                          AQLOG_COMPONENT_ID, tagId, __FILE__))                 \
     {                                                                           \
-        __AQLog_Write(level, AQLOG_COMPONENT_ID, sizeof(AQLOG_COMPONENT_ID),    \
+        __AQLog_Write(&__aqlog_site_, level,                                    \
+                      AQLOG_COMPONENT_ID, sizeof(AQLOG_COMPONENT_ID),           \
                       tagId, sizeof(tagId), __FILE__, sizeof(__FILE__),         \
                       __FUNCTION__, sizeof(__FUNCTION__), __LINE__,             \
-                      data, dataSize, fmt, __VA_ARGS__);                        \
+                      data, dataSize, fmt, ##__VA_ARGS__);                      \
     }                                                                           \
 } while (0)
 
@@ -272,7 +384,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_Critical(fmt, ...)                                                \
-    AQLOG_WRITE(AQLOG_LEVEL_CRITICAL, "", fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_CRITICAL, "", fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_CRITICAL level to the log.  The log
@@ -285,7 +397,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TCritical(tag, fmt, ...)                                        \
-    AQLOG_WRITE(AQLOG_LEVEL_CRITICAL, #tag, fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_CRITICAL, #tag, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_CRITICAL level to the log with an 
@@ -299,7 +411,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_DCritical(data, dataSize, fmt, ...)                               \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_CRITICAL, "", data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_CRITICAL, "", data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_CRITICAL level to the log with an
@@ -315,7 +427,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDCritical(tag, data, dataSize, fmt, ...)                         \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_CRITICAL, #tag, data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_CRITICAL, #tag, data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_ERROR level to the log.  The log
@@ -326,7 +438,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_Error(fmt, ...)                                                \
-    AQLOG_WRITE(AQLOG_LEVEL_ERROR, "", fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_ERROR, "", fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_ERROR level to the log.  The log
@@ -339,7 +451,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TError(tag, fmt, ...)                                        \
-    AQLOG_WRITE(AQLOG_LEVEL_ERROR, #tag, fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_ERROR, #tag, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_ERROR level to the log with an
@@ -353,7 +465,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_DError(data, dataSize, fmt, ...)                               \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_ERROR, "", data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_ERROR, "", data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_ERROR level to the log with an
@@ -369,7 +481,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDError(tag, data, dataSize, fmt, ...)                         \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_ERROR, #tag, data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_ERROR, #tag, data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_WARNING level to the log.  The log
@@ -380,7 +492,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_Warning(fmt, ...)                                                \
-    AQLOG_WRITE(AQLOG_LEVEL_WARNING, "", fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_WARNING, "", fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_WARNING level to the log.  The log
@@ -393,7 +505,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TWarning(tag, fmt, ...)                                        \
-    AQLOG_WRITE(AQLOG_LEVEL_WARNING, #tag, fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_WARNING, #tag, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_WARNING level to the log with an
@@ -407,7 +519,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_DWarning(data, dataSize, fmt, ...)                               \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_WARNING, "", data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_WARNING, "", data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_WARNING level to the log with an
@@ -423,7 +535,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDWarning(tag, data, dataSize, fmt, ...)                         \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_WARNING, #tag, data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_WARNING, #tag, data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_NOTICE level to the log.  The log
@@ -434,7 +546,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_Notice(fmt, ...)                                                \
-    AQLOG_WRITE(AQLOG_LEVEL_NOTICE, "", fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_NOTICE, "", fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_NOTICE level to the log.  The log
@@ -447,7 +559,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TNotice(tag, fmt, ...)                                        \
-    AQLOG_WRITE(AQLOG_LEVEL_NOTICE, #tag, fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_NOTICE, #tag, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_NOTICE level to the log with an
@@ -461,7 +573,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_DNotice(data, dataSize, fmt, ...)                               \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_NOTICE, "", data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_NOTICE, "", data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_NOTICE level to the log with an
@@ -477,7 +589,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDNotice(tag, data, dataSize, fmt, ...)                         \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_NOTICE, #tag, data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_NOTICE, #tag, data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_INFO level to the log.  The log
@@ -488,7 +600,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_Info(fmt, ...)                                                \
-    AQLOG_WRITE(AQLOG_LEVEL_INFO, "", fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_INFO, "", fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_INFO level to the log.  The log
@@ -501,7 +613,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TInfo(tag, fmt, ...)                                        \
-    AQLOG_WRITE(AQLOG_LEVEL_INFO, #tag, fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_INFO, #tag, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_INFO level to the log with an
@@ -515,7 +627,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_DInfo(data, dataSize, fmt, ...)                               \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_INFO, "", data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_INFO, "", data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_INFO level to the log with an
@@ -531,7 +643,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDInfo(tag, data, dataSize, fmt, ...)                         \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_INFO, #tag, data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_INFO, #tag, data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_DETAIL level to the log.  The log
@@ -542,7 +654,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_Detail(fmt, ...)                                                \
-    AQLOG_WRITE(AQLOG_LEVEL_DETAIL, "", fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_DETAIL, "", fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_DETAIL level to the log.  The log
@@ -555,7 +667,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDetail(tag, fmt, ...)                                        \
-    AQLOG_WRITE(AQLOG_LEVEL_DETAIL, #tag, fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_DETAIL, #tag, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_DETAIL level to the log with an
@@ -569,7 +681,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_DDetail(data, dataSize, fmt, ...)                               \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_DETAIL, "", data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_DETAIL, "", data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_DETAIL level to the log with an
@@ -585,7 +697,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDDetail(tag, data, dataSize, fmt, ...)                         \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_DETAIL, #tag, data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_DETAIL, #tag, data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_DEBUG level to the log.  The log
@@ -596,7 +708,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_Debug(fmt, ...)                                                \
-    AQLOG_WRITE(AQLOG_LEVEL_DEBUG, "", fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_DEBUG, "", fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_DEBUG level to the log.  The log
@@ -609,7 +721,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDebug(tag, fmt, ...)                                        \
-    AQLOG_WRITE(AQLOG_LEVEL_DEBUG, #tag, fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_DEBUG, #tag, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_DEBUG level to the log with an
@@ -623,7 +735,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_DDebug(data, dataSize, fmt, ...)                               \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_DEBUG, "", data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_DEBUG, "", data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_DEBUG level to the log with an
@@ -639,7 +751,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDDebug(tag, data, dataSize, fmt, ...)                         \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_DEBUG, #tag, data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_DEBUG, #tag, data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_TRACE level to the log.  The log
@@ -650,7 +762,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_Trace(fmt, ...)                                                \
-    AQLOG_WRITE(AQLOG_LEVEL_TRACE, "", fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_TRACE, "", fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_TRACE level to the log.  The log
@@ -663,7 +775,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TTrace(tag, fmt, ...)                                        \
-    AQLOG_WRITE(AQLOG_LEVEL_TRACE, #tag, fmt, __VA_ARGS__)
+    AQLOG_WRITE(AQLOG_LEVEL_TRACE, #tag, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_TRACE level to the log with an
@@ -677,7 +789,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_DTrace(data, dataSize, fmt, ...)                               \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_TRACE, "", data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_TRACE, "", data, dataSize, fmt, ##__VA_ARGS__)
 
 /**
  * Writes a message at the AQLOG_LEVEL_TRACE level to the log with an
@@ -693,7 +805,7 @@ do
  * @param ... The formatting arguments for the log message.
  */
 #define AQLog_TDTrace(tag, data, dataSize, fmt, ...)                         \
-    AQLOG_WRITEDATA(AQLOG_LEVEL_TRACE, #tag, data, dataSize, fmt, __VA_ARGS__)
+    AQLOG_WRITEDATA(AQLOG_LEVEL_TRACE, #tag, data, dataSize, fmt, ##__VA_ARGS__)
 
 
 
@@ -777,12 +889,37 @@ typedef enum AQLOG_INITOUTCOME_T
 } AQLogInitOutcome_t;
 
 
+// Holds the state kept for each logging statement.  An instance is declared
+// static at each call site by AQLOG_WRITEDATA() and so starts zero-filled.
+typedef struct AQLOG_CALLSITE_T
+{
+    // One more than the log level hash table index for the call site strings,
+    // or zero if it has not yet been calculated.  The index depends only on
+    // the strings so it never needs to be recalculated.  Only used by builds
+    // without AQLOG_HASH_USE_CONSTEXPR, where the index is not a compile time
+    // constant; it is always present so that the layout does not depend on
+    // the language standard.
+    volatile uint32_t hashIndex;
+
+    // The string table epoch that the identifiers in strId[] were interned
+    // against.  When this does not match the current epoch the identifiers 
+    // are stale and must be interned again.
+    volatile uint32_t epoch;
+
+    // The string table identifiers for each of the call site strings, indexed
+    // by the lookup or extra tier.  The process name entry is not used.
+    uint32_t strId[AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT];
+
+} AQLogCallSite_t;
+
+
 //------------------------------------------------------------------------------
 // Exported Variable Declarations
 //------------------------------------------------------------------------------
 
-// The hash table that is used to lookup the log level based on component, tag
-// and line.
+// The log level hash memory that is used to lookup the log level based on 
+// component, tag and line.  Words are read from the table in use with 
+// AQLog_HashWord().
 extern const uint32_t *AQLog_LevelHashTable_g;
 
 
@@ -792,6 +929,25 @@ extern const uint32_t *AQLog_LevelHashTable_g;
 // Exported Function and Class Declarations
 //------------------------------------------------------------------------------
 
+// Reads word 'word' of the log level hash table in use.  The generation is
+// read before and after the word; volatile loads are not reordered by the
+// compiler and loads are not reordered with each other by the processor, so
+// if it is unchanged the word came from a table that was not being rebuilt.
+static inline uint32_t AQLog_HashWord(uint32_t word)
+{
+    uint32_t gen = AQLOG_HASH_GENERATION(AQLog_LevelHashTable_g);
+    for (;;)
+    {
+        uint32_t value = AQLOG_HASH_TABLE(AQLog_LevelHashTable_g, gen)[word];
+        uint32_t check = AQLOG_HASH_GENERATION(AQLog_LevelHashTable_g);
+        if (check == gen)
+        {
+            return value;
+        }
+        gen = check;
+    }
+}
+
 // Calculates the log level hash value for lookup strings str1, str2, and
 // str3 using the inline calculation method.  The lengths represent the number
 // of characters in the string that participate in the hash.
@@ -815,9 +971,84 @@ AQLOG_HASH_INLINE_ATTRIBUTE bool AQLog_HashIsLevelInline(int level,
     uint32_t word = index >> AQLOG_HASH_INDEX_WORD_BITNUM;
     uint32_t bitnum = (index & AQLOG_HASH_INDEX_LEVEL_MASK) << AQLOG_HASH_LEVEL_BITS_MUL_SHIFT;
 
-    return (AQLog_LevelHashTable_g[word] & (AQLOG_HASH_LEVEL_MASK << bitnum)) >= ((uint32_t)level << bitnum);
+    return (AQLog_HashWord(word) & (AQLOG_HASH_LEVEL_MASK << bitnum)) >= ((uint32_t)level << bitnum);
+}
+
+#if defined(AQLOG_HASH_USE_CONSTEXPR)
+// Steps the hash 'hash' over the characters of 'str' from index 'i' - 1 down to
+// index 'limit', stopping early at a path separator.
+static constexpr uint32_t AQLog_HashTierStepConstexpr(const char *str, size_t i, 
+    size_t limit, uint32_t hash)
+{
+    return (i <= limit || AQLOG_HASH_ISEND(str[i - 1])) 
+        ? hash 
+        : AQLog_HashTierStepConstexpr(str, i - 1, limit, 
+              AQLOG_HASH_STEP(hash, AQLOG_HASH_CHARMAP(str[i - 1])));
+}
+
+// Replaces a zero masked hash 'hash' of string 'str' of 'size' characters by
+// a non-zero value if 'rehashZero' is set.
+static constexpr uint32_t AQLog_HashTierRehashConstexpr(const char *str, 
+    size_t size, uint32_t mask, bool rehashZero, uint32_t hash)
+{
+    return (hash != 0 || !rehashZero) 
+        ? hash 
+        : ((str[size - 1] & mask) != 0 ? (str[size - 1] & mask) : 1);
+}
+
+// Calculates the hash value of a string 'str' consisting of 'size' characters
+// exactly as HashFunction::standard() does, but as a constant expression.
+static constexpr uint32_t AQLog_HashTierConstexpr(uint32_t mask, const char *str, 
+    size_t size, bool rehashZero)
+{
+    return (size == 0 && rehashZero)
+        ? 0
+        : AQLog_HashTierRehashConstexpr(str, size, mask, rehashZero, mask 
+              & AQLog_HashTierStepConstexpr(str, size, 
+                    size > AQLOG_HASH_CHARMAX ? size - AQLOG_HASH_CHARMAX : 0, 
+                    AQLOG_HASH_INIT));
+}
+
+// Calculates the log level hash table index for lookup strings str1, str2, 
+// and str3 as a constant expression.
+static constexpr uint32_t AQLog_HashIndexConstexpr(
+    const char *str1, size_t str1Size,
+    const char *str2, size_t str2Size,
+    const char *str3, size_t str3Size)
+{
+    return (AQLog_HashTierConstexpr(AQLOG_TIER_0_MASK, str1, str1Size, AQLOG_LOOKUP_TIER_TAGID == 0) << AQLOG_TIER_0_BITNUM)
+        | (AQLog_HashTierConstexpr(AQLOG_TIER_1_MASK, str2, str2Size, AQLOG_LOOKUP_TIER_TAGID == 1) << AQLOG_TIER_1_BITNUM)
+        | (AQLog_HashTierConstexpr(AQLOG_TIER_2_MASK, str3, str3Size, AQLOG_LOOKUP_TIER_TAGID == 2) << AQLOG_TIER_2_BITNUM);
+}
+
+// Holds the compile time constant 'V'.  Used as a template argument the value
+// must be evaluated by the compiler whatever the optimization level.
+template<uint32_t V> struct AQLogHashConstant
+{
+    static const uint32_t value = V;
+};
+#endif
+
+// Determines if the call site with hash table index 'siteIndex' is enabled
+// at 'level'.  The index is one more than the table index, as calculated by
+// AQLog_HashIndexConstexpr() or cached in AQLogCallSite_t::hashIndex.
+static inline bool AQLog_SiteIsLevel(int level, uint32_t siteIndex)
+{
+    uint32_t index = siteIndex - 1;
+    uint32_t word = index >> AQLOG_HASH_INDEX_WORD_BITNUM;
+    uint32_t bitnum = (index & AQLOG_HASH_INDEX_LEVEL_MASK) << AQLOG_HASH_LEVEL_BITS_MUL_SHIFT;
+
+    return (AQLog_HashWord(word) & (AQLOG_HASH_LEVEL_MASK << bitnum)) >= ((uint32_t)level << bitnum);
 }
 
+// Calculates the log level hash table index for lookup strings str1, str2,
+// and str3, stores one more than it in the call site 'site' and returns the
+// stored value.  The lengths represent the number of characters in the 
+// string that participate in the hash.  Only called by AQLOG_SITEISLEVEL() in
+// builds without AQLOG_HASH_USE_CONSTEXPR; the library always provides it so
+// that it can be linked with code built to either standard.
+extern "C" uint32_t AQLog_SiteHashIndex(AQLogCallSite_t *site, const char *str1, size_t str1Size, const char *str2, size_t str2Size, const char *str3, size_t str3Size);
+
 // Calculates the log level hash value for lookup strings str1, str2, and
 // str3 using the exernal function calculation method.  The lengths represent 
 // the number of characters in the string that participate in the hash.
@@ -836,13 +1067,15 @@ extern "C" AQLogInitOutcome_t AQLog_InitSharedMemory(IAQSharedMemory& sm);
 extern "C" void AQLog_Deinit(void);
 
 // The single entry-point for actually writing a log message into the shared
-// log buffer.  
-extern "C" void __AQLog_Write(AQLogLevel_t level, const char *componentId,
-    size_t componentIdSize, const char *tagId, size_t tagIdSize,
-    const char *file, size_t fileSize, const char *func, size_t funcSize,
-    int line, const void *data, size_t dataSize, const char *msg, ...)
+// log buffer.  The call site caches the string table identifiers for the
+// static strings; if it is NULL every string is written into the record.
+extern "C" void __AQLog_Write(AQLogCallSite_t *site, AQLogLevel_t level,
+    const char *componentId, size_t componentIdSize, const char *tagId, 
+    size_t tagIdSize, const char *file, size_t fileSize, const char *func,
+    size_t funcSize, int line, const void *data, size_t dataSize, 
+    const char *msg, ...)
 #ifdef __GNUC__
-    __attribute__((format(printf, 13, 14)))
+    __attribute__((format(printf, 14, 15)))
 #endif
     ;
 
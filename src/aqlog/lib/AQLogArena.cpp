@@ -0,0 +1,126 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "AQLogArena.h"
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const size_t AQLogArena::FIRST_BLOCK_SIZE;
+const uint32_t AQLogArena::MAX_SHIFT_BITS;
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+AQLogArena::AQLogArena(void)
+    : m_nextBlock(0)
+    , m_free(NULL)
+    , m_end(NULL)
+{
+}
+
+//------------------------------------------------------------------------------
+AQLogArena::~AQLogArena(void)
+{
+    for (size_t i = 0; i < m_blocks.size(); ++i)
+    {
+        delete[] m_blocks[i].start;
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t AQLogArena::capacity(void) const
+{
+    size_t size = 0;
+    for (size_t i = 0; i < m_blocks.size(); ++i)
+    {
+        size += m_blocks[i].size;
+    }
+    return size;
+}
+
+//------------------------------------------------------------------------------
+char *AQLogArena::nextBlock(size_t len)
+{
+    // Look for a retained block that is large enough, moving it into the
+    // next position so that the smaller blocks it skipped over are still
+    // available to later allocations.
+    size_t idx = m_nextBlock;
+    while (idx < m_blocks.size() && m_blocks[idx].size < len)
+    {
+        idx++;
+    }
+
+    if (idx < m_blocks.size())
+    {
+        Block b = m_blocks[idx];
+        m_blocks[idx] = m_blocks[m_nextBlock];
+        m_blocks[m_nextBlock] = b;
+    }
+    else
+    {
+        uint32_t bitShift = m_blocks.size() < MAX_SHIFT_BITS
+            ? (uint32_t)m_blocks.size() : MAX_SHIFT_BITS;
+        size_t size = FIRST_BLOCK_SIZE << bitShift;
+        if (size < len)
+        {
+            size = len;
+        }
+
+        Block b = { new char[size], size };
+        m_blocks.insert(m_blocks.begin() + m_nextBlock, b);
+    }
+
+    const Block& b = m_blocks[m_nextBlock++];
+    m_free = b.start;
+    m_end = b.start + b.size;
+    return m_free;
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,188 @@
+#ifndef AQLOGARENA_H
+#define AQLOGARENA_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+/**
+* Provides a bump allocator for the character data held by a string builder.
+*
+* Memory is handed out from a chain of blocks and is only returned when the
+* arena is reset.  Resetting keeps every block so that once an arena has grown
+* to fit the largest working set it is used for, it never allocates again.
+* An arena is not thread safe; each thread that formats log records should use
+* its own.
+*/
+class AQLogArena
+{
+public:
+
+    // The size in bytes of the first block allocated by the arena.
+    static const size_t FIRST_BLOCK_SIZE = 256;
+
+    // Each block after the first is FIRST_BLOCK_SIZE << (number of blocks)
+    // bytes in size, with the shift limited to this value.
+    static const uint32_t MAX_SHIFT_BITS = 8;
+
+    /**
+     * Constructs a new arena.  No memory is allocated until the first call to
+     * alloc() or reserve().
+     */
+    AQLogArena(void);
+
+    /**
+     * Destroys this arena, freeing all of its blocks.
+     */
+    ~AQLogArena(void);
+
+private:
+    // No implementation provided - arenas cannot be copied or assigned.
+    AQLogArena(const AQLogArena& other);
+    AQLogArena& operator=(const AQLogArena& other);
+
+public:
+
+    /**
+     * Allocates 'len' bytes from this arena.  The memory remains valid until
+     * reset() is called or the arena is destroyed.
+     *
+     * @param len The number of bytes to allocate.
+     * @return The allocated memory.
+     */
+    char *alloc(size_t len)
+    {
+        char *str = reserve(len);
+        m_free += len;
+        return str;
+    }
+
+    /**
+     * Obtains at least 'len' bytes of contiguous memory without allocating
+     * it.  The caller may write into the memory then call commit() to keep
+     * some or all of it; the memory is reused by the next allocation
+     * otherwise.
+     *
+     * @param len The number of bytes required.
+     * @return The start of the memory.
+     */
+    char *reserve(size_t len)
+    {
+        if (len <= (size_t)(m_end - m_free))
+        {
+            return m_free;
+        }
+        return nextBlock(len);
+    }
+
+    /**
+     * Allocates the first 'len' bytes returned by the most recent call to
+     * reserve().
+     *
+     * @param len The number of bytes to keep; no more than was reserved.
+     */
+    void commit(size_t len) { m_free += len; }
+
+    /**
+     * Releases all memory allocated from this arena.  The blocks are kept for
+     * reuse so this takes constant time.
+     */
+    void reset(void)
+    {
+        if (m_blocks.size() > 0)
+        {
+            m_free = m_blocks[0].start;
+            m_end = m_free + m_blocks[0].size;
+            m_nextBlock = 1;
+        }
+    }
+
+    /**
+     * Obtains the number of blocks held by this arena.
+     *
+     * @return The block count.
+     */
+    size_t blockCount(void) const { return m_blocks.size(); }
+
+    /**
+     * Obtains the total number of bytes held by this arena across all of
+     * its blocks.
+     *
+     * @return The capacity in bytes.
+     */
+    size_t capacity(void) const;
+
+private:
+
+    // A block of memory owned by the arena.
+    struct Block
+    {
+        // The start of the block.
+        char *start;
+
+        // The size of the block in bytes.
+        size_t size;
+    };
+
+    // Moves to the next retained block with at least 'len' bytes, allocating
+    // a new block if there is none, and returns its start.
+    char *nextBlock(size_t len);
+
+    // The blocks in the order they are used.
+    std::vector<Block> m_blocks;
+
+    // The index of the block to use once the current block is full.
+    size_t m_nextBlock;
+
+    // The first free byte in the current block.
+    char *m_free;
+
+    // The end of the current block.
+    char *m_end;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -11,6 +11,14 @@
 
 #include "AQLogConsumer.h"
 
+#include "LogDispatcher.h"
+
+#include "Atomic.h"
+
+#include <stdexcept>
+
+using namespace aqlog;
+using namespace aqosa;
 using namespace std;
 
 
@@ -48,6 +56,91 @@ using namespace std;
 // Function and Class Implementation
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+AQLogConsumer::AQLogConsumer(IAQSharedMemory& sm)
+    : m_logDispatcher(new LogDispatcher(sm))
+    , m_runState(RUN_STATE_STOPPED)
+{
+}
+
+//------------------------------------------------------------------------------
+AQLogConsumer::~AQLogConsumer(void)
+{
+    stop();
+    delete m_logDispatcher;
+}
+
+//------------------------------------------------------------------------------
+void AQLogConsumer::startAsync(void)
+{
+    beginRunning(RUN_STATE_ASYNC);
+    if (!m_logDispatcher->start())
+    {
+        Atomic::write(&m_runState, RUN_STATE_STOPPED);
+        throw runtime_error("Cannot create log consumer thread");
+    }
+}
+
+//------------------------------------------------------------------------------
+void AQLogConsumer::execute(void)
+{
+    beginRunning(RUN_STATE_EXECUTE);
+    m_logDispatcher->run();
+    Atomic::write(&m_runState, RUN_STATE_STOPPED);
+}
+
+//------------------------------------------------------------------------------
+void AQLogConsumer::stop(void)
+{
+    uint32_t state = Atomic::read(&m_runState);
+    if (state == RUN_STATE_ASYNC)
+    {
+        m_logDispatcher->stop();
+        m_logDispatcher->join();
+        Atomic::write(&m_runState, RUN_STATE_STOPPED);
+    }
+    else if (state == RUN_STATE_EXECUTE)
+    {
+        m_logDispatcher->stop();
+    }
+}
+
+//------------------------------------------------------------------------------
+void AQLogConsumer::addHandler(AQLogHandler *handler)
+{
+    if (Atomic::read(&m_runState) != RUN_STATE_STOPPED)
+    {
+        throw domain_error("Cannot add a log handler while the log consumer is running");
+    }
+    m_logDispatcher->addHandler(handler);
+}
+
+//------------------------------------------------------------------------------
+void AQLogConsumer::removeHandler(AQLogHandler *handler)
+{
+    if (Atomic::read(&m_runState) != RUN_STATE_STOPPED)
+    {
+        throw domain_error("Cannot remove a log handler while the log consumer is running");
+    }
+    m_logDispatcher->removeHandler(handler);
+}
+
+//------------------------------------------------------------------------------
+uint32_t AQLogConsumer::droppedCount(const AQLogHandler *handler) const
+{
+    return m_logDispatcher->droppedCount(handler);
+}
+
+//------------------------------------------------------------------------------
+void AQLogConsumer::beginRunning(RunState state)
+{
+    if (Atomic::cmpXchg(&m_runState, state, RUN_STATE_STOPPED) != RUN_STATE_STOPPED)
+    {
+        throw domain_error("The log consumer is already running");
+    }
+}
+
+
 
 
 //=============================== End of File ==================================
@@ -11,6 +11,8 @@
 // Includes
 //------------------------------------------------------------------------------
 
+#include <stdint.h>
+
 
 
 
@@ -26,6 +28,7 @@
 //------------------------------------------------------------------------------
 
 // Forward declarations.
+class AQLogHandler;
 class IAQSharedMemory;
 namespace aqlog
 {
@@ -77,9 +80,29 @@ private:
 
 private:
 
+    // The states that the consumer can be in.
+    enum RunState
+    {
+        // The consumer is not running.
+        RUN_STATE_STOPPED = 0,
+
+        // The consumer is running in its own thread due to startAsync().
+        RUN_STATE_ASYNC,
+
+        // The consumer is running in the context of a call to execute().
+        RUN_STATE_EXECUTE,
+    };
+
+    // Moves from the stopped state to 'state' throwing a domain_error if 
+    // the consumer is already running.
+    void beginRunning(RunState state);
+
     // The actual log record dispatcher.
     aqlog::LogDispatcher *m_logDispatcher;
 
+    // The current RunState of this consumer.
+    volatile uint32_t m_runState;
+
 public:
 
     /**
@@ -108,6 +131,47 @@ public:
      */
     void execute(void);
 
+    /**
+     * Stops the execution of this log consumer.  If the consumer was started
+     * with startAsync() this waits for its thread to finish; if it was 
+     * started with execute() this causes execute() to return.  Records that
+     * have already been passed to log handlers are handled before the
+     * consumer stops.  Does nothing if the consumer is not running.
+     */
+    void stop(void);
+
+    /**
+     * Adds a log handler to this consumer.  Log records that match any of
+     * the handler's filters are passed to it.  Each handler is called from
+     * its own thread so a slow handler does not delay the others.
+     *
+     * @param handler The handler to add.  It must remain valid until it is
+     * removed or this consumer is destroyed.
+     *
+     * @throws domain_error If the consumer is running.
+     */
+    void addHandler(AQLogHandler *handler);
+
+    /**
+     * Removes a log handler from this consumer.
+     *
+     * @param handler The handler to remove.
+     *
+     * @throws domain_error If the consumer is running.
+     */
+    void removeHandler(AQLogHandler *handler);
+
+    /**
+     * Gets the number of log records that were not passed to a handler 
+     * because it was too far behind.  May be called at any time.
+     *
+     * @param handler The handler to get the count for.
+     *
+     * @returns The number of records dropped for the handler or 0 if it has
+     * not been added to this consumer.
+     */
+    uint32_t droppedCount(const AQLogHandler *handler) const;
+
 };
 
 
@@ -0,0 +1,103 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "AQLogFdHandler.h"
+
+#include "AQLogFormatter.h"
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const size_t AQLogFdHandler::DEFAULT_BATCH_SIZE;
+const size_t AQLogFdHandler::MAX_WRITE_IOV;
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+AQLogFdHandler::AQLogFdHandler(int fd, const AQLogFormatter& formatter,
+    size_t batchSize)
+    : m_fd(fd)
+    , m_formatter(formatter)
+    , m_batchSize(batchSize > 0 ? batchSize : 1)
+    , m_writeCount(0)
+    , m_errorCount(0)
+{
+}
+
+//------------------------------------------------------------------------------
+AQLogFdHandler::~AQLogFdHandler(void)
+{
+    // Nothing is written here; the batch may refer to records that have
+    // already been released if flush() was never called.
+}
+
+//------------------------------------------------------------------------------
+void AQLogFdHandler::handle(const AQLogRecord& rec)
+{
+    m_formatter.format(rec, m_batch);
+    m_batch.appendCopy("\n", 1);
+
+    // The records remain valid until flush() so a full batch can be written
+    // out early.
+    if (m_batch.iovCount() >= MAX_WRITE_IOV)
+    {
+        writeBatch();
+    }
+}
+
+//------------------------------------------------------------------------------
+void AQLogFdHandler::flush(void)
+{
+    if (m_batch.size() > 0)
+    {
+        writeBatch();
+    }
+}
+
+
+
+
+//=============================== End of File ==================================
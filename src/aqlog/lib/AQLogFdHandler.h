@@ -0,0 +1,159 @@
+#ifndef AQLOGFDHANDLER_H
+#define AQLOGFDHANDLER_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "AQLogHandler.h"
+#include "AQLogStringBuilder.h"
+
+#include <stdint.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class AQLogFormatter;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+/**
+ * A log handler that writes each record as a line to a file descriptor.
+ *
+ * Records are formatted into a single string builder and the whole batch is
+ * written with one gathering write when the handler is flushed.  The
+ * builder's I/O vectors are passed straight to the write so the formatted
+ * text is never flattened into a single buffer; adjacent segments are
+ * coalesced by the builder to keep the vector count down.  If a batch grows
+ * to MAX_WRITE_IOV vectors it is written out early.
+ */
+class AQLogFdHandler : public AQLogHandler
+{
+public:
+
+    // The default number of records that are written in each batch.
+    static const size_t DEFAULT_BATCH_SIZE = 64;
+
+    // The largest number of I/O vectors passed to a single write call.
+    static const size_t MAX_WRITE_IOV = 1024;
+
+    /**
+     * Constructs a new file descriptor log handler.
+     *
+     * @param fd The file descriptor to write to.  It is not closed by this
+     * handler.
+     * @param formatter The formatter used to format each record.  It must
+     * remain valid for the lifetime of this handler.
+     * @param batchSize The largest number of records written by each write
+     * call.
+     */
+    AQLogFdHandler(int fd, const AQLogFormatter& formatter, 
+        size_t batchSize = DEFAULT_BATCH_SIZE);
+
+    /**
+     * Destroys this log handler.
+     */
+    virtual ~AQLogFdHandler(void);
+
+private:
+    // No implementation provided - handlers cannot be copied or assigned.
+    AQLogFdHandler(const AQLogFdHandler& other);
+    AQLogFdHandler& operator=(const AQLogFdHandler& other);
+
+public:
+
+    /**
+     * Formats a record into the current batch.
+     *
+     * @param rec The record to handle.
+     */
+    virtual void handle(const AQLogRecord& rec);
+
+    /**
+     * Obtains the number of records written in each batch.
+     *
+     * @return The batch size.
+     */
+    virtual size_t batchSize(void) const { return m_batchSize; }
+
+    /**
+     * Writes out the current batch.
+     */
+    virtual void flush(void);
+
+    /**
+     * Obtains the number of write calls made by this handler.
+     *
+     * @return The write count.
+     */
+    uint32_t writeCount(void) const { return m_writeCount; }
+
+    /**
+     * Obtains the number of write calls that failed.  The rest of the batch
+     * being written is discarded on failure.
+     *
+     * @return The error count.
+     */
+    uint32_t errorCount(void) const { return m_errorCount; }
+
+private:
+
+    // Writes the content of the batch to the file descriptor then clears
+    // the batch.
+    void writeBatch(void);
+
+    // The file descriptor to write to.
+    int m_fd;
+
+    // The formatter for the records.
+    const AQLogFormatter& m_formatter;
+
+    // The number of records written in each batch.
+    size_t m_batchSize;
+
+    // The formatted records waiting to be written.
+    AQLogStringBuilder m_batch;
+
+    // The number of write calls made.
+    uint32_t m_writeCount;
+
+    // The number of write calls that failed.
+    uint32_t m_errorCount;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
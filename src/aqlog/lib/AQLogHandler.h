@@ -122,6 +122,28 @@ public:
      */
     virtual void handle(const AQLogRecord& rec) = 0;
 
+    /**
+     * Obtains the largest number of records that are passed to handle()
+     * before flush() is called.  Each record passed to handle() remains valid
+     * until the following call to flush() returns, so a handler that batches
+     * its output may refer to the record content until then.
+     *
+     * The default implementation returns 1 so that flush() is called after
+     * every record.
+     *
+     * @return The batch size.
+     */
+    virtual size_t batchSize(void) const { return 1; }
+
+    /**
+     * Called after a batch of records has been passed to handle(); either
+     * batchSize() records have been handled or there are no more records
+     * waiting.  Handlers that buffer their output write it out here.
+     *
+     * The default implementation does nothing.
+     */
+    virtual void flush(void) { }
+
 private:
 
     // The filters for this handler.
@@ -11,7 +11,12 @@
 
 #include "AQLogRecord.h"
 
+#include "StringTable.h"
+
 #include "Timer.h"
+#include "Timestamp.h"
+
+#include <string.h>
 
 using namespace aqosa;
 using namespace std;
@@ -52,10 +57,19 @@ using namespace std;
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-AQLogRecord::AQLogRecord(void)
+AQLogRecord::AQLogRecord(const aqlog::StringTable *strings)
     : m_level(AQLOG_LEVEL_CRITICAL)
+    , m_strings(strings)
     , m_overlay(NULL)
     , m_processTimeMs(0)
+    , m_droppedCount(0)
+    , m_reorderPrev(NULL)
+    , m_reorderNext(NULL)
+    , m_reorderKeyNs(0)
+    , m_reorderSeq(0)
+    , m_reorderAged(false)
+    , m_readerState(0)
+    , m_dispatchRefs(0)
 {
 }
 
@@ -63,8 +77,17 @@ AQLogRecord::AQLogRecord(void)
 AQLogRecord::AQLogRecord(AQLogLevel_t level, const char *componentId,
     const char *tagId, const char *file)
     : m_level(level)
+    , m_strings(NULL)
     , m_overlay(NULL)
     , m_processTimeMs(0)
+    , m_droppedCount(0)
+    , m_reorderPrev(NULL)
+    , m_reorderNext(NULL)
+    , m_reorderKeyNs(0)
+    , m_reorderSeq(0)
+    , m_reorderAged(false)
+    , m_readerState(0)
+    , m_dispatchRefs(0)
 {
     m_tierId[AQLOG_LOOKUP_TIER_COMPONENTID] = componentId;
     m_tierId[AQLOG_LOOKUP_TIER_TAGID] = tagId;
@@ -81,6 +104,7 @@ AQLogRecord::PopulateOutcome AQLogRecord::populate(void)
 {
     m_message.clear();
     m_processTimeMs = Timer::start();
+    m_droppedCount = 0;
 
     // Check the item - make sure it is valid.
     if (!m_item.isCommitted())
@@ -111,15 +135,27 @@ AQLogRecord::PopulateOutcome AQLogRecord::populate(void)
     size_t strLen = m_item.size() - offsetof(Overlay, strData) - m_overlay->dataSize;
     for (int i = 0; i < AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT; ++i)
     {
-        size_t len = 1 + strnlen(str, strLen);
-        if (len > strLen)
+        if (m_overlay->strId[i] != 0)
+        {
+            // Interned string - resolve it from the string table.
+            m_tierId[i] = m_strings == NULL ? NULL : m_strings->lookup(m_overlay->strId[i]);
+            if (m_tierId[i] == NULL)
+            {
+                return (PopulateOutcome)(POPULATE_ERROR_TRUNCATED_COMPONENT_ID + i);
+            }
+        }
+        else
         {
-            // Out of space in the buffer.  Looks to be corrupted.
-            return (PopulateOutcome)(POPULATE_ERROR_TRUNCATED_COMPONENT_ID + i);
+            size_t len = 1 + strnlen(str, strLen);
+            if (len > strLen)
+            {
+                // Out of space in the buffer.  Looks to be corrupted.
+                return (PopulateOutcome)(POPULATE_ERROR_TRUNCATED_COMPONENT_ID + i);
+            }
+            m_tierId[i] = str;
+            str += len;
+            strLen -= len;
         }
-        m_tierId[i] = str;
-        str += len;
-        strLen -= len;
     }
 
     // Obtain the message.
@@ -137,6 +173,30 @@ AQLogRecord::PopulateOutcome AQLogRecord::populate(void)
     return POPULATE_SUCCESS;
 }
 
+//------------------------------------------------------------------------------
+void AQLogRecord::populateDropReport(AQLogLevel_t level, const char *componentId,
+    uint32_t count)
+{
+    m_message.clear();
+    m_processTimeMs = Timer::start();
+    m_droppedCount = count;
+
+    memset(&m_dropOverlay, 0, sizeof(m_dropOverlay));
+    m_dropOverlay.timestampNs = Timestamp::now();
+    m_dropOverlay.logLevel = level;
+    m_overlay = &m_dropOverlay;
+    m_level = level;
+
+    m_tierId[AQLOG_LOOKUP_TIER_COMPONENTID] = componentId;
+    m_tierId[AQLOG_LOOKUP_TIER_TAGID] = "";
+    m_tierId[AQLOG_LOOKUP_TIER_FILE] = "";
+    m_tierId[AQLOG_EXTRA_TIER_PROCESS_NAME] = "";
+    m_tierId[AQLOG_EXTRA_TIER_FUNCTION] = "";
+
+    m_message.appendf("%u record%s dropped due to lack of log queue space", 
+        count, count == 1 ? "" : "s");
+}
+
 
 
 
@@ -37,6 +37,7 @@
 
 // Forward declarations.
 class AQLogHandler;
+namespace aqlog { class LogDispatcher; class LogReader; class ReorderBuffer; class StringTable; }
 
 
 
@@ -80,9 +81,9 @@ public:
         // If set to '1' then the strings in this log record have been truncated.
         uint32_t truncatedStr : 1;
 
-        // If set to '1' then at least one message has been dropped from the log
-        // due to an out-of-space condition before this one was published.
-        uint32_t dropped : 1;
+        // Reserved for future use; formerly flagged that an earlier record
+        // had been dropped.  Drops are now counted in shared memory.
+        uint32_t reservedDropped : 1;
 
         // Reserved for future use.
         uint32_t reservedFlag : 1;
@@ -96,14 +97,19 @@ public:
         // The line number where this log record was generated.
         uint32_t lineNumber : 24;
 
+        // The string table identifiers for the component, tag, file, process
+        // name and function strings (in that order).  An identifier of 0 means
+        // the string is held in the string data region instead.
+        uint32_t strId[AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT];
+
         // The string data region for this log record.  The string data region
         // is constructed as follows:
         //  {data} - {dataSize} bytes
-        //  "processName" '\0'
-        //  "componentId" '\0'
-        //  "tagId"       '\0'  (only if hasTag is '1')
-        //  "file"        '\0'
-        //  "function"    '\0'
+        //  "componentId" '\0'  (only if strId[0] is 0)
+        //  "tagId"       '\0'  (only if strId[1] is 0)
+        //  "file"        '\0'  (only if strId[2] is 0)
+        //  "processName" '\0'  (only if strId[3] is 0)
+        //  "function"    '\0'  (only if strId[4] is 0)
         //  "message"     '\0'
         char strData[1];
 
@@ -111,8 +117,9 @@ public:
 
 public:
 
-    // Create a new empty AQLogRecord object.
-    AQLogRecord(void);
+    // Create a new empty AQLogRecord object.  Records that reference interned
+    // strings are resolved using the passed string table.
+    AQLogRecord(const aqlog::StringTable *strings = NULL);
     
     // Creates a new record.  This constructor is used for unit testing only,
     // it just sets the passed level and IDs.
@@ -153,23 +160,23 @@ public:
         POPULATE_ERROR_TRUNCATED_DATA,
 
         // Population failed due to this record not containing enough bytes
-        // for the component ID.
+        // for, or a valid string table identifier of, the component ID.
         POPULATE_ERROR_TRUNCATED_COMPONENT_ID,
 
         // Population failed due to this record not containing enough bytes
-        // for the tag ID.
+        // for, or a valid string table identifier of, the tag ID.
         POPULATE_ERROR_TRUNCATED_TAG_ID,
 
         // Population failed due to this record not containing enough bytes
-        // for the source file name.
+        // for, or a valid string table identifier of, the source file name.
         POPULATE_ERROR_TRUNCATED_FILE,
 
         // Population failed due to this record not containing enough bytes
-        // for the process name.
+        // for, or a valid string table identifier of, the process name.
         POPULATE_ERROR_TRUNCATED_PROCESS_NAME,
 
         // Population failed due to this record not containing enough bytes
-        // for the function name.
+        // for, or a valid string table identifier of, the function name.
         POPULATE_ERROR_TRUNCATED_FUNCTION,
 
         // The number of possible outcomes for population.
@@ -180,21 +187,27 @@ public:
     // Populates the fields of this record with the current content of the AQ item.
     PopulateOutcome populate(void);
 
+    // Populates the fields of this record as a report that 'count' records
+    // logged at 'level' by component 'componentId' have been dropped.  The
+    // record does not use the AQ item.
+    void populateDropReport(AQLogLevel_t level, const char *componentId, 
+        uint32_t count);
+
     // The monotonic clock time when this item was processed in milliseconds.
     uint32_t processTimeMs(void) const { return m_processTimeMs; }
 
     // Gets the identifier used at a particular filter tier 'idx'.
     const char *tierId(size_t idx) const { return m_tierId[idx]; }
 
-    // Returns true if this record also reports that a previous record has been
-    // dropped in its entirity due to an out of space condition.
-    bool isReportingOutOfSpaceDrop(void) const { return !!m_overlay->dropped; }
 
 private:
 
     // The log level for this record.
     AQLogLevel_t m_level;
 
+    // The string table used to resolve interned strings.
+    const aqlog::StringTable *m_strings;
+
     // The tier look-up for the log record at each look-up level.
     const char *m_tierId[AQLOG_LOOKUP_TIER_COUNT + AQLOG_EXTRA_TIER_COUNT];
 
@@ -207,9 +220,44 @@ private:
     // The monotonic clock time when this item was processed in milliseconds.
     uint32_t m_processTimeMs;
 
+    // The number of dropped records reported by this record; 0 if this is a
+    // record read from the queue.
+    uint32_t m_droppedCount;
+
+    // The overlay used when this record is a drop report.
+    Overlay m_dropOverlay;
+
     // The message for this record.
     AQLogStringBuilder m_message;
 
+    // The remaining fields are owned by the log reader that allocated this
+    // record and are used to track it without any further allocation.
+    friend class aqlog::LogDispatcher;
+    friend class aqlog::LogReader;
+    friend class aqlog::ReorderBuffer;
+
+    // The previous record in arrival order while this record is pending.
+    AQLogRecord *m_reorderPrev;
+
+    // The next record in arrival order while this record is pending, or the
+    // next free record while this record is on the free list.
+    AQLogRecord *m_reorderNext;
+
+    // The timestamp used to order this record while it is pending.
+    uint64_t m_reorderKeyNs;
+
+    // The arrival sequence number used to order records with equal keys.
+    uint32_t m_reorderSeq;
+
+    // Set once this record has been pending for the maximum hold time.
+    bool m_reorderAged;
+
+    // The state of this record in the log reader.
+    uint32_t m_readerState;
+
+    // The number of log dispatcher workers still handling this record.
+    uint32_t m_dispatchRefs;
+
 public:
 
     /**
@@ -320,6 +368,23 @@ public:
      */
     bool isMessageTruncated(void) const { return !!m_overlay->truncatedStr; }
 
+    /**
+     * Determines if this record was generated by the log consumer to report
+     * that records were dropped because the log queue was out of space.  The
+     * record has the level and component identifier of the dropped records;
+     * the remaining identifiers are empty.
+     *
+     * @return True if this record is a drop report.
+     */
+    bool isDropReport(void) const { return m_droppedCount > 0; }
+
+    /**
+     * Obtains the number of records this drop report is reporting.
+     *
+     * @return The number of dropped records, or 0 if isDropReport() is false.
+     */
+    uint32_t droppedCount(void) const { return m_droppedCount; }
+
     /**
      * Obtains the message for this log record.
      *
@@ -27,6 +27,10 @@ using namespace std;
 // The base size of the memory to allocated for dynamic strftime generation.
 #define STRFTIME_DCOPY_BASE_SIZE        512
 
+// The largest amount of memory to try for dynamic strftime generation before
+// assuming the format produces an empty string.
+#define STRFTIME_DCOPY_MAX_SIZE         65536
+
 
 
 
@@ -59,9 +63,6 @@ using namespace std;
 AQLogStringBuilder::AQLogStringBuilder(void)
     : m_options(OPTION_COALESCE_ADJACENT_IOV)
     , m_scopyPos(0)
-    , m_dcopy(NULL)
-    , m_dcopyFree(NULL)
-    , m_dcopyFreeSize(0)
     , m_totalSize(0)
 {
 }
@@ -70,9 +71,6 @@ AQLogStringBuilder::AQLogStringBuilder(void)
 AQLogStringBuilder::AQLogStringBuilder(uint32_t options)
     : m_options(options)
     , m_scopyPos(0)
-    , m_dcopy(NULL)
-    , m_dcopyFree(NULL)
-    , m_dcopyFreeSize(0)
     , m_totalSize(0)
 {
 }
@@ -81,9 +79,6 @@ AQLogStringBuilder::AQLogStringBuilder(uint32_t options)
 AQLogStringBuilder::AQLogStringBuilder(const AQLogStringBuilder& other)
     : m_options(other.m_options)
     , m_scopyPos(0)
-    , m_dcopy(NULL)
-    , m_dcopyFree(NULL)
-    , m_dcopyFreeSize(0)
     , m_totalSize(0)
 {
     appendCopy(other);
@@ -104,10 +99,6 @@ AQLogStringBuilder &AQLogStringBuilder::operator=(const AQLogStringBuilder& othe
 AQLogStringBuilder::~AQLogStringBuilder(void)
 {
     clear();
-    if (m_dcopy != NULL)
-    {
-        delete m_dcopy;
-    }
 }
 
 //------------------------------------------------------------------------------
@@ -117,18 +108,15 @@ AQLogStringBuilder& AQLogStringBuilder::clear(void)
     m_vect.clear();
     m_totalSize = 0;
 
-    // Clear the copied strings.
+    // Clear the copied strings.  The vector and arena keep their memory so
+    // that refilling this builder does not allocate.
     m_scopyPos = 0;
-    if (m_dcopy != NULL)
+    m_arena.reset();
+    for (size_t i = 0; i < m_freeList.size(); ++i)
     {
-        for (size_t i = 0; i < m_dcopy->size(); ++i)
-        {
-            free((*m_dcopy)[i]);
-        }
-        m_dcopy->clear();
+        free(m_freeList[i]);
     }
-    m_dcopyFree = NULL;
-    m_dcopyFreeSize = 0;
+    m_freeList.clear();
     return *this;
 }
 
@@ -165,11 +153,7 @@ AQLogStringBuilder& AQLogStringBuilder::appendFree(char *str, size_t len)
         return *this;
     }
 
-    if (m_dcopy == NULL)
-    {
-        m_dcopy = new vector<char *>();
-    }
-    m_dcopy->push_back(str);
+    m_freeList.push_back(str);
     appendPointer(str, len);
     return *this;
 }
@@ -290,11 +274,7 @@ AQLogStringBuilder& AQLogStringBuilder::insertFree(const iterator& pos, char *st
         return *this;
     }
 
-    if (m_dcopy == NULL)
-    {
-        m_dcopy = new vector<char *>();
-    }
-    m_dcopy->push_back(str);
+    m_freeList.push_back(str);
     insertPointer(pos, str, len);
     return *this;
 }
@@ -576,42 +556,10 @@ char *AQLogStringBuilder::allocString(size_t len)
         str = &m_scopy[m_scopyPos];
         m_scopyPos += len;
     }
-    else if (len <= m_dcopyFreeSize)
-    {
-        // Allocate from the most recent dynamic buffer.
-        str = m_dcopyFree;
-        m_dcopyFreeSize -= len;
-        m_dcopyFree += len;
-    }
     else
     {
-        // Allocate a new dynamic buffer.
-        if (m_dcopy == NULL)
-        {
-            m_dcopy = new vector<char *>();
-        }
-
-        uint32_t bitShift = m_dcopy->size();
-        if (bitShift > DCOPY_MAX_SHIFT_BITS)
-        {
-            bitShift = DCOPY_MAX_SHIFT_BITS;
-        }
-        size_t minSize = DCOPY_FIRST_SIZE << bitShift;
-
-        if (len >= minSize || minSize - len <= m_dcopyFreeSize)
-        {
-            // Don't overallocate - we get no benefit from it at this 
-            // point.
-            str = (char *)malloc(len);
-        }
-        else
-        {
-            // Overallocate and use the rest for the m_dcopyFree.
-            str = (char *)malloc(minSize);
-            m_dcopyFreeSize = minSize - len;
-            m_dcopyFree = &str[len];
-        }
-        m_dcopy->push_back(str);
+        // Allocate from the arena.
+        str = m_arena.alloc(len);
     }
     return str;
 }
@@ -633,32 +581,20 @@ const char *AQLogStringBuilder::allocStrftime(const char *fmt, const struct tm *
         }
     }
 
-    // Not enough space available.  Have to allocate dynamically.
+    // Not enough space available.  Format into the arena, doubling the
+    // space reserved until the result fits.
     availLen = STRFTIME_DCOPY_BASE_SIZE;
-    char *str = (char *)malloc(availLen);
-    while ((strLen = strftime(str, availLen, fmt, tm)) == 0)
+    char *str;
+    while ((strLen = strftime(str = m_arena.reserve(availLen), availLen, fmt, tm)) == 0)
     {
-        availLen <<= 1;
-        char *newStr = (char *)realloc(str, availLen);
-        if (newStr == NULL)
+        if (availLen >= STRFTIME_DCOPY_MAX_SIZE)
         {
-            free(str);
+            // The format produces an empty string.
             return NULL;
         }
-        str = newStr;
-    }
-    char *newStr = (char *)realloc(str, strLen);
-    if (newStr != NULL)
-    {
-        str = newStr;
-    }
-
-    // Add to the dynamic allocation list.
-    if (m_dcopy == NULL)
-    {
-        m_dcopy = new vector<char *>();
+        availLen <<= 1;
     }
-    m_dcopy->push_back(str);
+    m_arena.commit(strLen);
     return str;
 }
 
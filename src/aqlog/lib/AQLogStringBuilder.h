@@ -18,6 +18,10 @@
 #include <string.h>
 #include <time.h>
 
+#include "AQLogArena.h"
+
+#include <cstddef>
+#include <iterator>
 #include <ostream>
 #include <vector>
 #include <string>
@@ -74,8 +78,17 @@ public:
      * Defines the iterator that is used to access and navigate a formatted
      * string.
      */
-    class iterator : public std::iterator<std::bidirectional_iterator_tag, char>
+    class iterator
     {
+    public:
+
+        // The iterator traits; std::iterator is deprecated as a base class.
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef char value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef char *pointer;
+        typedef char& reference;
+
     private:
 
         // Constructs a new iterator with no associated data.
@@ -442,6 +455,29 @@ public:
             return total;
         }
 
+        /**
+         * Obtains the characters that follow this iterator contiguously in
+         * memory; that is up to the end of the vector it points into.  This
+         * allows the string to be scanned a vector at a time rather than a
+         * character at a time.
+         *
+         * @param len Set to the number of contiguous characters, or 0 if this
+         * iterator is at the end of the string.
+         * @return A pointer to the character referenced by this iterator, or
+         * NULL if it is at the end of the string.
+         */
+        const char *contiguous(size_t& len) const
+        {
+            if (m_vectIdx < m_fm->m_vect.size())
+            {
+                const struct iovec& iov = vect();
+                len = iov.iov_len - m_vectOff;
+                return &((const char *)iov.iov_base)[m_vectOff];
+            }
+            len = 0;
+            return NULL;
+        }
+
     private:
 
         // Returns the vector currently pointed at by this iterator.
@@ -531,7 +567,9 @@ public:
     iterator end(void) const { return iterator(*this, m_vect.size(), 0); }
 
     /**
-     * Clears this string builder, reducing its size to 0.
+     * Clears this string builder, reducing its size to 0.  The memory used to
+     * hold copied strings is kept for reuse, so a builder that is cleared and
+     * refilled with similar content does not allocate.
      *
      * @returns A reference to this string builder.
      */
@@ -1164,6 +1202,24 @@ public:
      */
     size_t iovCount(void) const { return m_vect.size(); }
 
+    /**
+     * Obtains the I/O vectors that make up this string builder so that it can
+     * be written out without first being copied.  The array has iovCount()
+     * entries, each with the same layout as a POSIX struct iovec, and remains
+     * valid until this string builder is next changed.
+     *
+     * @returns The I/O vectors, or NULL if this string builder is empty.
+     */
+    const void *iov(void) const { return m_vect.size() > 0 ? &m_vect[0] : NULL; }
+
+    /**
+     * Obtains the arena that holds the strings copied into this string
+     * builder.
+     *
+     * @returns The arena.
+     */
+    const AQLogArena& arena(void) const { return m_arena; }
+
     /**
      * Writes this entire string builder into a character array.  The character array
      * is provided by the caller of a fixed size.  If the entire string builder cannot
@@ -1204,13 +1260,6 @@ private:
     // The number of bytes to allocated statically for the static copy buffer.
     static const size_t SCOPY_SIZE = 64;
 
-    // The number of bytes to allocate to the first dynamic copy buffer.
-    static const size_t DCOPY_FIRST_SIZE = 256;
-
-    // When allocating dcopy buffers after the first, each buffer is 
-    // DCOPY_FIRST_SIZE << (number of buffers) with a maximum of this value.
-    static const uint32_t DCOPY_MAX_SHIFT_BITS = 8;
-
     // The configuration options for this string builder.
     uint32_t m_options;
 
@@ -1223,17 +1272,13 @@ private:
     // The position of the next copy out of the static copy buffer.
     size_t m_scopyPos;
 
-    // The array of dynamically allocated buffers holding strings that were copied into this string builder.
-    std::vector<char *> *m_dcopy;
-
-    // Pointer to the first free (unused) byte in a dynamically allocated
-    // character array.  The array (start) is already in the m_dcopy
-    // list.
-    char *m_dcopyFree;
+    // The arena holding strings that were copied into this string builder
+    // once the static copy buffer is full.
+    AQLogArena m_arena;
 
-    // The amount of space remaining in the m_dcopyFree dynamically allocated character
-    // array.
-    size_t m_dcopyFreeSize;
+    // The strings passed to appendFree() or insertFree(), to be freed when
+    // this string builder is cleared.
+    std::vector<char *> m_freeList;
 
     // The total size of the string builder.
     size_t m_totalSize;
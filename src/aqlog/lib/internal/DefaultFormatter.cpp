@@ -11,6 +11,15 @@
 
 #include "DefaultFormatter.h"
 
+#include "AQLogRecord.h"
+#include "AQLogStringBuilder.h"
+
+#include "HexDump.h"
+
+#include <string.h>
+
+#include <stdexcept>
+
 using namespace std;
 
 namespace aqlog
@@ -23,6 +32,22 @@ namespace aqlog
 // Private Macros
 //------------------------------------------------------------------------------
 
+// The strftime() format of the cached date and time.
+#define SECOND_PREFIX_FORMAT            "%Y-%m-%d %H:%M:%S"
+
+// The length of the cached date and time: YYYY-MM-DD HH:MM:SS
+#define SECOND_PREFIX_LEN               19
+
+// The length of a formatted timestamp: the cached prefix then ".mmm".
+#define TIMESTAMP_LEN                   (SECOND_PREFIX_LEN + 4)
+
+// Storage that is separate for each thread.
+#ifdef _WIN32
+#define THREAD_LOCAL                    __declspec(thread)
+#else
+#define THREAD_LOCAL                    __thread
+#endif
+
 
 
 
@@ -44,6 +69,32 @@ namespace aqlog
 // Variable Declarations
 //------------------------------------------------------------------------------
 
+const char *const DefaultFormatter::DEFAULT_PATTERN = "%T %L [%c/%t] %f:%n %m%d";
+
+// The names of each log level.
+static const char *const LEVEL_NAMES[AQLOG_LEVEL_COUNT] =
+{
+    "CRITICAL",
+    "ERROR",
+    "WARNING",
+    "NOTICE",
+    "INFO",
+    "DETAIL",
+    "DEBUG",
+    "TRACE",
+};
+
+// The name used for a level that is out of range.
+static const char UNKNOWN_LEVEL_NAME[] = "UNKNOWN";
+
+// The second held in CachedSecondPrefix by this thread, or -1 if none has been
+// formatted.  The prefix format is fixed so the cache is shared by every
+// formatter used on the thread.
+static THREAD_LOCAL time_t CachedSecond = -1;
+
+// The formatted date and time for CachedSecond.
+static THREAD_LOCAL char CachedSecondPrefix[SECOND_PREFIX_LEN + 1];
+
 
 
 
@@ -52,9 +103,55 @@ namespace aqlog
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-DefaultFormatter::DefaultFormatter(void)
+DefaultFormatter::DefaultFormatter(const char *pattern)
 {
-
+    // Literal text is gathered into a single string first, and the offsets
+    // recorded, as the string may move while it grows.
+    const char *literal = pattern;
+    const char *p = pattern;
+    while (*p != '\0')
+    {
+        if (*p != '%')
+        {
+            p++;
+            continue;
+        }
+
+        OpType type;
+        switch (p[1])
+        {
+        case 'T': type = OP_TIMESTAMP; break;
+        case 'L': type = OP_LEVEL; break;
+        case 'c': type = OP_COMPONENT_ID; break;
+        case 't': type = OP_TAG_ID; break;
+        case 'f': type = OP_FILE; break;
+        case 'n': type = OP_LINE_NUMBER; break;
+        case 'F': type = OP_FUNCTION; break;
+        case 'p': type = OP_PROCESS_NAME; break;
+        case 'P': type = OP_PROCESS_ID; break;
+        case 'i': type = OP_THREAD_ID; break;
+        case 'm': type = OP_MESSAGE; break;
+        case 'd': type = OP_DATA; break;
+        case '%': type = OP_LITERAL; break;
+        default:
+            throw invalid_argument(string("Unknown log format directive in pattern: ") + pattern);
+        }
+
+        if (type == OP_LITERAL)
+        {
+            // Keep the first '%' as part of the literal text.
+            addLiteral(literal, p + 1 - literal);
+        }
+        else
+        {
+            addLiteral(literal, p - literal);
+            Op op = { type, 0, 0 };
+            m_ops.push_back(op);
+        }
+        p += 2;
+        literal = p;
+    }
+    addLiteral(literal, p - literal);
 }
 
 //------------------------------------------------------------------------------
@@ -65,9 +162,137 @@ DefaultFormatter::~DefaultFormatter(void)
 //------------------------------------------------------------------------------
 void DefaultFormatter::format(const AQLogRecord& rec, AQLogStringBuilder& sb) const
 {
+    const char *literals = m_literals.data();
+    for (size_t i = 0; i < m_ops.size(); ++i)
+    {
+        const Op& op = m_ops[i];
+        switch (op.type)
+        {
+        case OP_LITERAL:
+            sb.appendPointer(&literals[op.offset], op.len);
+            break;
+
+        case OP_TIMESTAMP:
+            appendTimestamp(rec.timestampNs(), sb);
+            break;
+
+        case OP_LEVEL:
+            if ((uint32_t)rec.level() < AQLOG_LEVEL_COUNT)
+            {
+                sb.appendPointer(LEVEL_NAMES[rec.level()]);
+            }
+            else
+            {
+                sb.appendPointer(UNKNOWN_LEVEL_NAME, sizeof(UNKNOWN_LEVEL_NAME) - 1);
+            }
+            break;
+
+        case OP_COMPONENT_ID:
+            sb.appendPointer(rec.componentId());
+            break;
+
+        case OP_TAG_ID:
+            sb.appendPointer(rec.tagId());
+            break;
+
+        case OP_FILE:
+            sb.appendPointer(rec.file());
+            break;
+
+        case OP_LINE_NUMBER:
+            appendDecimal(rec.lineNumber(), sb);
+            break;
+
+        case OP_FUNCTION:
+            sb.appendPointer(rec.function());
+            break;
+
+        case OP_PROCESS_NAME:
+            sb.appendPointer(rec.processName());
+            break;
+
+        case OP_PROCESS_ID:
+            appendDecimal(rec.processId(), sb);
+            break;
+
+        case OP_THREAD_ID:
+            appendDecimal(rec.threadId(), sb);
+            break;
+
+        case OP_MESSAGE:
+            sb.appendPointer(rec.message());
+            break;
+
+        case OP_DATA:
+            HexDump::appendHexDump(rec.data(), rec.dataSize(), rec.isDataTruncated(), sb);
+            break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void DefaultFormatter::addLiteral(const char *str, size_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+    // Merge with the previous literal where possible; '%%' splits the text.
+    if (m_ops.size() > 0 && m_ops.back().type == OP_LITERAL)
+    {
+        m_ops.back().len += len;
+    }
+    else
+    {
+        Op op = { OP_LITERAL, m_literals.size(), len };
+        m_ops.push_back(op);
+    }
+    m_literals.append(str, len);
+}
 
+//------------------------------------------------------------------------------
+void DefaultFormatter::appendTimestamp(uint64_t ns, AQLogStringBuilder& sb) const
+{
+    time_t second = (time_t)(ns / 1000000000);
+    uint32_t ms = (uint32_t)((ns / 1000000) % 1000);
+
+    // Only convert to local time once per second on each thread.  The prefix
+    // is copied into the string builder as the cache changes while the
+    // builder may still be in use.
+    if (second != CachedSecond)
+    {
+        AQLogStringBuilder prefix;
+        prefix.appendftime(SECOND_PREFIX_FORMAT, second);
+        prefix.toCharArray(CachedSecondPrefix, sizeof(CachedSecondPrefix));
+        for (size_t i = prefix.size(); i < SECOND_PREFIX_LEN; ++i)
+        {
+            CachedSecondPrefix[i] = ' ';
+        }
+        CachedSecondPrefix[SECOND_PREFIX_LEN] = '\0';
+        CachedSecond = second;
+    }
+
+    char *str = sb.appendEmpty(TIMESTAMP_LEN);
+    memcpy(str, CachedSecondPrefix, SECOND_PREFIX_LEN);
+    str[SECOND_PREFIX_LEN] = '.';
+    str[SECOND_PREFIX_LEN + 1] = (char)('0' + ms / 100);
+    str[SECOND_PREFIX_LEN + 2] = (char)('0' + (ms / 10) % 10);
+    str[SECOND_PREFIX_LEN + 3] = (char)('0' + ms % 10);
 }
 
+//------------------------------------------------------------------------------
+void DefaultFormatter::appendDecimal(uint32_t value, AQLogStringBuilder& sb)
+{
+    char buf[10];
+    size_t pos = sizeof(buf);
+    do
+    {
+        buf[--pos] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    sb.appendCopy(&buf[pos], sizeof(buf) - pos);
+}
 
 
 
@@ -13,6 +13,12 @@
 
 #include "AQLogFormatter.h"
 
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
 
 
 
@@ -45,16 +51,36 @@
 // specified for a given log handler.  The default log formatter is designed
 // to produce human-readable text output.
 //
-// There are no configurable options for the default log formatter and for this
-// reason it is not possible to directy construct run; rather simply do not set
-// the log formatter for a particular handler and it will fall back to the
-// default log formtter.
+// The output is described by a pattern that is parsed once, when the formatter
+// is constructed, into a list of operations.  Each directive in the pattern is
+// replaced by a field of the record:
+//  %T  The timestamp as local time: YYYY-MM-DD HH:MM:SS.mmm
+//  %L  The log level name.
+//  %c  The component identifier.
+//  %t  The tag identifier.
+//  %f  The file name.
+//  %n  The line number.
+//  %F  The function name.
+//  %p  The process name.
+//  %P  The process identifier.
+//  %i  The thread identifier.
+//  %m  The message.
+//  %d  The data attached to the record as a hex dump on the following lines;
+//      nothing if there is none.
+//  %%  A literal '%'.
+// String fields and the message are added to the string builder by pointer so
+// they are never copied.  The date and time of the most recent second formatted
+// is cached per thread, so one formatter may be shared by several handlers.
 namespace aqlog { class DefaultFormatter : public AQLogFormatter
 {
 public:
 
-    // Constructs a default formatter.
-    DefaultFormatter(void);
+    // The pattern used when none is specified.
+    static const char *const DEFAULT_PATTERN;
+
+    // Constructs a formatter for 'pattern'.  Throws invalid_argument if the
+    // pattern contains an unknown directive.
+    DefaultFormatter(const char *pattern = DEFAULT_PATTERN);
 
 private:
     // Duplication and assignment are not supported.
@@ -68,6 +94,52 @@ public:
     // Formats the a log record into a string builder.
     virtual void format(const AQLogRecord& rec, AQLogStringBuilder& sb) const;
 
+private:
+
+    // The operations a pattern is compiled into.
+    enum OpType
+    {
+        OP_LITERAL,
+        OP_TIMESTAMP,
+        OP_LEVEL,
+        OP_COMPONENT_ID,
+        OP_TAG_ID,
+        OP_FILE,
+        OP_LINE_NUMBER,
+        OP_FUNCTION,
+        OP_PROCESS_NAME,
+        OP_PROCESS_ID,
+        OP_THREAD_ID,
+        OP_MESSAGE,
+        OP_DATA,
+    };
+
+    // A single compiled operation.
+    struct Op
+    {
+        // The operation to perform.
+        OpType type;
+
+        // For OP_LITERAL the offset and length of the text in m_literals.
+        size_t offset;
+        size_t len;
+    };
+
+    // Adds a literal operation for 'len' characters of 'str'.
+    void addLiteral(const char *str, size_t len);
+
+    // Appends the timestamp 'ns' to 'sb'.
+    void appendTimestamp(uint64_t ns, AQLogStringBuilder& sb) const;
+
+    // Appends the decimal representation of 'value' to 'sb'.
+    static void appendDecimal(uint32_t value, AQLogStringBuilder& sb);
+
+    // The operations in the order they are applied.
+    std::vector<Op> m_ops;
+
+    // The literal text from the pattern.
+    std::string m_literals;
+
 };}
 
 
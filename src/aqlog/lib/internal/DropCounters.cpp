@@ -0,0 +1,202 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "DropCounters.h"
+
+#include "Atomic.h"
+
+#include "IAQSharedMemory.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <string.h>
+
+using namespace aqosa;
+using namespace std;
+
+namespace aqlog
+{
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const uint32_t DropCounters::FORMAT_VERSION_INVALID;
+const uint32_t DropCounters::FORMAT_VERSION_1;
+const uint32_t DropCounters::COMPONENT_COUNT;
+const uint32_t DropCounters::DIRTY_WORDS;
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+DropCounters::DropCounters(IAQSharedMemory& sm)
+    : m_header((Header *)sm.baseAddress())
+    , m_counters((volatile uint32_t *)&m_header[1])
+    , m_dirty(&m_counters[COMPONENT_COUNT * AQLOG_LEVEL_COUNT])
+{
+    if (sm.size() < AQLOG_DROP_COUNTERS_SIZE)
+    {
+        ostringstream ss;
+
+        ss << "The drop counter memory must be at least " << AQLOG_DROP_COUNTERS_SIZE
+           << " bytes in size, however the provided shared memory region was only " << sm.size();
+        throw length_error(ss.str());
+    }
+}
+
+//------------------------------------------------------------------------------
+DropCounters::~DropCounters(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void DropCounters::format(size_t reserveSize)
+{
+    Atomic::write(&m_header->formatVersion, FORMAT_VERSION_INVALID);
+
+    m_header->reserveSize = (uint32_t)reserveSize;
+    m_header->totalCount = 0;
+    m_header->reserved = 0;
+    memset((void *)m_counters, 0, COMPONENT_COUNT * AQLOG_LEVEL_COUNT * sizeof(uint32_t));
+    memset((void *)m_dirty, 0, DIRTY_WORDS * sizeof(uint32_t));
+
+    Atomic::write(&m_header->formatVersion, FORMAT_VERSION_1);
+}
+
+//------------------------------------------------------------------------------
+bool DropCounters::isFormatted(void) const
+{
+    return Atomic::read(&m_header->formatVersion) == FORMAT_VERSION_1;
+}
+
+//------------------------------------------------------------------------------
+void DropCounters::setReserveSize(size_t reserveSize)
+{
+    Atomic::write(&m_header->reserveSize, (uint32_t)reserveSize);
+}
+
+//------------------------------------------------------------------------------
+size_t DropCounters::reserveSize(AQLogLevel_t level) const
+{
+    if (level <= AQLOG_RESERVE_LEVEL || !isFormatted())
+    {
+        return 0;
+    }
+    return Atomic::read(&m_header->reserveSize);
+}
+
+//------------------------------------------------------------------------------
+void DropCounters::increment(uint32_t componentId, AQLogLevel_t level)
+{
+    if (isFormatted())
+    {
+        // The counter is incremented before the component is marked and the
+        // total so that a consumer that sees either always finds the count.
+        // A consumer that clears the mark between the two finds the count on
+        // its next pass.
+        if (componentId >= COMPONENT_COUNT)
+        {
+            componentId = 0;
+        }
+        Atomic::increment(counter(componentId, level));
+        Atomic::bitwiseOr(&m_dirty[componentId >> 5], 1U << (componentId & 31));
+        Atomic::increment(&m_header->totalCount);
+    }
+}
+
+//------------------------------------------------------------------------------
+uint32_t DropCounters::totalCount(void) const
+{
+    return Atomic::read(&m_header->totalCount);
+}
+
+//------------------------------------------------------------------------------
+uint32_t DropCounters::take(uint32_t componentId, AQLogLevel_t level)
+{
+    volatile uint32_t *c = counter(componentId, level);
+    uint32_t count = Atomic::read(c);
+    while (count != 0)
+    {
+        uint32_t prev = Atomic::cmpXchg(c, 0, count);
+        if (prev == count)
+        {
+            break;
+        }
+        count = prev;
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+uint32_t DropCounters::takeDirty(uint32_t word)
+{
+    volatile uint32_t *d = &m_dirty[word];
+    uint32_t bits = Atomic::read(d);
+    while (bits != 0)
+    {
+        uint32_t prev = Atomic::cmpXchg(d, 0, bits);
+        if (prev == bits)
+        {
+            break;
+        }
+        bits = prev;
+    }
+    return bits;
+}
+
+//------------------------------------------------------------------------------
+volatile uint32_t *DropCounters::counter(uint32_t componentId, AQLogLevel_t level) const
+{
+    if (componentId >= COMPONENT_COUNT)
+    {
+        componentId = 0;
+    }
+    return &m_counters[componentId * AQLOG_LEVEL_COUNT + (level & (AQLOG_LEVEL_COUNT - 1))];
+}
+
+
+
+
+}
+//=============================== End of File ==================================
@@ -0,0 +1,164 @@
+#ifndef DROPCOUNTERS_H
+#define DROPCOUNTERS_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "AQLog.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class IAQSharedMemory;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Counts the log records dropped by producers because the queue was out of
+// space.  The counters are held in shared memory with one counter for each
+// log level of each component; the component is identified by its string
+// table identifier with index 0 used for components that were not interned.
+//
+// A bitmap marks the components whose counters may be non-zero, so that the
+// consumer only reads the counters of components that have dropped records.
+//
+// The region also holds the size of the queue reserve: records less severe
+// than AQLOG_RESERVE_LEVEL are dropped rather than claim space that would
+// leave less than this number of bytes available.
+namespace aqlog { class DropCounters
+{
+public:
+
+    // Used in the 'formatVersion' field to indicate that this memory is not
+    // formatted.
+    static const uint32_t FORMAT_VERSION_INVALID = 0x00000000;
+
+    // Used in the 'formatVersion' field to indicate the V1 format.
+    static const uint32_t FORMAT_VERSION_1 = 0x00000001;
+
+    // The number of components that have counters.
+    static const uint32_t COMPONENT_COUNT = AQLOG_STRING_TABLE_SLOTS + 1;
+
+    // The number of words in the bitmap of components with counts.
+    static const uint32_t DIRTY_WORDS = AQLOG_DROP_DIRTY_WORDS;
+
+    // Constructs a new set of drop counters that use the passed shared memory
+    // region.  If the passed shared memory region is too small a length_error
+    // exception is thrown.
+    DropCounters(IAQSharedMemory& sm);
+
+    // Destroys these drop counters.
+    ~DropCounters(void);
+
+private:
+    // No implementation provided - drop counters cannot be copied or assigned.
+    DropCounters(const DropCounters& other);
+    DropCounters& operator=(const DropCounters& other);
+
+private:
+
+    // The header at the start of the drop counter memory.
+    struct Header
+    {
+        // The version of the counters; FORMAT_VERSION_1 once formatted.
+        volatile uint32_t formatVersion;
+
+        // The number of bytes in the queue reserved for severe records.
+        volatile uint32_t reserveSize;
+
+        // The total number of records ever dropped; wraps on overflow.
+        volatile uint32_t totalCount;
+
+        // Reserved for future use.
+        uint32_t reserved;
+    };
+
+public:
+
+    // Formats the drop counters, clearing all counts and setting the reserve
+    // size.  This must only be called by the log consumer.
+    void format(size_t reserveSize);
+
+    // Returns true if the drop counters have been formatted.
+    bool isFormatted(void) const;
+
+    // Sets the number of bytes in the queue reserved for severe records.
+    void setReserveSize(size_t reserveSize);
+
+    // Returns the number of bytes in the queue that a record at 'level' may
+    // not consume.  This is 0 for severe records or if unformatted.
+    size_t reserveSize(AQLogLevel_t level) const;
+
+    // Counts a record dropped at 'level' by the component with string table
+    // identifier 'componentId'.
+    void increment(uint32_t componentId, AQLogLevel_t level);
+
+    // Returns the total number of records ever dropped.  The value wraps so
+    // it is only useful to detect that more records have been dropped.
+    uint32_t totalCount(void) const;
+
+    // Returns the number of records dropped at 'level' by the component with
+    // string table identifier 'componentId' and atomically resets the count
+    // to 0.
+    uint32_t take(uint32_t componentId, AQLogLevel_t level);
+
+    // Returns the bits for components 32 * 'word' to 32 * 'word' + 31 that 
+    // may have counts and atomically clears them.  Bit 'n' is set if the
+    // component 32 * 'word' + n has had a record dropped since the bit was
+    // last taken.
+    uint32_t takeDirty(uint32_t word);
+
+private:
+
+    // Returns the counter for the passed component and level.
+    volatile uint32_t *counter(uint32_t componentId, AQLogLevel_t level) const;
+
+    // The header for the counters.
+    Header *m_header;
+
+    // The counters, indexed by component then level.
+    volatile uint32_t *m_counters;
+
+    // The bitmap of components that may have counts.
+    volatile uint32_t *m_dirty;
+
+};}
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -0,0 +1,159 @@
+#ifndef HANDLERSET_H
+#define HANDLERSET_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// A set of log handlers represented as a bitset of the handler indexes
+// assigned by the log level hash.  Once the set has been sized it can be
+// cleared and refilled without any further allocation.
+namespace aqlog { class HandlerSet
+{
+public:
+
+    // The number of handlers represented by each word.
+    static const size_t WORD_BITS = 32;
+
+    // Constructs a new empty handler set.
+    HandlerSet(void) { }
+
+    // Destroys this handler set.
+    ~HandlerSet(void) { }
+
+    // Returns the number of handler indexes this set can hold.
+    size_t capacity(void) const { return m_words.size() * WORD_BITS; }
+
+    // Returns the number of words that make up this set.
+    size_t wordCount(void) const { return m_words.size(); }
+
+    // Returns the words that make up this set.
+    const uint32_t *words(void) const { return m_words.size() > 0 ? &m_words[0] : NULL; }
+
+    // Clears this set and sizes it to hold 'capacity' handler indexes.
+    void reset(size_t capacity)
+    {
+        m_words.assign((capacity + WORD_BITS - 1) / WORD_BITS, 0);
+    }
+
+    // Removes all handlers from this set.
+    void clear(void)
+    {
+        for (size_t i = 0; i < m_words.size(); ++i)
+        {
+            m_words[i] = 0;
+        }
+    }
+
+    // Adds handler 'idx' to this set.
+    void set(size_t idx) { m_words[idx / WORD_BITS] |= 1U << (idx % WORD_BITS); }
+
+    // Returns true if handler 'idx' is in this set.
+    bool isSet(size_t idx) const
+    {
+        return idx < capacity() && (m_words[idx / WORD_BITS] & (1U << (idx % WORD_BITS))) != 0;
+    }
+
+    // Returns true if there are no handlers in this set.
+    bool isEmpty(void) const
+    {
+        for (size_t i = 0; i < m_words.size(); ++i)
+        {
+            if (m_words[i] != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Adds all the handlers in 'words' to this set.  There must be
+    // wordCount() words.
+    void merge(const uint32_t *words)
+    {
+        for (size_t i = 0; i < m_words.size(); ++i)
+        {
+            m_words[i] |= words[i];
+        }
+    }
+
+    // Returns the lowest handler index in this set that is no less than
+    // 'idx', or capacity() if there is none.
+    size_t next(size_t idx) const
+    {
+        size_t w = idx / WORD_BITS;
+        if (w >= m_words.size())
+        {
+            return capacity();
+        }
+
+        uint32_t bits = m_words[w] & (~0U << (idx % WORD_BITS));
+        while (bits == 0)
+        {
+            if (++w >= m_words.size())
+            {
+                return capacity();
+            }
+            bits = m_words[w];
+        }
+
+        size_t bit = 0;
+        while ((bits & 1) == 0)
+        {
+            bits >>= 1;
+            bit++;
+        }
+        return w * WORD_BITS + bit;
+    }
+
+private:
+
+    // The bitset words; bit 'n' of word 'w' is handler index w * 32 + n.
+    std::vector<uint32_t> m_words;
+
+};}
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -39,6 +39,24 @@ namespace aqlog
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
+#if defined(AQLOG_HASH_USE_CONSTEXPR)
+// The constexpr hash used by the logging macros must produce the same values
+// as standard() below or producers and the log level hash disagree on the
+// table index.  The expected values were calculated with standard().
+static_assert(AQLog_HashTierConstexpr(0xFFFFFFFF, "aqlog", 5, false) == 260412537U,
+    "constexpr hash does not match HashFunction::standard()");
+static_assert(AQLog_HashTierConstexpr(0xFFFFFFFF, "src/aqlog/lib/AQLog.cpp", 23, false) == 2096397674U,
+    "constexpr hash does not stop at a path separator");
+static_assert(AQLog_HashTierConstexpr(0xFFFFFFFF, "C:\\aq\\src\\AQLog.cpp", 19, false) == 2096397674U,
+    "constexpr hash does not stop at a path separator");
+static_assert(AQLog_HashTierConstexpr(0xFFFFFFFF, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghij", 36, false) == 2623202641U,
+    "constexpr hash does not match HashFunction::standard() beyond AQLOG_HASH_CHARMAX");
+static_assert(AQLog_HashTierConstexpr(AQLOG_TIER_1_MASK, "aqlog", 5, true) == 121,
+    "constexpr masked hash does not match HashFunction::standard()");
+static_assert(AQLog_HashTierConstexpr(AQLOG_TIER_1_MASK, "", 0, true) == 0,
+    "constexpr hash of an empty tag is not zero");
+#endif
+
 
 
 
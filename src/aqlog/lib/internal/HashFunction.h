@@ -11,6 +11,7 @@
 // Includes
 //------------------------------------------------------------------------------
 
+#include <stddef.h>
 #include <stdint.h>
 
 
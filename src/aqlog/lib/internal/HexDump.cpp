@@ -0,0 +1,202 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "HexDump.h"
+
+#include "AQLogStringBuilder.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEXDUMP_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace aqlog
+{
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The number of hex digits in the offset at the start of each line.
+#define OFFSET_DIGITS                   8
+
+// The number of characters from the start of the offset to the first byte.
+#define HEX_START                       (OFFSET_DIGITS + 2)
+
+// The number of characters from the first byte to the start of the ASCII
+// column: three for each byte, one between the two groups of eight and one
+// before the '|'.
+#define HEX_AREA_LEN                    (3 * HexDump::BYTES_PER_LINE + 2)
+
+// The length of a line holding 'n' bytes, including its newline and indent.
+#define LINE_LEN(n)                     (1 + HexDump::INDENT_SPACES + HEX_START + HEX_AREA_LEN + (n) + 2)
+
+// The text of the line added when the data is truncated.
+#define TRUNCATED_TEXT                  "(truncated)"
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const size_t HexDump::BYTES_PER_LINE;
+const size_t HexDump::INDENT_SPACES;
+#endif
+
+// The two hex digits for each byte value, so a byte is rendered with a
+// single table look-up.
+static const char HexPairs[] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+size_t HexDump::dumpSize(size_t len, bool truncated)
+{
+    size_t size = (len / BYTES_PER_LINE) * LINE_LEN(BYTES_PER_LINE);
+    if (len % BYTES_PER_LINE > 0)
+    {
+        size += LINE_LEN(len % BYTES_PER_LINE);
+    }
+    if (truncated)
+    {
+        size += 1 + INDENT_SPACES + sizeof(TRUNCATED_TEXT) - 1;
+    }
+    return size;
+}
+
+//------------------------------------------------------------------------------
+void HexDump::appendHexDump(const void *data, size_t len, bool truncated,
+    AQLogStringBuilder& dst)
+{
+    size_t size = dumpSize(len, truncated);
+    if (size == 0)
+    {
+        return;
+    }
+
+    char *p = dst.appendEmpty(size);
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t off = 0; off < len; off += BYTES_PER_LINE)
+    {
+        size_t n = len - off < BYTES_PER_LINE ? len - off : BYTES_PER_LINE;
+        p = writeLine(p, (uint32_t)off, &bytes[off], n);
+    }
+
+    if (truncated)
+    {
+        *p++ = '\n';
+        memset(p, ' ', INDENT_SPACES);
+        memcpy(&p[INDENT_SPACES], TRUNCATED_TEXT, sizeof(TRUNCATED_TEXT) - 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+char *HexDump::writeLine(char *dst, uint32_t offset, const uint8_t *data,
+    size_t n)
+{
+    *dst++ = '\n';
+    memset(dst, ' ', INDENT_SPACES);
+    dst += INDENT_SPACES;
+
+    // The offset, most significant byte first.
+    for (int shift = 24; shift >= 0; shift -= 8)
+    {
+        memcpy(dst, &HexPairs[((offset >> shift) & 0xFF) * 2], 2);
+        dst += 2;
+    }
+    dst[0] = ' ';
+    dst[1] = ' ';
+    dst += 2;
+
+    // Blank the hex columns so a short final line is padded, then fill in
+    // each byte.
+    memset(dst, ' ', HEX_AREA_LEN);
+    for (size_t i = 0; i < n; ++i)
+    {
+        memcpy(&dst[3 * i + (i >= BYTES_PER_LINE / 2 ? 1 : 0)], &HexPairs[data[i] * 2], 2);
+    }
+    dst += HEX_AREA_LEN;
+
+    *dst++ = '|';
+    writeAscii(dst, data, n);
+    dst += n;
+    *dst++ = '|';
+    return dst;
+}
+
+//------------------------------------------------------------------------------
+void HexDump::writeAscii(char *dst, const uint8_t *data, size_t n)
+{
+#ifdef HEXDUMP_SSE2
+    if (n == BYTES_PER_LINE)
+    {
+        // A byte is printable if, once ' ' is subtracted, it is no more than
+        // '~' - ' '; anything else is replaced with '.'.
+        __m128i v = _mm_loadu_si128((const __m128i *)data);
+        __m128i c = _mm_sub_epi8(v, _mm_set1_epi8(' '));
+        __m128i range = _mm_set1_epi8('~' - ' ');
+        __m128i printable = _mm_cmpeq_epi8(_mm_min_epu8(c, range), c);
+        __m128i ascii = _mm_or_si128(_mm_and_si128(printable, v),
+            _mm_andnot_si128(printable, _mm_set1_epi8('.')));
+        _mm_storeu_si128((__m128i *)dst, ascii);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        dst[i] = (uint8_t)(data[i] - ' ') <= '~' - ' ' ? (char)data[i] : '.';
+    }
+}
+
+
+
+
+}
+//=============================== End of File ==================================
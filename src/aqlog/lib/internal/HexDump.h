@@ -0,0 +1,98 @@
+#ifndef HEXDUMP_H
+#define HEXDUMP_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class AQLogStringBuilder;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Renders binary data, such as the data attached to a log record, as a
+// hex and ASCII dump in the same layout as 'hexdump -C':
+//
+//   00000000  48 65 6c 6c 6f 2c 20 77  6f 72 6c 64 21 0a 00 01  |Hello, world!...|
+//
+// Each line starts with a newline and is indented so that the dump follows
+// on from the message it belongs to.  The whole dump is written into a single
+// block allocated from the string builder; no printf-style formatting is used.
+namespace aqlog { class HexDump
+{
+private:
+
+    // Utility class - cannot be constructed, assigned or destroyed.
+    HexDump(void);
+    ~HexDump(void);
+
+public:
+
+    // The number of bytes shown on each line.
+    static const size_t BYTES_PER_LINE = 16;
+
+    // The number of spaces that each line is indented by.
+    static const size_t INDENT_SPACES = 2;
+
+    // Appends a dump of the 'len' bytes at 'data' to 'dst'.  If 'truncated'
+    // is set the dump ends with a line noting that the data is incomplete.
+    // Nothing is appended if 'len' is 0 and the data is not truncated.
+    static void appendHexDump(const void *data, size_t len, bool truncated,
+        AQLogStringBuilder& dst);
+
+    // Returns the number of characters appendHexDump() appends for 'len'
+    // bytes of data.
+    static size_t dumpSize(size_t len, bool truncated);
+
+private:
+
+    // Writes the line for the 'n' bytes at 'data' that start 'offset' bytes
+    // into the dump to 'dst' and returns the end of the line.
+    static char *writeLine(char *dst, uint32_t offset, const uint8_t *data,
+        size_t n);
+
+    // Writes the printable ASCII form of the 'n' bytes at 'data' to 'dst'.
+    static void writeAscii(char *dst, const uint8_t *data, size_t n);
+
+};}
+
+
+
+
+#endif
+//=============================== End of File ==================================
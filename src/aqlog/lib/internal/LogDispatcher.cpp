@@ -0,0 +1,379 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "LogDispatcher.h"
+
+#include "AQLogHandler.h"
+#include "AQLogRecord.h"
+
+#include "Atomic.h"
+#include "Timer.h"
+
+#include <stdexcept>
+
+using namespace aqosa;
+using namespace std;
+
+namespace aqlog
+{
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The longest time in milliseconds that run() sleeps between calls to
+// dispatch(), so that handled records are released and stop() is noticed
+// promptly.
+#define MAXIMUM_POLL_MS                 10
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const uint32_t LogDispatcher::HANDLER_QUEUE_SIZE;
+const uint32_t LogDispatcher::HANDLER_HELD_DIVISOR;
+const uint32_t LogDispatcher::IDLE_SLEEP_MS;
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+LogDispatcher::LogDispatcher(IAQSharedMemory& sm, uint32_t handlerQueueSize,
+                             size_t handlerHeldSize)
+    : m_logMem(sm)
+    , m_reader(m_logMem)
+    , m_hash(m_logMem.logLevelHashMemory())
+    , m_handlerQueueSize(handlerQueueSize)
+    , m_handlerHeldSize(handlerHeldSize > 0 ? handlerHeldSize : m_logMem.aqMemory().size() / HANDLER_HELD_DIVISOR)
+    , m_stopFlag(0)
+{
+}
+
+//------------------------------------------------------------------------------
+LogDispatcher::~LogDispatcher(void)
+{
+    stop();
+    join();
+    stopWorkers();
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        delete m_workers[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::addHandler(AQLogHandler *handler)
+{
+    if (findWorker(handler) == NULL)
+    {
+        m_hash.addHandler(handler);
+        m_workers.push_back(new Worker(handler, m_handlerQueueSize));
+        indexWorkers();
+    }
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::removeHandler(AQLogHandler *handler)
+{
+    for (vector<Worker *>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+    {
+        if ((*it)->handler == handler)
+        {
+            m_hash.removeHandler(handler);
+            delete *it;
+            m_workers.erase(it);
+            indexWorkers();
+            break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::startWorkers(void)
+{
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        Worker *w = m_workers[i];
+        if (!w->isStarted())
+        {
+            Atomic::write(&w->stopFlag, 0);
+            if (!w->start())
+            {
+                throw runtime_error("Cannot create log handler worker thread");
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+uint32_t LogDispatcher::dispatch(void)
+{
+    collectHandled();
+
+    uint32_t maxRecallMs;
+    AQLogRecord *rec;
+    while ((rec = m_reader.retrieve(maxRecallMs)) != NULL)
+    {
+        dispatchRecord(rec);
+    }
+    return maxRecallMs;
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::run(void)
+{
+    startWorkers();
+
+    while (Atomic::read(&m_stopFlag) == 0)
+    {
+        uint32_t ms = dispatch();
+        Timer::sleep(ms < MAXIMUM_POLL_MS ? (ms > 0 ? ms : IDLE_SLEEP_MS) : MAXIMUM_POLL_MS);
+    }
+
+    stopWorkers();
+    Atomic::write(&m_stopFlag, 0);
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::stop(void)
+{
+    Atomic::write(&m_stopFlag, 1);
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::stopWorkers(void)
+{
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        Atomic::write(&m_workers[i]->stopFlag, 1);
+    }
+
+    // Keep collecting while the workers finish so none of them is blocked
+    // on a full handled ring.
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        Worker *w = m_workers[i];
+        while (w->isStarted() && Atomic::read(&w->stopFlag) != 2)
+        {
+            collectHandled();
+            Timer::sleep(IDLE_SLEEP_MS);
+        }
+        w->join();
+    }
+    collectHandled();
+}
+
+//------------------------------------------------------------------------------
+uint32_t LogDispatcher::droppedCount(const AQLogHandler *handler) const
+{
+    Worker *w = findWorker(handler);
+    return w == NULL ? 0 : Atomic::read(&w->droppedCount);
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::dispatchRecord(AQLogRecord *rec)
+{
+    m_hash.matchHandlers(*rec, m_matched);
+
+    // The dispatcher holds a reference while the record is being passed out
+    // so that it cannot be released part way through.
+    rec->m_dispatchRefs = 1;
+    size_t size = recordSize(rec);
+    size_t count = m_matched.capacity() < m_workerIndex.size() ? m_matched.capacity() : m_workerIndex.size();
+    for (size_t i = m_matched.next(0); i < count; i = m_matched.next(i + 1))
+    {
+        Worker *w = m_workerIndex[i];
+        if (w != NULL)
+        {
+            // A slow handler must not hold so much of the queue that the 
+            // producers run out of space.
+            if ((w->heldSize == 0 || w->heldSize + size <= m_handlerHeldSize) 
+                && w->pending.push(rec))
+            {
+                w->heldSize += size;
+                rec->m_dispatchRefs++;
+            }
+            else
+            {
+                Atomic::write(&w->droppedCount, w->droppedCount + 1);
+            }
+        }
+    }
+    unreference(rec);
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::collectHandled(void)
+{
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        Worker *w = m_workers[i];
+        AQLogRecord *rec;
+        while (w->handled.pop(rec))
+        {
+            w->heldSize -= recordSize(rec);
+            unreference(rec);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t LogDispatcher::recordSize(AQLogRecord *rec)
+{
+    size_t size = 0;
+    for (const AQItem *item = &rec->aqItem(); item != NULL; item = item->next())
+    {
+        size += item->capacity();
+    }
+    return size;
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::unreference(AQLogRecord *rec)
+{
+    if (--rec->m_dispatchRefs == 0)
+    {
+        m_reader.release(rec);
+    }
+}
+
+//------------------------------------------------------------------------------
+LogDispatcher::Worker *LogDispatcher::findWorker(const AQLogHandler *handler) const
+{
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        if (m_workers[i]->handler == handler)
+        {
+            return m_workers[i];
+        }
+    }
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::indexWorkers(void)
+{
+    m_workerIndex.assign(m_hash.handlerCount(), NULL);
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        size_t idx = m_hash.handlerIndex(m_workers[i]->handler);
+        if (idx < m_workerIndex.size())
+        {
+            m_workerIndex[idx] = m_workers[i];
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+LogDispatcher::Worker::Worker(AQLogHandler *handler, uint32_t queueSize)
+    : handler(handler)
+    , pending(queueSize)
+    , handled(queueSize)
+    , stopFlag(0)
+    , droppedCount(0)
+    , heldSize(0)
+{
+}
+
+//------------------------------------------------------------------------------
+LogDispatcher::Worker::~Worker(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::Worker::run(void)
+{
+    size_t batchSize = handler->batchSize();
+    if (batchSize < 1)
+    {
+        batchSize = 1;
+    }
+    else if (batchSize > pending.capacity())
+    {
+        batchSize = pending.capacity();
+    }
+    held.reserve(batchSize);
+
+    for (;;)
+    {
+        AQLogRecord *rec;
+        if (pending.pop(rec))
+        {
+            handler->handle(*rec);
+            held.push_back(rec);
+            if (held.size() >= batchSize)
+            {
+                flushHeld();
+            }
+        }
+        else if (held.size() > 0)
+        {
+            flushHeld();
+        }
+        else if (Atomic::read(&stopFlag) != 0)
+        {
+            break;
+        }
+        else
+        {
+            Timer::sleep(IDLE_SLEEP_MS);
+        }
+    }
+
+    // Tell the dispatcher that this worker holds no more records.
+    Atomic::write(&stopFlag, 2);
+}
+
+//------------------------------------------------------------------------------
+void LogDispatcher::Worker::flushHeld(void)
+{
+    handler->flush();
+    for (size_t i = 0; i < held.size(); ++i)
+    {
+        while (!handled.push(held[i]))
+        {
+            Timer::sleep(IDLE_SLEEP_MS);
+        }
+    }
+    held.clear();
+}
+
+
+
+}
+//=============================== End of File ==================================
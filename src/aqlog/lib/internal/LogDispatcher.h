@@ -0,0 +1,234 @@
+#ifndef LOGDISPATCHER_H
+#define LOGDISPATCHER_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "HandlerSet.h"
+#include "LogLevelHash.h"
+#include "LogMemory.h"
+#include "LogReader.h"
+#include "SpscRing.h"
+
+#include "Thread.h"
+
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class AQLogHandler;
+class AQLogRecord;
+class IAQSharedMemory;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// The log dispatcher reads records from a LogReader and passes each to the
+// log handlers whose filters match it.
+//
+// Each handler is serviced by its own worker thread fed through a bounded
+// single-producer single-consumer ring.  The dispatcher thread never calls a
+// handler directly, so a slow handler cannot stall draining of the queue.
+// Records stay in the queue until every handler has finished with them, so
+// the queue memory held by each handler is also bounded; if a handler's ring
+// is full or it holds too many bytes the record is dropped for that handler
+// and counted.  Workers hand each record back through a second ring once the
+// handler has flushed the batch containing it and the dispatcher releases it
+// to the reader once every handler it was passed to has finished with it.
+namespace aqlog { class LogDispatcher : public aqosa::Thread
+{
+public:
+
+    // The default number of records that can be waiting for each handler.
+    static const uint32_t HANDLER_QUEUE_SIZE = 1024;
+
+    // By default each handler may hold records taking up to this fraction of
+    // the queue memory.
+    static const uint32_t HANDLER_HELD_DIVISOR = 4;
+
+    // The time in milliseconds that an idle worker or dispatcher sleeps
+    // before checking for more work.
+    static const uint32_t IDLE_SLEEP_MS = 1;
+
+    // Constructs a new log dispatcher for the log in shared memory region 'sm'.
+    // Up to 'handlerQueueSize' records can be waiting for each handler, and
+    // each handler can hold records taking up to 'handlerHeldSize' bytes of
+    // queue memory; if 0 this is the queue size over HANDLER_HELD_DIVISOR.
+    // A single record larger than this is passed to a handler that holds 
+    // nothing else.
+    LogDispatcher(IAQSharedMemory& sm, uint32_t handlerQueueSize = HANDLER_QUEUE_SIZE,
+                  size_t handlerHeldSize = 0);
+
+    // Destroys this log dispatcher, stopping it if it is running.
+    virtual ~LogDispatcher(void);
+
+private:
+    // No implementation provided - log dispatchers cannot be copied or
+    // assigned.
+    LogDispatcher(const LogDispatcher& other);
+    LogDispatcher& operator=(const LogDispatcher& other);
+
+public:
+
+    // Adds a log handler to this dispatcher.  Must not be called while the
+    // dispatcher is running.
+    void addHandler(AQLogHandler *handler);
+
+    // Removes a log handler from this dispatcher.  Must not be called while
+    // the dispatcher is running.
+    void removeHandler(AQLogHandler *handler);
+
+    // Starts the handler worker threads.  Called automatically by run().
+    void startWorkers(void);
+
+    // Retrieves all available records and passes them to the workers, then
+    // releases any records that all workers have finished with.  Returns the
+    // maximum number of milliseconds before this should be called again.
+    // startWorkers() must have been called first.
+    uint32_t dispatch(void);
+
+    // Starts the workers then calls dispatch() until stop() is called, at
+    // which point all handled records are released and the workers stopped.
+    virtual void run(void);
+
+    // Requests that run() returns.  May be called from any thread.
+    void stop(void);
+
+    // Stops and joins the worker threads, releasing all records they hold.
+    void stopWorkers(void);
+
+    // Returns the number of records that were not passed to 'handler'
+    // because its queue was full or it held too many bytes.  May be called
+    // from any thread.
+    uint32_t droppedCount(const AQLogHandler *handler) const;
+
+private:
+
+    // A worker thread that passes records to a single handler.
+    class Worker : public aqosa::Thread
+    {
+    public:
+
+        // Constructs a new worker for 'handler' with queues of 'queueSize'.
+        Worker(AQLogHandler *handler, uint32_t queueSize);
+
+        // Destroys this worker.
+        virtual ~Worker(void);
+
+        // Handles records from the pending ring until stopped.
+        virtual void run(void);
+
+        // Flushes the handler then passes the held records back to the
+        // dispatcher.
+        void flushHeld(void);
+
+        // The handler serviced by this worker.
+        AQLogHandler *handler;
+
+        // Records waiting to be handled; pushed by the dispatcher.
+        SpscRing<AQLogRecord *> pending;
+
+        // Records that have been handled; pushed by the worker.
+        SpscRing<AQLogRecord *> handled;
+
+        // Set to 1 by the dispatcher to stop the worker once the pending ring
+        // is empty, then set to 2 by the worker once it holds no records.
+        volatile uint32_t stopFlag;
+
+        // The number of records dropped because 'pending' was full or 
+        // 'heldSize' too large.
+        volatile uint32_t droppedCount;
+
+        // The bytes of queue memory taken by the records passed to this
+        // worker that are not yet collected.  Only used by the dispatcher.
+        size_t heldSize;
+
+        // The records passed to the handler since it was last flushed.
+        std::vector<AQLogRecord *> held;
+    };
+
+    // Passes 'rec' to each matching worker, or releases it if there are none.
+    void dispatchRecord(AQLogRecord *rec);
+
+    // Releases all records that workers have finished handling.
+    void collectHandled(void);
+
+    // Returns the bytes of queue memory taken by 'rec'.
+    static size_t recordSize(AQLogRecord *rec);
+
+    // Decrements the reference count for 'rec' and releases it to the reader
+    // once no workers hold it.
+    void unreference(AQLogRecord *rec);
+
+    // Returns the worker for 'handler' or NULL if there is none.
+    Worker *findWorker(const AQLogHandler *handler) const;
+
+    // Rebuilds the table that maps handler indexes to workers.
+    void indexWorkers(void);
+
+    // The log memory that divides the shared memory.
+    LogMemory m_logMem;
+
+    // The reader for the log records.
+    LogReader m_reader;
+
+    // The log level hash used to select handlers.
+    LogLevelHash m_hash;
+
+    // The size of the queue for each worker.
+    uint32_t m_handlerQueueSize;
+
+    // The most bytes of queue memory each worker may hold.
+    size_t m_handlerHeldSize;
+
+    // The workers; one for each handler.
+    std::vector<Worker *> m_workers;
+
+    // The workers indexed by the handler index assigned by the log level
+    // hash; NULL where there is no worker.
+    std::vector<Worker *> m_workerIndex;
+
+    // The handlers matched for the record being dispatched.
+    HandlerSet m_matched;
+
+    // Set to non-zero to request that run() returns.
+    volatile uint32_t m_stopFlag;
+
+};}
+
+
+
+
+#endif
+//=============================== End of File ==================================
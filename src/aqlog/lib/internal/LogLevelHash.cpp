@@ -17,8 +17,14 @@
 
 #include "IAQSharedMemory.h"
 
+#include "Atomic.h"
+
+#include <algorithm>
 #include <set>
 
+#include <string.h>
+
+using namespace aqosa;
 using namespace std;
 
 namespace aqlog {
@@ -51,6 +57,11 @@ namespace aqlog {
 // Variable Declarations
 //------------------------------------------------------------------------------
 
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const uint32_t LogLevelHash::NO_MATCH_NODE;
+#endif
+
 // Look-up table that maps the tier to the number of bits for that tier.
 static const uint32_t TierBits[AQLOG_LOOKUP_TIER_COUNT] =
 {
@@ -85,10 +96,12 @@ static const uint32_t TierSize[AQLOG_LOOKUP_TIER_COUNT] =
 //------------------------------------------------------------------------------
 LogLevelHash::LogLevelHash(IAQSharedMemory& hashMem, HashFunction_fn hashFn)
     : m_freezeState(FREEZE_OFF)
+    , m_matcherStale(true)
+    , m_matchWords(0)
     , m_hashMem(hashMem)
     , m_hashFn(hashFn)
 {
-    memset(hashMem.baseAddress(), 0, sizeof(uint32_t) * AQLOG_HASH_TABLE_WORDS);
+    memset(hashMem.baseAddress(), 0, sizeof(uint32_t) * AQLOG_HASH_MEMORY_WORDS);
 }
 
 //------------------------------------------------------------------------------
@@ -120,10 +133,12 @@ void LogLevelHash::addHandler(AQLogHandler *handler)
 {
     const std::vector<AQLogFilter>& filters = handler->filters();
 
+    acquireHandlerSlot(handler);
     for (size_t i = 0; i < filters.size(); ++i)
     {
         addFilter(&filters[i]);
     }
+    m_matcherStale = true;
 }
 
 //------------------------------------------------------------------------------
@@ -135,6 +150,54 @@ void LogLevelHash::removeHandler(AQLogHandler *handler)
     {
         removeFilter(&filters[i]);
     }
+    releaseHandlerSlot(handler);
+    m_matcherStale = true;
+}
+
+//------------------------------------------------------------------------------
+size_t LogLevelHash::handlerIndex(const AQLogHandler *handler) const
+{
+    for (size_t i = 0; i < m_handlerSlots.size(); ++i)
+    {
+        if (m_handlerSlots[i].m_handler == handler)
+        {
+            return i;
+        }
+    }
+    return m_handlerSlots.size();
+}
+
+//------------------------------------------------------------------------------
+size_t LogLevelHash::acquireHandlerSlot(AQLogHandler *handler)
+{
+    size_t idx = handlerIndex(handler);
+    if (idx == m_handlerSlots.size())
+    {
+        // Reuse the first free slot so that the bitsets stay small.
+        idx = handlerIndex(NULL);
+        if (idx == m_handlerSlots.size())
+        {
+            m_handlerSlots.push_back(HandlerSlot());
+        }
+        m_handlerSlots[idx].m_handler = handler;
+        m_handlerSlots[idx].m_refs = 0;
+    }
+    m_handlerSlots[idx].m_refs++;
+    return idx;
+}
+
+//------------------------------------------------------------------------------
+void LogLevelHash::releaseHandlerSlot(AQLogHandler *handler)
+{
+    size_t idx = handlerIndex(handler);
+    if (idx < m_handlerSlots.size() && --m_handlerSlots[idx].m_refs == 0)
+    {
+        m_handlerSlots[idx].m_handler = NULL;
+        while (m_handlerSlots.size() > 0 && m_handlerSlots.back().m_handler == NULL)
+        {
+            m_handlerSlots.pop_back();
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -174,7 +237,7 @@ void LogLevelHash::addFilter(const AQLogFilter *filter)
     {
         if (m_freezeState == FREEZE_OFF)
         {
-            populateHash((uint32_t *)m_hashMem.baseAddress(), *filter, 0, 0);
+            raiseHash(*filter);
         }
         else
         {
@@ -234,40 +297,180 @@ void LogLevelHash::removeFilter(const AQLogFilter *filter)
     }
 }
 
+//------------------------------------------------------------------------------
+void LogLevelHash::matchHandlers(const AQLogRecord& rec, HandlerSet& handlers)
+{
+    if (m_matcherStale)
+    {
+        compileMatcher();
+    }
+    if (handlers.wordCount() == m_matchWords)
+    {
+        handlers.clear();
+    }
+    else
+    {
+        handlers.reset(m_matchWords * HandlerSet::WORD_BITS);
+    }
+
+    size_t level = rec.level();
+    if (level >= AQLOG_LEVEL_COUNT)
+    {
+        return;
+    }
+
+    // Walk the matcher one tier at a time.  At each tier a node can lead to
+    // at most two children - the one for any identifier and the one for the
+    // record's identifier - so the frontier is bounded.
+    uint32_t frontier[2][1 << AQLOG_LOOKUP_TIER_COUNT];
+    size_t count = 1;
+    uint32_t *cur = frontier[0];
+    uint32_t *next = frontier[1];
+    cur[0] = 0;
+    for (size_t tier = 0; count > 0; ++tier)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            handlers.merge(&m_matchLevels[(cur[i] * AQLOG_LEVEL_COUNT + level) * m_matchWords]);
+        }
+        if (tier >= AQLOG_LOOKUP_TIER_COUNT)
+        {
+            break;
+        }
+
+        const char *id = rec.tierId(tier);
+        bool hashed = false;
+        uint32_t hash = 0;
+        size_t nextCount = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const MatchNode& node = m_matchNodes[cur[i]];
+            if (node.m_anyChild != NO_MATCH_NODE)
+            {
+                next[nextCount++] = node.m_anyChild;
+            }
+            if (node.m_keyCount > 0 && id != NULL && *id != '\0')
+            {
+                if (!hashed)
+                {
+                    hash = m_hashFn(0xFFFFFFFF, id, strlen(id), false);
+                    hashed = true;
+                }
+                uint32_t child = findChild(node, hash, id);
+                if (child != NO_MATCH_NODE)
+                {
+                    next[nextCount++] = child;
+                }
+            }
+        }
+
+        uint32_t *tmp = cur;
+        cur = next;
+        next = tmp;
+        count = nextCount;
+    }
+}
+
 //------------------------------------------------------------------------------
 void LogLevelHash::matchHandlers(const AQLogRecord& rec, set<AQLogHandler *>& handlers)
 {
-    // Recursivly populate all the handlers for this log record.
-    populateHandlers(handlers, rec, m_filters, 0);
+    matchHandlers(rec, m_setMatch);
+    for (size_t i = m_setMatch.next(0); i < m_setMatch.capacity(); i = m_setMatch.next(i + 1))
+    {
+        handlers.insert(handler(i));
+    }
 }
 
 //------------------------------------------------------------------------------
-void LogLevelHash::populateHandlers(std::set<AQLogHandler *>& handlers, 
-    const AQLogRecord& rec, FilterMap& fm, size_t tier)
+void LogLevelHash::compileMatcher(void)
 {
-    // First populate with everything in this filter map.
-    std::list<const AQLogFilter *>::iterator it = fm.m_handlers.begin();
-    while (it != fm.m_handlers.end() && (*it)->level() >= rec.level())
+    m_matchWords = (m_handlerSlots.size() + HandlerSet::WORD_BITS - 1) / HandlerSet::WORD_BITS;
+    m_matchNodes.clear();
+    m_matchKeys.clear();
+    m_matchLevels.clear();
+
+    m_matchNodes.push_back(MatchNode());
+    m_matchLevels.resize(AQLOG_LEVEL_COUNT * m_matchWords, 0);
+    compileNode(0, m_filters, 0);
+
+    m_matcherStale = false;
+}
+
+//------------------------------------------------------------------------------
+void LogLevelHash::compileNode(uint32_t node, const FilterMap& fm, size_t tier)
+{
+    // Every filter at this node accepts records at its level and below.
+    for (list<const AQLogFilter *>::const_iterator it = fm.m_handlers.begin(); 
+         it != fm.m_handlers.end(); ++it)
     {
-        handlers.insert(&(*it)->handler());
-        it++;
+        size_t idx = handlerIndex(&(*it)->handler());
+        uint32_t bit = 1U << (idx % HandlerSet::WORD_BITS);
+        for (size_t level = 0; level <= (size_t)(*it)->level() && level < AQLOG_LEVEL_COUNT; ++level)
+        {
+            m_matchLevels[(node * AQLOG_LEVEL_COUNT + level) * m_matchWords
+                          + idx / HandlerSet::WORD_BITS] |= bit;
+        }
     }
 
-    if (tier < AQLOG_LOOKUP_TIER_COUNT)
+    m_matchNodes[node].m_anyChild = NO_MATCH_NODE;
+    m_matchNodes[node].m_firstKey = (uint32_t)m_matchKeys.size();
+    m_matchNodes[node].m_keyCount = 0;
+    if (tier >= AQLOG_LOOKUP_TIER_COUNT)
     {
-        // Tier specific handers - ones that match all strings for this tier then
-        // the ones that only match a specified component.
-        map<string, FilterMap>::iterator it = fm.m_children.find("");
-        if (it != fm.m_children.end())
+        return;
+    }
+
+    // Allocate the children as a contiguous block of nodes with the keys for
+    // this node contiguous in the key table, then compile each child.
+    uint32_t firstChild = (uint32_t)m_matchNodes.size();
+    uint32_t child = firstChild;
+    for (map<string, FilterMap>::const_iterator it = fm.m_children.begin(); 
+         it != fm.m_children.end(); ++it, ++child)
+    {
+        if (it->first.size() == 0)
+        {
+            m_matchNodes[node].m_anyChild = child;
+        }
+        else
         {
-            populateHandlers(handlers, rec, it->second, tier + 1);
+            MatchKey key;
+            key.m_hash = m_hashFn(0xFFFFFFFF, it->first.c_str(), it->first.size(), false);
+            key.m_child = child;
+            key.m_id = &it->first;
+            m_matchKeys.push_back(key);
+            m_matchNodes[node].m_keyCount++;
         }
-        it = fm.m_children.find(rec.tierId(tier));
-        if (it != fm.m_children.end())
+    }
+    m_matchNodes.resize(child, MatchNode());
+    m_matchLevels.resize(child * AQLOG_LEVEL_COUNT * m_matchWords, 0);
+    sort(m_matchKeys.begin() + m_matchNodes[node].m_firstKey, m_matchKeys.end());
+
+    child = firstChild;
+    for (map<string, FilterMap>::const_iterator it = fm.m_children.begin(); 
+         it != fm.m_children.end(); ++it, ++child)
+    {
+        compileNode(child, it->second, tier + 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+uint32_t LogLevelHash::findChild(const MatchNode& node, uint32_t hash, const char *id) const
+{
+    MatchKey probe;
+    probe.m_hash = hash;
+    vector<MatchKey>::const_iterator end = m_matchKeys.begin() + node.m_firstKey + node.m_keyCount;
+    vector<MatchKey>::const_iterator it = lower_bound(m_matchKeys.begin() + node.m_firstKey, end, probe);
+
+    // The hash selects the candidates; the identifier must still match
+    // exactly.
+    for (; it != end && it->m_hash == hash; ++it)
+    {
+        if (strcmp(it->m_id->c_str(), id) == 0)
         {
-            populateHandlers(handlers, rec, it->second, tier + 1);
+            return it->m_child;
         }
     }
+    return NO_MATCH_NODE;
 }
 
 //------------------------------------------------------------------------------
@@ -311,10 +514,25 @@ void LogLevelHash::populateHash(uint32_t *hashMem, const AQLogFilter& filter,
     }
 }
 
+//------------------------------------------------------------------------------
+void LogLevelHash::raiseHash(const AQLogFilter& filter)
+{
+    // Producers may be reading the table in use so it is never written; 
+    // raising levels only needs a copy of it.
+    uint32_t gen = generation() + 1;
+    uint32_t *hashMem = table(gen);
+    memcpy(hashMem, table(gen - 1), AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
+    populateHash(hashMem, filter, 0, 0);
+
+    publishHash(gen);
+}
+
 //------------------------------------------------------------------------------
 void LogLevelHash::rebuildHash(void)
 {
-    uint32_t tmpHashMem[AQLOG_HASH_TABLE_WORDS];
+    // Build the new table in the generation that is not in use.
+    uint32_t gen = generation() + 1;
+    uint32_t *hashMem = table(gen);
 
     // Fill with the default value based on the top level.
     AQLogLevel_t level = (AQLogLevel_t)0;
@@ -322,14 +540,36 @@ void LogLevelHash::rebuildHash(void)
     {
         level = m_filters.m_handlers.front()->level();
     }
-    memset(tmpHashMem, (level << AQLOG_HASH_LEVEL_BITS) | level, 
+    memset(hashMem, (level << AQLOG_HASH_LEVEL_BITS) | level, 
            AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
 
     // Now repopulate with every filter.
-    repopulateHash(tmpHashMem, m_filters);
+    repopulateHash(hashMem, m_filters);
 
-    // Finally copy it over our current hash.
-    memcpy(m_hashMem.baseAddress(), tmpHashMem, AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
+    publishHash(gen);
+}
+
+//------------------------------------------------------------------------------
+void LogLevelHash::publishHash(uint32_t gen)
+{
+    // Producers switch to the new table on their next check; any producer 
+    // that was reading the table now out of use sees the generation change
+    // and reads again.  The write is a full barrier so the next change to
+    // that table cannot be seen before it.
+    Atomic::write((uint32_t *)m_hashMem.baseAddress(), gen);
+}
+
+//------------------------------------------------------------------------------
+uint32_t LogLevelHash::generation(void) const
+{
+    return Atomic::read((uint32_t *)m_hashMem.baseAddress());
+}
+
+//------------------------------------------------------------------------------
+uint32_t *LogLevelHash::table(uint32_t gen) const
+{
+    return (uint32_t *)m_hashMem.baseAddress() + AQLOG_HASH_HEADER_WORDS 
+        + (gen & 1) * AQLOG_HASH_TABLE_WORDS;
 }
 
 //------------------------------------------------------------------------------
@@ -13,11 +13,14 @@
 
 #include "AQLog.h"
 
+#include "HandlerSet.h"
 #include "HashFunction.h"
 
 #include <list>
 #include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 #include <stdint.h>
 
@@ -55,13 +58,15 @@ class IAQSharedMemory;
 // Exported Function and Class Declarations
 //------------------------------------------------------------------------------
 
-// Defines the log level hash table writer.
+// Defines the log level hash table writer.  The log level hash also compiles
+// the filters of its handlers into a flat matcher that is used to select the
+// handlers for each log record without any string map lookups or allocation.
 namespace aqlog { class LogLevelHash
 {
 public:
 
     // Constructs a new log level hash in the memory 'hashMem'.  This memory must
-    // be at least AQLOG_HASH_TABLE_WORDS uint32_t words in length.
+    // be at least AQLOG_HASH_MEMORY_WORDS uint32_t words in length.
     LogLevelHash(IAQSharedMemory& hashMem, HashFunction_fn hashFn = HashFunction::standard);
 
     // Destroys this log level hash.  This does not change the content of the hash
@@ -91,6 +96,26 @@ public:
     // Removes a log handler from this log level hash.
     void removeHandler(AQLogHandler *handler);
 
+    // Returns the number of handler indexes that have been assigned.  Every
+    // handler index is less than this.
+    size_t handlerCount(void) const { return m_handlerSlots.size(); }
+
+    // Returns the handler with index 'idx', or NULL if that index is not in
+    // use.
+    AQLogHandler *handler(size_t idx) const
+    {
+        return idx < m_handlerSlots.size() ? m_handlerSlots[idx].m_handler : NULL;
+    }
+
+    // Returns the index of 'handler', or handlerCount() if it has not been
+    // added.
+    size_t handlerIndex(const AQLogHandler *handler) const;
+
+    // Sets 'handlers' to the indexes of all the handlers that are going to
+    // handle a particular log record.  No allocation is performed once
+    // 'handlers' has been sized by the first call after a handler is added.
+    void matchHandlers(const AQLogRecord& rec, HandlerSet& handlers);
+
     // Adds all the handlers that are going to handle a particular log record
     // to the passed handler set.
     void matchHandlers(const AQLogRecord& rec, std::set<AQLogHandler *>& handlers);
@@ -124,29 +149,122 @@ private:
 
     };
 
+    // A slot in the handler index table.
+    struct HandlerSlot
+    {
+        // The handler in this slot, or NULL if the slot is free.
+        AQLogHandler *m_handler;
+
+        // The number of times the handler has been added.
+        uint32_t m_refs;
+    };
+
+    // A node in the compiled matcher; there is one for each filter map.
+    struct MatchNode
+    {
+        // The index of the child node for filters that match any identifier
+        // at the next tier, or NO_MATCH_NODE if there is none.
+        uint32_t m_anyChild;
+
+        // The index of the first key in m_matchKeys for this node.
+        uint32_t m_firstKey;
+
+        // The number of keys for this node.
+        uint32_t m_keyCount;
+    };
+
+    // A key in the compiled matcher that leads to a child node.  The keys for
+    // each node are sorted by hash.
+    struct MatchKey
+    {
+        // The full 32-bit hash of the identifier.
+        uint32_t m_hash;
+
+        // The index of the child node.
+        uint32_t m_child;
+
+        // The identifier, which is owned by the filter map.
+        const std::string *m_id;
+
+        // Orders keys by hash.
+        bool operator<(const MatchKey& other) const { return m_hash < other.m_hash; }
+    };
+
+    // The node index used where there is no child node.
+    static const uint32_t NO_MATCH_NODE = 0xFFFFFFFF;
+
+    // Returns the slot index for 'handler', assigning one if required.
+    size_t acquireHandlerSlot(AQLogHandler *handler);
+
+    // Releases one reference to the slot for 'handler'.
+    void releaseHandlerSlot(AQLogHandler *handler);
+
+    // Compiles the filter map into the flat matcher.
+    void compileMatcher(void);
+
+    // Compiles the filter map 'fm' into node 'node' of the matcher.
+    void compileNode(uint32_t node, const FilterMap& fm, size_t tier);
+
+    // Returns the child of matcher node 'node' for identifier 'id' with hash
+    // 'hash', or NO_MATCH_NODE if there is none.
+    uint32_t findChild(const MatchNode& node, uint32_t hash, const char *id) const;
+
     // Adds the passed filter 'filter' to the filter map. 
     void addFilter(const AQLogFilter *filter);
 
     // Removes the passed filter from tee filter map.
     void removeFilter(const AQLogFilter *filter);
 
-    // Populates the handler set with all the handlers that match the given record
-    // with the filter map which is located at the specified tier.
-    void populateHandlers(std::set<AQLogHandler *>& handlers, const AQLogRecord& rec,
-        FilterMap& fm, size_t tier);
-
     // Populates the hash with the filter specified in 'filter'.
     void populateHash(uint32_t *hashMem, const AQLogFilter& filter, uint32_t index, uint32_t tier);
 
-    // Rebuilds the entire hash.
+    // Copies the table in use into the table that is not in use, raises it
+    // with 'filter' then makes it the table in use.
+    void raiseHash(const AQLogFilter& filter);
+
+    // Rebuilds the entire hash into the table that is not in use then makes
+    // it the table in use.
     void rebuildHash(void);
 
+    // Makes the table for generation 'gen' the table in use.
+    void publishHash(uint32_t gen);
+
+    // Returns the current generation of the hash table.
+    uint32_t generation(void) const;
+
+    // Returns the hash table for generation 'gen'.
+    uint32_t *table(uint32_t gen) const;
+
     // Repopulates the hash memory in 'hashMem' starting at filter 'fm'.
     void repopulateHash(uint32_t *hashMem, FilterMap& fm);
 
     // The collection of top-level filters.
     FilterMap m_filters;
 
+    // The handler index table.
+    std::vector<HandlerSlot> m_handlerSlots;
+
+    // Set when the filter map has changed since the matcher was compiled.
+    bool m_matcherStale;
+
+    // The nodes of the compiled matcher; node 0 is the top-level filter map.
+    std::vector<MatchNode> m_matchNodes;
+
+    // The keys of the compiled matcher.
+    std::vector<MatchKey> m_matchKeys;
+
+    // The handler bitsets for each node and log level of the compiled matcher.
+    // The bitset for node 'n' at level 'l' starts at word
+    // (n * AQLOG_LEVEL_COUNT + l) * m_matchWords and holds the handlers that
+    // accept records of level 'l' at that node.
+    std::vector<uint32_t> m_matchLevels;
+
+    // The number of words in each bitset of the compiled matcher.
+    size_t m_matchWords;
+
+    // The handler set used by the std::set form of matchHandlers().
+    HandlerSet m_setMatch;
+
     // The hash memory.
     IAQSharedMemory& m_hashMem;
 
@@ -58,7 +58,12 @@ namespace aqlog
 //------------------------------------------------------------------------------
 LogMemory::LogMemory(IAQSharedMemory& sm)
     : m_aqMemory(sm, 0, calculateAqMemorySize(sm))
-    , m_logLevelHashMemory(sm, m_aqMemory.size(), AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t))
+    , m_dropCountersMemory(sm, m_aqMemory.size(), AQLOG_DROP_COUNTERS_SIZE)
+    , m_stringTableMemory(sm, m_aqMemory.size() + AQLOG_DROP_COUNTERS_SIZE,
+        AQLOG_STRING_TABLE_SIZE)
+    , m_logLevelHashMemory(sm, 
+        m_aqMemory.size() + AQLOG_DROP_COUNTERS_SIZE + AQLOG_STRING_TABLE_SIZE, 
+        AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t))
 {
 
 }
@@ -78,7 +83,8 @@ size_t LogMemory::calculateAqMemorySize(IAQSharedMemory& sm)
         throw length_error(ss.str());
     }
 
-    return msize - AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t);
+    return msize - AQLOG_DROP_COUNTERS_SIZE - AQLOG_STRING_TABLE_SIZE 
+        - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t);
 }
 
 //------------------------------------------------------------------------------
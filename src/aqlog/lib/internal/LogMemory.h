@@ -77,6 +77,12 @@ private:
     // The memory to be used by the allocating queue.
     AQSharedMemoryWindow m_aqMemory;
 
+    // The memory to be used by the drop counters.
+    AQSharedMemoryWindow m_dropCountersMemory;
+
+    // The memory to be used by the string table.
+    AQSharedMemoryWindow m_stringTableMemory;
+
     // The memory to be used by the log level hash.
     AQSharedMemoryWindow m_logLevelHashMemory;
 
@@ -85,6 +91,12 @@ public:
     // Obtains the memory region to be used by the allocating queue.
     IAQSharedMemory& aqMemory(void) { return m_aqMemory; }
 
+    // Obtains the memory region to be used by the drop counters.
+    IAQSharedMemory& dropCountersMemory(void) { return m_dropCountersMemory; }
+
+    // Obtains the memory region to be used by the string table.
+    IAQSharedMemory& stringTableMemory(void) { return m_stringTableMemory; }
+
     // Obtains the memory region to be used by the log level hash.
     IAQSharedMemory& logLevelHashMemory(void) { return m_logLevelHashMemory; }
 
@@ -13,6 +13,7 @@
 
 #include "Timer.h"
 
+#include <functional>
 #include <stdexcept>
 
 using namespace aqosa;
@@ -49,6 +50,13 @@ namespace aqlog
 // Variable Declarations
 //------------------------------------------------------------------------------
 
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const uint32_t LogReader::PENDING_WINDOW_SIZE;
+const uint32_t LogReader::PENDING_MINIMUM_WINDOW_MS;
+const uint32_t LogReader::PENDING_MAXIMUM_WINDOW_MS;
+#endif
+
 
 
 
@@ -57,33 +65,33 @@ namespace aqlog
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-LogReader::LogReader(IAQSharedMemory& sm)
-    : m_aq(sm)
+LogReader::LogReader(LogMemory& mem, uint32_t windowSize)
+    : m_aq(mem.aqMemory())
+    , m_strings(mem.stringTableMemory())
+    , m_drops(mem.dropCountersMemory())
+    , m_dropTotal(0)
+    , m_windowSize(windowSize > 0 ? windowSize : 1)
+    , m_pending(m_windowSize, PENDING_MAXIMUM_WINDOW_MS)
+    , m_free(NULL)
 {
+    m_strings.format();
+    m_drops.format(mem.aqMemory().size() / AQLOG_RESERVE_DEFAULT_DIVISOR);
     m_aq.format(8, 1000, AQ::OPTION_EXTENDABLE);
 }
 
 //------------------------------------------------------------------------------
 LogReader::~LogReader(void)
 {
-    for (list<AQLogRecord *>::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
-    {
-        delete *it;
-    }
-    for (set<AQLogRecord *>::iterator it = m_outstanding.begin(); it != m_outstanding.end(); ++it)
+    for (size_t i = 0; i < m_blocks.size(); ++i)
     {
-        delete *it;
-    }
-    for (deque<AQLogRecord *>::iterator it = m_free.begin(); it != m_free.end(); ++it)
-    {
-        delete *it;
+        delete[] m_blocks[i];
     }
 }
 
 //------------------------------------------------------------------------------
 AQLogRecord *LogReader::retrieve(uint32_t& maxRecallMs)
 {
-    while (m_pending.size() < PENDING_WINDOW_SIZE)
+    while (m_pending.size() < m_windowSize)
     {
         AQLogRecord *rec = alloc();
 
@@ -103,30 +111,21 @@ AQLogRecord *LogReader::retrieve(uint32_t& maxRecallMs)
             }
             else
             {
-                // Record is available.  Put it into the pending queue with the highest
-                // timestamp appearing first.
-                list<AQLogRecord *>::iterator it = m_pending.begin();
-                while (it != m_pending.end()
-                    && rec->timestampNs() < (*it)->timestampNs()
-                    && Timer::elapsed((*it)->processTimeMs()) < PENDING_MAXIMUM_WINDOW_MS)
-                {
-                    it++;
-                }
-                m_pending.insert(it, rec);
+                pend(rec);
             }
         }
     }
+    pendDropReports();
 
-    // Now look at the last item in the pending list.
-    AQLogRecord *rec = NULL;
-    if (m_pending.size() > 0)
+    // Now look at the next item in the pending list.
+    AQLogRecord *rec = m_pending.top();
+    if (rec != NULL)
     {
-        rec = m_pending.back();
-        if (   m_pending.size() == PENDING_WINDOW_SIZE 
+        if (   m_pending.size() >= m_windowSize 
             || Timer::elapsed(rec->processTimeMs()) > PENDING_MINIMUM_WINDOW_MS)
         {
-            m_pending.pop_back();
-            m_outstanding.insert(rec);
+            m_pending.pop();
+            rec->m_readerState = RECORD_OUTSTANDING;
         }
         else
         {
@@ -137,7 +136,7 @@ AQLogRecord *LogReader::retrieve(uint32_t& maxRecallMs)
     // Finally calculate the recall time.
     if (m_pending.size() > 0)
     {
-        maxRecallMs = Timer::elapsed(m_pending.back()->processTimeMs());
+        maxRecallMs = Timer::elapsed(m_pending.top()->processTimeMs());
         if (maxRecallMs >= PENDING_MINIMUM_WINDOW_MS)
         {
             maxRecallMs = 0;
@@ -158,37 +157,106 @@ AQLogRecord *LogReader::retrieve(uint32_t& maxRecallMs)
 //------------------------------------------------------------------------------
 void LogReader::release(AQLogRecord *rec)
 {
-    set<AQLogRecord *>::iterator it = m_outstanding.find(rec);
-    if (it == m_outstanding.end())
+    if (!isAllocated(rec) || rec->m_readerState != RECORD_OUTSTANDING)
     {
         throw invalid_argument("AQLogRecord is not currently outstanding");
     }
-    m_outstanding.erase(it);
-    m_aq.release(rec->aqItem());
+    if (!rec->isDropReport())
+    {
+        m_aq.release(rec->aqItem());
+    }
 
     free(rec);
 }
 
 //------------------------------------------------------------------------------
-AQLogRecord *LogReader::alloc(void)
+void LogReader::pend(AQLogRecord *rec)
 {
-    AQLogRecord *rec;
-    if (m_free.size() == 0)
+    rec->m_readerState = RECORD_PENDING;
+    m_pending.push(rec, Timer::start());
+}
+
+//------------------------------------------------------------------------------
+void LogReader::pendDropReports(void)
+{
+    uint32_t total = m_drops.totalCount();
+    if (total == m_dropTotal)
     {
-        rec = new AQLogRecord;
+        return;
     }
-    else
+    m_dropTotal = total;
+
+    // Only the components marked as having dropped records are read.
+    for (uint32_t word = 0; word < DropCounters::DIRTY_WORDS; ++word)
+    {
+        uint32_t bits = m_drops.takeDirty(word);
+        for (uint32_t bit = 0; bits != 0; ++bit, bits >>= 1)
+        {
+            if ((bits & 1) == 0)
+            {
+                continue;
+            }
+
+            uint32_t c = (word << 5) + bit;
+            for (int level = 0; level < AQLOG_LEVEL_COUNT; ++level)
+            {
+                uint32_t count = m_drops.take(c, (AQLogLevel_t)level);
+                if (count > 0)
+                {
+                    const char *componentId = m_strings.lookup(c);
+                    AQLogRecord *rec = alloc();
+                    rec->populateDropReport((AQLogLevel_t)level, 
+                        componentId == NULL ? "" : componentId, count);
+                    pend(rec);
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+AQLogRecord *LogReader::alloc(void)
+{
+    if (m_free == NULL)
     {
-        rec = m_free.front();
-        m_free.pop_front();
+        // Allocate a new block of records and put them all on the free list.
+        AQLogRecord *block = new AQLogRecord[m_windowSize];
+        m_blocks.push_back(block);
+        for (uint32_t i = m_windowSize; i > 0; --i)
+        {
+            block[i - 1].m_strings = &m_strings;
+            block[i - 1].m_reorderNext = m_free;
+            m_free = &block[i - 1];
+        }
     }
+
+    AQLogRecord *rec = m_free;
+    m_free = rec->m_reorderNext;
+    rec->m_reorderNext = NULL;
     return rec;
 }
 
 //------------------------------------------------------------------------------
 void LogReader::free(AQLogRecord *rec)
 {
-    m_free.push_back(rec);
+    rec->m_readerState = RECORD_FREE;
+    rec->m_reorderNext = m_free;
+    m_free = rec;
+}
+
+//------------------------------------------------------------------------------
+bool LogReader::isAllocated(const AQLogRecord *rec) const
+{
+    less<const AQLogRecord *> lt;
+    for (size_t i = 0; i < m_blocks.size(); ++i)
+    {
+        const AQLogRecord *block = m_blocks[i];
+        if (!lt(rec, block) && lt(rec, &block[m_windowSize]))
+        {
+            return ((const char *)rec - (const char *)block) % sizeof(AQLogRecord) == 0;
+        }
+    }
+    return false;
 }
 
 
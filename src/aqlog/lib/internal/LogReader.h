@@ -12,12 +12,14 @@
 //------------------------------------------------------------------------------
 
 #include "AQLogRecord.h"
+#include "DropCounters.h"
+#include "LogMemory.h"
+#include "ReorderBuffer.h"
+#include "StringTable.h"
 
 #include "AQReader.h"
 
-#include <deque>
-#include <list>
-#include <set>
+#include <vector>
 
 
 
@@ -55,7 +57,7 @@ namespace aqlog { class LogReader
 {
 public:
 
-    // The maximum number of items to hold in the pending list.
+    // The default maximum number of items to hold in the pending list.
     static const uint32_t PENDING_WINDOW_SIZE = 100;
 
     // The minimum amount of time to delay an item in the pending list.
@@ -66,8 +68,12 @@ public:
 
     // Constructs a new log reader that uses a shared memory region to
     // communicate with all of the log writers.  Only a single log reader can
-    // use any given shared memory region.
-    LogReader(IAQSharedMemory& sm);
+    // use any given shared memory region.  The queue, string table and drop
+    // counters in the region are all formatted.
+    //
+    // Up to 'windowSize' records are held in the pending list to be reordered
+    // by timestamp.
+    LogReader(LogMemory& mem, uint32_t windowSize = PENDING_WINDOW_SIZE);
 
     // Destroys this log reader.
     ~LogReader(void);
@@ -94,30 +100,71 @@ public:
     // exception is this record is not an outstanding one from this reader.
     void release(AQLogRecord *rec);
 
+    // Sets the number of bytes at the end of the queue that are reserved for
+    // records at AQLOG_RESERVE_LEVEL or more severe.  Less severe records are
+    // dropped rather than use this space.
+    void setReserveSize(size_t reserveSize) { m_drops.setReserveSize(reserveSize); }
+
 private:
 
+    // The states of a record allocated by a log reader.
+    enum RecordState
+    {
+        // The record is on the free list.
+        RECORD_FREE = 0,
+
+        // The record is in the pending list.
+        RECORD_PENDING,
+
+        // The record has been returned by retrieve() but not yet released.
+        RECORD_OUTSTANDING,
+    };
+
     // Allocates a new AQLogRecord object and returns that object.
     AQLogRecord *alloc(void);
 
+    // Returns true if 'rec' is one of the records allocated by this reader.
+    bool isAllocated(const AQLogRecord *rec) const;
+
     // Frees the passed AQLogRecord object.
     void free(AQLogRecord *rec);
 
+    // Adds the passed record into the pending list in timestamp order.
+    void pend(AQLogRecord *rec);
+
+    // Checks the drop counters and adds a drop report record to the pending
+    // list for each component and level that has dropped records.
+    void pendDropReports(void);
+
     // The AQReader used by this log reader.
     AQReader m_aq;
 
+    // The string table used to resolve the interned strings in each record.
+    StringTable m_strings;
+
+    // The counters of records dropped by the producers.
+    DropCounters m_drops;
+
+    // The drop counter total when the drop counters were last checked.
+    uint32_t m_dropTotal;
+
     // Counts the number of different population outcome events.
     uint32_t m_outcomeCount[AQLogRecord::POPULATE_OUTCOME_COUNT];
 
+    // The maximum number of items to hold in the pending list.
+    uint32_t m_windowSize;
+
     // Log records that have been received but not yet returned - they are pending
     // reordering due to timestamps.
-    std::list<AQLogRecord *> m_pending;
+    ReorderBuffer m_pending;
 
-    // The set of log records returned but not yet free'd by calling release().
-    std::set<AQLogRecord *> m_outstanding;
+    // The blocks of log records allocated by this reader; each holds 
+    // m_windowSize records.
+    std::vector<AQLogRecord *> m_blocks;
 
     // Log records that are not currently used - but can be allocated to future
-    // processing.
-    std::deque<AQLogRecord *> m_free;
+    // processing.  Linked through their m_reorderNext fields.
+    AQLogRecord *m_free;
 
 public:
 
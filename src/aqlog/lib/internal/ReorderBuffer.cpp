@@ -0,0 +1,234 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "ReorderBuffer.h"
+
+#include "AQLogRecord.h"
+
+using namespace std;
+
+namespace aqlog
+{
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+ReorderBuffer::ReorderBuffer(size_t capacity, uint32_t maxHoldMs)
+    : m_maxHoldMs(maxHoldMs)
+    , m_arrivalHead(NULL)
+    , m_arrivalTail(NULL)
+    , m_ageCursor(NULL)
+    , m_agedCount(0)
+    , m_agedFloorNs(0)
+    , m_nextSeq(0)
+{
+    m_heap.reserve(capacity);
+}
+
+//------------------------------------------------------------------------------
+ReorderBuffer::~ReorderBuffer(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void ReorderBuffer::push(AQLogRecord *rec, uint32_t nowMs)
+{
+    age(nowMs);
+
+    rec->m_reorderKeyNs = rec->timestampNs();
+    if (m_agedCount > 0 && rec->m_reorderKeyNs < m_agedFloorNs)
+    {
+        rec->m_reorderKeyNs = m_agedFloorNs;
+    }
+    rec->m_reorderSeq = m_nextSeq++;
+    rec->m_reorderAged = false;
+
+    // Link at the end of the arrival order.
+    rec->m_reorderPrev = m_arrivalTail;
+    rec->m_reorderNext = NULL;
+    if (m_arrivalTail == NULL)
+    {
+        m_arrivalHead = rec;
+    }
+    else
+    {
+        m_arrivalTail->m_reorderNext = rec;
+    }
+    m_arrivalTail = rec;
+    if (m_ageCursor == NULL)
+    {
+        m_ageCursor = rec;
+    }
+
+    m_heap.push_back(rec);
+    siftUp(m_heap.size() - 1);
+}
+
+//------------------------------------------------------------------------------
+AQLogRecord *ReorderBuffer::pop(void)
+{
+    if (m_heap.size() == 0)
+    {
+        return NULL;
+    }
+
+    AQLogRecord *rec = m_heap[0];
+    m_heap[0] = m_heap.back();
+    m_heap.pop_back();
+    if (m_heap.size() > 0)
+    {
+        siftDown(0);
+    }
+
+    // Unlink from the arrival order.
+    if (rec->m_reorderPrev == NULL)
+    {
+        m_arrivalHead = rec->m_reorderNext;
+    }
+    else
+    {
+        rec->m_reorderPrev->m_reorderNext = rec->m_reorderNext;
+    }
+    if (rec->m_reorderNext == NULL)
+    {
+        m_arrivalTail = rec->m_reorderPrev;
+    }
+    else
+    {
+        rec->m_reorderNext->m_reorderPrev = rec->m_reorderPrev;
+    }
+    if (m_ageCursor == rec)
+    {
+        m_ageCursor = rec->m_reorderNext;
+    }
+
+    if (rec->m_reorderAged)
+    {
+        m_agedCount--;
+        if (m_agedCount == 0)
+        {
+            m_agedFloorNs = 0;
+        }
+    }
+
+    rec->m_reorderPrev = NULL;
+    rec->m_reorderNext = NULL;
+    return rec;
+}
+
+//------------------------------------------------------------------------------
+void ReorderBuffer::age(uint32_t nowMs)
+{
+    // Records arrive in processing time order so the aged records are always
+    // a prefix of the arrival order.
+    while (m_ageCursor != NULL && nowMs - m_ageCursor->processTimeMs() >= m_maxHoldMs)
+    {
+        m_ageCursor->m_reorderAged = true;
+        m_agedCount++;
+        if (m_ageCursor->m_reorderKeyNs > m_agedFloorNs)
+        {
+            m_agedFloorNs = m_ageCursor->m_reorderKeyNs;
+        }
+        m_ageCursor = m_ageCursor->m_reorderNext;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool ReorderBuffer::isBefore(const AQLogRecord *a, const AQLogRecord *b)
+{
+    if (a->m_reorderKeyNs != b->m_reorderKeyNs)
+    {
+        return a->m_reorderKeyNs < b->m_reorderKeyNs;
+    }
+    return (int32_t)(a->m_reorderSeq - b->m_reorderSeq) < 0;
+}
+
+//------------------------------------------------------------------------------
+void ReorderBuffer::siftUp(size_t idx)
+{
+    AQLogRecord *rec = m_heap[idx];
+    while (idx > 0)
+    {
+        size_t parent = (idx - 1) / 2;
+        if (!isBefore(rec, m_heap[parent]))
+        {
+            break;
+        }
+        m_heap[idx] = m_heap[parent];
+        idx = parent;
+    }
+    m_heap[idx] = rec;
+}
+
+//------------------------------------------------------------------------------
+void ReorderBuffer::siftDown(size_t idx)
+{
+    AQLogRecord *rec = m_heap[idx];
+    size_t count = m_heap.size();
+    for (;;)
+    {
+        size_t child = 2 * idx + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && isBefore(m_heap[child + 1], m_heap[child]))
+        {
+            child++;
+        }
+        if (!isBefore(m_heap[child], rec))
+        {
+            break;
+        }
+        m_heap[idx] = m_heap[child];
+        idx = child;
+    }
+    m_heap[idx] = rec;
+}
+
+
+
+
+}
+//=============================== End of File ==================================
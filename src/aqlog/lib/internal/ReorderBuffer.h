@@ -0,0 +1,146 @@
+#ifndef REORDERBUFFER_H
+#define REORDERBUFFER_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class AQLogRecord;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Holds log records while they wait to be reordered by timestamp.  The records
+// are kept in a binary min-heap ordered by timestamp, with records of equal
+// timestamp kept in arrival order.  The records are also linked in arrival
+// order through intrusive pointers so that records held for longer than the
+// maximum hold time can be found without searching.
+//
+// A record that has been held for longer than the maximum hold time is never
+// overtaken by a record that arrives after it; later records are ordered as
+// though their timestamp was no lower than that of the aged record.  This
+// stops a record with a timestamp far in the future being held forever.
+namespace aqlog { class ReorderBuffer
+{
+public:
+
+    // Constructs a new reorder buffer with space preallocated for 'capacity'
+    // records.  Records held for longer than 'maxHoldMs' are not overtaken
+    // by later arrivals.
+    ReorderBuffer(size_t capacity, uint32_t maxHoldMs);
+
+    // Destroys this reorder buffer.  Any records it holds are not destroyed.
+    ~ReorderBuffer(void);
+
+private:
+    // No implementation provided - reorder buffers cannot be copied or
+    // assigned.
+    ReorderBuffer(const ReorderBuffer& other);
+    ReorderBuffer& operator=(const ReorderBuffer& other);
+
+public:
+
+    // Returns the number of records held.
+    size_t size(void) const { return m_heap.size(); }
+
+    // Adds 'rec' to this buffer given that the monotonic clock is 'nowMs'.
+    // The buffer grows beyond its preallocated capacity if required.
+    void push(AQLogRecord *rec, uint32_t nowMs);
+
+    // Returns the record that should be emitted next, or NULL if the buffer
+    // is empty.  The record remains in the buffer.
+    AQLogRecord *top(void) const { return m_heap.size() > 0 ? m_heap[0] : NULL; }
+
+    // Removes and returns the record that should be emitted next, or NULL if
+    // the buffer is empty.
+    AQLogRecord *pop(void);
+
+private:
+
+    // Marks all records that have been held for longer than the maximum hold
+    // time as aged given that the monotonic clock is 'nowMs'.
+    void age(uint32_t nowMs);
+
+    // Returns true if record 'a' should be emitted before record 'b'.
+    static bool isBefore(const AQLogRecord *a, const AQLogRecord *b);
+
+    // Moves the record at heap index 'idx' towards the root until the heap
+    // is ordered.
+    void siftUp(size_t idx);
+
+    // Moves the record at heap index 'idx' towards the leaves until the heap
+    // is ordered.
+    void siftDown(size_t idx);
+
+    // The maximum time in milliseconds a record is held before later records
+    // stop overtaking it.
+    uint32_t m_maxHoldMs;
+
+    // The min-heap of records.
+    std::vector<AQLogRecord *> m_heap;
+
+    // The oldest record in arrival order, or NULL if empty.
+    AQLogRecord *m_arrivalHead;
+
+    // The newest record in arrival order, or NULL if empty.
+    AQLogRecord *m_arrivalTail;
+
+    // The oldest record in arrival order that has not yet aged, or NULL if
+    // all records have aged.
+    AQLogRecord *m_ageCursor;
+
+    // The number of aged records in the buffer.
+    size_t m_agedCount;
+
+    // The highest ordering key of any aged record in the buffer.  Records
+    // that arrive while there are aged records are given a key no lower
+    // than this.
+    uint64_t m_agedFloorNs;
+
+    // The sequence number given to the next record to arrive.
+    uint32_t m_nextSeq;
+
+};}
+
+
+
+
+#endif
+//=============================== End of File ==================================
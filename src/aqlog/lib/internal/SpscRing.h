@@ -0,0 +1,140 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Atomic.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// A bounded single-producer single-consumer ring of values.  Exactly one
+// thread may call push() and exactly one thread may call pop(); no locks are
+// taken by either.
+namespace aqlog { template<typename T> class SpscRing
+{
+public:
+
+    // Constructs a new ring that holds at least 'capacity' values.  The
+    // capacity is rounded up to a power of two.
+    SpscRing(uint32_t capacity)
+        : m_mask(0)
+        , m_head(0)
+        , m_tail(0)
+    {
+        uint32_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    // Destroys this ring.
+    ~SpscRing(void)
+    {
+    }
+
+private:
+    // Not implemented - rings cannot be copied or assigned.
+    SpscRing(const SpscRing& other);
+    SpscRing& operator=(const SpscRing& other);
+
+public:
+
+    // Returns the number of values this ring can hold.
+    uint32_t capacity(void) const { return m_mask + 1; }
+
+    // Returns the number of values currently in this ring.
+    uint32_t size(void) const
+    {
+        return aqosa::Atomic::read(&m_tail) - aqosa::Atomic::read(&m_head);
+    }
+
+    // Adds 'value' to the tail of this ring.  Returns false if the ring is
+    // full.  Only called by the producer.
+    bool push(const T& value)
+    {
+        uint32_t tail = m_tail;
+        if (tail - aqosa::Atomic::read(&m_head) > m_mask)
+        {
+            return false;
+        }
+        m_slots[tail & m_mask] = value;
+        aqosa::Atomic::write(&m_tail, tail + 1);
+        return true;
+    }
+
+    // Removes the value at the head of this ring into 'value'.  Returns false
+    // if the ring is empty.  Only called by the consumer.
+    bool pop(T& value)
+    {
+        uint32_t head = m_head;
+        if (head == aqosa::Atomic::read(&m_tail))
+        {
+            return false;
+        }
+        value = m_slots[head & m_mask];
+        aqosa::Atomic::write(&m_head, head + 1);
+        return true;
+    }
+
+private:
+
+    // The storage for the values.
+    std::vector<T> m_slots;
+
+    // The mask applied to the head and tail to obtain a slot index.
+    uint32_t m_mask;
+
+    // The index of the next value to pop; only written by the consumer.
+    mutable volatile uint32_t m_head;
+
+    // The index of the next value to push; only written by the producer.
+    mutable volatile uint32_t m_tail;
+
+};}
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -0,0 +1,256 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "AQLog.h"
+
+#include "StringTable.h"
+
+#include "Atomic.h"
+
+#include "IAQSharedMemory.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <string.h>
+
+using namespace aqosa;
+using namespace std;
+
+namespace aqlog
+{
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// Local storage in case the constant is taken as a reference.
+#ifdef __GNUC__
+const uint32_t StringTable::FORMAT_VERSION_INVALID;
+const uint32_t StringTable::FORMAT_VERSION_1;
+const uint32_t StringTable::INVALID_ID;
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+StringTable::StringTable(IAQSharedMemory& sm)
+    : m_header((Header *)sm.baseAddress())
+    , m_slots(NULL)
+    , m_slotCount(AQLOG_STRING_TABLE_SLOTS)
+    , m_heap(NULL)
+    , m_heapSize(0)
+{
+    size_t overhead = sizeof(Header) + m_slotCount * sizeof(uint32_t);
+    if (sm.size() <= overhead)
+    {
+        ostringstream ss;
+
+        ss << "The string table memory must be larger than " << overhead
+           << " bytes in size, however the provided shared memory region was only " << sm.size();
+        throw length_error(ss.str());
+    }
+    m_slots = (volatile uint32_t *)&m_header[1];
+    m_heap = (char *)&m_slots[m_slotCount];
+    m_heapSize = (uint32_t)(sm.size() - overhead);
+}
+
+//------------------------------------------------------------------------------
+StringTable::~StringTable(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void StringTable::format(void)
+{
+    Atomic::write(&m_header->formatVersion, FORMAT_VERSION_INVALID);
+
+    m_header->slotCount = m_slotCount;
+    m_header->heapSize = m_heapSize;
+    m_header->heapUsed = 0;
+    memset((void *)m_slots, 0, m_slotCount * sizeof(uint32_t));
+
+    // The epoch moves only once the table is formatted so a producer that sees
+    // the new epoch always interns into the new table.  The memory may hold
+    // the epoch of a previous consumer; it is carried forward so identifiers
+    // cached against that consumer are never mistaken as current.
+    uint32_t epoch = m_header->epoch + 1;
+    if (epoch == 0)
+    {
+        epoch++;
+    }
+    Atomic::write(&m_header->formatVersion, FORMAT_VERSION_1);
+    Atomic::write(&m_header->epoch, epoch);
+}
+
+//------------------------------------------------------------------------------
+bool StringTable::isFormatted(void) const
+{
+    return Atomic::read(&m_header->formatVersion) == FORMAT_VERSION_1
+        && m_header->slotCount == m_slotCount
+        && m_header->heapSize == m_heapSize;
+}
+
+//------------------------------------------------------------------------------
+uint32_t StringTable::epoch(void) const
+{
+    uint32_t epoch = Atomic::read(&m_header->epoch);
+    return isFormatted() ? epoch : 0;
+}
+
+//------------------------------------------------------------------------------
+uint32_t StringTable::intern(const char *str, size_t strLen)
+{
+    if (!isFormatted() || strLen >= m_heapSize)
+    {
+        return INVALID_ID;
+    }
+
+    uint32_t hash = hashString(str, strLen);
+    for (uint32_t i = 0; i < m_slotCount; ++i)
+    {
+        uint32_t idx = (hash + i) % m_slotCount;
+        uint32_t ref = Atomic::read(&m_slots[idx]);
+        if (ref == 0)
+        {
+            // Empty slot; copy the string into the heap then try to publish it.
+            uint32_t offset;
+            if (!claimHeap((uint32_t)strLen + 1, offset))
+            {
+                return INVALID_ID;
+            }
+            memcpy(&m_heap[offset], str, strLen);
+            m_heap[offset + strLen] = '\0';
+
+            ref = Atomic::cmpXchg(&m_slots[idx], offset + 1, 0);
+            if (ref == 0)
+            {
+                return idx + 1;
+            }
+
+            // Another producer published into this slot first.  The heap space
+            // we claimed is abandoned; it is only ever lost when producers race
+            // to intern into the same slot.
+        }
+
+        if (isMatch(ref, str, strLen))
+        {
+            return idx + 1;
+        }
+    }
+
+    return INVALID_ID;
+}
+
+//------------------------------------------------------------------------------
+const char *StringTable::lookup(uint32_t id) const
+{
+    if (id == INVALID_ID || id > m_slotCount || !isFormatted())
+    {
+        return NULL;
+    }
+
+    uint32_t ref = Atomic::read(&m_slots[id - 1]);
+    if (ref == 0 || ref > m_heapSize)
+    {
+        return NULL;
+    }
+
+    const char *str = &m_heap[ref - 1];
+    if (memchr(str, '\0', m_heapSize - (ref - 1)) == NULL)
+    {
+        return NULL;
+    }
+    return str;
+}
+
+//------------------------------------------------------------------------------
+size_t StringTable::availableHeapSize(void) const
+{
+    uint32_t used = Atomic::read(&m_header->heapUsed);
+    return used < m_heapSize ? m_heapSize - used : 0;
+}
+
+//------------------------------------------------------------------------------
+uint32_t StringTable::hashString(const char *str, size_t strLen)
+{
+    uint32_t hash = AQLOG_HASH_INIT;
+    for (size_t i = 0; i < strLen; ++i)
+    {
+        hash = AQLOG_HASH_STEP(hash, (unsigned char)str[i]);
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+bool StringTable::claimHeap(uint32_t size, uint32_t& offset)
+{
+    uint32_t used = Atomic::read(&m_header->heapUsed);
+    for (;;)
+    {
+        if (used > m_heapSize || size > m_heapSize - used)
+        {
+            return false;
+        }
+        uint32_t prev = Atomic::cmpXchg(&m_header->heapUsed, used + size, used);
+        if (prev == used)
+        {
+            offset = used;
+            return true;
+        }
+        used = prev;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool StringTable::isMatch(uint32_t ref, const char *str, size_t strLen) const
+{
+    uint32_t offset = ref - 1;
+    return offset < m_heapSize
+        && strLen < m_heapSize - offset
+        && memcmp(&m_heap[offset], str, strLen) == 0
+        && m_heap[offset + strLen] == '\0';
+}
+
+
+
+
+}
+//=============================== End of File ==================================
@@ -0,0 +1,168 @@
+#ifndef STRINGTABLE_H
+#define STRINGTABLE_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class IAQSharedMemory;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// The string table maps the static strings used by log records (component,
+// tag, file, function and process name) to 32-bit identifiers.  The table is
+// held in shared memory so that each string is registered once by whichever
+// producer first uses it and log records then carry just the identifier.
+//
+// The table is an open-addressed hash of slots followed by a heap of nul
+// terminated strings.  Slots and heap space are claimed with atomic
+// operations; once a slot is published it never changes until the table is
+// formatted again, so lookups require no synchronisation.
+namespace aqlog { class StringTable
+{
+public:
+
+    // Used in the 'formatVersion' field to indicate that this memory is not
+    // formatted.
+    static const uint32_t FORMAT_VERSION_INVALID = 0x00000000;
+
+    // Used in the 'formatVersion' field to indicate the V1 format.
+    static const uint32_t FORMAT_VERSION_1 = 0x00000001;
+
+    // The identifier returned when a string could not be interned.
+    static const uint32_t INVALID_ID = 0;
+
+    // Constructs a new string table that uses the passed shared memory region.
+    // If the passed shared memory region is too small to hold the table
+    // a length_error exception is thrown.
+    StringTable(IAQSharedMemory& sm);
+
+    // Destroys this string table.
+    ~StringTable(void);
+
+private:
+    // No implementation provided - string tables cannot be copied or assigned.
+    StringTable(const StringTable& other);
+    StringTable& operator=(const StringTable& other);
+
+private:
+
+    // The header at the start of the string table memory.
+    struct Header
+    {
+        // The version of the table; FORMAT_VERSION_1 once formatted.
+        volatile uint32_t formatVersion;
+
+        // The number of slots in the table.
+        uint32_t slotCount;
+
+        // The number of bytes in the string heap.
+        uint32_t heapSize;
+
+        // The number of bytes of the string heap that have been claimed.
+        volatile uint32_t heapUsed;
+
+        // Incremented each time the table is formatted; never 0 once 
+        // formatted.  Producers that cached identifiers against a different
+        // epoch must intern their strings again.
+        volatile uint32_t epoch;
+    };
+
+public:
+
+    // Formats the string table, discarding all strings it contains, and moves
+    // the table to a new epoch.  This is called by the log consumer when it
+    // starts; producers that are still attached notice the new epoch and
+    // intern their strings again.
+    void format(void);
+
+    // Returns true if the string table has been formatted.
+    bool isFormatted(void) const;
+
+    // Returns the epoch of the string table, or 0 if it is not formatted.
+    uint32_t epoch(void) const;
+
+    // Interns the string 'str' consisting of 'strLen' characters (not counting
+    // any nul terminator), returning its identifier.  Returns INVALID_ID if
+    // the table is not formatted or has no space for the string.
+    uint32_t intern(const char *str, size_t strLen);
+
+    // Looks up the string with identifier 'id'.  Returns NULL if the
+    // identifier does not refer to a valid string in this table.
+    const char *lookup(uint32_t id) const;
+
+    // Returns the number of bytes of string heap still available.
+    size_t availableHeapSize(void) const;
+
+private:
+
+    // Calculates the hash of the string 'str' of length 'strLen'.
+    static uint32_t hashString(const char *str, size_t strLen);
+
+    // Claims 'size' bytes from the string heap, storing the offset of the
+    // claimed region in 'offset'.  Returns false if there is not enough space.
+    bool claimHeap(uint32_t size, uint32_t& offset);
+
+    // Returns true if the heap reference 'ref' read from a slot refers to the
+    // string 'str' of length 'strLen'.
+    bool isMatch(uint32_t ref, const char *str, size_t strLen) const;
+
+    // The header for the table.
+    Header *m_header;
+
+    // The slots in the table; each is either 0 (empty) or one more than the
+    // offset of the string in the heap.
+    volatile uint32_t *m_slots;
+
+    // The number of slots in the table.
+    uint32_t m_slotCount;
+
+    // The string heap.
+    char *m_heap;
+
+    // The number of bytes in the string heap.
+    uint32_t m_heapSize;
+
+};}
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -15,6 +15,14 @@
 
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WORDWRAPPER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 using namespace std;
 
 namespace aqlog
@@ -44,6 +52,18 @@ namespace aqlog
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
+// Returns true if 'ch' is white space in the C locale: a space, tab, vertical
+// tab, form feed, carriage return or linefeed.
+static inline bool isWrapSpace(char ch);
+
+// Returns the number of characters at the start of the 'len' characters of
+// 'str' that are not white space.
+static size_t wordLength(const char *str, size_t len);
+
+// Returns the number of characters at the start of the 'len' characters of
+// 'str' that are white space other than a carriage return or linefeed.
+static size_t spaceLength(const char *str, size_t len);
+
 
 
 
@@ -87,15 +107,21 @@ void WordWrapper::appendWordWrapped(const AQLogStringBuilder& src,
     }
 
 
+    AQLogStringBuilder::iterator end = src.end();
     AQLogStringBuilder::iterator lineStart = src.begin();
     AQLogStringBuilder::iterator it = lineStart;
-    AQLogStringBuilder::iterator firstSpace = src.end();
+    AQLogStringBuilder::iterator firstSpace = end;
     AQLogStringBuilder::iterator lastSpace = firstSpace;
     uint32_t cols = 0;
-    while (it != src.end())
+    while (it != end)
     {
+        // Scan the source a vector at a time; only newlines are handled a
+        // character at a time.
+        size_t avail;
+        const char *str = it.contiguous(avail);
+
         // Any of "\n", "\r\n", or "\n\r" result in a newline being inserted.
-        char ch = *it;
+        char ch = *str;
         if (ch == '\r' || ch == '\n')
         {
             // Append the line.
@@ -111,7 +137,7 @@ void WordWrapper::appendWordWrapped(const AQLogStringBuilder& src,
             // Check for a following '\r' or '\n' and skip over it for the
             // next line.
             it++;
-            if (it != src.end())
+            if (it != end)
             {
                 char ch2 = *it;
                 if (ch2 != ch && (ch2 == '\r' || ch2 == '\n'))
@@ -120,46 +146,62 @@ void WordWrapper::appendWordWrapped(const AQLogStringBuilder& src,
                 }
             }
             lineStart = it;
-            firstSpace = lastSpace = src.end();
+            firstSpace = lastSpace = end;
             cols = 0;
 
             // Attach the prefix for the next line unless we reached the end.
-            if (it != src.end())
+            if (it != end)
             {
                 appendPrefix(dst, prefixSpaces, basePrefixOffset);
             }
         }
         else 
         {
-            if (isspace(ch))
+            bool wrap;
+            uint32_t wrappedCols;
+            if (isWrapSpace(ch))
             {
-                // Find the range of spaces until the end of the line or a non-space
-                // character.
+                // Find the range of spaces until the end of the line or a 
+                // non-space character, which may be in a later vector.
                 firstSpace = it;
+                size_t n;
                 do
                 {
-                    it++;
-                    cols++;
-                } while (it != src.end() && isspace(*it) && *it != '\r' && *it != '\n');
+                    n = spaceLength(str, avail);
+                    it += n;
+                    cols += (uint32_t)n;
+                    str = it.contiguous(avail);
+                } while (n > 0 && str != NULL);
                 lastSpace = it;
+
+                wrap = cols >= wrapCols;
+                wrappedCols = 0;
             }
             else
             {
-                it++;
-                cols++;
+                // Skip the whole word, or the part of it in this vector.  If
+                // the line needs wrapping then the break is at the last space
+                // and the columns past the wrap point carry onto the next line.
+                size_t n = wordLength(str, avail);
+                it += n;
+                uint32_t wrapAt = cols < wrapCols ? wrapCols : cols + 1;
+                cols += (uint32_t)n;
+
+                wrap = cols >= wrapAt;
+                wrappedCols = cols - wrapAt;
             }
 
             // Word wrap.
-            if (cols >= wrapCols && firstSpace != src.end())
+            if (wrap && firstSpace != end)
             {
                 dst.appendPointer(lineStart, firstSpace);
-                if (lastSpace != src.end())
+                if (lastSpace != end)
                 {
                     appendPrefix(dst, prefixSpaces, basePrefixOffset);
                 }
                 lineStart = lastSpace;
-                firstSpace = lastSpace = src.end();
-                cols = 0;
+                firstSpace = lastSpace = end;
+                cols = wrappedCols;
             }
         }
     }
@@ -178,6 +220,62 @@ void WordWrapper::appendWordWrapped(const AQLogStringBuilder& src,
     }
 }
 
+//------------------------------------------------------------------------------
+static inline bool isWrapSpace(char ch)
+{
+    return ch == ' ' || (unsigned char)(ch - '\t') <= (unsigned char)('\r' - '\t');
+}
+
+//------------------------------------------------------------------------------
+static size_t wordLength(const char *str, size_t len)
+{
+    size_t n = 0;
+
+#ifdef WORDWRAPPER_SSE2
+    // Test 16 characters at a time; a character is white space if it is a
+    // space or, once '\t' is subtracted, is no more than '\r' - '\t'.
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i range = _mm_set1_epi8('\r' - '\t');
+    while (len - n >= sizeof(__m128i))
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)&str[n]);
+        __m128i c = _mm_sub_epi8(v, tab);
+        __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, space), 
+            _mm_cmpeq_epi8(_mm_min_epu8(c, range), c));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(ws);
+        if (mask != 0)
+        {
+#ifdef _MSC_VER
+            unsigned long bit;
+            _BitScanForward(&bit, mask);
+            return n + bit;
+#else
+            return n + __builtin_ctz(mask);
+#endif
+        }
+        n += sizeof(__m128i);
+    }
+#endif
+
+    while (n < len && !isWrapSpace(str[n]))
+    {
+        n++;
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+static size_t spaceLength(const char *str, size_t len)
+{
+    size_t n = 0;
+    while (n < len && isWrapSpace(str[n]) && str[n] != '\r' && str[n] != '\n')
+    {
+        n++;
+    }
+    return n;
+}
+
 //------------------------------------------------------------------------------
 void WordWrapper::appendPrefix(AQLogStringBuilder& dst, uint32_t prefixSpaces,
     uint32_t prefixOffset)
@@ -187,7 +285,7 @@ void WordWrapper::appendPrefix(AQLogStringBuilder& dst, uint32_t prefixSpaces,
     uint32_t n = 0;
     while (n < prefixSpaces)
     {
-        size_t c = std::min(sizeof(Prefix) - prefixOffset - 1, prefixSpaces - n);
+        size_t c = std::min(sizeof(Prefix) - prefixOffset - 1, (size_t)(prefixSpaces - n));
         dst.appendPointer(&Prefix[prefixOffset], c);
         n += c;
         prefixOffset = 2;
@@ -79,6 +79,8 @@ public:
     // The following rules are applied:
     //  - Each line is prefixed with 'prefixSpaces' space characters.
     //  - The newline used is 'newline'.
+    // The source is scanned a vector at a time and nothing is copied; 'dst'
+    // references the characters of 'src' and a shared prefix buffer.
     static void appendWordWrapped(const AQLogStringBuilder& src, 
         AQLogStringBuilder& dst, uint32_t wrapCols, uint32_t prefixSpaces, 
         Newline newline = NEWLINE_PLATFORM);
@@ -0,0 +1,97 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "AQLogFdHandler.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// Fall back to the POSIX minimum where the limit is not defined.
+#ifndef IOV_MAX
+#define IOV_MAX                         16
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void AQLogFdHandler::writeBatch(void)
+{
+    const size_t maxIov = (size_t)IOV_MAX < MAX_WRITE_IOV ? (size_t)IOV_MAX : MAX_WRITE_IOV;
+
+    while (m_batch.size() > 0)
+    {
+        size_t count = m_batch.iovCount();
+        if (count > maxIov)
+        {
+            count = maxIov;
+        }
+
+        ssize_t written = writev(m_fd, (const struct iovec *)m_batch.iov(), (int)count);
+        m_writeCount++;
+        if (written > 0)
+        {
+            // Drop what was written; this also trims a vector that was only
+            // partially written.
+            m_batch.erase(m_batch.begin(), (size_t)written);
+        }
+        else if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            m_errorCount++;
+            break;
+        }
+    }
+    m_batch.clear();
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -51,12 +51,16 @@ using namespace std;
 //------------------------------------------------------------------------------
 AQLogStringBuilder& AQLogStringBuilder::vappendf(const char *fmt, va_list argp)
 {
-    char *str = NULL;
-    int count = vasprintf(&str, fmt, argp);
+    va_list cargp;
+    va_copy(cargp, argp);
+    int count = vsnprintf(NULL, 0, fmt, cargp);
+    va_end(cargp);
     if (count > 0)
     {
         size_t len = (size_t)count;
-        appendFree(str, len);
+        char *str = allocString(len + 1);
+        vsnprintf(str, len + 1, fmt, argp);
+        appendPointer(str, len);
     }
     return *this;
 }
@@ -75,13 +79,17 @@ AQLogStringBuilder& AQLogStringBuilder::appendftime(const char *fmt, time_t time
 //------------------------------------------------------------------------------
 size_t AQLogStringBuilder::vinsertf(const iterator& pos, const char *fmt, va_list argp)
 {
-    char *str = NULL;
     size_t len;
-    int count = vasprintf(&str, fmt, argp);
+    va_list cargp;
+    va_copy(cargp, argp);
+    int count = vsnprintf(NULL, 0, fmt, cargp);
+    va_end(cargp);
     if (count > 0)
     {
         len = (size_t)count;
-        insertFree(pos, str, len);
+        char *str = allocString(len + 1);
+        vsnprintf(str, len + 1, fmt, argp);
+        insertPointer(pos, str, len);
     }
     else
     {
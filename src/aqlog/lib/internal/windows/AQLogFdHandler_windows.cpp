@@ -0,0 +1,90 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "AQLogFdHandler.h"
+
+#include <io.h>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+// Matches the layout of the I/O vectors returned by AQLogStringBuilder::iov().
+struct iovec
+{
+    void *iov_base;
+    size_t iov_len;
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void AQLogFdHandler::writeBatch(void)
+{
+    // There is no gathering write for CRT file descriptors so each vector is
+    // written in turn.
+    const struct iovec *iov = (const struct iovec *)m_batch.iov();
+    for (size_t i = 0; i < m_batch.iovCount(); ++i)
+    {
+        const char *str = (const char *)iov[i].iov_base;
+        size_t len = iov[i].iov_len;
+        while (len > 0)
+        {
+            int written = _write(m_fd, str, (unsigned int)len);
+            m_writeCount++;
+            if (written <= 0)
+            {
+                m_errorCount++;
+                m_batch.clear();
+                return;
+            }
+            str += written;
+            len -= written;
+        }
+    }
+    m_batch.clear();
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,175 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#define AQLOG_COMPONENT_ID              "aqlog_perftest"
+
+#include "DrainTest.h"
+
+#include "AQLogRecord.h"
+
+#include "DefaultFormatter.h"
+#include "LogReader.h"
+
+#include <sstream>
+
+using namespace aqlog;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+DrainTest::DrainTest(const std::string& name, const std::string& pattern,
+    size_t recordCount)
+    : LogTest(name, AQLOG_LEVEL_TRACE)
+    , m_pattern(pattern)
+    , m_recordCount(recordCount)
+    , m_formatter(NULL)
+    , m_drainedCount(0)
+    , m_formattedSize(0)
+{
+    addThread<DrainTest>(&DrainTest::threadDrain);
+}
+
+//------------------------------------------------------------------------------
+DrainTest::~DrainTest(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void DrainTest::before(void)
+{
+    // The records held back by the reader stay in the log memory.
+    openLog((m_recordCount + LogReader::PENDING_WINDOW_SIZE) * LOG_TEST_RECORD_MEMORY_SIZE,
+        LogReader::PENDING_WINDOW_SIZE);
+    m_formatter = new DefaultFormatter(m_pattern.c_str());
+    m_drainedCount = 0;
+    m_formattedSize = 0;
+}
+
+//------------------------------------------------------------------------------
+void DrainTest::beforeIteration(void)
+{
+    for (size_t i = 0; i < m_recordCount; ++i)
+    {
+        switch (i % 4)
+        {
+        case 0:
+            AQLog_Info("Drained record %u", (unsigned int)i);
+            break;
+
+        case 1:
+            AQLog_Debug("Drained record %u of %u with a longer message body",
+                (unsigned int)i, (unsigned int)m_recordCount);
+            break;
+
+        case 2:
+            AQLog_Warning("Drained record %u: %s", (unsigned int)i, m_pattern.c_str());
+            break;
+
+        default:
+            AQLog_Error("Drained record %u", (unsigned int)i);
+            break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void DrainTest::after(void)
+{
+    m_sb.clear();
+    delete m_formatter;
+    m_formatter = NULL;
+    closeLog();
+}
+
+//------------------------------------------------------------------------------
+void DrainTest::threadDrain(void)
+{
+    LogReader& r = reader();
+    unsigned long count = 0;
+    for (;;)
+    {
+        uint32_t maxRecallMs;
+        AQLogRecord *rec = r.retrieve(maxRecallMs);
+        if (rec == NULL)
+        {
+            break;
+        }
+        if (!countDropped(*rec))
+        {
+            m_sb.clear();
+            m_formatter->format(*rec, m_sb);
+            m_formattedSize += m_sb.size();
+            count++;
+        }
+        r.release(rec);
+    }
+    m_drainedCount += count;
+}
+
+//------------------------------------------------------------------------------
+std::string DrainTest::config(void) const
+{
+    ostringstream ss;
+
+    ss << m_recordCount << " records";
+
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+std::string DrainTest::results(void) const
+{
+    ostringstream ss;
+
+    ss << "avg-size[" << (m_drainedCount > 0 ? m_formattedSize / m_drainedCount : 0)
+       << "] dropped[" << droppedCount() << "]";
+
+    return ss.str();
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,136 @@
+#ifndef DRAINTEST_H
+#define DRAINTEST_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "LogTest.h"
+
+#include "AQLogStringBuilder.h"
+
+#include <string>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+// The default number of records logged for each iteration.
+#define DRAIN_TEST_DEFAULT_RECORD_COUNT 10000
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+namespace aqlog
+{
+    class DefaultFormatter;
+}
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Tests the rate at which a consumer drains the log: each record is retrieved
+// from the LogReader, formatted by the default formatter and released, the
+// way a handler worker does.  The records are logged before each iteration
+// starts.
+//
+// The reader holds back the newest records to reorder them, so those are
+// drained by the next iteration; the operation count is the number of
+// records actually drained.
+class DrainTest : public LogTest
+{
+public:
+
+    // Constructs a new drain test that logs 'recordCount' records before
+    // each iteration and formats them with 'pattern'.
+    DrainTest(const std::string& name, const std::string& pattern,
+        size_t recordCount = DRAIN_TEST_DEFAULT_RECORD_COUNT);
+
+private:
+    // No copy or assignment permitted.
+    DrainTest(const DrainTest& other);
+    DrainTest& operator=(const DrainTest& other);
+public:
+
+    // Destroys this drain test.
+    virtual ~DrainTest(void);
+
+private:
+
+    // The formatter pattern.
+    std::string m_pattern;
+
+    // The number of records logged per iteration.
+    size_t m_recordCount;
+
+    // The formatter.
+    aqlog::DefaultFormatter *m_formatter;
+
+    // The string builder the records are formatted into.
+    AQLogStringBuilder m_sb;
+
+    // The number of records drained.
+    unsigned long m_drainedCount;
+
+    // The total number of characters formatted.
+    unsigned long long m_formattedSize;
+
+protected:
+
+    // Opens the log.
+    virtual void before(void);
+
+    // Logs the records for the next iteration.
+    virtual void beforeIteration(void);
+
+    // Closes the log.
+    virtual void after(void);
+
+private:
+
+    // Drains the records.
+    void threadDrain(void);
+
+public:
+
+    // The total number of operations that were performed.
+    virtual unsigned long totalOperationCount(void) const { return m_drainedCount; }
+
+    // Gets a description of the configuration of this test.
+    virtual std::string config(void) const;
+
+    // Gets a description of the results for this test.
+    virtual std::string results(void) const;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
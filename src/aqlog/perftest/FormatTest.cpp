@@ -0,0 +1,193 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#define AQLOG_COMPONENT_ID              "aqlog_perftest"
+
+#include "FormatTest.h"
+
+#include "AQLogRecord.h"
+
+#include "DefaultFormatter.h"
+#include "LogReader.h"
+
+#include <sstream>
+#include <stdexcept>
+
+using namespace aqlog;
+using namespace aqosa;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The number of consecutive empty retrievals before the records are assumed
+// to be lost.
+#define MAXIMUM_EMPTY_RETRIEVE_COUNT    3
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+FormatTest::FormatTest(const std::string& name, const std::string& pattern,
+    size_t recordCount)
+    : LogTest(name, AQLOG_LEVEL_TRACE)
+    , m_pattern(pattern)
+    , m_recordCount(recordCount)
+    , m_formatter(NULL)
+    , m_formattedSize(0)
+{
+    addThread<FormatTest>(&FormatTest::threadFormat);
+}
+
+//------------------------------------------------------------------------------
+FormatTest::~FormatTest(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void FormatTest::before(void)
+{
+    openLog(m_recordCount * LOG_TEST_RECORD_MEMORY_SIZE, LogReader::PENDING_WINDOW_SIZE);
+    m_formatter = new DefaultFormatter(m_pattern.c_str());
+    m_formattedSize = 0;
+
+    // Log a spread of levels and message lengths, then wait for the records
+    // to leave the pending window.
+    for (size_t i = 0; i < m_recordCount; ++i)
+    {
+        switch (i % 4)
+        {
+        case 0:
+            AQLog_Info("Formatted record %u", (unsigned int)i);
+            break;
+
+        case 1:
+            AQLog_Debug("Formatted record %u of %u with a longer message body",
+                (unsigned int)i, (unsigned int)m_recordCount);
+            break;
+
+        case 2:
+            AQLog_Warning("Formatted record %u: %s", (unsigned int)i, m_pattern.c_str());
+            break;
+
+        default:
+            AQLog_Error("Formatted record %u", (unsigned int)i);
+            break;
+        }
+    }
+
+    int emptyCount = 0;
+    while (m_records.size() < m_recordCount)
+    {
+        uint32_t maxRecallMs;
+        AQLogRecord *rec = reader().retrieve(maxRecallMs);
+        if (rec != NULL)
+        {
+            m_records.push_back(rec);
+            emptyCount = 0;
+        }
+        else if (emptyCount++ < MAXIMUM_EMPTY_RETRIEVE_COUNT)
+        {
+            Timer::sleep(maxRecallMs + 25);
+        }
+        else
+        {
+            throw runtime_error("Format test records could not be retrieved");
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void FormatTest::after(void)
+{
+    for (size_t i = 0; i < m_records.size(); ++i)
+    {
+        reader().release(m_records[i]);
+    }
+    m_records.clear();
+    m_sb.clear();
+
+    delete m_formatter;
+    m_formatter = NULL;
+    closeLog();
+}
+
+//------------------------------------------------------------------------------
+void FormatTest::threadFormat(void)
+{
+    for (size_t i = 0; i < m_records.size(); ++i)
+    {
+        m_sb.clear();
+        m_formatter->format(*m_records[i], m_sb);
+        m_formattedSize += m_sb.size();
+    }
+}
+
+//------------------------------------------------------------------------------
+unsigned long FormatTest::totalOperationCount(void) const
+{
+    return iterationCount() * (unsigned long)m_recordCount;
+}
+
+//------------------------------------------------------------------------------
+std::string FormatTest::config(void) const
+{
+    ostringstream ss;
+
+    ss << m_recordCount << " records";
+
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+std::string FormatTest::results(void) const
+{
+    ostringstream ss;
+
+    unsigned long count = totalOperationCount();
+    ss << "avg-size[" << (count > 0 ? m_formattedSize / count : 0) << "]";
+
+    return ss.str();
+}
+
+
+
+
+//=============================== End of File ==================================
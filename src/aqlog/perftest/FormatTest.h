@@ -0,0 +1,130 @@
+#ifndef FORMATTEST_H
+#define FORMATTEST_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "LogTest.h"
+
+#include "AQLogStringBuilder.h"
+
+#include <string>
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+// The default number of records formatted in each iteration.
+#define FORMAT_TEST_DEFAULT_RECORD_COUNT    1000
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+namespace aqlog
+{
+    class DefaultFormatter;
+}
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Tests the performance of the default log formatter.  A set of records is
+// logged and retrieved before the test starts; each iteration then formats
+// every record into a single reused string builder, the way a handler worker
+// does.
+class FormatTest : public LogTest
+{
+public:
+
+    // Constructs a new format test that formats 'recordCount' records per
+    // iteration with the default formatter configured with 'pattern'.
+    FormatTest(const std::string& name, const std::string& pattern,
+        size_t recordCount = FORMAT_TEST_DEFAULT_RECORD_COUNT);
+
+private:
+    // No copy or assignment permitted.
+    FormatTest(const FormatTest& other);
+    FormatTest& operator=(const FormatTest& other);
+public:
+
+    // Destroys this format test.
+    virtual ~FormatTest(void);
+
+private:
+
+    // The formatter pattern.
+    std::string m_pattern;
+
+    // The number of records formatted per iteration.
+    size_t m_recordCount;
+
+    // The formatter under test.
+    aqlog::DefaultFormatter *m_formatter;
+
+    // The records formatted in each iteration.
+    std::vector<AQLogRecord *> m_records;
+
+    // The string builder the records are formatted into.
+    AQLogStringBuilder m_sb;
+
+    // The total number of characters formatted.
+    unsigned long long m_formattedSize;
+
+protected:
+
+    // Logs and retrieves the records.
+    virtual void before(void);
+
+    // Releases the records.
+    virtual void after(void);
+
+private:
+
+    // Formats each of the records.
+    void threadFormat(void);
+
+public:
+
+    // The total number of operations that were performed.
+    virtual unsigned long totalOperationCount(void) const;
+
+    // Gets a description of the configuration of this test.
+    virtual std::string config(void) const;
+
+    // Gets a description of the results for this test.
+    virtual std::string results(void) const;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -0,0 +1,160 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#define AQLOG_COMPONENT_ID              "aqlog_perftest"
+
+#include "HashCheckTest.h"
+
+#include <sstream>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The memory for the records; none should be written.
+#define RECORD_MEMORY_SIZE              (64 * LOG_TEST_RECORD_MEMORY_SIZE)
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+HashCheckTest::HashCheckTest(const std::string& name, Method method,
+    size_t checkCount)
+    : LogTest(name, AQLOG_LEVEL_INFO)
+    , m_method(method)
+    , m_checkCount(checkCount)
+    , m_checkLevel(AQLOG_LEVEL_TRACE)
+    , m_enabledCount(0)
+{
+    addThread<HashCheckTest>(&HashCheckTest::threadCheck);
+}
+
+//------------------------------------------------------------------------------
+HashCheckTest::~HashCheckTest(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void HashCheckTest::before(void)
+{
+    openLog(RECORD_MEMORY_SIZE, 1);
+    m_enabledCount = 0;
+}
+
+//------------------------------------------------------------------------------
+void HashCheckTest::after(void)
+{
+    // Any statement that was enabled wrote a record.
+    if (m_method == METHOD_STATEMENT)
+    {
+        m_enabledCount += drain();
+    }
+    closeLog();
+}
+
+//------------------------------------------------------------------------------
+void HashCheckTest::threadCheck(void)
+{
+    unsigned long long enabled = 0;
+
+    switch (m_method)
+    {
+    case METHOD_STATEMENT:
+        for (size_t i = 0; i < m_checkCount; ++i)
+        {
+            AQLOG_WRITE((AQLogLevel_t)m_checkLevel, "", "Disabled statement %u", (unsigned int)i);
+        }
+        break;
+
+    case METHOD_INLINE:
+        for (size_t i = 0; i < m_checkCount; ++i)
+        {
+            if (AQLOG_HASHISLEVEL_INLINE(m_checkLevel, AQLOG_COMPONENT_ID, "", __FILE__))
+            {
+                enabled++;
+            }
+        }
+        break;
+
+    case METHOD_EXTERN:
+        for (size_t i = 0; i < m_checkCount; ++i)
+        {
+            if (AQLOG_HASHISLEVEL_EXTERN(m_checkLevel, AQLOG_COMPONENT_ID, "", __FILE__))
+            {
+                enabled++;
+            }
+        }
+        break;
+    }
+
+    m_enabledCount += enabled;
+}
+
+//------------------------------------------------------------------------------
+unsigned long HashCheckTest::totalOperationCount(void) const
+{
+    return iterationCount() * (unsigned long)m_checkCount;
+}
+
+//------------------------------------------------------------------------------
+std::string HashCheckTest::config(void) const
+{
+    ostringstream ss;
+
+    ss << m_checkCount << " checks";
+
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+std::string HashCheckTest::results(void) const
+{
+    ostringstream ss;
+
+    ss << "enabled[" << m_enabledCount << "]";
+
+    return ss.str();
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,129 @@
+#ifndef HASHCHECKTEST_H
+#define HASHCHECKTEST_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "LogTest.h"
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+// The default number of checks made in each iteration.
+#define HASH_CHECK_TEST_DEFAULT_CHECK_COUNT 1000000
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Tests the cost of a log statement that is disabled: the statements are at
+// AQLOG_LEVEL_TRACE while the log is enabled at AQLOG_LEVEL_INFO, so each one
+// costs only the check of the log level hash.
+//
+// The level of each check is read from a volatile member so that the
+// compiler cannot move the check out of the loop.
+class HashCheckTest : public LogTest
+{
+public:
+
+    // The ways the log level hash is checked.
+    enum Method
+    {
+        // A complete AQLog_Trace() style statement, checked the way the build
+        // selects through the call site.
+        METHOD_STATEMENT,
+
+        // The inline hash calculation, AQLOG_HASHISLEVEL_INLINE().
+        METHOD_INLINE,
+
+        // The external hash function, AQLOG_HASHISLEVEL_EXTERN().
+        METHOD_EXTERN
+    };
+
+    // Constructs a new hash check test that makes 'checkCount' checks per
+    // iteration using 'method'.
+    HashCheckTest(const std::string& name, Method method,
+        size_t checkCount = HASH_CHECK_TEST_DEFAULT_CHECK_COUNT);
+
+private:
+    // No copy or assignment permitted.
+    HashCheckTest(const HashCheckTest& other);
+    HashCheckTest& operator=(const HashCheckTest& other);
+public:
+
+    // Destroys this hash check test.
+    virtual ~HashCheckTest(void);
+
+private:
+
+    // The way the hash is checked.
+    Method m_method;
+
+    // The number of checks per iteration.
+    size_t m_checkCount;
+
+    // The level checked.
+    volatile int m_checkLevel;
+
+    // The number of checks that found the statement enabled.
+    unsigned long long m_enabledCount;
+
+protected:
+
+    // Opens the log.
+    virtual void before(void);
+
+    // Closes the log.
+    virtual void after(void);
+
+private:
+
+    // Makes each of the checks.
+    void threadCheck(void);
+
+public:
+
+    // The total number of operations that were performed.
+    virtual unsigned long totalOperationCount(void) const;
+
+    // Gets a description of the configuration of this test.
+    virtual std::string config(void) const;
+
+    // Gets a description of the results for this test.
+    virtual std::string results(void) const;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
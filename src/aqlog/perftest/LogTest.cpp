@@ -0,0 +1,169 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "LogTest.h"
+
+#include "AQLogHandler.h"
+#include "AQLogRecord.h"
+
+#include "LogLevelHash.h"
+#include "LogMemory.h"
+#include "LogReader.h"
+
+#include "AQHeapMemory.h"
+
+#include <string.h>
+
+using namespace aqlog;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+// Enables every statement logged by the test at or above a level; never
+// handles anything itself.
+class LogTestHandler : public AQLogHandler
+{
+public:
+    LogTestHandler(AQLogLevel_t level) { addFilter(level); }
+    virtual ~LogTestHandler(void) { }
+    virtual void handle(const AQLogRecord& rec) { }
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+LogTest::LogTest(const std::string& name, AQLogLevel_t level)
+    : PerfTest(name)
+    , m_level(level)
+    , m_sm(NULL)
+    , m_logMem(NULL)
+    , m_reader(NULL)
+    , m_hash(NULL)
+    , m_handler(NULL)
+    , m_droppedCount(0)
+{
+}
+
+//------------------------------------------------------------------------------
+LogTest::~LogTest(void)
+{
+    closeLog();
+}
+
+//------------------------------------------------------------------------------
+void LogTest::openLog(size_t recordMemorySize, uint32_t windowSize)
+{
+    closeLog();
+
+    size_t size = AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t)
+        + AQLOG_STRING_TABLE_SIZE + AQLOG_DROP_COUNTERS_SIZE
+        + recordMemorySize;
+    m_sm = new AQHeapMemory(size);
+    memset(m_sm->baseAddress(), 0, m_sm->size());
+    m_logMem = new LogMemory(*m_sm);
+    m_reader = new LogReader(*m_logMem, windowSize);
+    m_reader->setReserveSize(0);
+    m_hash = new LogLevelHash(m_logMem->logLevelHashMemory());
+    m_handler = new LogTestHandler(m_level);
+    m_droppedCount = 0;
+
+    AQLog_InitSharedMemory(*m_sm);
+    m_hash->addHandler(m_handler);
+}
+
+//------------------------------------------------------------------------------
+void LogTest::closeLog(void)
+{
+    if (m_sm == NULL)
+    {
+        return;
+    }
+
+    AQLog_Deinit();
+    delete m_hash;
+    delete m_handler;
+    delete m_reader;
+    delete m_logMem;
+    delete m_sm;
+    m_hash = NULL;
+    m_handler = NULL;
+    m_reader = NULL;
+    m_logMem = NULL;
+    m_sm = NULL;
+}
+
+//------------------------------------------------------------------------------
+unsigned long LogTest::drain(void)
+{
+    unsigned long count = 0;
+    for (;;)
+    {
+        uint32_t maxRecallMs;
+        AQLogRecord *rec = m_reader->retrieve(maxRecallMs);
+        if (rec == NULL)
+        {
+            break;
+        }
+        if (!countDropped(*rec))
+        {
+            count++;
+        }
+        m_reader->release(rec);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+bool LogTest::countDropped(const AQLogRecord& rec)
+{
+    if (!rec.isDropReport())
+    {
+        return false;
+    }
+    m_droppedCount += rec.droppedCount();
+    return true;
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,140 @@
+#ifndef LOGTEST_H
+#define LOGTEST_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PerfTest.h"
+
+#include "AQLog.h"
+
+#include <string>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+// The shared memory allowed for each record on top of the fixed log memory.
+#define LOG_TEST_RECORD_MEMORY_SIZE     512
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class AQHeapMemory;
+class AQLogRecord;
+namespace aqlog
+{
+    class LogLevelHash;
+    class LogMemory;
+    class LogReader;
+}
+class LogTestHandler;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// The base class for the performance tests that log through AQLog.  It owns
+// the log shared memory, the reader that consumes it and a handler that
+// enables every statement at or above a level, and initialises the AQLog
+// producer interface over them while the log is open.
+class LogTest : public PerfTest
+{
+protected:
+
+    // Constructs a new log test where the statements at 'level' or more
+    // severe are enabled.
+    LogTest(const std::string& name, AQLogLevel_t level);
+
+private:
+    // No copy or assignment permitted.
+    LogTest(const LogTest& other);
+    LogTest& operator=(const LogTest& other);
+public:
+
+    // Destroys this log test, closing the log if it is open.
+    virtual ~LogTest(void);
+
+private:
+
+    // The level that statements are enabled at.
+    AQLogLevel_t m_level;
+
+    // The shared memory that holds the log.
+    AQHeapMemory *m_sm;
+
+    // The log memory that divides the shared memory.
+    aqlog::LogMemory *m_logMem;
+
+    // The reader that consumes the log.
+    aqlog::LogReader *m_reader;
+
+    // The log level hash used to enable the statements.
+    aqlog::LogLevelHash *m_hash;
+
+    // The handler that enables the statements.
+    LogTestHandler *m_handler;
+
+    // The number of records reported as dropped while the log was open.
+    unsigned long long m_droppedCount;
+
+protected:
+
+    // Opens the log with 'recordMemorySize' bytes for the records on top of
+    // the fixed log memory, and a reader that holds up to 'windowSize'
+    // records to reorder them.  No space is reserved for the more severe
+    // records.
+    void openLog(size_t recordMemorySize, uint32_t windowSize);
+
+    // Closes the log, deinitialising AQLog.
+    void closeLog(void);
+
+    // Returns the reader for the open log.
+    aqlog::LogReader& reader(void) const { return *m_reader; }
+
+    // Retrieves and releases every record the reader will return without
+    // waiting, and returns the number that were not drop reports.
+    unsigned long drain(void);
+
+    // Counts the records reported as dropped by 'rec' if it is a drop report.
+    // Returns true if it was a drop report.
+    bool countDropped(const AQLogRecord& rec);
+
+public:
+
+    // Returns the number of records reported as dropped while the log was
+    // open.
+    unsigned long long droppedCount(void) const { return m_droppedCount; }
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -0,0 +1,309 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "DrainTest.h"
+#include "FormatTest.h"
+#include "HashCheckTest.h"
+#include "WriteTest.h"
+
+#include "DefaultFormatter.h"
+
+#include "Optarg.h"
+
+#include <iomanip>
+#include <iostream>
+
+using namespace aqlog;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// We run for this many seconds in each test.
+#define DEFAULT_TEST_DURATION_SECS      10
+
+// The default thread counts and message sizes for the write tests.
+#define DEFAULT_THREAD_COUNTS           {1, 2, 4}
+#define DEFAULT_MESSAGE_SIZES           {16, 128, 1024}
+
+// The pattern that exercises every formatter directive.
+#define ALL_DIRECTIVES_PATTERN          "%T %L %p(%P:%i) [%c/%t] %f:%n %F() %m"
+
+// The widths of each column.
+#define THREAD_COUNT_WIDTH              3
+#define CONFIG_WIDTH                    24
+#define ITERATION_COUNT_WIDTH           5
+#define DURATION_MS_WIDTH               9
+#define OPERATION_COUNT_WIDTH           9
+#define OPERATIONS_PER_SEC_WIDTH        9
+#define RESULTS_WIDTH                   24
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Runs the main loop internally.
+static int internalMain(int argc, char *argv[]);
+
+// Prints the result header.
+static void printTestHeader(size_t nameWidth);
+
+// Prints the test results.
+static void printTestConfig(size_t nameWidth, PerfTest& test);
+
+// Prints the test results.
+static void printTestResults(PerfTest& test);
+
+// Configures the performance test run using the passed options.
+static void configure(Optarg &cfg);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// The test duration, in seconds.
+static uint32_t TestDurationSecs = DEFAULT_TEST_DURATION_SECS;
+
+// The number of records formatted in each format test iteration.
+static unsigned int FormatRecordCount = FORMAT_TEST_DEFAULT_RECORD_COUNT;
+
+// An additional formatter pattern to test, empty for none.
+static string FormatPattern;
+
+// The thread counts for the write tests.
+static std::vector<unsigned int> ThreadCounts;
+
+// The message sizes for the write tests.
+static std::vector<unsigned int> MessageSizes;
+
+// The number of records logged for each drain test iteration.
+static unsigned int DrainRecordCount = DRAIN_TEST_DEFAULT_RECORD_COUNT;
+
+// If true, count the hardware events of each test thread.
+static bool CountEvents = false;
+
+// The tests to execute.
+static bool TestHashCheck = false;
+static bool TestWrite = false;
+static bool TestDrain = false;
+static bool TestFormat = false;
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    int res = 0;
+    try
+    {
+        res = internalMain(argc, argv);
+    }
+    catch (const exception& ex)
+    {
+        cerr << endl << endl << "**EXCEPTION** " << ex.what() << endl;
+        res = 1;
+    }
+    return res;
+}
+
+//------------------------------------------------------------------------------
+static int internalMain(int argc, char *argv[])
+{
+    const unsigned int defaultThreadCounts[] = DEFAULT_THREAD_COUNTS;
+    for (size_t i = 0; i < sizeof(defaultThreadCounts) / sizeof(defaultThreadCounts[0]); ++i)
+    {
+        ThreadCounts.push_back(defaultThreadCounts[i]);
+    }
+    const unsigned int defaultMessageSizes[] = DEFAULT_MESSAGE_SIZES;
+    for (size_t i = 0; i < sizeof(defaultMessageSizes) / sizeof(defaultMessageSizes[0]); ++i)
+    {
+        MessageSizes.push_back(defaultMessageSizes[i]);
+    }
+    Optarg opt(argc, argv);
+    configure(opt);
+    cout << endl << endl << "Running AQLog Performance Test" << endl;
+
+    std::vector<PerfTest *> m_tests;
+
+    // Build the list of tests.
+    if (TestHashCheck)
+    {
+        m_tests.push_back(new HashCheckTest("Disabled-Statement", HashCheckTest::METHOD_STATEMENT));
+        m_tests.push_back(new HashCheckTest("Disabled-Inline", HashCheckTest::METHOD_INLINE));
+        m_tests.push_back(new HashCheckTest("Disabled-Extern", HashCheckTest::METHOD_EXTERN));
+        m_tests.push_back(NULL);
+    }
+    if (TestWrite)
+    {
+        for (size_t i = 0; i < MessageSizes.size(); ++i)
+        {
+            for (size_t j = 0; j < ThreadCounts.size(); ++j)
+            {
+                m_tests.push_back(new WriteTest("Write", ThreadCounts[j], MessageSizes[i]));
+            }
+            m_tests.push_back(NULL);
+        }
+    }
+    if (TestDrain)
+    {
+        m_tests.push_back(new DrainTest("Drain-Default", DefaultFormatter::DEFAULT_PATTERN, DrainRecordCount));
+        m_tests.push_back(new DrainTest("Drain-Message", "%m", DrainRecordCount));
+        m_tests.push_back(NULL);
+    }
+    if (TestFormat)
+    {
+        m_tests.push_back(new FormatTest("Format-Default", DefaultFormatter::DEFAULT_PATTERN, FormatRecordCount));
+        m_tests.push_back(new FormatTest("Format-Message", "%m", FormatRecordCount));
+        m_tests.push_back(new FormatTest("Format-AllFields", ALL_DIRECTIVES_PATTERN, FormatRecordCount));
+        if (!FormatPattern.empty())
+        {
+            m_tests.push_back(new FormatTest("Format-Custom", FormatPattern, FormatRecordCount));
+        }
+        m_tests.push_back(NULL);
+    }
+
+    // Run each test, then publish its results.
+    size_t nameWidth = 4;
+    for (size_t i = 0; i < m_tests.size(); ++i)
+    {
+        if (m_tests[i])
+        {
+            m_tests[i]->setDurationMs(TestDurationSecs * 1000);
+            m_tests[i]->setCounters(CountEvents);
+            size_t width = m_tests[i]->name().size();
+            if (width > nameWidth)
+            {
+                nameWidth = width;
+            }
+        }
+    }
+    printTestHeader(nameWidth);
+    for (size_t i = 0; i < m_tests.size(); ++i)
+    {
+        if (m_tests[i] == NULL)
+        {
+            cout << endl;
+        }
+        else
+        {
+            printTestConfig(nameWidth, *m_tests[i]);
+            m_tests[i]->run();
+            printTestResults(*m_tests[i]);
+        }
+    }
+
+    for (size_t i = 0; i < m_tests.size(); ++i)
+    {
+        if (m_tests[i])
+        {
+            delete m_tests[i];
+        }
+    }
+    m_tests.clear();
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+static void printTestHeader(size_t nameWidth)
+{
+    cout << left << setw(1) << "|"
+        << setw(nameWidth) << "Name" << setw(1) << "|"
+        << setw(THREAD_COUNT_WIDTH) << "Th#" << setw(1) << "|"
+        << setw(CONFIG_WIDTH) << "Configuration" << setw(1) << "|"
+        << right << setw(ITERATION_COUNT_WIDTH) << "#Iter" << setw(1) << "|"
+        << right << setw(DURATION_MS_WIDTH) << "ms/Iter" << setw(1) << "|"
+        << right << setw(OPERATION_COUNT_WIDTH) << "#Ops" << setw(1) << "|"
+        << right << setw(OPERATIONS_PER_SEC_WIDTH) << "Ops/sec" << setw(1) << "|"
+        << left << setw(RESULTS_WIDTH) << "Results" << setw(1) << "|" << endl;
+}
+
+//------------------------------------------------------------------------------
+static void printTestConfig(size_t nameWidth, PerfTest& test)
+{
+    cout << left << setw(1) << "|"
+        << setw(nameWidth) << test.name() << setw(1) << "|"
+        << right << setw(THREAD_COUNT_WIDTH) << test.threadCount() << setw(1) << "|"
+        << left << setw(CONFIG_WIDTH) << test.config() << setw(1) << "|";
+}
+
+//------------------------------------------------------------------------------
+static void printTestResults(PerfTest& test)
+{
+    double ms = (double)test.totalDurationMs();
+
+    double durationMs = ms / (double)test.iterationCount();
+    double opsPerSec = (double)test.totalOperationCount() / (ms / 1000.0);
+    cout << right << setw(ITERATION_COUNT_WIDTH) << test.iterationCount() << setw(1) << "|"
+         << right << setw(DURATION_MS_WIDTH) << fixed << setprecision(3) << durationMs << setw(1) << "|"
+         << right << setw(OPERATION_COUNT_WIDTH) << test.totalOperationCount() << setw(1) << "|"
+         << right << setw(OPERATIONS_PER_SEC_WIDTH) << fixed << setprecision(0) << opsPerSec << setw(1) << "|"
+         << left << setw(RESULTS_WIDTH) << test.results() << setw(1) << "|" << endl;
+
+    PerfCounters counters = test.counters();
+    if (counters.hasTotals())
+    {
+        cout << "|  counters: " << counters.summary(test.totalOperationCount()) << endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+static void configure(Optarg &cfg)
+{
+    cfg.opt('d', TestDurationSecs, "The minimum duration of each test execution in seconds.");
+    cfg.opt('t', ThreadCounts, "A comma-separated list of thread counts; that is the number of concurrent threads logging in the write tests.  Test cases are run separately for each entry in the list.");
+    cfg.opt('s', MessageSizes, "A comma-separated list of message sizes in characters for the write tests.  Test cases are run separately for each entry in the list.");
+    cfg.opt('r', DrainRecordCount, "The number of records logged before each iteration of the drain tests.");
+    cfg.opt('n', FormatRecordCount, "The number of records formatted in each iteration of the format tests.");
+    cfg.opt('p', FormatPattern, "An additional formatter pattern to run the format tests with.");
+
+    cfg.opt('e', CountEvents, "Counts the cycles, instructions, last level cache misses, branch misses and HITM loads of every test thread with the hardware performance counters, and reports them per operation.");
+
+    cfg.opt('H', TestHashCheck, "Enables the disabled statement tests; a statement below the enabled level through the call site, the inline hash check and the extern hash check.");
+    cfg.opt('W', TestWrite, "Enables the __AQLog_Write() tests for each message size and thread count; the operation count is the number of messages written.");
+    cfg.opt('D', TestDrain, "Enables the consumer drain tests, where each record is retrieved from the LogReader, formatted and released; the operation count is the number of records drained.");
+    cfg.opt('F', TestFormat, "Enables the DefaultFormatter::format() tests; the operation count is the number of records formatted.");
+
+    if (cfg.hasOpt('h', "Show the command line option help."))
+    {
+        cout << endl << cfg.helpMessage() << endl;
+        exit(0);
+    }
+}
+
+
+
+
+//=============================== End of File ==================================
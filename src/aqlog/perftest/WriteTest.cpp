@@ -0,0 +1,148 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#define AQLOG_COMPONENT_ID              "aqlog_perftest"
+
+#include "WriteTest.h"
+
+#include <sstream>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The memory taken by a record on top of its message, used to work out how
+// many messages fit in the record memory.
+#define RECORD_OVERHEAD_SIZE            256
+
+// Only this percentage of the record memory is filled in each iteration so
+// that rounding records up to whole pages does not fill the log.
+#define MEMORY_FILL_PERCENT             75
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+WriteTest::WriteTest(const std::string& name, int threadCount, size_t messageSize,
+    size_t memorySize)
+    : LogTest(name, AQLOG_LEVEL_INFO)
+    , m_messageSize(messageSize)
+    , m_memorySize(memorySize)
+    , m_writesPerThread(memorySize / 100 * MEMORY_FILL_PERCENT
+        / ((size_t)threadCount * (messageSize + RECORD_OVERHEAD_SIZE)))
+    , m_message(messageSize, 'x')
+    , m_drainedCount(0)
+{
+    if (m_writesPerThread == 0)
+    {
+        m_writesPerThread = 1;
+    }
+    for (int i = 0; i < threadCount; ++i)
+    {
+        addThread<WriteTest>(&WriteTest::threadWrite);
+    }
+}
+
+//------------------------------------------------------------------------------
+WriteTest::~WriteTest(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void WriteTest::before(void)
+{
+    openLog(m_memorySize, 1);
+    m_drainedCount = 0;
+}
+
+//------------------------------------------------------------------------------
+void WriteTest::beforeIteration(void)
+{
+    m_drainedCount += drain();
+}
+
+//------------------------------------------------------------------------------
+void WriteTest::after(void)
+{
+    m_drainedCount += drain();
+    closeLog();
+}
+
+//------------------------------------------------------------------------------
+void WriteTest::threadWrite(void)
+{
+    const char *msg = m_message.c_str();
+    for (size_t i = 0; i < m_writesPerThread; ++i)
+    {
+        AQLog_Info("%s", msg);
+    }
+}
+
+//------------------------------------------------------------------------------
+unsigned long WriteTest::totalOperationCount(void) const
+{
+    return iterationCount() * (unsigned long)(m_writesPerThread * threadCount());
+}
+
+//------------------------------------------------------------------------------
+std::string WriteTest::config(void) const
+{
+    ostringstream ss;
+
+    ss << m_messageSize << "B x " << m_writesPerThread;
+
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+std::string WriteTest::results(void) const
+{
+    ostringstream ss;
+
+    ss << "drained[" << m_drainedCount << "] dropped[" << droppedCount() << "]";
+
+    return ss.str();
+}
+
+
+
+
+//=============================== End of File ==================================
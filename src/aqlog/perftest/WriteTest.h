@@ -0,0 +1,123 @@
+#ifndef WRITETEST_H
+#define WRITETEST_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "LogTest.h"
+
+#include <string>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+// The default size of the record memory that each iteration fills.
+#define WRITE_TEST_DEFAULT_MEMORY_SIZE  (8 * 1024 * 1024)
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Tests the cost of an enabled log statement, that is of __AQLog_Write(), in
+// one or more threads logging concurrently.  Each iteration writes as many
+// messages of a fixed size as fit in the record memory; the records are
+// drained between iterations so the write cost does not include the reader.
+// Any write that found the log full is counted as dropped.
+class WriteTest : public LogTest
+{
+public:
+
+    // Constructs a new write test with 'threadCount' threads each writing
+    // messages of 'messageSize' characters into 'memorySize' bytes of record
+    // memory.
+    WriteTest(const std::string& name, int threadCount, size_t messageSize,
+        size_t memorySize = WRITE_TEST_DEFAULT_MEMORY_SIZE);
+
+private:
+    // No copy or assignment permitted.
+    WriteTest(const WriteTest& other);
+    WriteTest& operator=(const WriteTest& other);
+public:
+
+    // Destroys this write test.
+    virtual ~WriteTest(void);
+
+private:
+
+    // The number of characters in each message.
+    size_t m_messageSize;
+
+    // The size of the record memory.
+    size_t m_memorySize;
+
+    // The number of messages written by each thread per iteration.
+    size_t m_writesPerThread;
+
+    // The message written.
+    std::string m_message;
+
+    // The number of records drained.
+    unsigned long long m_drainedCount;
+
+protected:
+
+    // Opens the log.
+    virtual void before(void);
+
+    // Drains the records written by the previous iteration.
+    virtual void beforeIteration(void);
+
+    // Drains the remaining records and closes the log.
+    virtual void after(void);
+
+private:
+
+    // Writes the messages for one thread.
+    void threadWrite(void);
+
+public:
+
+    // The total number of operations that were performed.
+    virtual unsigned long totalOperationCount(void) const;
+
+    // Gets a description of the configuration of this test.
+    virtual std::string config(void) const;
+
+    // Gets a description of the results for this test.
+    virtual std::string results(void) const;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -56,7 +56,7 @@ public:
 private:
 
     // The actual hash memory to use.
-    uint32_t m_words[AQLOG_HASH_TABLE_WORDS];
+    uint32_t m_words[AQLOG_HASH_MEMORY_WORDS];
 };
 
 
@@ -63,7 +63,7 @@ LogReaderTest::LogReaderTest(AQLogLevel_t level, string tier1, string tier2,
     : m_sm(clearMemory(m_mem, sizeof(m_mem)), sizeof(m_mem))
     , m_logMem(m_sm)
     , m_handler(level, tier1, tier2, tier3)
-    , reader(m_logMem.aqMemory())
+    , reader(m_logMem)
     , hash(m_logMem.logLevelHashMemory())
     , aq(m_logMem.aqMemory())
 {
@@ -135,7 +135,9 @@ private:
     static void *clearMemory(void *mem, size_t memSize);
 
     // The log memory used in the m_sm field.
-    uint32_t m_mem[AQLOG_HASH_TABLE_WORDS + 10000];
+    uint32_t m_mem[  AQLOG_HASH_MEMORY_WORDS
+                   + (AQLOG_STRING_TABLE_SIZE + AQLOG_DROP_COUNTERS_SIZE) / sizeof(uint32_t)
+                   + 10000];
 
     // The shared memory.
     AQExternMemory m_sm;
@@ -151,6 +153,9 @@ public:
     // Gets the AQ memory region.
     IAQSharedMemory& aqMemory(void) { return m_logMem.aqMemory(); }
 
+    // Gets the string table memory region.
+    IAQSharedMemory& stringTableMemory(void) { return m_logMem.stringTableMemory(); }
+
     // The log reader.
     LogReader reader;
 
@@ -56,8 +56,9 @@ using namespace aqosa;
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
-// Returns the size of a file as it is saved to the log.
-static size_t savedSizeOfFile(const char *file);
+// Writes an info level record with the message 'msg' from a single call site.
+static void logFromCallSite(const char *msg);
+
 
 
 
@@ -73,23 +74,14 @@ static size_t savedSizeOfFile(const char *file);
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-TEST_SUITE(UtAQLog);
-
-//------------------------------------------------------------------------------
-static size_t savedSizeOfFile(const char *file)
+static void logFromCallSite(const char *msg)
 {
-    const char *p = file;
-    while (*p != '\0')
-    {
-        if (*p == '/' || *p == '\\')
-        {
-            file = &p[1];
-        }
-        p++;
-    }
-    return strlen(p);
+    AQLog_Info("%s", msg);
 }
 
+//------------------------------------------------------------------------------
+TEST_SUITE(UtAQLog);
+
 //------------------------------------------------------------------------------
 TEST(given_MemoryRegionTooSmall_when_AQLogInit_then_ErrorReturned)
 {
@@ -110,15 +102,11 @@ TEST(given_LogQueueCanOnlyContainTruncatedData_when_WriteLargeData_then_DataTrun
 {
     size_t maxSpace = sizeof(AQLogRecord::Overlay) 
         + sizeof(BinaryData_g) 
-        + ProcessIdentifier::currentProcessName().size() + 1
-        + sizeof(AQLOG_COMPONENT_ID) 
-        + sizeof("") 
-        + savedSizeOfFile(__FILE__) 
-        + sizeof(__FUNCTION__) 
         + AQLOG_RESERVE_MESSAGE_SIZE
         - 1;
 
     LogReaderTest log(AQLOG_LEVEL_INFO);
+    log.reader.setReserveSize(0);
     while (log.aq.availableSize() > maxSpace)
     {
         AQLog_Info("");
@@ -129,27 +117,23 @@ TEST(given_LogQueueCanOnlyContainTruncatedData_when_WriteLargeData_then_DataTrun
     AQLogRecord *rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
     log.requireTruncatedData(rec, "Lorem ipsum dolor sit amet", BinaryData_g,
         AQLOG_COMPONENT_ID, "", __FILE__, 0, __FUNCTION__, AQLOG_LEVEL_NOTICE);
-    REQUIRE(!rec->isReportingOutOfSpaceDrop());
+    REQUIRE(!rec->isDropReport());
 
     AQLog_Notice("");
     rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
-    REQUIRE(!rec->isReportingOutOfSpaceDrop());
+    REQUIRE(!rec->isDropReport());
 }
 
 //------------------------------------------------------------------------------
-TEST(given_LogQueueCannotContainTruncatedData_when_WriteLargeData_then_NothingWrittenAndOutOfSpaceFlagSet)
+TEST(given_LogQueueCannotContainTruncatedData_when_WriteLargeData_then_NothingWrittenAndDropReported)
 {
     size_t maxSpace = sizeof(AQLogRecord::Overlay)
         + AQLOG_DATA_TRUNCATE_SIZE - 1
-        + ProcessIdentifier::currentProcessName().size() + 1
-        + sizeof(AQLOG_COMPONENT_ID)
-        + sizeof("")
-        + savedSizeOfFile(__FILE__)
-        + sizeof(__FUNCTION__)
         + AQLOG_RESERVE_MESSAGE_SIZE
         - 1;
 
     LogReaderTest log(AQLOG_LEVEL_INFO);
+    log.reader.setReserveSize(0);
     while (log.aq.availableSize() > maxSpace)
     {
         AQLog_Info("");
@@ -158,27 +142,26 @@ TEST(given_LogQueueCannotContainTruncatedData_when_WriteLargeData_then_NothingWr
     AQLog_DNotice(BinaryData_g, sizeof(BinaryData_g), "%s%s", "Lorem ipsum dolor sit", " amet");
 
     AQLogRecord *rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
-    REQUIRE(rec == NULL);
+    REQUIRE(rec->isDropReport());
+    REQUIRE(rec->droppedCount() == 1);
+    REQUIRE(string(rec->componentId()) == AQLOG_COMPONENT_ID);
+    REQUIRE(rec->message().toString() == "1 record dropped due to lack of log queue space");
 
     AQLog_Notice("");
     rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
-    REQUIRE(rec->isReportingOutOfSpaceDrop());
+    REQUIRE(!rec->isDropReport());
 }
 
 //------------------------------------------------------------------------------
-TEST(given_LogQueueCannotContainMessage_when_WriteEmptyMessage_then_NothingWrittenAndOutOfSpaceFlagSet)
+TEST(given_LogQueueCannotContainMessage_when_WriteEmptyMessage_then_NothingWrittenAndDropReported)
 {
     size_t maxSpace = sizeof(AQLogRecord::Overlay)
         + 0
-        + ProcessIdentifier::currentProcessName().size() + 1
-        + sizeof(AQLOG_COMPONENT_ID)
-        + sizeof("")
-        + savedSizeOfFile(__FILE__)
-        + sizeof(__FUNCTION__)
         + AQLOG_RESERVE_MESSAGE_SIZE
         - 1;
 
     LogReaderTest log(AQLOG_LEVEL_INFO);
+    log.reader.setReserveSize(0);
     while (log.aq.availableSize() > maxSpace)
     {
         AQLog_Info("");
@@ -186,26 +169,25 @@ TEST(given_LogQueueCannotContainMessage_when_WriteEmptyMessage_then_NothingWritt
 
     AQLog_Notice("");
     AQLogRecord *rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
-    REQUIRE(rec == NULL);
+    REQUIRE(rec->isDropReport());
+    REQUIRE(rec->droppedCount() == 1);
+    REQUIRE(string(rec->componentId()) == AQLOG_COMPONENT_ID);
+    REQUIRE(rec->message().toString() == "1 record dropped due to lack of log queue space");
 
     AQLog_Notice("");
     rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
-    REQUIRE(rec->isReportingOutOfSpaceDrop());
+    REQUIRE(!rec->isDropReport());
 }
 
 //------------------------------------------------------------------------------
 TEST(given_LogQueueCannotContainWholeMessage_when_WriteLargeMessage_then_MessageTruncated)
 {
     size_t maxSpace = sizeof(AQLogRecord::Overlay)
-        + ProcessIdentifier::currentProcessName().size() + 1
-        + sizeof(AQLOG_COMPONENT_ID)
-        + sizeof("")
-        + savedSizeOfFile(__FILE__)
-        + sizeof(__FUNCTION__)
         + sizeof(LONG_STR_844) - 1
         - 1;
 
     LogReaderTest log(AQLOG_LEVEL_INFO);
+    log.reader.setReserveSize(0);
     while (log.aq.availableSize() > maxSpace)
     {
         AQLog_Info("");
@@ -215,26 +197,22 @@ TEST(given_LogQueueCannotContainWholeMessage_when_WriteLargeMessage_then_Message
     AQLogRecord *rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
     log.requireTruncatedMessage(rec, LONG_STR_844, 
         AQLOG_COMPONENT_ID, "", __FILE__, 0, __FUNCTION__, AQLOG_LEVEL_NOTICE);
-    REQUIRE(!rec->isReportingOutOfSpaceDrop());
+    REQUIRE(!rec->isDropReport());
 
     AQLog_Notice("");
     rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
-    REQUIRE(!rec->isReportingOutOfSpaceDrop());
+    REQUIRE(!rec->isDropReport());
 }
 
 //------------------------------------------------------------------------------
 TEST(given_LogQueueCannotContainWholeMessage_when_WriteLargeDataLargeMessage_then_DataAndMessageTruncated)
 {
     size_t maxSpace = sizeof(AQLogRecord::Overlay)
-        + ProcessIdentifier::currentProcessName().size() + 1
-        + sizeof(AQLOG_COMPONENT_ID)
-        + sizeof("")
-        + savedSizeOfFile(__FILE__)
-        + sizeof(__FUNCTION__)
         + sizeof(LONG_STR_865) - 1
         - 1;
 
     LogReaderTest log(AQLOG_LEVEL_INFO);
+    log.reader.setReserveSize(0);
     while (log.aq.availableSize() > maxSpace)
     {
         AQLog_Info("");
@@ -244,11 +222,115 @@ TEST(given_LogQueueCannotContainWholeMessage_when_WriteLargeDataLargeMessage_the
     AQLogRecord *rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
     log.requireTruncatedMessageData(rec, LONG_STR_865, BinaryData_g,
         AQLOG_COMPONENT_ID, "", __FILE__, 0, __FUNCTION__, AQLOG_LEVEL_NOTICE);
-    REQUIRE(!rec->isReportingOutOfSpaceDrop());
+    REQUIRE(!rec->isDropReport());
 
     AQLog_Notice("");
     rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
-    REQUIRE(!rec->isReportingOutOfSpaceDrop());
+    REQUIRE(!rec->isDropReport());
+}
+
+//------------------------------------------------------------------------------
+TEST(given_LogQueueFull_when_WriteAtDifferentLevels_then_DropReportedPerLevelMostSevereFirst)
+{
+    size_t maxSpace = sizeof(AQLogRecord::Overlay)
+        + 0
+        + AQLOG_RESERVE_MESSAGE_SIZE
+        - 1;
+
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    log.reader.setReserveSize(0);
+    while (log.aq.availableSize() > maxSpace)
+    {
+        AQLog_Info("");
+    }
+
+    AQLog_Notice("");
+    AQLog_Warning("");
+    AQLog_Warning("");
+
+    AQLogRecord *rec = log.nextLevelRecord(AQLOG_LEVEL_WARNING);
+    REQUIRE(rec != NULL);
+    REQUIRE(rec->isDropReport());
+    REQUIRE(rec->droppedCount() == 2);
+    REQUIRE(rec->message().toString() == "2 records dropped due to lack of log queue space");
+    log.reader.release(rec);
+
+    rec = log.nextLevelRecord(AQLOG_LEVEL_NOTICE);
+    REQUIRE(rec != NULL);
+    REQUIRE(rec->isDropReport());
+    REQUIRE(rec->droppedCount() == 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_LogQueueReserve_when_InfoFloodsQueue_then_ErrorWrittenAndInfoDropReported)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    size_t queueSize = log.aq.availableSize();
+    for (size_t i = 0; i < queueSize; ++i)
+    {
+        AQLog_Info("flood");
+    }
+    REQUIRE(log.aq.availableSize() > 0);
+
+    AQLog_Error("severe");
+
+    bool errorFound = false;
+    bool dropFound = false;
+    uint32_t maxRecallMs;
+    int sleepCount = 0;
+    while (sleepCount < 3)
+    {
+        AQLogRecord *rec = log.reader.retrieve(maxRecallMs);
+        if (rec == NULL)
+        {
+            Timer::sleep(maxRecallMs + 25);
+            sleepCount++;
+            continue;
+        }
+        sleepCount = 0;
+        if (rec->level() == AQLOG_LEVEL_ERROR)
+        {
+            REQUIRE(!rec->isDropReport());
+            REQUIRE(rec->message().toString() == "severe");
+            errorFound = true;
+        }
+        else if (rec->isDropReport())
+        {
+            REQUIRE(rec->level() == AQLOG_LEVEL_INFO);
+            REQUIRE(rec->droppedCount() > 0);
+            dropFound = true;
+        }
+        log.reader.release(rec);
+    }
+    REQUIRE(errorFound);
+    REQUIRE(dropFound);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_CallSiteStringsCached_when_ConsumerFormatsStringTable_then_StringsInternedAgain)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+
+    logFromCallSite("before");
+    AQLogRecord *rec = log.nextLevelRecord(AQLOG_LEVEL_INFO);
+    log.requireMessage(rec, "before", AQLOG_COMPONENT_ID, "", __FILE__, 0,
+        "logFromCallSite", AQLOG_LEVEL_INFO);
+
+    // A restarted consumer formats the string table again and then interns
+    // strings of its own into the slots the call site used.
+    StringTable restarted(log.stringTableMemory());
+    restarted.format();
+    for (int i = 0; i < 100; ++i)
+    {
+        char str[16];
+        sprintf(str, "other%d", i);
+        restarted.intern(str, strlen(str));
+    }
+
+    logFromCallSite("after");
+    rec = log.nextLevelRecord(AQLOG_LEVEL_INFO);
+    log.requireMessage(rec, "after", AQLOG_COMPONENT_ID, "", __FILE__, 0,
+        "logFromCallSite", AQLOG_LEVEL_INFO);
 }
 
 
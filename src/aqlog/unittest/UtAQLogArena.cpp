@@ -0,0 +1,160 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQLogArena.h"
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtAQLogArena);
+
+//------------------------------------------------------------------------------
+TEST(given_NewArena_when_Constructed_then_NoBlocks)
+{
+    AQLogArena arena;
+
+    REQUIRE(arena.blockCount() == 0);
+    REQUIRE(arena.capacity() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_NewArena_when_SmallAllocs_then_AllocatedContiguouslyFromFirstBlock)
+{
+    AQLogArena arena;
+
+    char *a = arena.alloc(10);
+    char *b = arena.alloc(20);
+    char *c = arena.alloc(AQLogArena::FIRST_BLOCK_SIZE - 30);
+
+    REQUIRE(b == a + 10);
+    REQUIRE(c == b + 20);
+    REQUIRE(arena.blockCount() == 1);
+    REQUIRE(arena.capacity() == AQLogArena::FIRST_BLOCK_SIZE);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FullBlock_when_Alloc_then_LargerBlockAdded)
+{
+    AQLogArena arena;
+    arena.alloc(AQLogArena::FIRST_BLOCK_SIZE);
+
+    arena.alloc(1);
+
+    REQUIRE(arena.blockCount() == 2);
+    REQUIRE(arena.capacity() == 3 * AQLogArena::FIRST_BLOCK_SIZE);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_NewArena_when_AllocLargerThanBlock_then_BlockSizedToFit)
+{
+    AQLogArena arena;
+
+    arena.alloc(AQLogArena::FIRST_BLOCK_SIZE * 10);
+
+    REQUIRE(arena.blockCount() == 1);
+    REQUIRE(arena.capacity() == AQLogArena::FIRST_BLOCK_SIZE * 10);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ArenaWithBlocks_when_Reset_then_BlocksReusedInOrder)
+{
+    AQLogArena arena;
+    char *a = arena.alloc(AQLogArena::FIRST_BLOCK_SIZE);
+    char *b = arena.alloc(AQLogArena::FIRST_BLOCK_SIZE);
+    size_t capacity = arena.capacity();
+
+    arena.reset();
+
+    REQUIRE(arena.alloc(AQLogArena::FIRST_BLOCK_SIZE) == a);
+    REQUIRE(arena.alloc(AQLogArena::FIRST_BLOCK_SIZE) == b);
+    REQUIRE(arena.blockCount() == 2);
+    REQUIRE(arena.capacity() == capacity);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_MixedAllocs_when_ResetAndRepeated_then_NoBlocksAdded)
+{
+    AQLogArena arena;
+    for (size_t i = 1; i < 16; ++i)
+    {
+        arena.alloc(i * 97);
+    }
+    arena.reset();
+    for (size_t i = 1; i < 16; ++i)
+    {
+        arena.alloc(i * 97);
+    }
+    size_t blocks = arena.blockCount();
+    size_t capacity = arena.capacity();
+
+    for (int j = 0; j < 4; ++j)
+    {
+        arena.reset();
+        for (size_t i = 1; i < 16; ++i)
+        {
+            arena.alloc(i * 97);
+        }
+        REQUIRE(arena.blockCount() == blocks);
+        REQUIRE(arena.capacity() == capacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(given_Reserved_when_Committed_then_NextAllocFollows)
+{
+    AQLogArena arena;
+
+    char *a = arena.reserve(100);
+    arena.commit(40);
+    char *b = arena.alloc(1);
+
+    REQUIRE(b == a + 40);
+}
+
+
+
+
+//=============================== End of File ==================================
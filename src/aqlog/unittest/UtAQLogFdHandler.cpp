@@ -0,0 +1,224 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQLogFdHandler.h"
+#include "AQLogFormatter.h"
+#include "AQLogRecord.h"
+#include "AQLogStringBuilder.h"
+
+#ifdef WIN32
+#include <fcntl.h>
+#include <io.h>
+#define pipe(fds)                       _pipe(fds, 65536, _O_BINARY)
+#define read                            _read
+#define close                           _close
+#else
+#include <unistd.h>
+#endif
+
+#include <string>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The component used by the test records.
+#define TEST_COMPONENT_ID               "fd"
+
+// The line written for a drop report of 'n' records.
+#define TEST_LINE(n)                    TEST_COMPONENT_ID ": " #n " records dropped due to lack of log queue space\n"
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// A formatter that writes the component and message of each record without
+// copying either.
+class PointerFormatter : public AQLogFormatter
+{
+public:
+    virtual void format(const AQLogRecord& rec, AQLogStringBuilder& sb) const
+    {
+        sb.appendPointer(rec.componentId());
+        sb.appendPointer(": ");
+        sb.appendPointer(rec.message());
+    }
+};
+
+// Owns a pipe that the handler under test writes to.
+class TestPipe
+{
+public:
+    TestPipe(void)
+    {
+        REQUIRE(pipe(m_fds) == 0);
+    }
+
+    ~TestPipe(void)
+    {
+        close(m_fds[0]);
+        close(m_fds[1]);
+    }
+
+    // The descriptor written by the handler.
+    int fd(void) const { return m_fds[1]; }
+
+    // Reads exactly 'len' bytes from the pipe.
+    string read(size_t len)
+    {
+        string s(len, '\0');
+        size_t pos = 0;
+        while (pos < len)
+        {
+            int n = ::read(m_fds[0], &s[pos], (unsigned int)(len - pos));
+            REQUIRE(n > 0);
+            pos += n;
+        }
+        return s;
+    }
+
+private:
+    int m_fds[2];
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtAQLogFdHandler);
+
+//------------------------------------------------------------------------------
+TEST(given_RecordsHandled_when_NotFlushed_then_NothingWritten)
+{
+    TestPipe p;
+    PointerFormatter f;
+    AQLogFdHandler h(p.fd(), f);
+    AQLogRecord rec;
+    rec.populateDropReport(AQLOG_LEVEL_INFO, TEST_COMPONENT_ID, 2);
+
+    h.handle(rec);
+    h.handle(rec);
+
+    REQUIRE(h.writeCount() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_RecordsHandled_when_Flushed_then_BatchWrittenInOneCall)
+{
+    TestPipe p;
+    PointerFormatter f;
+    AQLogFdHandler h(p.fd(), f);
+    AQLogRecord rec2;
+    rec2.populateDropReport(AQLOG_LEVEL_INFO, TEST_COMPONENT_ID, 2);
+    AQLogRecord rec3;
+    rec3.populateDropReport(AQLOG_LEVEL_INFO, TEST_COMPONENT_ID, 3);
+
+    h.handle(rec2);
+    h.handle(rec3);
+    h.handle(rec2);
+    h.flush();
+
+    REQUIRE(h.writeCount() == 1);
+    REQUIRE(h.errorCount() == 0);
+    string expected = TEST_LINE(2) TEST_LINE(3) TEST_LINE(2);
+    REQUIRE(p.read(expected.size()) == expected);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_EmptyBatch_when_Flushed_then_NothingWritten)
+{
+    TestPipe p;
+    PointerFormatter f;
+    AQLogFdHandler h(p.fd(), f);
+
+    h.flush();
+
+    REQUIRE(h.writeCount() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_BatchReachesMaxIov_when_Handled_then_WrittenBeforeFlush)
+{
+    TestPipe p;
+    PointerFormatter f;
+    AQLogFdHandler h(p.fd(), f, 1000);
+    AQLogRecord rec;
+    rec.populateDropReport(AQLOG_LEVEL_INFO, TEST_COMPONENT_ID, 4);
+
+    // Each record adds at least two vectors that cannot be coalesced.
+    size_t count = 0;
+    while (h.writeCount() == 0)
+    {
+        h.handle(rec);
+        count++;
+        REQUIRE(count <= AQLogFdHandler::MAX_WRITE_IOV);
+    }
+    h.flush();
+
+    string expected;
+    for (size_t i = 0; i < count; ++i)
+    {
+        expected += TEST_LINE(4);
+    }
+    REQUIRE(h.errorCount() == 0);
+    REQUIRE(p.read(expected.size()) == expected);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ClosedDescriptor_when_Flushed_then_ErrorCounted)
+{
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    close(fds[0]);
+    close(fds[1]);
+    PointerFormatter f;
+    AQLogFdHandler h(fds[1], f);
+    AQLogRecord rec;
+    rec.populateDropReport(AQLOG_LEVEL_INFO, TEST_COMPONENT_ID, 2);
+
+    h.handle(rec);
+    h.flush();
+
+    REQUIRE(h.errorCount() == 1);
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -72,8 +72,9 @@ typedef enum ACTION_EN
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
-// Returns the test record by passing it through the log.
-static vector<char> getTestRecord(LogReaderTest &log);
+// Returns the test record by passing it through the log.  If 'site' is NULL
+// all strings are written into the record, otherwise they are interned.
+static vector<char> getTestRecord(LogReaderTest &log, AQLogCallSite_t *site = NULL);
 
 // Converts raw log string data into an AQItem which is then set in the passed
 // test record.
@@ -202,6 +203,38 @@ TEST(given_LogRecordTruncatedProcessName_when_Populate_ErrorTruncatedProcessName
         == AQLogRecord::POPULATE_ERROR_TRUNCATED_PROCESS_NAME);
 }
 
+//------------------------------------------------------------------------------
+TEST(given_LogRecordInternedStrings_when_PopulateWithoutStringTable_then_ErrorTruncatedComponentId)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    AQLogCallSite_t site;
+    memset(&site, 0, sizeof(site));
+    vector<char> data = getTestRecord(log, &site);
+
+    AQLogRecord rec;
+    setTestRecord(rec, data);
+    REQUIRE(rec.populate() == AQLogRecord::POPULATE_ERROR_TRUNCATED_COMPONENT_ID);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_LogRecordInternedStrings_when_Written_then_StringsNotInRecord)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    AQLogCallSite_t site;
+    memset(&site, 0, sizeof(site));
+    vector<char> inlineData = getTestRecord(log);
+    vector<char> internData = getTestRecord(log, &site);
+
+    size_t stringSize = sizeof(MARK_COMPONENT_ID) + sizeof(MARK_TAG_ID) 
+        + sizeof(MARK_FILE) + sizeof(MARK_FUNC) 
+        + ProcessIdentifier::currentProcessName().size() + 1;
+    REQUIRE(internData.size() == inlineData.size() - stringSize);
+    REQUIRE(site.strId[AQLOG_LOOKUP_TIER_COMPONENTID] != 0);
+    REQUIRE(site.strId[AQLOG_LOOKUP_TIER_TAGID] != 0);
+    REQUIRE(site.strId[AQLOG_LOOKUP_TIER_FILE] != 0);
+    REQUIRE(site.strId[AQLOG_EXTRA_TIER_FUNCTION] != 0);
+}
+
 //------------------------------------------------------------------------------
 static AQLogRecord::PopulateOutcome truncateStringAndPopulate(AQLogRecord& rec, 
     const string& str)
@@ -223,9 +256,9 @@ static AQLogRecord::PopulateOutcome truncateStringAndPopulate(AQLogRecord& rec,
 }
 
 //------------------------------------------------------------------------------
-static vector<char> getTestRecord(LogReaderTest &log)
+static vector<char> getTestRecord(LogReaderTest &log, AQLogCallSite_t *site)
 {
-    __AQLog_Write(AQLOG_LEVEL_NOTICE,
+    __AQLog_Write(site, AQLOG_LEVEL_NOTICE,
         MARK_COMPONENT_ID, sizeof(MARK_COMPONENT_ID),
         MARK_TAG_ID, sizeof(MARK_TAG_ID),
         MARK_FILE, sizeof(MARK_FILE),
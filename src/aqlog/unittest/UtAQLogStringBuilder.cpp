@@ -2632,6 +2632,54 @@ TEST(given_SbFragmented_when_WrittenToOstream_OstreamContainsString)
 }
 
 
+//------------------------------------------------------------------------------
+TEST(given_SbFormatted_when_ClearedAndReformatted_then_ArenaNotGrown)
+{
+    AQLogStringBuilder msg;
+    for (int i = 0; i < 8; ++i)
+    {
+        msg.appendCopy(LONG_STR_BUF, LONG_STR_LEN);
+        msg.appendf("%s %d", LONG_STR, i);
+    }
+    size_t blocks = msg.arena().blockCount();
+    size_t capacity = msg.arena().capacity();
+    REQUIRE(blocks > 0);
+
+    for (int j = 0; j < 4; ++j)
+    {
+        msg.clear();
+        REQUIRE(msg.size() == 0);
+        for (int i = 0; i < 8; ++i)
+        {
+            msg.appendCopy(LONG_STR_BUF, LONG_STR_LEN);
+            msg.appendf("%s %d", LONG_STR, i);
+        }
+        REQUIRE(msg.size() == 8 * (2 * LONG_STR_LEN + 2));
+        REQUIRE(msg.arena().blockCount() == blocks);
+        REQUIRE(msg.arena().capacity() == capacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(given_SbStaticBufferFull_when_Appendftime_then_ArenaHoldsFormattedText)
+{
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_year = 77;
+    tm.tm_mon = 6;
+    tm.tm_mday = 23;
+    tm.tm_hour = 3;
+    tm.tm_min = 19;
+    tm.tm_sec = 52;
+
+    AQLogStringBuilder msg;
+    msg.appendCopy(LONG_STR_BUF, 64);
+    REQUIRE(msg.arena().blockCount() == 0);
+    msg.appendftime(STRFTIME_TEST_TIME_FMT, &tm);
+    REQUIRE(msg.arena().blockCount() == 1);
+    REQUIRE(msg.toString() == string(LONG_STR_BUF, 64) + STRFTIME_TEST_TIME_STR);
+}
+
 
 
 //=============================== End of File ==================================
@@ -0,0 +1,239 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQLogRecord.h"
+#include "AQLogStringBuilder.h"
+
+#include "DefaultFormatter.h"
+#include "LogReaderTest.h"
+
+#include "Timestamp.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace aqlog;
+using namespace aqosa;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The fields of the test records.
+#define TEST_COMPONENT_ID               "comp"
+#define TEST_TAG_ID                     "tag"
+#define TEST_FILE                       "file.cpp"
+#define TEST_FUNC                       "func"
+#define TEST_LINE                       42
+#define TEST_MESSAGE                    "hello world"
+
+// A timestamp with a millisecond part of 123.
+#define TEST_TIMESTAMP_NS               1234567890123456789ULL
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Logs a test record at 'level' through 'log' and returns it.
+static AQLogRecord *logTestRecord(LogReaderTest& log, AQLogLevel_t level);
+
+// Formats 'rec' with 'formatter' and returns the result.
+static string format(const DefaultFormatter& formatter, const AQLogRecord& rec);
+
+#ifdef AQ_TEST_UNIT
+// Returns the local date and time at 'ns' as formatted by the formatter.
+static string localSecond(uint64_t ns);
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtDefaultFormatter);
+
+//------------------------------------------------------------------------------
+static AQLogRecord *logTestRecord(LogReaderTest& log, AQLogLevel_t level)
+{
+    __AQLog_Write(NULL, level,
+        TEST_COMPONENT_ID, sizeof(TEST_COMPONENT_ID),
+        TEST_TAG_ID, sizeof(TEST_TAG_ID),
+        TEST_FILE, sizeof(TEST_FILE),
+        TEST_FUNC, sizeof(TEST_FUNC),
+        TEST_LINE, NULL, 0, "%s", TEST_MESSAGE);
+    AQLogRecord *rec = log.nextLevelRecord(level);
+    CHECK(rec != NULL);
+    return rec;
+}
+
+//------------------------------------------------------------------------------
+static string format(const DefaultFormatter& formatter, const AQLogRecord& rec)
+{
+    AQLogStringBuilder sb;
+    formatter.format(rec, sb);
+    return sb.toString();
+}
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+static string localSecond(uint64_t ns)
+{
+    AQLogStringBuilder sb;
+    sb.appendftime("%Y-%m-%d %H:%M:%S", (time_t)(ns / 1000000000));
+    return sb.toString();
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_DefaultPattern_when_RecordFormatted_then_FieldsInPatternOrder)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    DefaultFormatter formatter;
+    Timestamp::fixTimestamp(TEST_TIMESTAMP_NS);
+    AQLogRecord *rec = logTestRecord(log, AQLOG_LEVEL_NOTICE);
+
+    REQUIRE(format(formatter, *rec) == localSecond(TEST_TIMESTAMP_NS) 
+        + ".123 NOTICE [" TEST_COMPONENT_ID "/" TEST_TAG_ID "] " TEST_FILE ":42 " TEST_MESSAGE);
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_RecordsInSameSecond_when_Formatted_then_OnlyMillisecondsDiffer)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    DefaultFormatter formatter("%T");
+    Timestamp::fixTimestamp(TEST_TIMESTAMP_NS);
+    AQLogRecord *rec = logTestRecord(log, AQLOG_LEVEL_INFO);
+    string first = format(formatter, *rec);
+    Timestamp::fixTimestamp(TEST_TIMESTAMP_NS + 7000000);
+    rec = logTestRecord(log, AQLOG_LEVEL_INFO);
+    string second = format(formatter, *rec);
+    Timestamp::fixTimestamp(TEST_TIMESTAMP_NS + 1000000000);
+    rec = logTestRecord(log, AQLOG_LEVEL_INFO);
+    string third = format(formatter, *rec);
+
+    REQUIRE(first == localSecond(TEST_TIMESTAMP_NS) + ".123");
+    REQUIRE(second == localSecond(TEST_TIMESTAMP_NS) + ".130");
+    REQUIRE(third == localSecond(TEST_TIMESTAMP_NS + 1000000000) + ".123");
+}
+#endif
+
+//------------------------------------------------------------------------------
+TEST(given_PatternWithProcessDirectives_when_RecordFormatted_then_ProcessFieldsWritten)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    DefaultFormatter formatter("%p(%P:%i) %F %L");
+    AQLogRecord *rec = logTestRecord(log, AQLOG_LEVEL_ERROR);
+
+    ostringstream ss;
+    ss << rec->processName() << "(" << rec->processId() << ":" << rec->threadId()
+        << ") " TEST_FUNC " ERROR";
+    REQUIRE(format(formatter, *rec) == ss.str());
+}
+
+//------------------------------------------------------------------------------
+TEST(given_PatternWithLiteralPercent_when_RecordFormatted_then_SinglePercentWritten)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    DefaultFormatter formatter("100%% %c%%%t%%");
+    AQLogRecord *rec = logTestRecord(log, AQLOG_LEVEL_INFO);
+
+    REQUIRE(format(formatter, *rec) == "100% " TEST_COMPONENT_ID "%" TEST_TAG_ID "%");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_EmptyPattern_when_RecordFormatted_then_NothingWritten)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    DefaultFormatter formatter("");
+    AQLogRecord *rec = logTestRecord(log, AQLOG_LEVEL_INFO);
+
+    REQUIRE(format(formatter, *rec) == "");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_RecordWithData_when_FormattedWithDataDirective_then_HexDumpFollowsMessage)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    DefaultFormatter formatter("%m%d");
+    __AQLog_Write(NULL, AQLOG_LEVEL_INFO,
+        TEST_COMPONENT_ID, sizeof(TEST_COMPONENT_ID),
+        TEST_TAG_ID, sizeof(TEST_TAG_ID),
+        TEST_FILE, sizeof(TEST_FILE),
+        TEST_FUNC, sizeof(TEST_FUNC),
+        TEST_LINE, "abc", 3, "%s", TEST_MESSAGE);
+    AQLogRecord *rec = log.nextLevelRecord(AQLOG_LEVEL_INFO);
+    REQUIRE(rec != NULL);
+
+    REQUIRE(format(formatter, *rec) == TEST_MESSAGE
+        "\n  00000000  61 62 63                                          |abc|");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_RecordWithoutData_when_FormattedWithDataDirective_then_NothingAdded)
+{
+    LogReaderTest log(AQLOG_LEVEL_INFO);
+    DefaultFormatter formatter("%m%d");
+    AQLogRecord *rec = logTestRecord(log, AQLOG_LEVEL_INFO);
+
+    REQUIRE(format(formatter, *rec) == TEST_MESSAGE);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_DropReport_when_Formatted_then_LevelComponentAndMessageWritten)
+{
+    DefaultFormatter formatter("%L %c: %m");
+    AQLogRecord rec;
+    rec.populateDropReport(AQLOG_LEVEL_WARNING, TEST_COMPONENT_ID, 3);
+
+    REQUIRE(format(formatter, rec) == "WARNING " TEST_COMPONENT_ID ": 3 records dropped due to lack of log queue space");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_PatternWithUnknownDirective_when_Constructed_then_InvalidArgumentException)
+{
+    REQUIRE_EXCEPTION(DefaultFormatter("%T %q"), invalid_argument);
+    REQUIRE_EXCEPTION(DefaultFormatter("%m %"), invalid_argument);
+}
+
+
+
+
+//=============================== End of File ==================================
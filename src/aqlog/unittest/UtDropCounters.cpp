@@ -0,0 +1,161 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQLog.h"
+
+#include "DropCounters.h"
+
+#include "AQHeapMemory.h"
+
+#include <string.h>
+
+using namespace aqlog;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtDropCounters);
+
+//------------------------------------------------------------------------------
+TEST(given_MemoryRegionTooSmall_when_DropCounters_then_LengthErrorException)
+{
+    AQHeapMemory mem(AQLOG_DROP_COUNTERS_SIZE - 1);
+
+    REQUIRE_EXCEPTION(DropCounters dc(mem), length_error);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_UnformattedCounters_when_Increment_then_NothingCounted)
+{
+    AQHeapMemory mem(AQLOG_DROP_COUNTERS_SIZE);
+    memset(mem.baseAddress(), 0, mem.size());
+    DropCounters dc(mem);
+
+    REQUIRE(!dc.isFormatted());
+    dc.increment(1, AQLOG_LEVEL_INFO);
+    REQUIRE(dc.totalCount() == 0);
+    REQUIRE(dc.take(1, AQLOG_LEVEL_INFO) == 0);
+    REQUIRE(dc.reserveSize(AQLOG_LEVEL_INFO) == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedCounters_when_Increment_then_CountedPerComponentAndLevel)
+{
+    AQHeapMemory mem(AQLOG_DROP_COUNTERS_SIZE);
+    DropCounters dc(mem);
+    dc.format(0);
+
+    dc.increment(1, AQLOG_LEVEL_INFO);
+    dc.increment(1, AQLOG_LEVEL_INFO);
+    dc.increment(1, AQLOG_LEVEL_DEBUG);
+    dc.increment(2, AQLOG_LEVEL_INFO);
+    REQUIRE(dc.totalCount() == 4);
+
+    REQUIRE(dc.take(1, AQLOG_LEVEL_INFO) == 2);
+    REQUIRE(dc.take(1, AQLOG_LEVEL_INFO) == 0);
+    REQUIRE(dc.take(1, AQLOG_LEVEL_DEBUG) == 1);
+    REQUIRE(dc.take(2, AQLOG_LEVEL_INFO) == 1);
+    REQUIRE(dc.take(2, AQLOG_LEVEL_DEBUG) == 0);
+    REQUIRE(dc.totalCount() == 4);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedCounters_when_IncrementOutOfRangeComponent_then_CountedAgainstComponentZero)
+{
+    AQHeapMemory mem(AQLOG_DROP_COUNTERS_SIZE);
+    DropCounters dc(mem);
+    dc.format(0);
+
+    dc.increment(DropCounters::COMPONENT_COUNT, AQLOG_LEVEL_NOTICE);
+    REQUIRE(dc.take(0, AQLOG_LEVEL_NOTICE) == 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedCounters_when_Increment_then_ComponentMarkedUntilTaken)
+{
+    AQHeapMemory mem(AQLOG_DROP_COUNTERS_SIZE);
+    DropCounters dc(mem);
+    dc.format(0);
+    for (uint32_t word = 0; word < DropCounters::DIRTY_WORDS; ++word)
+    {
+        REQUIRE(dc.takeDirty(word) == 0);
+    }
+
+    dc.increment(1, AQLOG_LEVEL_INFO);
+    dc.increment(33, AQLOG_LEVEL_INFO);
+    dc.increment(DropCounters::COMPONENT_COUNT - 1, AQLOG_LEVEL_INFO);
+    dc.increment(DropCounters::COMPONENT_COUNT, AQLOG_LEVEL_INFO);
+
+    REQUIRE(dc.takeDirty(0) == 0x00000003);
+    REQUIRE(dc.takeDirty(0) == 0);
+    REQUIRE(dc.takeDirty(1) == 0x00000002);
+    REQUIRE(dc.takeDirty(DropCounters::DIRTY_WORDS - 1) 
+        == 1U << ((DropCounters::COMPONENT_COUNT - 1) & 31));
+
+    // Taking the marks leaves the counts.
+    REQUIRE(dc.take(33, AQLOG_LEVEL_INFO) == 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ReserveSize_when_ReserveSizeForLevel_then_OnlyLessSevereLevelsReserved)
+{
+    AQHeapMemory mem(AQLOG_DROP_COUNTERS_SIZE);
+    DropCounters dc(mem);
+    dc.format(1000);
+
+    REQUIRE(dc.reserveSize(AQLOG_LEVEL_CRITICAL) == 0);
+    REQUIRE(dc.reserveSize(AQLOG_RESERVE_LEVEL) == 0);
+    REQUIRE(dc.reserveSize(AQLOG_LEVEL_WARNING) == 1000);
+    REQUIRE(dc.reserveSize(AQLOG_LEVEL_TRACE) == 1000);
+
+    dc.setReserveSize(0);
+    REQUIRE(dc.reserveSize(AQLOG_LEVEL_TRACE) == 0);
+}
+
+
+
+
+//=============================== End of File ==================================
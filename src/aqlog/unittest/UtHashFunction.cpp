@@ -242,6 +242,37 @@ TEST(given_String_when_InlineAndExternHashCalculated_then_HashesMatch)
     }
 }
 
+//------------------------------------------------------------------------------
+#if defined(AQLOG_HASH_USE_CONSTEXPR)
+TEST(given_DataSetStrings_when_ConstexprAndExternHashCalculated_then_HashesMatch)
+{
+    // The data set strings were generated with HashFunction::standard() so
+    // the constexpr hash must give the same indexes at compile time.
+    static_assert(AQLog_HashTierConstexpr(MAX_TIER_MASK, HASHIDX_101_A, sizeof(HASHIDX_101_A) - 1, false) == 101,
+        "constexpr hash does not match the data set");
+    static_assert(AQLog_HashTierConstexpr(MAX_TIER_MASK, HASHIDX_0_A, sizeof(HASHIDX_0_A) - 1, true) == HASHIDX_0_A_REHASH_IDX,
+        "constexpr rehash of zero does not match the data set");
+    static_assert(AQLog_HashIndexConstexpr(HASHIDX_101_A, sizeof(HASHIDX_101_A) - 1,
+                                           HASHIDX_72_A, sizeof(HASHIDX_72_A) - 1,
+                                           HASHIDX_3_A, sizeof(HASHIDX_3_A) - 1)
+                  == ((101 << AQLOG_TIER_0_BITNUM) | (72 << AQLOG_TIER_1_BITNUM) | (3 << AQLOG_TIER_2_BITNUM)),
+        "constexpr table index does not match the data set");
+
+    for (size_t i = 0; i < HASHIDX_TABLE_COUNT; ++i)
+    {
+        const char *str = HashIdxTable_g[i];
+        size_t len = strlen(str);
+        for (int rehash = 0; rehash < 2; ++rehash)
+        {
+            REQUIRE(AQLog_HashTierConstexpr(UINT32_MAX, str, len, rehash != 0)
+                == HashFunction::standard(UINT32_MAX, str, len, rehash != 0));
+            REQUIRE(AQLog_HashTierConstexpr(AQLOG_TIER_2_MASK, str, len, rehash != 0)
+                == HashFunction::standard(AQLOG_TIER_2_MASK, str, len, rehash != 0));
+        }
+    }
+}
+#endif
+
 //------------------------------------------------------------------------------
 TEST(given_MatchZeroZeroString_when_InlineAndExternHashCalculated_then_HashesMatch)
 {
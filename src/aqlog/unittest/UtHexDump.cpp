@@ -0,0 +1,149 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQLogStringBuilder.h"
+#include "HexDump.h"
+
+#include <stdio.h>
+
+#include <string>
+
+using namespace aqlog;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Dumps the 'len' bytes at 'data' and returns the result.
+static string hexDump(const void *data, size_t len, bool truncated = false);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtHexDump);
+
+//------------------------------------------------------------------------------
+static string hexDump(const void *data, size_t len, bool truncated)
+{
+    AQLogStringBuilder sb;
+    HexDump::appendHexDump(data, len, truncated, sb);
+    REQUIRE(sb.size() == HexDump::dumpSize(len, truncated));
+    return sb.toString();
+}
+
+//------------------------------------------------------------------------------
+TEST(given_NoData_when_Dumped_then_NothingAppended)
+{
+    REQUIRE(hexDump(NULL, 0) == "");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FullLine_when_Dumped_then_HexAndAsciiColumns)
+{
+    REQUIRE(hexDump("Hello, world!\n\0\x01", 16) ==
+        "\n  00000000  48 65 6c 6c 6f 2c 20 77  6f 72 6c 64 21 0a 00 01  |Hello, world!...|");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_PartialLines_when_Dumped_then_HexColumnsPadded)
+{
+    REQUIRE(hexDump("abc", 3) ==
+        "\n  00000000  61 62 63                                          |abc|");
+    REQUIRE(hexDump("0123456789abcdefXYZ~\x7f", 21) ==
+        "\n  00000000  30 31 32 33 34 35 36 37  38 39 61 62 63 64 65 66  |0123456789abcdef|"
+        "\n  00000010  58 59 5a 7e 7f                                    |XYZ~.|");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_AllByteValues_when_Dumped_then_OnlyPrintableCharactersShown)
+{
+    uint8_t data[256];
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (uint8_t)i;
+    }
+    string dump = hexDump(data, sizeof(data));
+
+    REQUIRE(dump.size() == 16 * HexDump::dumpSize(16, false));
+    for (size_t line = 0; line < 16; ++line)
+    {
+        string text = dump.substr(line * HexDump::dumpSize(16, false), HexDump::dumpSize(16, false));
+
+        char offset[16];
+        sprintf(offset, "\n  %08x  ", (unsigned int)(line * 16));
+        REQUIRE(text.substr(0, 13) == offset);
+
+        for (size_t i = 0; i < 16; ++i)
+        {
+            uint8_t b = data[line * 16 + i];
+            char hex[4];
+            sprintf(hex, "%02x", b);
+            REQUIRE(text.substr(13 + 3 * i + (i >= 8 ? 1 : 0), 2) == hex);
+            REQUIRE(text[64 + i] == (b >= ' ' && b <= '~' ? (char)b : '.'));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(given_TruncatedData_when_Dumped_then_TruncationNoted)
+{
+    REQUIRE(hexDump("ab", 2, true) ==
+        "\n  00000000  61 62                                             |ab|"
+        "\n  (truncated)");
+    REQUIRE(hexDump(NULL, 0, true) == "\n  (truncated)");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_LargePayload_when_Dumped_then_OffsetsCountUp)
+{
+    string data(4000, 'x');
+    string dump = hexDump(data.data(), data.size());
+
+    REQUIRE(dump.size() == 250 * HexDump::dumpSize(16, false));
+    REQUIRE(dump.substr(249 * HexDump::dumpSize(16, false), 13) == "\n  00000f90  ");
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,447 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQLog.h"
+
+#include "AQLogConsumer.h"
+#include "AQLogHandler.h"
+#include "AQLogRecord.h"
+#include "AQLogStringBuilder.h"
+
+#include "DefaultFormatter.h"
+#include "LogDispatcher.h"
+
+#include "Atomic.h"
+#include "Timer.h"
+#include "Timestamp.h"
+#include "WorkerThread.h"
+
+#include "AQHeapMemory.h"
+
+#include <string>
+#include <vector>
+
+using namespace aqlog;
+using namespace aqosa;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The component used by the test records.
+#define AQLOG_COMPONENT_ID              "aqlog_unittest"
+
+// The size of the shared memory used by the tests.
+#define TEST_SHM_SIZE                   (AQLOG_SHM_MINIMUM_SIZE + 64 * 1024)
+
+// The maximum number of milliseconds to wait for a handler to receive records.
+#define TEST_WAIT_MS                    5000
+
+// The timestamp of the first record logged by the shared formatter test.
+#define TEST_TIMESTAMP_NS               939920390123456789ULL
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// A handler that records the messages it handles.  The handler can be held
+// so that it blocks in handle() until it is released.
+class CollectingHandler : public AQLogHandler
+{
+public:
+    CollectingHandler(bool hold = false) : m_count(0), m_hold(hold ? 1 : 0)
+    {
+        addFilter(AQLOG_LEVEL_INFO);
+    }
+
+    virtual void handle(const AQLogRecord& rec)
+    {
+        while (Atomic::read(&m_hold) != 0)
+        {
+            WorkerThread::yieldMs(1);
+        }
+        messages.push_back(rec.message().toString());
+        Atomic::increment(&m_count);
+    }
+
+    // Waits until at least 'count' records have been handled.  Returns 
+    // false on timeout.
+    bool waitForCount(uint32_t count)
+    {
+        for (int i = 0; i < TEST_WAIT_MS && Atomic::read(&m_count) < count; ++i)
+        {
+            WorkerThread::yieldMs(1);
+        }
+        return Atomic::read(&m_count) >= count;
+    }
+
+    // Releases the handler if it is being held.
+    void release(void) { Atomic::write(&m_hold, 0); }
+
+    // The messages handled; only read once the handler thread has stopped.
+    vector<string> messages;
+
+private:
+    volatile uint32_t m_count;
+    volatile uint32_t m_hold;
+};
+
+// A handler that only reads the records it is passed once it is flushed.
+class BatchingHandler : public AQLogHandler
+{
+public:
+    BatchingHandler(size_t batchSize) : m_batchSize(batchSize), m_count(0)
+    {
+        addFilter(AQLOG_LEVEL_INFO);
+    }
+
+    virtual void handle(const AQLogRecord& rec)
+    {
+        m_held.push_back(&rec);
+    }
+
+    virtual size_t batchSize(void) const { return m_batchSize; }
+
+    virtual void flush(void)
+    {
+        batches.push_back(m_held.size());
+        for (size_t i = 0; i < m_held.size(); ++i)
+        {
+            messages.push_back(m_held[i]->message().toString());
+        }
+        Atomic::write(&m_count, Atomic::read(&m_count) + (uint32_t)m_held.size());
+        m_held.clear();
+    }
+
+    // Waits until at least 'count' records have been flushed.  Returns 
+    // false on timeout.
+    bool waitForCount(uint32_t count)
+    {
+        for (int i = 0; i < TEST_WAIT_MS && Atomic::read(&m_count) < count; ++i)
+        {
+            WorkerThread::yieldMs(1);
+        }
+        return Atomic::read(&m_count) >= count;
+    }
+
+    // The number of records in each flushed batch and the messages flushed;
+    // only read once the handler thread has stopped.
+    vector<size_t> batches;
+    vector<string> messages;
+
+private:
+    size_t m_batchSize;
+    vector<const AQLogRecord *> m_held;
+    volatile uint32_t m_count;
+};
+
+// A handler that records the output of a formatter that may be shared with
+// other handlers.
+class FormattingHandler : public AQLogHandler
+{
+public:
+    FormattingHandler(const AQLogFormatter& formatter) 
+        : m_formatter(formatter), m_count(0)
+    {
+        addFilter(AQLOG_LEVEL_INFO);
+    }
+
+    virtual void handle(const AQLogRecord& rec)
+    {
+        AQLogStringBuilder sb;
+        m_formatter.format(rec, sb);
+        lines.push_back(sb.toString());
+        Atomic::increment(&m_count);
+    }
+
+    // Waits until at least 'count' records have been handled.  Returns 
+    // false on timeout.
+    bool waitForCount(uint32_t count)
+    {
+        for (int i = 0; i < TEST_WAIT_MS && Atomic::read(&m_count) < count; ++i)
+        {
+            WorkerThread::yieldMs(1);
+        }
+        return Atomic::read(&m_count) >= count;
+    }
+
+    // The formatted records; only read once the handler thread has stopped.
+    vector<string> lines;
+
+private:
+    const AQLogFormatter& m_formatter;
+    volatile uint32_t m_count;
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+// Returns the expected "%T %m" output for record 'i' of the shared
+// formatter test.
+static string expectedLine(uint32_t i)
+{
+    uint64_t ns = TEST_TIMESTAMP_NS + i * 1000000000ULL;
+    AQLogStringBuilder sb;
+    sb.appendftime("%Y-%m-%d %H:%M:%S", (time_t)(ns / 1000000000));
+    sb.appendf(".123 record %d", i);
+    return sb.toString();
+}
+#endif
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtLogDispatcher);
+
+//------------------------------------------------------------------------------
+TEST(given_ConsumerStartedAsync_when_RecordsLogged_then_HandlerReceivesRecordsInOrder)
+{
+    AQHeapMemory mem(TEST_SHM_SIZE);
+    CollectingHandler h;
+    {
+        AQLogConsumer consumer(mem);
+        consumer.addHandler(&h);
+        REQUIRE(AQLog_InitSharedMemory(mem) == AQLOG_INITOUTCOME_SUCCESS);
+        consumer.startAsync();
+
+        AQLog_Info("first");
+        AQLog_Info("second");
+        REQUIRE(h.waitForCount(2));
+
+        consumer.stop();
+        AQLog_Deinit();
+    }
+
+    REQUIRE(h.messages.size() == 2);
+    REQUIRE(h.messages[0] == "first");
+    REQUIRE(h.messages[1] == "second");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ConsumerStartedAsync_when_StartAsyncOrExecute_then_DomainErrorException)
+{
+    AQHeapMemory mem(TEST_SHM_SIZE);
+    AQLogConsumer consumer(mem);
+    consumer.startAsync();
+
+    REQUIRE_EXCEPTION(consumer.startAsync(), domain_error);
+    REQUIRE_EXCEPTION(consumer.execute(), domain_error);
+
+    consumer.stop();
+    consumer.startAsync();
+    consumer.stop();
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ConsumerStartedAsync_when_AddOrRemoveHandler_then_DomainErrorException)
+{
+    AQHeapMemory mem(TEST_SHM_SIZE);
+    CollectingHandler h;
+    AQLogConsumer consumer(mem);
+    consumer.startAsync();
+
+    REQUIRE_EXCEPTION(consumer.addHandler(&h), domain_error);
+    REQUIRE_EXCEPTION(consumer.removeHandler(&h), domain_error);
+
+    consumer.stop();
+    consumer.addHandler(&h);
+    consumer.removeHandler(&h);
+}
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_SlowHandler_when_RecordsDispatched_then_OtherHandlersReceiveAllAndSlowHandlerDrops)
+{
+    AQHeapMemory mem(TEST_SHM_SIZE);
+    CollectingHandler fast;
+    CollectingHandler slow(true);
+    LogDispatcher dispatcher(mem, 2);
+    dispatcher.addHandler(&fast);
+    dispatcher.addHandler(&slow);
+    REQUIRE(AQLog_InitSharedMemory(mem) == AQLOG_INITOUTCOME_SUCCESS);
+    dispatcher.startWorkers();
+
+    // Dispatch one record at a time so the fast handler keeps up with its
+    // small queue while the held handler's queue fills.
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        AQLog_Info("record %d", i);
+        dispatcher.dispatch();
+        Timer::sleep(LogReader::PENDING_MINIMUM_WINDOW_MS + 1);
+        dispatcher.dispatch();
+        REQUIRE(fast.waitForCount(i + 1));
+    }
+
+    REQUIRE(dispatcher.droppedCount(&fast) == 0);
+    REQUIRE(dispatcher.droppedCount(&slow) >= 10 - 2 - 1);
+
+    slow.release();
+    dispatcher.stopWorkers();
+    AQLog_Deinit();
+
+    REQUIRE(fast.messages.size() == 10);
+    REQUIRE(slow.messages.size() == 10 - dispatcher.droppedCount(&slow));
+    REQUIRE(slow.messages[0] == "record 0");
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_SlowHandlerHeldSizeLimit_when_RecordsDispatched_then_SlowHandlerHoldsOneRecordAndDropsRest)
+{
+    AQHeapMemory mem(TEST_SHM_SIZE);
+    CollectingHandler fast;
+    CollectingHandler slow(true);
+    LogDispatcher dispatcher(mem, 100, 1);
+    dispatcher.addHandler(&fast);
+    dispatcher.addHandler(&slow);
+    REQUIRE(AQLog_InitSharedMemory(mem) == AQLOG_INITOUTCOME_SUCCESS);
+    dispatcher.startWorkers();
+
+    // The held handler's queue has plenty of room but only the first record
+    // fits within its byte limit.
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        AQLog_Info("record %d", i);
+        dispatcher.dispatch();
+        Timer::sleep(LogReader::PENDING_MINIMUM_WINDOW_MS + 1);
+        dispatcher.dispatch();
+        REQUIRE(fast.waitForCount(i + 1));
+    }
+
+    REQUIRE(dispatcher.droppedCount(&fast) == 0);
+    REQUIRE(dispatcher.droppedCount(&slow) == 9);
+
+    slow.release();
+    dispatcher.stopWorkers();
+    AQLog_Deinit();
+
+    REQUIRE(fast.messages.size() == 10);
+    REQUIRE(slow.messages.size() == 1);
+    REQUIRE(slow.messages[0] == "record 0");
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_BatchingHandler_when_RecordsDispatched_then_RecordsValidUntilFlushedInBatches)
+{
+    AQHeapMemory mem(TEST_SHM_SIZE);
+    BatchingHandler h(4);
+    LogDispatcher dispatcher(mem);
+    dispatcher.addHandler(&h);
+    REQUIRE(AQLog_InitSharedMemory(mem) == AQLOG_INITOUTCOME_SUCCESS);
+    dispatcher.startWorkers();
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        AQLog_Info("record %d", i);
+    }
+    dispatcher.dispatch();
+    Timer::sleep(LogReader::PENDING_MINIMUM_WINDOW_MS + 1);
+    dispatcher.dispatch();
+    REQUIRE(h.waitForCount(10));
+
+    dispatcher.stopWorkers();
+    AQLog_Deinit();
+
+    size_t total = 0;
+    for (size_t i = 0; i < h.batches.size(); ++i)
+    {
+        REQUIRE(h.batches[i] >= 1);
+        REQUIRE(h.batches[i] <= 4);
+        total += h.batches[i];
+    }
+    REQUIRE(total == 10);
+    REQUIRE(h.messages.size() == 10);
+    REQUIRE(h.messages[0] == "record 0");
+    REQUIRE(h.messages[9] == "record 9");
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_HandlersSharingFormatter_when_RecordsDispatched_then_EachHandlerFormatsEveryTimestamp)
+{
+    const uint32_t rounds = 20;
+    const uint32_t count = 50;
+    AQHeapMemory mem(TEST_SHM_SIZE);
+    DefaultFormatter formatter("%T %m");
+    FormattingHandler h1(formatter);
+    FormattingHandler h2(formatter);
+    LogDispatcher dispatcher(mem);
+    dispatcher.addHandler(&h1);
+    dispatcher.addHandler(&h2);
+    REQUIRE(AQLog_InitSharedMemory(mem) == AQLOG_INITOUTCOME_SUCCESS);
+    dispatcher.startWorkers();
+
+    // Every record is in a different second so both handler threads keep
+    // replacing the cached date and time while the other is formatting.
+    for (uint32_t r = 0; r < rounds; ++r)
+    {
+        for (uint32_t i = r * count; i < (r + 1) * count; ++i)
+        {
+            Timestamp::fixTimestamp(TEST_TIMESTAMP_NS + i * 1000000000ULL);
+            AQLog_Info("record %d", i);
+        }
+        Timestamp::fixTimestamp(0);
+        dispatcher.dispatch();
+        Timer::sleep(LogReader::PENDING_MINIMUM_WINDOW_MS + 1);
+        dispatcher.dispatch();
+        REQUIRE(h1.waitForCount((r + 1) * count));
+        REQUIRE(h2.waitForCount((r + 1) * count));
+    }
+
+    dispatcher.stopWorkers();
+    AQLog_Deinit();
+
+    REQUIRE(h1.lines.size() == rounds * count);
+    REQUIRE(h2.lines.size() == rounds * count);
+    for (uint32_t i = 0; i < rounds * count; ++i)
+    {
+        string expected = expectedLine(i);
+        REQUIRE(h1.lines[i] == expected);
+        REQUIRE(h2.lines[i] == expected);
+    }
+}
+#endif
+
+
+
+
+//=============================== End of File ==================================
@@ -17,9 +17,12 @@
 #include "HashMemory.h"
 #include "RandomHandlers.h"
 #include "TestHandler.h"
+#include "WorkerThread.h"
 
 #include "AQLogRecord.h"
 
+#include "Atomic.h"
+
 
 
 
@@ -78,12 +81,12 @@ public:
 
     void capture(void)
     {
-        memcpy(m_cmpHash, AQLog_LevelHashTable_g, AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
+        memcpy(m_cmpHash, AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g), AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
     }
 
     bool matches(void)
     {
-        return memcmp(m_cmpHash, AQLog_LevelHashTable_g, AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t)) == 0;
+        return memcmp(m_cmpHash, AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g), AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t)) == 0;
     }
 
 private:
@@ -95,6 +98,41 @@ private:
 
 
 
+// Repeatedly checks that a log level is enabled while the table is changed
+// by another thread, counting the checks that fail.
+class LevelChecker : public WorkerThread
+{
+public:
+
+    LevelChecker(void) : failCount(0), checkCount(0) { }
+
+    virtual void run(void)
+    {
+        for (;;)
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                if (!AQLOG_HASHISLEVEL(AQLOG_LEVEL_DETAIL, HASHIDX_61_B, HASHIDX_108_B, HASHIDX_2_B))
+                {
+                    aqosa::Atomic::increment(&failCount);
+                }
+            }
+            aqosa::Atomic::increment(&checkCount);
+            abortIfStop();
+        }
+    }
+
+    // The number of checks that failed.
+    volatile uint32_t failCount;
+
+    // The number of batches of checks made.
+    volatile uint32_t checkCount;
+
+};
+
+
+
+
 //------------------------------------------------------------------------------
 // Variable Declarations
 //------------------------------------------------------------------------------
@@ -981,6 +1019,100 @@ TEST(given_AddInfoHandlerAndRandomHandlers_when_RemoveComponentTagFileInfoHandle
     REQUIRE(hc.matches());
 }
 
+//------------------------------------------------------------------------------
+TEST(given_InfoFilter_when_HandlerRemoved_then_RebuiltTablePublishedInOtherGeneration)
+{
+    HashMemory hm;
+    LogLevelHash hash(hm);
+    TestHandler h1(AQLOG_LEVEL_INFO);
+    uint32_t gen = AQLOG_HASH_GENERATION(AQLog_LevelHashTable_g);
+    const uint32_t *initial = AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g);
+    uint32_t initialWord = initial[0];
+
+    // Raising a level copies into the other table and leaves the previous
+    // table intact for any producer still reading it.
+    hash.addHandler(&h1);
+    REQUIRE(AQLOG_HASH_GENERATION(AQLog_LevelHashTable_g) == gen + 1);
+    const uint32_t *before = AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g);
+    REQUIRE(before != initial);
+    REQUIRE(initial[0] == initialWord);
+    checkRegion(0, AQLOG_HASH_TABLE_WORDS, AQLOG_LEVEL_INFO);
+
+    // Lowering a level rebuilds into the other table in the same way.
+    hash.removeHandler(&h1);
+    REQUIRE(AQLOG_HASH_GENERATION(AQLog_LevelHashTable_g) == gen + 2);
+    REQUIRE(AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g) != before);
+    checkRegion(0, AQLOG_HASH_TABLE_WORDS, AQLOG_LEVEL_CRITICAL);
+    REQUIRE(before[0] == 0x44444444);
+    REQUIRE(before[AQLOG_HASH_TABLE_WORDS - 1] == 0x44444444);
+    REQUIRE(!AQLOG_HASHISLEVEL(AQLOG_LEVEL_ERROR, HASHIDX_11_B, HASHIDX_108_B, HASHIDX_2_B));
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ComponentInfoFilter_when_CallSiteChecked_then_IndexCachedAndLevelFollowsTable)
+{
+    HashMemory hm;
+    LogLevelHash hash(hm);
+    TestHandler h1(AQLOG_LEVEL_INFO, HASHIDX_101_A);
+    hash.addHandler(&h1);
+
+    AQLogCallSite_t site;
+    memset(&site, 0, sizeof(site));
+    uint32_t cached = AQLog_SiteHashIndex(&site, HASHIDX_101_B, sizeof(HASHIDX_101_B) - 1, 
+        HASHIDX_72_B, sizeof(HASHIDX_72_B) - 1, HASHIDX_2_B, sizeof(HASHIDX_2_B) - 1);
+    REQUIRE(cached != 0);
+    REQUIRE(site.hashIndex == cached);
+#if defined(AQLOG_HASH_USE_CONSTEXPR)
+    REQUIRE(cached == 1 + AQLog_HashIndexConstexpr(HASHIDX_101_B, sizeof(HASHIDX_101_B) - 1, 
+        HASHIDX_72_B, sizeof(HASHIDX_72_B) - 1, HASHIDX_2_B, sizeof(HASHIDX_2_B) - 1));
+#endif
+    REQUIRE(AQLOG_SITEISLEVEL(&site, AQLOG_LEVEL_INFO, HASHIDX_101_B, HASHIDX_72_B, HASHIDX_2_B));
+    REQUIRE(!AQLOG_SITEISLEVEL(&site, AQLOG_LEVEL_DETAIL, HASHIDX_101_B, HASHIDX_72_B, HASHIDX_2_B));
+    REQUIRE(site.hashIndex == cached);
+
+    // The cached index is used against whichever table is in use.
+    hash.removeHandler(&h1);
+    REQUIRE(!AQLog_SiteIsLevel(AQLOG_LEVEL_INFO, site.hashIndex));
+    REQUIRE(AQLog_SiteIsLevel(AQLOG_LEVEL_CRITICAL, site.hashIndex));
+    REQUIRE(!AQLOG_SITEISLEVEL(&site, AQLOG_LEVEL_INFO, HASHIDX_101_B, HASHIDX_72_B, HASHIDX_2_B));
+    REQUIRE(site.hashIndex == cached);
+
+    // With constexpr support the call site cache is never filled.
+    memset(&site, 0, sizeof(site));
+    REQUIRE(AQLOG_SITEISLEVEL(&site, AQLOG_LEVEL_CRITICAL, HASHIDX_101_B, HASHIDX_72_B, HASHIDX_2_B));
+    uint32_t siteIndex = site.hashIndex;
+#if defined(AQLOG_HASH_USE_CONSTEXPR)
+    REQUIRE(siteIndex == 0);
+#else
+    REQUIRE(siteIndex == cached);
+#endif
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ComponentDetailFilter_when_OtherFiltersChangedConcurrently_then_ProducerAlwaysSeesDetail)
+{
+    HashMemory hm;
+    LogLevelHash hash(hm);
+    TestHandler h1(AQLOG_LEVEL_DETAIL, HASHIDX_61_A);
+    TestHandler h2(AQLOG_LEVEL_INFO);
+    hash.addHandler(&h1);
+
+    // Every rebuild fills the table with the top level before the component
+    // entries are restored, so a producer reading a table being changed 
+    // would see the component below detail.
+    LevelChecker checker;
+    checker.start();
+    for (int i = 0; i < 500 || aqosa::Atomic::read(&checker.checkCount) < 10; ++i)
+    {
+        hash.addHandler(&h2);
+        hash.removeHandler(&h2);
+    }
+    checker.stop();
+    REQUIRE(checker.join(5000));
+
+    REQUIRE(aqosa::Atomic::read(&checker.failCount) == 0);
+}
+
 //------------------------------------------------------------------------------
 static void checkRegion(uint32_t off, uint32_t count, AQLogLevel_t level)
 {
@@ -994,11 +1126,11 @@ static void checkRegion(uint32_t off, uint32_t count, AQLogLevel_t level)
         | (level << 0);
     for (size_t i = off; i < off + count; ++i)
     {
-        if (AQLog_LevelHashTable_g[i] != m)
+        if (AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g)[i] != m)
         {
-            CHECK(AQLog_LevelHashTable_g[i] == m);
+            CHECK(AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g)[i] == m);
             ostringstream ss;
-            ss << endl << "Index " << i << ": " << hex << setw(8) << setfill('0') << AQLog_LevelHashTable_g[i] << endl;
+            ss << endl << "Index " << i << ": " << hex << setw(8) << setfill('0') << AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g)[i] << endl;
             cout << ss.str();
             return;
         }
@@ -1020,11 +1152,11 @@ static void checkSkipRegion(uint32_t off, uint32_t skip, uint32_t max, AQLogLeve
     {
         for (size_t j = 0; j < size && i + j < max; ++j)
         {
-            if (AQLog_LevelHashTable_g[i + j] != m)
+            if (AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g)[i + j] != m)
             {
-                CHECK(AQLog_LevelHashTable_g[i + j] == m);
+                CHECK(AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g)[i + j] == m);
                 ostringstream ss;
-                ss << endl << "Index " << (i + j) << ": " << hex << setw(8) << setfill('0') << AQLog_LevelHashTable_g[i] << endl;
+                ss << endl << "Index " << (i + j) << ": " << hex << setw(8) << setfill('0') << AQLOG_HASH_ACTIVE_TABLE(AQLog_LevelHashTable_g)[i] << endl;
                 cout << ss.str();
                 return;
             }
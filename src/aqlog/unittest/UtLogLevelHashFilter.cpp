@@ -658,6 +658,64 @@ TEST(given_FileHandlerAddFirstInGroup_when_HandlerRemoved_then_NoLongerInMatchSe
     REQUIRE((handlers.find(&h1) == handlers.end()));
 }
 
+//------------------------------------------------------------------------------
+TEST(given_ComponentAndTagFilters_when_MatchHandlerSet_then_OnlyMatchingIndexesSet)
+{
+    HashMemory hm;
+    LogLevelHash hash(hm);
+    TestHandler h1(AQLOG_LEVEL_INFO, "comp_bar");
+    TestHandler h2(AQLOG_LEVEL_INFO, "comp_foo");
+    TestHandler h3(AQLOG_LEVEL_DETAIL, "", "tag_bar");
+    hash.addHandler(&h1);
+    hash.addHandler(&h2);
+    hash.addHandler(&h3);
+    RandomHandlers rh(hash);
+
+    AQLogRecord rec(AQLOG_LEVEL_DETAIL, "comp_bar", "tag_bar", "file_bar");
+    HandlerSet handlers;
+    hash.matchHandlers(rec, handlers);
+
+    REQUIRE(!handlers.isSet(hash.handlerIndex(&h1)));
+    REQUIRE(!handlers.isSet(hash.handlerIndex(&h2)));
+    REQUIRE(handlers.isSet(hash.handlerIndex(&h3)));
+
+    AQLogRecord rec2(AQLOG_LEVEL_INFO, "comp_bar", "tag_foo", "file_bar");
+    hash.matchHandlers(rec2, handlers);
+
+    REQUIRE(handlers.isSet(hash.handlerIndex(&h1)));
+    REQUIRE(!handlers.isSet(hash.handlerIndex(&h2)));
+    REQUIRE(!handlers.isSet(hash.handlerIndex(&h3)));
+}
+
+//------------------------------------------------------------------------------
+TEST(given_HandlerRemoved_when_HandlerAdded_then_HandlerIndexReused)
+{
+    HashMemory hm;
+    LogLevelHash hash(hm);
+    TestHandler h1(AQLOG_LEVEL_INFO);
+    TestHandler h2(AQLOG_LEVEL_INFO);
+    TestHandler h3(AQLOG_LEVEL_INFO);
+    hash.addHandler(&h1);
+    hash.addHandler(&h2);
+    size_t idx1 = hash.handlerIndex(&h1);
+
+    hash.removeHandler(&h1);
+    REQUIRE(hash.handlerIndex(&h1) == hash.handlerCount());
+    REQUIRE(hash.handler(idx1) == NULL);
+
+    hash.addHandler(&h3);
+    REQUIRE(hash.handlerIndex(&h3) == idx1);
+    REQUIRE(hash.handler(idx1) == &h3);
+
+    AQLogRecord rec(AQLOG_LEVEL_INFO, "comp_bar", "tag_bar", "file_bar");
+    HandlerSet handlers;
+    hash.matchHandlers(rec, handlers);
+
+    REQUIRE(handlers.next(0) < handlers.capacity());
+    REQUIRE(handlers.isSet(hash.handlerIndex(&h2)));
+    REQUIRE(handlers.isSet(hash.handlerIndex(&h3)));
+}
+
 
 
 
@@ -62,9 +62,13 @@ TEST(given_MinimumSizeMemoryRegion_when_LogMemory_then_AllocationValid)
 
     LogMemory logMem(mem);
     REQUIRE(logMem.aqMemory().baseAddress() == mem.baseAddress());
-    REQUIRE(logMem.aqMemory().size() == AQLOG_SHM_MINIMUM_SIZE - AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
-    REQUIRE(logMem.logLevelHashMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE - AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
-    REQUIRE(logMem.logLevelHashMemory().size() == AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.aqMemory().size() == AQLOG_SHM_MINIMUM_SIZE - AQLOG_DROP_COUNTERS_SIZE - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.dropCountersMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE - AQLOG_DROP_COUNTERS_SIZE - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.dropCountersMemory().size() == AQLOG_DROP_COUNTERS_SIZE);
+    REQUIRE(logMem.stringTableMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.stringTableMemory().size() == AQLOG_STRING_TABLE_SIZE);
+    REQUIRE(logMem.logLevelHashMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.logLevelHashMemory().size() == AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
 }
 
 //------------------------------------------------------------------------------
@@ -74,9 +78,13 @@ TEST(given_OffsetSizeMemoryRegion_when_LogMemory_then_AllocationValid)
 
     LogMemory logMem(mem);
     REQUIRE(logMem.aqMemory().baseAddress() == mem.baseAddress());
-    REQUIRE(logMem.aqMemory().size() == AQLOG_SHM_MINIMUM_SIZE - AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
-    REQUIRE(logMem.logLevelHashMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE - AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
-    REQUIRE(logMem.logLevelHashMemory().size() == AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.aqMemory().size() == AQLOG_SHM_MINIMUM_SIZE - AQLOG_DROP_COUNTERS_SIZE - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.dropCountersMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE - AQLOG_DROP_COUNTERS_SIZE - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.dropCountersMemory().size() == AQLOG_DROP_COUNTERS_SIZE);
+    REQUIRE(logMem.stringTableMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.stringTableMemory().size() == AQLOG_STRING_TABLE_SIZE);
+    REQUIRE(logMem.logLevelHashMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.logLevelHashMemory().size() == AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
 }
 
 //------------------------------------------------------------------------------
@@ -86,9 +94,13 @@ TEST(given_LargeMemoryRegion_when_LogMemory_then_ExtraMemoryAddedToLog)
 
     LogMemory logMem(mem);
     REQUIRE(logMem.aqMemory().baseAddress() == mem.baseAddress());
-    REQUIRE(logMem.aqMemory().size() == AQLOG_SHM_MINIMUM_SIZE + 1024 - AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
-    REQUIRE(logMem.logLevelHashMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE + 1024 - AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
-    REQUIRE(logMem.logLevelHashMemory().size() == AQLOG_HASH_TABLE_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.aqMemory().size() == AQLOG_SHM_MINIMUM_SIZE + 1024 - AQLOG_DROP_COUNTERS_SIZE - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.dropCountersMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE + 1024 - AQLOG_DROP_COUNTERS_SIZE - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.dropCountersMemory().size() == AQLOG_DROP_COUNTERS_SIZE);
+    REQUIRE(logMem.stringTableMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE + 1024 - AQLOG_STRING_TABLE_SIZE - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.stringTableMemory().size() == AQLOG_STRING_TABLE_SIZE);
+    REQUIRE(logMem.logLevelHashMemory().baseAddress() == (unsigned char *)mem.baseAddress() + AQLOG_SHM_MINIMUM_SIZE + 1024 - AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
+    REQUIRE(logMem.logLevelHashMemory().size() == AQLOG_HASH_MEMORY_WORDS * sizeof(uint32_t));
 }
 
 //------------------------------------------------------------------------------
@@ -111,7 +111,7 @@ TEST(given_RecordTimeTFarInFuture_when_RecordsAtCurrentTimeConstantlySubmitted_t
     for (size_t i = 0; i < 200; ++i)
     {
         Timestamp::fixTimestamp(i);
-        AQLog_Info("T%d", i);
+        AQLog_Info("T%d", (int)i);
         Timer::sleep((LogReader::PENDING_MAXIMUM_WINDOW_MS + 99) / 100);
         AQLogRecord *rec = log.reader.retrieve(ms);
         if (rec != NULL && rec->message().toString() == "Tfuture")
@@ -149,17 +149,20 @@ TEST(given_RecordRetrieved_when_ReleaseNullRecord_then_InvalidArgumentException)
 TEST(given_RecordCorrupted_when_LogReaderRetrieve_then_RecordNotRetrieved)
 {
     LogReaderTest log(AQLOG_LEVEL_INFO);
-    static const char matchStr[] = "tag_corrupt_flag";
+    static const char matchStr[] = "data_corrupt_flag";
 
-    AQLog_TInfo(tag_corrupt_flag, "T");
+    AQLog_DInfo(matchStr, sizeof(matchStr), "T");
     IAQSharedMemory& aqm = log.aqMemory();
     char *ptr = (char *)aqm.baseAddress();
     bool corrupted = false;
-    for (size_t i = 0; i < aqm.size() - sizeof(matchStr); ++i)
+    for (size_t i = offsetof(AQLogRecord::Overlay, strData); i < aqm.size() - sizeof(matchStr); ++i)
     {
         if (memcmp(&ptr[i], matchStr, sizeof(matchStr)) == 0)
         {
-            ptr[i + sizeof(matchStr) - 1] = 'x';
+            // The data immediately follows the overlay; claim more data than
+            // the record holds.
+            AQLogRecord::Overlay *rec = (AQLogRecord::Overlay *)&ptr[i - offsetof(AQLogRecord::Overlay, strData)];
+            rec->dataSize = (uint32_t)aqm.size();
             corrupted = true;
             break;
         }
@@ -0,0 +1,172 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQLog.h"
+
+#include "ReorderBuffer.h"
+
+#include "AQLogRecord.h"
+
+#include "Timestamp.h"
+#include "Timer.h"
+
+using namespace aqlog;
+using namespace aqosa;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+#ifdef AQ_TEST_UNIT
+// Populates 'rec' as a record with timestamp 'timestampNs' processed at the
+// current (fixed) timer value.
+static AQLogRecord *timedRecord(AQLogRecord& rec, uint64_t timestampNs);
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtReorderBuffer);
+
+//------------------------------------------------------------------------------
+TEST(given_EmptyBuffer_when_Pop_then_NullReturned)
+{
+    ReorderBuffer rb(4, 200);
+
+    REQUIRE(rb.size() == 0);
+    REQUIRE(rb.top() == NULL);
+    REQUIRE(rb.pop() == NULL);
+}
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_RecordsOutOfOrder_when_Pop_then_RecordsReturnedInTimestampOrder)
+{
+    ReorderBuffer rb(4, 200);
+    AQLogRecord rec[5];
+
+    rb.push(timedRecord(rec[0], 30), Timer::start());
+    rb.push(timedRecord(rec[1], 10), Timer::start());
+    rb.push(timedRecord(rec[2], 50), Timer::start());
+    rb.push(timedRecord(rec[3], 20), Timer::start());
+    rb.push(timedRecord(rec[4], 40), Timer::start());
+    REQUIRE(rb.size() == 5);
+
+    REQUIRE(rb.top() == &rec[1]);
+    REQUIRE(rb.pop() == &rec[1]);
+    REQUIRE(rb.pop() == &rec[3]);
+    REQUIRE(rb.pop() == &rec[0]);
+    REQUIRE(rb.pop() == &rec[4]);
+    REQUIRE(rb.pop() == &rec[2]);
+    REQUIRE(rb.pop() == NULL);
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_RecordsWithEqualTimestamps_when_Pop_then_RecordsReturnedInArrivalOrder)
+{
+    ReorderBuffer rb(4, 200);
+    AQLogRecord rec[4];
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        rb.push(timedRecord(rec[i], 100), Timer::start());
+    }
+    for (size_t i = 0; i < 4; ++i)
+    {
+        REQUIRE(rb.pop() == &rec[i]);
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_RecordHeldForMaximumTime_when_EarlierRecordPushed_then_EarlierRecordDoesNotOvertake)
+{
+    ReorderBuffer rb(4, 200);
+    AQLogRecord rec[3];
+
+    rb.push(timedRecord(rec[0], 1000), Timer::start());
+    rb.push(timedRecord(rec[1], 10), Timer::start());
+    Timer::sleep(200);
+    rb.push(timedRecord(rec[2], 20), Timer::start());
+
+    REQUIRE(rb.pop() == &rec[1]);
+    REQUIRE(rb.pop() == &rec[0]);
+    REQUIRE(rb.pop() == &rec[2]);
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+TEST(given_AgedRecordPopped_when_EarlierRecordPushed_then_TimestampOrderRestored)
+{
+    ReorderBuffer rb(4, 200);
+    AQLogRecord rec[3];
+
+    rb.push(timedRecord(rec[0], 1000), Timer::start());
+    Timer::sleep(200);
+    rb.push(timedRecord(rec[1], 30), Timer::start());
+    REQUIRE(rb.pop() == &rec[0]);
+
+    rb.push(timedRecord(rec[2], 20), Timer::start());
+    REQUIRE(rb.pop() == &rec[2]);
+    REQUIRE(rb.pop() == &rec[1]);
+}
+#endif
+
+//------------------------------------------------------------------------------
+#ifdef AQ_TEST_UNIT
+static AQLogRecord *timedRecord(AQLogRecord& rec, uint64_t timestampNs)
+{
+    Timestamp::fixTimestamp(timestampNs);
+    rec.populateDropReport(AQLOG_LEVEL_INFO, "", 1);
+    Timestamp::fixTimestamp(0);
+    return &rec;
+}
+#endif
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,234 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "AQLog.h"
+
+#include "StringTable.h"
+
+#include "AQHeapMemory.h"
+
+#include <sstream>
+
+using namespace aqlog;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtStringTable);
+
+//------------------------------------------------------------------------------
+TEST(given_UnformattedTable_when_Intern_then_InvalidIdReturned)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    memset(mem.baseAddress(), 0xCD, mem.size());
+    StringTable st(mem);
+
+    REQUIRE(!st.isFormatted());
+    REQUIRE(st.intern("foo", 3) == StringTable::INVALID_ID);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_UnformattedTable_when_Epoch_then_ZeroReturned)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    memset(mem.baseAddress(), 0xCD, mem.size());
+    StringTable st(mem);
+
+    REQUIRE(st.epoch() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedTable_when_FormatAgain_then_EpochIncremented)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    memset(mem.baseAddress(), 0, mem.size());
+    StringTable consumer(mem);
+    consumer.format();
+    StringTable producer(mem);
+
+    uint32_t epoch = producer.epoch();
+    REQUIRE(epoch != 0);
+
+    StringTable restarted(mem);
+    restarted.format();
+    REQUIRE(producer.epoch() == epoch + 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_EpochAtLimit_when_Format_then_EpochSkipsZero)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    memset(mem.baseAddress(), 0xFF, mem.size());
+    StringTable st(mem);
+    st.format();
+
+    REQUIRE(st.epoch() == 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_MemoryRegionTooSmall_when_StringTable_then_LengthErrorException)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SLOTS * sizeof(uint32_t));
+
+    REQUIRE_EXCEPTION(StringTable st(mem), length_error);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedTable_when_InternSameStringTwice_then_SameIdReturned)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    StringTable st(mem);
+    st.format();
+
+    uint32_t id = st.intern("component", 9);
+    REQUIRE(id != StringTable::INVALID_ID);
+    REQUIRE(st.intern("component", 9) == id);
+    REQUIRE(string(st.lookup(id)) == "component");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedTable_when_InternDifferentStrings_then_DifferentIdsReturned)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    StringTable st(mem);
+    st.format();
+
+    uint32_t id1 = st.intern("tag", 3);
+    uint32_t id2 = st.intern("tags", 4);
+    uint32_t id3 = st.intern("tagsx", 3);
+    REQUIRE(id1 != StringTable::INVALID_ID);
+    REQUIRE(id2 != StringTable::INVALID_ID);
+    REQUIRE(id1 != id2);
+    REQUIRE(id3 == id1);
+    REQUIRE(string(st.lookup(id1)) == "tag");
+    REQUIRE(string(st.lookup(id2)) == "tags");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedTable_when_InternEmptyString_then_EmptyStringReturned)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    StringTable st(mem);
+    st.format();
+
+    uint32_t id = st.intern("", 0);
+    REQUIRE(id != StringTable::INVALID_ID);
+    REQUIRE(string(st.lookup(id)) == "");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_SecondTableOnSameMemory_when_Intern_then_SameIdsReturned)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    StringTable consumer(mem);
+    consumer.format();
+    StringTable producer(mem);
+
+    uint32_t id = producer.intern("file.cpp", 8);
+    REQUIRE(id != StringTable::INVALID_ID);
+    REQUIRE(string(consumer.lookup(id)) == "file.cpp");
+    REQUIRE(consumer.intern("file.cpp", 8) == id);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedTable_when_LookupUnusedOrOutOfRangeId_then_NullReturned)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    StringTable st(mem);
+    st.format();
+
+    REQUIRE(st.lookup(StringTable::INVALID_ID) == NULL);
+    REQUIRE(st.lookup(1) == NULL);
+    REQUIRE(st.lookup(AQLOG_STRING_TABLE_SLOTS + 1) == NULL);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_TableFull_when_InternNewString_then_InvalidIdReturnedAndExistingStringsValid)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    StringTable st(mem);
+    st.format();
+
+    uint32_t firstId = st.intern("first", 5);
+    REQUIRE(firstId != StringTable::INVALID_ID);
+
+    size_t count = 0;
+    for (;;)
+    {
+        ostringstream ss;
+        ss << "string_number_" << count;
+        if (st.intern(ss.str().c_str(), ss.str().size()) == StringTable::INVALID_ID)
+        {
+            break;
+        }
+        count++;
+        REQUIRE(count < AQLOG_STRING_TABLE_SLOTS);
+    }
+
+    REQUIRE(count > 0);
+    REQUIRE(st.intern("first", 5) == firstId);
+    REQUIRE(string(st.lookup(firstId)) == "first");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_FormattedTableWithStrings_when_Format_then_StringsDiscarded)
+{
+    AQHeapMemory mem(AQLOG_STRING_TABLE_SIZE);
+    StringTable st(mem);
+    st.format();
+    size_t available = st.availableHeapSize();
+
+    uint32_t id = st.intern("function", 8);
+    REQUIRE(st.availableHeapSize() == available - 9);
+    st.format();
+    REQUIRE(st.lookup(id) == NULL);
+    REQUIRE(st.availableHeapSize() == available);
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -14,6 +14,10 @@
 #include "AQLogStringBuilder.h"
 #include "WordWrapper.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 
 
 
@@ -299,6 +303,51 @@ TEST(given_StringContainsWhitespaceBefore10Cols_when_WordWrap10Cols_then_WrapsBe
             "ducimus"));
     }
 }
+
+//------------------------------------------------------------------------------
+TEST(given_LongWordsSplitAcrossVectors_when_WordWrap_then_SameAsOneVector)
+{
+    const char *text = "Sed_ut_perspiciatis_unde_omnis iste natus error\tsit "
+        "voluptatem_accusantium_doloremque_laudantium,  totam rem\r\naperiam "
+        "\v eaque ipsa\n\n quae_ab_illo_inventore_veritatis_et_quasi \f"
+        "architecto beatae vitae dicta sunt explicabo.   ";
+    size_t len = strlen(text);
+    const uint32_t wrapCols[] = { 0, 1, 10, 17, 40, 1000 };
+
+    for (size_t i = 0; i < sizeof(wrapCols) / sizeof(wrapCols[0]); ++i)
+    {
+        AQLogStringBuilder one;
+        AQLogStringBuilder expected;
+        one.appendPointer(text, len);
+        WordWrapper::appendWordWrapped(one, expected, wrapCols[i], 2, WordWrapper::NEWLINE_LF);
+
+        for (size_t chunk = 1; chunk <= 20; ++chunk)
+        {
+            AQLogStringBuilder src;
+            AQLogStringBuilder dst;
+            for (size_t off = 0; off < len; off += chunk)
+            {
+                src.appendPointer(&text[off], std::min(chunk, len - off));
+            }
+            WordWrapper::appendWordWrapped(src, dst, wrapCols[i], 2, WordWrapper::NEWLINE_LF);
+            REQUIRE(DumpString(dst.toString()) == expected.toString());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(given_WordCrossesWrapColumn_when_WordWrap10Cols_then_ColumnsCarryToNextLine)
+{
+    AQLogStringBuilder src;
+    AQLogStringBuilder dst;
+    src.appendPointer("ab cdefghijklmnopqrstuvwxyz0123 x yz qrs tu v");
+    WordWrapper::appendWordWrapped(src, dst, 10, 0, WordWrapper::NEWLINE_LF);
+    REQUIRE(DumpString(dst.toString()) ==
+        "ab\n"
+        "cdefghijklmnopqrstuvwxyz0123\n"
+        "x yz qrs\n"
+        "tu v");
+}
 //------------------------------------------------------------------------------
 static char *TranslateNLInput(const NewlineCombo_t& combo, const char *in)
 {
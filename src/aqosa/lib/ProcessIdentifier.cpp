@@ -11,6 +11,10 @@
 
 #include "ProcessIdentifier.h"
 
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
 namespace aqosa
 {
 
@@ -34,6 +38,21 @@ namespace aqosa
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
+#ifndef _WIN32
+
+// Registers the fork handler that clears the cached identifiers when 
+// constructed during static initialisation.
+class ProcessIdentifierForkHandler
+{
+public:
+    ProcessIdentifierForkHandler(void)
+    {
+        pthread_atfork(NULL, NULL, &ProcessIdentifier::forgetIdentifiers);
+    }
+};
+
+#endif
+
 
 
 
@@ -57,6 +76,19 @@ uint32_t ProcessIdentifier::m_fixThreadId;
 
 #endif
 
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+__thread uint32_t ProcessIdentifier::m_processId = 0;
+
+//------------------------------------------------------------------------------
+__thread uint32_t ProcessIdentifier::m_threadId = 0;
+
+// Registers the fork handler before main() is entered.
+static ProcessIdentifierForkHandler ForkHandler;
+
+#endif
+
 
 
 
@@ -64,6 +96,17 @@ uint32_t ProcessIdentifier::m_fixThreadId;
 // Function and Class Implementation
 //------------------------------------------------------------------------------
 
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+void ProcessIdentifier::forgetIdentifiers(void)
+{
+    m_processId = 0;
+    m_threadId = 0;
+}
+
+#endif
+
 
 
 
@@ -35,6 +35,20 @@ namespace aqosa
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
+#ifndef _WIN32
+
+// Selects the timer clock when constructed during static initialisation.
+class TimerClockSelector
+{
+public:
+    TimerClockSelector(void)
+    {
+        Timer::selectClock();
+    }
+};
+
+#endif
+
 
 
 
@@ -42,6 +56,20 @@ namespace aqosa
 // Variable Declarations
 //------------------------------------------------------------------------------
 
+#ifndef _WIN32
+
+// Local storage in case the constant is taken as a reference.
+const long Timer::MAXIMUM_COARSE_RESOLUTION_NS;
+
+//------------------------------------------------------------------------------
+clockid_t Timer::m_clock = CLOCK_MONOTONIC;
+
+// Selects the clock before main() is entered.  Until then the precise
+// monotonic clock is used.
+static TimerClockSelector ClockSelector;
+
+#endif
+
 #ifdef AQ_TEST_UNIT
 //------------------------------------------------------------------------------
 bool Timer::m_fixClock = false;
@@ -57,6 +85,27 @@ uint32_t Timer::m_fixClockMs = 0;
 // Function and Class Implementation
 //------------------------------------------------------------------------------
 
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+void Timer::selectClock(void)
+{
+#ifdef CLOCK_MONOTONIC_COARSE
+    struct timespec res;
+
+    if (   clock_getres(CLOCK_MONOTONIC_COARSE, &res) == 0
+        && res.tv_sec == 0
+        && res.tv_nsec <= MAXIMUM_COARSE_RESOLUTION_NS)
+    {
+        m_clock = CLOCK_MONOTONIC_COARSE;
+        return;
+    }
+#endif
+    m_clock = CLOCK_MONOTONIC;
+}
+
+#endif
+
 
 
 
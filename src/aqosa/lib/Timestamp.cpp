@@ -11,6 +11,12 @@
 
 #include "Timestamp.h"
 
+#ifndef _WIN32
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#endif
+
 namespace aqosa
 {
 
@@ -21,6 +27,37 @@ namespace aqosa
 // Private Macros
 //------------------------------------------------------------------------------
 
+// The minimum period between two anchors for the tick rate to be calibrated
+// from them.  Until this has passed since the first call to now() the 
+// timestamp is read from CLOCK_REALTIME.
+#define TSC_CALIBRATION_NS              10000000ULL
+
+// The period after which the anchor is renewed.  The tick rate is measured 
+// again over each period so any drift against the system clock is bounded by
+// the rate error over a single period.
+#define TSC_REANCHOR_NS                 100000000ULL
+
+// The largest step backwards from the extrapolated timestamp that is hidden
+// when the anchor is renewed.  Larger differences are due to the real time 
+// clock being stepped and are followed.
+#define TSC_MAX_CORRECTION_NS           1000000ULL
+
+// The most time stamp counter ticks a clock read may take to be used.  Slower
+// reads were interrupted and would skew the calibration.
+#define TSC_READ_MAX_TICKS              20000
+
+// The number of attempts made to read the clock within TSC_READ_MAX_TICKS.
+#define TSC_READ_ATTEMPTS               8
+
+// The values of TscSupport once the processor has been checked.
+#define TSC_SUPPORTED                   1
+#define TSC_UNSUPPORTED                 2
+
+// The CPUID leaf and EDX bit that report an invariant time stamp counter; 
+// one that ticks at a constant rate in all power states.
+#define CPUID_LEAF_ADVANCED_POWER       0x80000007
+#define CPUID_EDX_INVARIANT_TSC         (1 << 8)
+
 
 
 
@@ -35,6 +72,20 @@ namespace aqosa
 // Private Function and Class Declarations
 //------------------------------------------------------------------------------
 
+#ifndef _WIN32
+#if defined(__x86_64__) || defined(__i386__)
+
+// Returns true if the processor has an invariant time stamp counter.
+static bool hasInvariantTsc(void);
+
+// Reads the time stamp counter and the clock 'clk' as close together as 
+// possible, storing the clock value in 'ns' and returning the counter value.
+static uint64_t readTscAndClock(clockid_t clk, uint64_t& ns);
+
+#endif
+
+#endif
+
 
 
 
@@ -49,6 +100,40 @@ uint64_t Timestamp::m_fixTimestamp = 0;
 
 #endif
 
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+volatile uint32_t Timestamp::m_tscSeq = 0;
+
+//------------------------------------------------------------------------------
+volatile uint32_t Timestamp::m_tscLock = 0;
+
+//------------------------------------------------------------------------------
+volatile uint64_t Timestamp::m_tscBase = 0;
+
+//------------------------------------------------------------------------------
+volatile uint64_t Timestamp::m_tscBaseNs = 0;
+
+//------------------------------------------------------------------------------
+volatile uint64_t Timestamp::m_tscLimit = 0;
+
+//------------------------------------------------------------------------------
+volatile double Timestamp::m_tscNsPerTick = 0.0;
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Set to TSC_SUPPORTED or TSC_UNSUPPORTED once the processor is checked.
+static volatile uint32_t TscSupport = 0;
+
+// The time stamp counter and CLOCK_MONOTONIC values of the previous anchor,
+// or 0 if there is none.  Only accessed while holding m_tscLock.
+static uint64_t AnchorTsc = 0;
+static uint64_t AnchorMonoNs = 0;
+
+#endif
+
+#endif
+
 
 
 
@@ -56,6 +141,114 @@ uint64_t Timestamp::m_fixTimestamp = 0;
 // Function and Class Implementation
 //------------------------------------------------------------------------------
 
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+uint64_t Timestamp::anchor(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (Atomic::read(&TscSupport) == 0)
+    {
+        Atomic::write(&TscSupport, hasInvariantTsc() ? TSC_SUPPORTED : TSC_UNSUPPORTED);
+    }
+    if (Atomic::read(&TscSupport) != TSC_SUPPORTED)
+    {
+        return clockNs(CLOCK_REALTIME);
+    }
+
+    // Only one thread renews the anchor; the others carry on with the current
+    // one, which is still accurate just past its limit.
+    uint64_t ns;
+    if (Atomic::cmpXchg(&m_tscLock, 1, 0) != 0)
+    {
+        return tscNow(true, ns) ? ns : clockNs(CLOCK_REALTIME);
+    }
+
+    // The tick rate is measured against the monotonic clock, which is not 
+    // subject to steps by the system administrator or NTP, while the base is
+    // taken from the real time clock.
+    uint64_t monoNs;
+    uint64_t monoTsc = readTscAndClock(CLOCK_MONOTONIC, monoNs);
+    uint64_t realNs;
+    uint64_t realTsc = readTscAndClock(CLOCK_REALTIME, realNs);
+
+    if (AnchorMonoNs == 0 || monoTsc <= AnchorTsc)
+    {
+        // First call; this anchor starts the calibration period.
+        AnchorTsc = monoTsc;
+        AnchorMonoNs = monoNs;
+    }
+    else if (monoNs - AnchorMonoNs >= TSC_CALIBRATION_NS)
+    {
+        double nsPerTick = (double)(monoNs - AnchorMonoNs) / (double)(monoTsc - AnchorTsc);
+
+        // Do not step backwards by the small error of the previous rate.
+        if (m_tscNsPerTick > 0.0)
+        {
+            ns = m_tscBaseNs + (uint64_t)((double)(realTsc - m_tscBase) * m_tscNsPerTick);
+            if (ns > realNs && ns - realNs < TSC_MAX_CORRECTION_NS)
+            {
+                realNs = ns;
+            }
+        }
+
+        Atomic::write(&m_tscSeq, m_tscSeq + 1);
+        m_tscBase = realTsc;
+        m_tscBaseNs = realNs;
+        m_tscLimit = (uint64_t)((double)TSC_REANCHOR_NS / nsPerTick);
+        m_tscNsPerTick = nsPerTick;
+        Atomic::write(&m_tscSeq, m_tscSeq + 1);
+
+        AnchorTsc = monoTsc;
+        AnchorMonoNs = monoNs;
+    }
+
+    Atomic::write(&m_tscLock, 0);
+    return realNs;
+#else
+    return clockNs(CLOCK_REALTIME);
+#endif
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+//------------------------------------------------------------------------------
+static bool hasInvariantTsc(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(CPUID_LEAF_ADVANCED_POWER, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    return (edx & CPUID_EDX_INVARIANT_TSC) != 0;
+}
+
+//------------------------------------------------------------------------------
+static uint64_t readTscAndClock(clockid_t clk, uint64_t& ns)
+{
+    // The clock is read between two counter reads and attributed to the
+    // midpoint so that the cost of the clock read does not bias the result.
+    // A read that was interrupted is tried again.
+    uint64_t before;
+    uint64_t after;
+    struct timespec ts;
+    int attempt = 0;
+    do
+    {
+        before = __builtin_ia32_rdtsc();
+        clock_gettime(clk, &ts);
+        after = __builtin_ia32_rdtsc();
+    } while (after - before > TSC_READ_MAX_TICKS && ++attempt < TSC_READ_ATTEMPTS);
+
+    ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return before + (after - before) / 2;
+}
+
+#endif
+
+#endif
+
 
 
 
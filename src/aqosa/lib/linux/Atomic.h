@@ -114,6 +114,13 @@ public:
         __sync_or_and_fetch(dest, mask);
     }
 
+    // Performs an atomic 'AND' of the passed memory location with the bits in 
+    // 'mask'.
+    static inline void bitwiseAnd(volatile uint32_t *dest, uint32_t mask)
+    {
+        __sync_and_and_fetch(dest, mask);
+    }
+
 };};
 
 
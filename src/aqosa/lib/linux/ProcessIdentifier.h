@@ -15,6 +15,10 @@
 
 #include <string>
 
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
 
 
 //------------------------------------------------------------------------------
@@ -61,7 +65,7 @@ public:
             return m_fixProcessName;
         }
 #endif
-        return std::string("");
+        return std::string(program_invocation_short_name);
     }
 
     // Returns the 32-bit process identifier for the current process.
@@ -73,7 +77,11 @@ public:
             return m_fixProcessId;
         }
 #endif
-        return 0;
+        if (m_processId == 0)
+        {
+            m_processId = (uint32_t)getpid();
+        }
+        return m_processId;
     }
 
     // Returns the 32-bit thread identifier for the current thread.
@@ -85,9 +93,31 @@ public:
             return m_fixThreadId;
         }
 #endif
-        return 0;
+        if (m_threadId == 0)
+        {
+            m_threadId = (uint32_t)syscall(SYS_gettid);
+        }
+        return m_threadId;
     }
 
+private:
+
+    // Clears the cached identifiers in the child after a fork().
+    static void forgetIdentifiers(void);
+
+    // Registers forgetIdentifiers() to be called after each fork().
+    friend class ProcessIdentifierForkHandler;
+
+    // The cached identifier of the current process, or 0 if not yet read.
+    // It is held per thread so that the thread calling fork() can clear its
+    // own copy in the child.
+    static __thread uint32_t m_processId;
+
+    // The cached identifier of the current thread, or 0 if not yet read.
+    static __thread uint32_t m_threadId;
+
+public:
+
     // Sets the process identifier to return fixed values.  If processName is NULL
     // this disables the fixed value return.
 #ifdef AQ_TEST_UNIT
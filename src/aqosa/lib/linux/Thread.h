@@ -0,0 +1,154 @@
+#ifndef THREAD_H
+#define THREAD_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <pthread.h>
+#include <time.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// A thread of execution.  Sub-classes override run() to perform the work of
+// the thread.
+namespace aqosa { class Thread
+{
+protected:
+
+    // Constructs a new thread that is not yet started.
+    Thread(void)
+        : m_started(false)
+    {
+    }
+
+public:
+
+    // Destroys this thread.  The thread must have been joined.
+    virtual ~Thread(void)
+    {
+    }
+
+private:
+    // Not implemented - threads cannot be copied or assigned.
+    Thread(const Thread& other);
+    Thread& operator=(const Thread& other);
+
+public:
+
+    // Starts this thread executing run().  Returns false if the thread could
+    // not be created or has already been started.
+    bool start(void)
+    {
+        if (m_started)
+        {
+            return false;
+        }
+        m_started = pthread_create(&m_thread, NULL, threadEntry, this) == 0;
+        return m_started;
+    }
+
+    // Blocks until run() has returned.  Does nothing if the thread has not
+    // been started.
+    void join(void)
+    {
+        if (m_started)
+        {
+            pthread_join(m_thread, NULL);
+            m_started = false;
+        }
+    }
+
+    // Blocks until run() has returned or 'timeoutMs' milliseconds have 
+    // passed.  Returns true if the thread has been joined or was not started,
+    // or false if the timeout was reached.
+    bool join(unsigned int timeoutMs)
+    {
+        if (m_started)
+        {
+            struct timespec when;
+            clock_gettime(CLOCK_REALTIME, &when);
+            when.tv_sec += timeoutMs / 1000;
+            when.tv_nsec += (long)(timeoutMs % 1000) * 1000000;
+            if (when.tv_nsec >= 1000000000)
+            {
+                when.tv_sec++;
+                when.tv_nsec -= 1000000000;
+            }
+            if (pthread_timedjoin_np(m_thread, NULL, &when) == 0)
+            {
+                m_started = false;
+            }
+        }
+        return !m_started;
+    }
+
+    // Returns true if this thread has been started and not yet joined.
+    bool isStarted(void) const { return m_started; }
+
+protected:
+
+    // Runs this thread.  Override in sub-classes to perform thread operations.
+    virtual void run(void) = 0;
+
+    // Called on the new thread to execute it; calls run().  Sub-classes that
+    // prepare every thread they start, whatever its run(), override this.
+    virtual void entry(void)
+    {
+        run();
+    }
+
+private:
+
+    // The thread entry-point function where 'pt' is the Thread object.
+    static void *threadEntry(void *pt)
+    {
+        ((Thread *)pt)->entry();
+        return NULL;
+    }
+
+    // Set to true if this thread has been started and not yet joined.
+    bool m_started;
+
+    // The handle for this thread.
+    pthread_t m_thread;
+
+};}
+
+
+
+
+#endif
+//=============================== End of File ==================================
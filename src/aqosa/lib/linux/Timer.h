@@ -53,14 +53,19 @@ private:
 public:
 
     // Returns the current millisecond timer - used to start timing a duration.
+    //
+    // Like GetTickCount() on Windows the timer is coarse: where the kernel
+    // provides CLOCK_MONOTONIC_COARSE with a resolution no worse than 
+    // MAXIMUM_COARSE_RESOLUTION_NS it is used, making this a read of the
+    // vDSO data page rather than a hardware clock read.
     static uint32_t start(void)
     {
         struct timespec ts;
         
-        clock_gettime(CLOCK_MONOTONIC, &ts);
-        uint64_t nsCount = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
-        uint32_t tickCount = (uint32_t)((nsCount / 1000000ULL) & 0xFFFFFFFF);
-        
+        clock_gettime(m_clock, &ts);
+
+        // Only the low 32 bits are kept so the arithmetic can wrap freely.
+        uint32_t tickCount = (uint32_t)ts.tv_sec * 1000U + (uint32_t)ts.tv_nsec / 1000000U;
         
 #ifdef AQ_TEST_UNIT
         return m_fixClock ? m_fixClockMs : tickCount;
@@ -94,6 +99,21 @@ public:
         }
     }
 
+    // The coarsest clock resolution that start() will accept; this matches
+    // the worst case resolution of GetTickCount() on Windows.
+    static const long MAXIMUM_COARSE_RESOLUTION_NS = 16000000;
+
+    // Selects the clock used by start(), preferring CLOCK_MONOTONIC_COARSE.
+    // This is called automatically during static initialisation.
+    static void selectClock(void);
+
+private:
+
+    // The clock read by start().
+    static clockid_t m_clock;
+
+public:
+
     // Sets the clock to return the fixed value 'ms'.  Used for unit tests.
 #ifdef AQ_TEST_UNIT
     static void fixClock(uint32_t ms)
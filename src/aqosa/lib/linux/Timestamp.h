@@ -11,7 +11,10 @@
 // Includes
 //------------------------------------------------------------------------------
 
+#include "Atomic.h"
+
 #include <stdint.h>
+#include <time.h>
 
 
 
@@ -52,6 +55,15 @@ private:
 public:
 
     // Returns the UNIX timestamp in nanoseconds since 1 January 1970.
+    //
+    // Where the processor has an invariant time stamp counter the timestamp
+    // is derived from the counter.  The counter is calibrated lazily from the
+    // calls to now() themselves and is re-anchored to the system clocks 
+    // periodically, so timestamps from different processes stay within a 
+    // small bound of CLOCK_REALTIME and of each other.  Until the first 
+    // calibration completes, or if the processor does not have an invariant
+    // time stamp counter, the value is read from CLOCK_REALTIME which is 
+    // serviced by the vDSO without a system call.
     static inline uint64_t now(void)
     {
 #ifdef AQ_TEST_UNIT
@@ -60,9 +72,95 @@ public:
             return m_fixTimestamp;
         }
 #endif
-        return 0;
+#if defined(__x86_64__) || defined(__i386__)
+        uint64_t ns;
+        if (tscNow(false, ns))
+        {
+            return ns;
+        }
+        return anchor();
+#else
+        return clockNs(CLOCK_REALTIME);
+#endif
+    }
+
+    // Returns true if timestamps are currently derived from the time stamp 
+    // counter.
+    static bool isTscSource(void)
+    {
+        return m_tscNsPerTick > 0.0;
     }
 
+private:
+
+    // Reads the clock 'clk' in nanoseconds.
+    static inline uint64_t clockNs(clockid_t clk)
+    {
+        struct timespec ts;
+
+        clock_gettime(clk, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+
+    // Converts the time stamp counter to a timestamp using the current anchor,
+    // storing it in 'ns'.  Returns false if there is no anchor or, unless 
+    // 'ignoreLimit' is set, the anchor is due to be renewed.
+    static inline bool tscNow(bool ignoreLimit, uint64_t& ns)
+    {
+        // The anchor is published under a sequence lock; an odd or changed
+        // sequence means it was read while being replaced.
+        for (;;)
+        {
+            uint32_t seq = Atomic::read(&m_tscSeq);
+            uint64_t base = m_tscBase;
+            uint64_t baseNs = m_tscBaseNs;
+            uint64_t limit = m_tscLimit;
+            double nsPerTick = m_tscNsPerTick;
+            uint64_t ticks = __builtin_ia32_rdtsc() - base;
+            if (Atomic::read(&m_tscSeq) != seq || (seq & 1))
+            {
+                continue;
+            }
+            if (nsPerTick <= 0.0 || (!ignoreLimit && ticks >= limit))
+            {
+                return false;
+            }
+            ns = baseNs + (uint64_t)((double)ticks * nsPerTick);
+            return true;
+        }
+    }
+
+#endif
+
+    // Anchors the time stamp counter to the system clocks, calibrating its
+    // rate once enough time has passed since the previous anchor.  Returns 
+    // the current timestamp.
+    static uint64_t anchor(void);
+
+    // Incremented before and after the anchor is changed.
+    static volatile uint32_t m_tscSeq;
+
+    // Set while a thread is renewing the anchor.
+    static volatile uint32_t m_tscLock;
+
+    // The time stamp counter value at the anchor.
+    static volatile uint64_t m_tscBase;
+
+    // The UNIX timestamp in nanoseconds corresponding to m_tscBase.
+    static volatile uint64_t m_tscBaseNs;
+
+    // The number of time stamp counter ticks after m_tscBase that the anchor
+    // is used for before it is renewed.
+    static volatile uint64_t m_tscLimit;
+
+    // The number of nanoseconds per time stamp counter tick, or 0 if the time
+    // stamp counter is not used.
+    static volatile double m_tscNsPerTick;
+
+public:
+
     // Sets the clock to return the fixed value 'ms'.  Used for unit tests.
 #ifdef AQ_TEST_UNIT
     static void fixTimestamp(uint64_t ts)
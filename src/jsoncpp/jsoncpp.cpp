@@ -230,8 +230,8 @@ static int       stackDepth_g = 0;  // see readValue()
 
 namespace Json {
 
-#if __GNUC__ >= 6
-typedef std::scoped_ptr<CharReader> const  CharReaderPtr;
+#if __cplusplus >= 201103L
+typedef std::unique_ptr<CharReader> const  CharReaderPtr;
 #else
 typedef std::auto_ptr<CharReader>          CharReaderPtr;
 #endif
@@ -1307,7 +1307,8 @@ bool OurReader::readToken(Token& token) {
     token.type_ = tokenString;
     ok = readStringSingleQuote();
     break;
-    } // else continue
+    }
+    // Falls through.
   case '/':
     token.type_ = tokenComment;
     ok = readComment();
@@ -2515,6 +2516,7 @@ Value::Value(ValueType vtype) {
   initBasic(vtype);
   switch (vtype) {
   case nullValue:
+    value_.int_ = 0;
     break;
   case intValue:
   case uintValue:
@@ -3799,8 +3801,8 @@ Value& Path::make(Value& root) const {
 
 namespace Json {
 
-#if __GNUC__ >= 6
-typedef std::scoped_ptr<StreamWriter> const  StreamWriterPtr;
+#if __cplusplus >= 201103L
+typedef std::unique_ptr<StreamWriter> const  StreamWriterPtr;
 #else
 typedef std::auto_ptr<StreamWriter>          StreamWriterPtr;
 #endif
@@ -0,0 +1,311 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "CpuAffinity.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+// The position of a CPU within the topology, used to order the CPUs.
+struct Placement
+{
+    // The CPU number.
+    int id;
+
+    // The socket the CPU is in.
+    int socket;
+
+    // The index of the CPU's core among the cores in its socket.
+    int coreIndex;
+
+    // The index of the CPU among the SMT siblings of its core.
+    int smtIndex;
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Orders placements for the compact policy.
+static bool compactOrder(const Placement& a, const Placement& b);
+
+// Orders placements for the scatter policy.
+static bool scatterOrder(const Placement& a, const Placement& b);
+
+// Orders placements for the SMT policy.
+static bool smtOrder(const Placement& a, const Placement& b);
+
+// Orders CPUs by their socket, core and then CPU number.
+static bool cpuOrder(const CpuAffinity::Cpu& a, const CpuAffinity::Cpu& b);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+CpuAffinity::CpuAffinity(const std::string& policy)
+    : m_policy(PolicyNone)
+    , m_topology(topology())
+{
+    init(policy);
+}
+
+//------------------------------------------------------------------------------
+CpuAffinity::CpuAffinity(const std::string& policy, const std::vector<Cpu>& topology)
+    : m_policy(PolicyNone)
+    , m_topology(topology)
+{
+    init(policy);
+}
+
+//------------------------------------------------------------------------------
+CpuAffinity::~CpuAffinity(void)
+{
+}
+
+//------------------------------------------------------------------------------
+static bool cpuOrder(const CpuAffinity::Cpu& a, const CpuAffinity::Cpu& b)
+{
+    if (a.socket != b.socket)
+    {
+        return a.socket < b.socket;
+    }
+    if (a.core != b.core)
+    {
+        return a.core < b.core;
+    }
+    return a.id < b.id;
+}
+
+//------------------------------------------------------------------------------
+static bool compactOrder(const Placement& a, const Placement& b)
+{
+    if (a.smtIndex != b.smtIndex)
+    {
+        return a.smtIndex < b.smtIndex;
+    }
+    if (a.socket != b.socket)
+    {
+        return a.socket < b.socket;
+    }
+    return a.coreIndex < b.coreIndex;
+}
+
+//------------------------------------------------------------------------------
+static bool scatterOrder(const Placement& a, const Placement& b)
+{
+    if (a.smtIndex != b.smtIndex)
+    {
+        return a.smtIndex < b.smtIndex;
+    }
+    if (a.coreIndex != b.coreIndex)
+    {
+        return a.coreIndex < b.coreIndex;
+    }
+    return a.socket < b.socket;
+}
+
+//------------------------------------------------------------------------------
+static bool smtOrder(const Placement& a, const Placement& b)
+{
+    if (a.socket != b.socket)
+    {
+        return a.socket < b.socket;
+    }
+    if (a.coreIndex != b.coreIndex)
+    {
+        return a.coreIndex < b.coreIndex;
+    }
+    return a.smtIndex < b.smtIndex;
+}
+
+//------------------------------------------------------------------------------
+void CpuAffinity::init(const std::string& policy)
+{
+    if (policy.empty() || policy == "none")
+    {
+        m_policy = PolicyNone;
+        return;
+    }
+
+    if (policy[0] >= '0' && policy[0] <= '9')
+    {
+        m_policy = PolicyList;
+
+        istringstream ss(policy);
+        string item;
+        while (getline(ss, item, ','))
+        {
+            char *end;
+            long id = strtol(item.c_str(), &end, 10);
+            bool found = false;
+            for (size_t i = 0; i < m_topology.size() && !found; ++i)
+            {
+                found = m_topology[i].id == id;
+            }
+            if (item.empty() || *end != '\0' || !found)
+            {
+                throw invalid_argument("CPU '" + item + "' in the affinity list is not available");
+            }
+            m_order.push_back((int)id);
+        }
+        return;
+    }
+
+    bool (*order)(const Placement&, const Placement&);
+    if (policy == "compact")
+    {
+        m_policy = PolicyCompact;
+        order = compactOrder;
+    }
+    else if (policy == "scatter")
+    {
+        m_policy = PolicyScatter;
+        order = scatterOrder;
+    }
+    else if (policy == "smt")
+    {
+        m_policy = PolicySmt;
+        order = smtOrder;
+    }
+    else
+    {
+        throw invalid_argument("Unknown CPU affinity policy '" + policy + "'");
+    }
+    if (m_topology.empty())
+    {
+        throw invalid_argument("The CPU topology could not be determined");
+    }
+
+    // Number the cores within each socket and the siblings within each core
+    // from 0, as the identifiers reported by the system need not be dense.
+    vector<Cpu> cpus(m_topology);
+    sort(cpus.begin(), cpus.end(), cpuOrder);
+    vector<Placement> placements;
+    for (size_t i = 0; i < cpus.size(); ++i)
+    {
+        Placement p;
+        p.id = cpus[i].id;
+        p.socket = cpus[i].socket;
+        if (i == 0 || cpus[i].socket != cpus[i - 1].socket)
+        {
+            p.coreIndex = 0;
+            p.smtIndex = 0;
+        }
+        else if (cpus[i].core != cpus[i - 1].core)
+        {
+            p.coreIndex = placements.back().coreIndex + 1;
+            p.smtIndex = 0;
+        }
+        else
+        {
+            p.coreIndex = placements.back().coreIndex;
+            p.smtIndex = placements.back().smtIndex + 1;
+        }
+        placements.push_back(p);
+    }
+
+    stable_sort(placements.begin(), placements.end(), order);
+    for (size_t i = 0; i < placements.size(); ++i)
+    {
+        m_order.push_back(placements[i].id);
+    }
+}
+
+//------------------------------------------------------------------------------
+int CpuAffinity::cpu(size_t index) const
+{
+    if (m_order.empty())
+    {
+        return -1;
+    }
+    return m_order[index % m_order.size()];
+}
+
+//------------------------------------------------------------------------------
+size_t CpuAffinity::socketCount(void) const
+{
+    set<int> sockets;
+    for (size_t i = 0; i < m_topology.size(); ++i)
+    {
+        sockets.insert(m_topology[i].socket);
+    }
+    return sockets.size();
+}
+
+//------------------------------------------------------------------------------
+size_t CpuAffinity::coreCount(void) const
+{
+    set<pair<int, int> > cores;
+    for (size_t i = 0; i < m_topology.size(); ++i)
+    {
+        cores.insert(make_pair(m_topology[i].socket, m_topology[i].core));
+    }
+    return cores.size();
+}
+
+//------------------------------------------------------------------------------
+std::string CpuAffinity::description(void) const
+{
+    static const char *PolicyNames[] = { "none", "compact", "scatter", "smt", "list" };
+
+    ostringstream ss;
+    ss << socketCount() << " socket(s), " << coreCount() << " core(s), "
+       << m_topology.size() << " CPU(s); affinity " << PolicyNames[m_policy];
+    if (!m_order.empty())
+    {
+        ss << ":";
+        for (size_t i = 0; i < m_order.size(); ++i)
+        {
+            ss << (i == 0 ? " " : ",") << m_order[i];
+        }
+    }
+    return ss.str();
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,142 @@
+#ifndef CPUAFFINITY_H
+#define CPUAFFINITY_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Decides which CPU each thread of a test is pinned to so that results do not
+// depend on where the scheduler happens to place the threads.  The policy is
+// given as a string:
+//
+//   none     Threads are not pinned.
+//   compact  One thread per physical core, filling each socket before moving
+//            on to the next; SMT siblings are only used once every core has
+//            a thread.
+//   scatter  One thread per physical core, alternating between sockets; SMT
+//            siblings are only used once every core has a thread.
+//   smt      Threads are paired on the SMT siblings of each core, filling
+//            each socket before moving on to the next.
+//   <list>   A comma-separated list of CPU numbers used in order.
+//
+// Threads are numbered from 0 and given the CPUs in the order the policy
+// selects; if there are more threads than CPUs the order repeats.
+class CpuAffinity
+{
+public:
+
+    // The placement policies.
+    enum Policy
+    {
+        PolicyNone,
+        PolicyCompact,
+        PolicyScatter,
+        PolicySmt,
+        PolicyList
+    };
+
+    // Describes one logical CPU.
+    struct Cpu
+    {
+        // The CPU number used to pin threads to it.
+        int id;
+
+        // The socket (physical package) the CPU is in.
+        int socket;
+
+        // The physical core the CPU is part of within its socket.
+        int core;
+    };
+
+    // Constructs the placement for 'policy' on the CPUs available to this
+    // process.  Throws an invalid_argument exception if 'policy' is not valid.
+    CpuAffinity(const std::string& policy);
+
+    // Constructs the placement for 'policy' on the CPUs in 'topology'.
+    CpuAffinity(const std::string& policy, const std::vector<Cpu>& topology);
+
+    // Destroys this CPU affinity.
+    ~CpuAffinity(void);
+
+    // Returns the placement policy.
+    Policy policy(void) const { return m_policy; }
+
+    // Returns the CPU that thread 'index' is to be pinned to, or -1 if the
+    // thread is not to be pinned.
+    int cpu(size_t index) const;
+
+    // Returns the number of sockets in the topology.
+    size_t socketCount(void) const;
+
+    // Returns the number of physical cores in the topology.
+    size_t coreCount(void) const;
+
+    // Describes the CPU topology and the order CPUs are given to threads.
+    std::string description(void) const;
+
+    // Pins the calling thread to 'cpu'; nothing is done if 'cpu' is negative.
+    // Returns false if the thread could not be pinned.
+    static bool pinCurrentThread(int cpu);
+
+    // Returns the CPUs that this process may run on.
+    static std::vector<Cpu> topology(void);
+
+private:
+
+    // The placement policy.
+    Policy m_policy;
+
+    // The CPUs available.
+    std::vector<Cpu> m_topology;
+
+    // The CPUs in the order they are given to threads.
+    std::vector<int> m_order;
+
+    // Parses 'policy' and builds the placement order.
+    void init(const std::string& policy);
+
+};
+
+
+
+#endif
+//=============================== End of File ==================================
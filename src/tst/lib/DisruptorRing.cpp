@@ -0,0 +1,185 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "DisruptorRing.h"
+
+#include "AQItem.h"
+#include "AQWriterItem.h"
+
+#include "Atomic.h"
+
+using namespace aqosa;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+DisruptorRing::DisruptorRing(int pageSizeShift, size_t pageCount)
+    : m_pageSizeShift(pageSizeShift)
+    , m_mask(1)
+    , m_cursor(0)
+    , m_gating(0)
+    , m_next(0)
+    , m_contentionCount(0)
+{
+    while (m_mask < pageCount)
+    {
+        m_mask <<= 1;
+    }
+    m_mask--;
+
+    m_mem = new unsigned char[(size_t)(m_mask + 1) << pageSizeShift];
+    m_memSize = new uint32_t[m_mask + 1];
+    m_sequence = new uint32_t[m_mask + 1];
+    m_available = new uint32_t[m_mask + 1];
+    reset();
+}
+
+//------------------------------------------------------------------------------
+DisruptorRing::~DisruptorRing(void)
+{
+    delete[] m_available;
+    delete[] m_sequence;
+    delete[] m_memSize;
+    delete[] m_mem;
+}
+
+//------------------------------------------------------------------------------
+void DisruptorRing::reset(void)
+{
+    // Each slot is marked as published for the sequence number one lap
+    // before the first one it will hold.
+    for (uint32_t i = 0; i <= m_mask; ++i)
+    {
+        m_available[i] = i - m_mask;
+    }
+    m_cursor = 0;
+    m_gating = 0;
+    m_next = 0;
+    m_contentionCount = 0;
+}
+
+//------------------------------------------------------------------------------
+uint32_t DisruptorRing::memToSlot(unsigned char *mem) const
+{
+    return (uint32_t)((mem - m_mem) >> m_pageSizeShift);
+}
+
+//------------------------------------------------------------------------------
+bool DisruptorRing::claim(AQWriterItem& item, size_t memSize)
+{
+    if (memSize > pageSize())
+    {
+        item.clear();
+        return false;
+    }
+
+    uint32_t seq = Atomic::read(&m_cursor);
+    for (;;)
+    {
+        if (seq - Atomic::read(&m_gating) > m_mask)
+        {
+            item.clear();
+            return false;
+        }
+        uint32_t prev = Atomic::cmpXchg(&m_cursor, seq + 1, seq);
+        if (prev == seq)
+        {
+            break;
+        }
+        Atomic::increment(&m_contentionCount);
+        seq = prev;
+    }
+
+    uint32_t slot = seq & m_mask;
+    m_sequence[slot] = seq;
+    m_memSize[slot] = (uint32_t)memSize;
+    item.m_mem = &m_mem[(size_t)slot << m_pageSizeShift];
+    item.m_memSize = memSize;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool DisruptorRing::commit(AQWriterItem& item)
+{
+    if (!item.isAllocated())
+    {
+        return false;
+    }
+
+    uint32_t slot = memToSlot(item.m_mem);
+    Atomic::write(&m_available[slot], m_sequence[slot] + 1);
+    item.clear();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool DisruptorRing::retrieve(AQItem& item)
+{
+    uint32_t slot = m_next & m_mask;
+    if (Atomic::read(&m_available[slot]) != m_next + 1)
+    {
+        item.clear();
+        return false;
+    }
+
+    m_next++;
+    item.m_mem = &m_mem[(size_t)slot << m_pageSizeShift];
+    item.m_memSize = m_memSize[slot];
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void DisruptorRing::release(AQItem& item)
+{
+    if (item.isAllocated())
+    {
+        Atomic::write(&m_gating, m_gating + 1);
+        item.clear();
+    }
+}
+
+
+
+
+//=============================== End of File ==================================
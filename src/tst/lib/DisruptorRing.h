@@ -0,0 +1,153 @@
+#ifndef DISRUPTORRING_H
+#define DISRUPTORRING_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "IAQReader.h"
+#include "IAQWriter.h"
+
+#include <stdint.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class AQItem;
+class AQWriterItem;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// A reference queue in the style of the LMAX disruptor's multi-producer
+// sequencer.  Each slot of the ring is a page; claim() takes the next
+// sequence number with a compare-and-exchange on the cursor, commit()
+// publishes the slot by writing its sequence number into the slot's
+// availability flag, and the single consumer retrieves the slots strictly
+// in sequence order.  release() advances the gating sequence that stops the
+// producers from lapping the consumer, so items must be released in the
+// order they were retrieved.
+class DisruptorRing
+{
+public:
+
+    // Constructs a ring of at least 'pageCount' pages each
+    // 1 << 'pageSizeShift' bytes; the page count is rounded up to a power of
+    // two.
+    DisruptorRing(int pageSizeShift, size_t pageCount);
+
+private:
+
+    // No implementation is defined for these functions.
+    DisruptorRing(const DisruptorRing& other);
+    DisruptorRing& operator=(const DisruptorRing& other);
+
+public:
+
+    // Destroys this ring.
+    virtual ~DisruptorRing(void);
+
+    // Resets the ring to all empty.
+    void reset(void);
+
+    // The claim() function as defined in IAQWriter.
+    bool claim(AQWriterItem& item, size_t memSize);
+
+    // The commit() function as defined in IAQWriter.
+    bool commit(AQWriterItem& item);
+
+    // The retrieve() function as defined in IAQReader.
+    bool retrieve(AQItem& item);
+
+    // The release() function as defined in IAQReader.
+    void release(AQItem& item);
+
+private:
+
+    // The size of each page is 1 << 'm_pageSizeShift'.
+    const int m_pageSizeShift;
+
+    // The number of slots in the ring less one.
+    uint32_t m_mask;
+
+    // The memory for the pages.
+    unsigned char *m_mem;
+
+    // The number of bytes claimed in each slot.
+    uint32_t *m_memSize;
+
+    // The sequence number each slot was claimed with.
+    uint32_t *m_sequence;
+
+    // One more than the sequence number last published in each slot.
+    volatile uint32_t *m_available;
+
+    // The next sequence number to claim.
+    volatile uint32_t m_cursor;
+
+    // Keeps the producer and consumer sequences on separate cache lines.
+    unsigned char m_pad1[60];
+
+    // The number of sequences released by the consumer.
+    volatile uint32_t m_gating;
+
+    // Keeps the producer and consumer sequences on separate cache lines.
+    unsigned char m_pad2[60];
+
+    // The next sequence number to retrieve; only used by the consumer.
+    uint32_t m_next;
+
+    // The number of times a compare-and-exchange on the cursor failed.
+    volatile uint32_t m_contentionCount;
+
+    // Converts a memory pointer into a slot index.
+    uint32_t memToSlot(unsigned char *mem) const;
+
+public:
+
+    // Gets the page count for this ring.
+    size_t pageCount(void) const { return m_mask + 1; }
+
+    // The size of each page in the ring.
+    size_t pageSize(void) const { return (size_t)(1 << m_pageSizeShift); }
+
+    // The number of times a producer had to retry a claim because another
+    // producer moved the cursor first.
+    uint32_t contentionCount(void) const { return m_contentionCount; }
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -0,0 +1,170 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PerfCounters.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// The short name of each counter.
+static const char *CounterNames[PerfCounters::COUNTER_COUNT] =
+{
+    "cycles",
+    "instructions",
+    "llc-misses",
+    "branch-misses",
+    "hitm"
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+PerfCounters::PerfCounters(void)
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        m_handle[i] = -1;
+        m_started[i] = false;
+    }
+    clear();
+}
+
+//------------------------------------------------------------------------------
+PerfCounters::PerfCounters(const PerfCounters& other)
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        m_handle[i] = -1;
+        m_started[i] = false;
+    }
+    *this = other;
+}
+
+//------------------------------------------------------------------------------
+PerfCounters& PerfCounters::operator=(const PerfCounters& other)
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        m_total[i] = other.m_total[i];
+        m_counted[i] = other.m_counted[i];
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+PerfCounters::~PerfCounters(void)
+{
+    close();
+}
+
+//------------------------------------------------------------------------------
+bool PerfCounters::hasTotals(void) const
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        if (m_counted[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::clear(void)
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        m_total[i] = 0;
+        m_counted[i] = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::add(const PerfCounters& other)
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        m_total[i] += other.m_total[i];
+        m_counted[i] = m_counted[i] || other.m_counted[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+std::string PerfCounters::summary(uint64_t operationCount) const
+{
+    double n = operationCount == 0 ? 1.0 : (double)operationCount;
+
+    ostringstream ss;
+    ss << fixed << setprecision(2);
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        if (m_counted[i])
+        {
+            if (ss.tellp() > 0)
+            {
+                ss << " ";
+            }
+            ss << CounterNames[i] << "/op=" << (double)m_total[i] / n;
+        }
+    }
+    if (m_counted[CounterCycles] && m_counted[CounterInstructions] && m_total[CounterCycles] > 0)
+    {
+        ss << " ipc=" << (double)m_total[CounterInstructions] / (double)m_total[CounterCycles];
+    }
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+const char *PerfCounters::name(Counter counter)
+{
+    return counter >= 0 && counter < COUNTER_COUNT ? CounterNames[counter] : "";
+}
+
+
+
+
+//=============================== End of File ==================================
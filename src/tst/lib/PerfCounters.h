@@ -0,0 +1,160 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include <string>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+// Passed to PerfCounters::setHitmEvent() to pick the HITM event from the CPU
+// vendor.
+#define PERF_COUNTERS_HITM_AUTO         (~(uint64_t)0)
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Counts hardware events in the calling thread over one or more measured
+// intervals.  The counters are opened by the thread to be measured; each
+// start() and stop() pair then adds the events between them to the totals.
+//
+// On Linux the counters use perf_event_open() and count user space only, so
+// that they work with the default perf_event_paranoid setting.  A counter the
+// kernel or CPU does not provide is left closed and the others still count.
+// Counters that the kernel multiplexes are scaled up to the full interval.
+//
+// HITM counts loads that hit a line modified in another core's cache, which
+// is the cost of a cache line bouncing between writers.  There is no generic
+// event for it; on Intel CPUs the raw event 0x04d2 is used unless another is
+// given with setHitmEvent().
+//
+// Copying a set of counters copies its totals only; the copy is not open.
+class PerfCounters
+{
+public:
+
+    // The events that are counted.
+    enum Counter
+    {
+        CounterCycles,
+        CounterInstructions,
+        CounterLlcMisses,
+        CounterBranchMisses,
+        CounterHitm,
+        COUNTER_COUNT
+    };
+
+    // Constructs a new set of closed counters with zero totals.
+    PerfCounters(void);
+
+    // Constructs a closed set of counters with the totals of 'other'.
+    PerfCounters(const PerfCounters& other);
+
+    // Replaces the totals with those of 'other'; this set stays open or
+    // closed as it was.
+    PerfCounters& operator=(const PerfCounters& other);
+
+    // Destroys this set of counters, closing them.
+    ~PerfCounters(void);
+
+    // Opens each of the counters for the calling thread.  Returns the number
+    // that could be opened.
+    size_t open(void);
+
+    // Closes each of the counters.  The totals are kept.
+    void close(void);
+
+    // Returns true if 'counter' is open.
+    bool isOpen(Counter counter) const { return m_handle[counter] >= 0; }
+
+    // Reads then starts each open counter.
+    void start(void);
+
+    // Stops each open counter and adds its count to its total.
+    void stop(void);
+
+    // Returns true if 'counter' has counted at least one interval.
+    bool hasTotal(Counter counter) const { return m_counted[counter]; }
+
+    // Returns the total count of 'counter'.
+    uint64_t total(Counter counter) const { return m_total[counter]; }
+
+    // Returns true if any counter has counted at least one interval.
+    bool hasTotals(void) const;
+
+    // Sets each total to zero.
+    void clear(void);
+
+    // Adds the totals of 'other' to these totals.
+    void add(const PerfCounters& other);
+
+    // Describes each counted event per operation given 'operationCount'
+    // operations, with the instructions per cycle.
+    std::string summary(uint64_t operationCount) const;
+
+    // Returns the short name of 'counter'.
+    static const char *name(Counter counter);
+
+    // Sets the raw event counted for HITM, or 0 for none.  The default,
+    // PERF_COUNTERS_HITM_AUTO, picks the event from the CPU vendor.
+    static void setHitmEvent(uint64_t rawEvent);
+
+private:
+
+    // The handle of each counter, or -1 if it is closed.
+    int m_handle[COUNTER_COUNT];
+
+    // The total of each counter.
+    uint64_t m_total[COUNTER_COUNT];
+
+    // Set to true once a counter has counted an interval.
+    bool m_counted[COUNTER_COUNT];
+
+    // The count, enabled time and running time of each counter read by 
+    // start(); the interval is the difference from these.
+    uint64_t m_startValue[COUNTER_COUNT];
+    uint64_t m_startEnabled[COUNTER_COUNT];
+    uint64_t m_startRunning[COUNTER_COUNT];
+
+    // Set to true if the start values of a counter were read.
+    bool m_started[COUNTER_COUNT];
+
+};
+
+
+
+#endif
+//=============================== End of File ==================================
@@ -98,6 +98,12 @@ TestAssert::~TestAssert(void)
 {
 }
 
+//------------------------------------------------------------------------------
+void TestAssert::raise(void) const
+{
+    throw *this;
+}
+
 
 
 
@@ -87,7 +87,7 @@ do
     if (__throwIfFailed && !TestExecution::isThrowing())                        \
     {                                                                           \
         TestExecution::markThrowing();                                          \
-        throw ast;                                                              \
+        ast.raise();                                                            \
     }                                                                           \
 } while(0)
 
@@ -294,6 +294,11 @@ public:
     // Destroys this assertion failure report.
     ~TestAssert(void);
 
+    // Throws a copy of this assertion failure.  Not inline so that CHECK() 
+    // can be used in a destructor, where a throw expression is diagnosed by
+    // the compiler even though CHECK() never reaches it.
+    void raise(void) const;
+
 private:
 
     // The file where the assertion occurred.
@@ -0,0 +1,236 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "VyukovRing.h"
+
+#include "AQItem.h"
+#include "AQWriterItem.h"
+
+#include "Atomic.h"
+
+using namespace aqosa;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+VyukovRing::VyukovRing(int pageSizeShift, size_t pageCount)
+    : m_pageCount(pageCount)
+    , m_pageSizeShift(pageSizeShift)
+    , m_mask(1)
+    , m_contentionCount(0)
+{
+    while (m_mask < pageCount)
+    {
+        m_mask <<= 1;
+    }
+    m_mask--;
+
+    m_mem = new unsigned char[pageCount << pageSizeShift];
+    m_memSize = new uint32_t[pageCount];
+    m_free.m_cells = new Cell[m_mask + 1];
+    m_committed.m_cells = new Cell[m_mask + 1];
+    reset();
+}
+
+//------------------------------------------------------------------------------
+VyukovRing::~VyukovRing(void)
+{
+    delete[] m_committed.m_cells;
+    delete[] m_free.m_cells;
+    delete[] m_memSize;
+    delete[] m_mem;
+}
+
+//------------------------------------------------------------------------------
+void VyukovRing::reset(void)
+{
+    for (uint32_t i = 0; i <= m_mask; ++i)
+    {
+        m_free.m_cells[i].m_sequence = i;
+        m_committed.m_cells[i].m_sequence = i;
+    }
+    m_free.m_enqueuePos = 0;
+    m_free.m_dequeuePos = 0;
+    m_committed.m_enqueuePos = 0;
+    m_committed.m_dequeuePos = 0;
+    m_contentionCount = 0;
+
+    for (uint32_t i = 0; i < m_pageCount; ++i)
+    {
+        enqueue(m_free, i);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool VyukovRing::enqueue(Ring& ring, uint32_t page)
+{
+    uint32_t pos = Atomic::read(&ring.m_enqueuePos);
+    Cell *cell;
+    for (;;)
+    {
+        cell = &ring.m_cells[pos & m_mask];
+        int32_t dif = (int32_t)(Atomic::read(&cell->m_sequence) - pos);
+        if (dif == 0)
+        {
+            uint32_t prev = Atomic::cmpXchg(&ring.m_enqueuePos, pos + 1, pos);
+            if (prev == pos)
+            {
+                break;
+            }
+            Atomic::increment(&m_contentionCount);
+            pos = prev;
+        }
+        else if (dif < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = Atomic::read(&ring.m_enqueuePos);
+        }
+    }
+
+    cell->m_page = page;
+    Atomic::write(&cell->m_sequence, pos + 1);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool VyukovRing::dequeue(Ring& ring, uint32_t& page)
+{
+    uint32_t pos = Atomic::read(&ring.m_dequeuePos);
+    Cell *cell;
+    for (;;)
+    {
+        cell = &ring.m_cells[pos & m_mask];
+        int32_t dif = (int32_t)(Atomic::read(&cell->m_sequence) - (pos + 1));
+        if (dif == 0)
+        {
+            uint32_t prev = Atomic::cmpXchg(&ring.m_dequeuePos, pos + 1, pos);
+            if (prev == pos)
+            {
+                break;
+            }
+            Atomic::increment(&m_contentionCount);
+            pos = prev;
+        }
+        else if (dif < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = Atomic::read(&ring.m_dequeuePos);
+        }
+    }
+
+    page = cell->m_page;
+    Atomic::write(&cell->m_sequence, pos + m_mask + 1);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool VyukovRing::claim(AQWriterItem& item, size_t memSize)
+{
+    if (memSize > pageSize())
+    {
+        item.clear();
+        return false;
+    }
+
+    uint32_t page;
+    if (!dequeue(m_free, page))
+    {
+        item.clear();
+        return false;
+    }
+
+    m_memSize[page] = (uint32_t)memSize;
+    item.m_mem = &m_mem[(size_t)page << m_pageSizeShift];
+    item.m_memSize = memSize;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool VyukovRing::commit(AQWriterItem& item)
+{
+    if (!item.isAllocated())
+    {
+        return false;
+    }
+
+    enqueue(m_committed, (uint32_t)((item.m_mem - m_mem) >> m_pageSizeShift));
+    item.clear();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool VyukovRing::retrieve(AQItem& item)
+{
+    uint32_t page;
+    if (!dequeue(m_committed, page))
+    {
+        item.clear();
+        return false;
+    }
+
+    item.m_mem = &m_mem[(size_t)page << m_pageSizeShift];
+    item.m_memSize = m_memSize[page];
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void VyukovRing::release(AQItem& item)
+{
+    if (item.isAllocated())
+    {
+        enqueue(m_free, (uint32_t)((item.m_mem - m_mem) >> m_pageSizeShift));
+        item.clear();
+    }
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,170 @@
+#ifndef VYUKOVRING_H
+#define VYUKOVRING_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "IAQReader.h"
+#include "IAQWriter.h"
+
+#include <stdint.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class AQItem;
+class AQWriterItem;
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// A reference queue built from two of Dmitry Vyukov's bounded multi-producer
+// multi-consumer rings: one holds the indexes of the free pages and the other
+// the indexes of the committed pages.  claim() takes a page from the free
+// ring, commit() puts it on the committed ring, retrieve() takes it from the
+// committed ring and release() returns it to the free ring.
+//
+// Each ring slot carries a sequence number that tells a producer when the
+// slot is free and a consumer when it is full, so the only shared write per
+// operation is a single compare-and-exchange on the ring position.
+class VyukovRing
+{
+public:
+
+    // Constructs a queue of 'pageCount' pages each 1 << 'pageSizeShift' bytes.
+    VyukovRing(int pageSizeShift, size_t pageCount);
+
+private:
+
+    // No implementation is defined for these functions.
+    VyukovRing(const VyukovRing& other);
+    VyukovRing& operator=(const VyukovRing& other);
+
+public:
+
+    // Destroys this queue.
+    virtual ~VyukovRing(void);
+
+    // Resets the queue to all empty.
+    void reset(void);
+
+    // The claim() function as defined in IAQWriter.
+    bool claim(AQWriterItem& item, size_t memSize);
+
+    // The commit() function as defined in IAQWriter.
+    bool commit(AQWriterItem& item);
+
+    // The retrieve() function as defined in IAQReader.
+    bool retrieve(AQItem& item);
+
+    // The release() function as defined in IAQReader.
+    void release(AQItem& item);
+
+private:
+
+    // A slot in a ring.
+    struct Cell
+    {
+        // The sequence number that says whether this slot may be written or
+        // read at the current ring position.
+        volatile uint32_t m_sequence;
+
+        // The page index held in this slot.
+        uint32_t m_page;
+    };
+
+    // A bounded ring of page indexes.
+    struct Ring
+    {
+        // The next position to enqueue at.
+        volatile uint32_t m_enqueuePos;
+
+        // Keeps the enqueue and dequeue positions on separate cache lines.
+        unsigned char m_pad[60];
+
+        // The next position to dequeue from.
+        volatile uint32_t m_dequeuePos;
+
+        // The slots in the ring.
+        Cell *m_cells;
+    };
+
+    // The page count.
+    const size_t m_pageCount;
+
+    // The size of each page is 1 << 'm_pageSizeShift'.
+    const int m_pageSizeShift;
+
+    // The number of slots in each ring less one; the number of slots is the
+    // page count rounded up to a power of two.
+    uint32_t m_mask;
+
+    // The memory for the pages.
+    unsigned char *m_mem;
+
+    // The number of bytes claimed in each page.
+    uint32_t *m_memSize;
+
+    // The free and committed rings.
+    Ring m_free;
+    Ring m_committed;
+
+    // The number of times a compare-and-exchange on a ring position failed.
+    volatile uint32_t m_contentionCount;
+
+    // Adds 'page' to 'ring'.  Returns false if the ring is full.
+    bool enqueue(Ring& ring, uint32_t page);
+
+    // Removes the oldest page from 'ring' into 'page'.  Returns false if the
+    // ring is empty.
+    bool dequeue(Ring& ring, uint32_t& page);
+
+public:
+
+    // Gets the page count for this queue.
+    size_t pageCount(void) const { return m_pageCount; }
+
+    // The size of each page in the queue.
+    size_t pageSize(void) const { return (size_t)(1 << m_pageSizeShift); }
+
+    // The number of times a thread had to retry an operation because another
+    // thread moved the ring position first.
+    uint32_t contentionCount(void) const { return m_contentionCount; }
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
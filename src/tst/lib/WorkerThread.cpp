@@ -11,9 +11,9 @@
 
 #include "WorkerThread.h"
 
+#include "CpuAffinity.h"
+
 #include <stdexcept>
-#include <time.h>
-#include <sys/sysinfo.h>
 
 using namespace std;
 
@@ -57,9 +57,9 @@ class WorkerThreadAbortException : public exception { };
 
 //------------------------------------------------------------------------------
 WorkerThread::WorkerThread(void)
-    : m_started(false)
-    , m_stop(false)
+    : m_stop(false)
     , m_stopImmediate(false)
+    , m_cpu(-1)
 {
 }
 
@@ -73,23 +73,16 @@ void WorkerThread::start(void)
 {
     lock();
 
-    if (!m_started)
+    if (!isStarted())
     {
         m_stop = false;
         m_stopImmediate = false;
-        
-        pthread_attr_t tattr;
-        pthread_attr_init(&tattr);
-        pthread_attr_setdetachstate(&tattr, PTHREAD_CREATE_JOINABLE);
-        int res = pthread_create(&m_thread, &tattr, threadEntry, this);
-        pthread_attr_destroy(&tattr);
-        
-        if (res != 0)
+
+        if (!Thread::start())
         {
             unlock();
             throw runtime_error("Cannot create thread");
         }
-        m_started = true;
     }
 
     unlock();
@@ -116,39 +109,16 @@ void WorkerThread::stopImmediate(void)
 bool WorkerThread::join(unsigned int timeoutMs)
 {
     lock();
-
-    if (m_started)
-    {
-        m_stop = true;
-        unlock();
-        
-        struct timespec when;
-        clock_gettime(CLOCK_REALTIME, &when);
-        when.tv_sec += (timeoutMs + 999) / 1000;
-        
-        void *p = NULL;
-        int res = pthread_timedjoin_np(m_thread, &p, &when);
-
-        lock();
-        if (res == 0)
-        {
-            m_started = false;
-        }
-    }
-    bool joined = !m_started;
+    m_stop = true;
     unlock();
 
-    return joined;
+    return Thread::join(timeoutMs);
 }
 
 //------------------------------------------------------------------------------
 bool WorkerThread::isJoined(void)
 {
-    lock();
-    bool joined = !m_started;
-    unlock();
-
-    return joined;
+    return !isStarted();
 }
 
 //------------------------------------------------------------------------------
@@ -164,26 +134,16 @@ void WorkerThread::unlock(void)
 }
 
 //------------------------------------------------------------------------------
-void *WorkerThread::threadEntry(void *pt)
+void WorkerThread::entry(void)
 {
     try
     {
-        ((WorkerThread *)pt)->run();
+        CpuAffinity::pinCurrentThread(m_cpu);
+        run();
     }
     catch (const WorkerThreadAbortException&)
     {
     }
-    return NULL;
-}
-
-//------------------------------------------------------------------------------
-void WorkerThread::yieldMs(unsigned int ms)
-{
-    struct timespec ts;
-    
-    ts.tv_sec = ms / 1000;
-    ts.tv_nsec = (ms % 1000) * 1000000;
-    nanosleep(&ts, NULL);
 }
 
 //------------------------------------------------------------------------------
@@ -212,12 +172,6 @@ void WorkerThread::abortIfStopImmediate(void)
     }
 }
 
-//------------------------------------------------------------------------------
-int WorkerThread::numberOfProcessors(void)
-{
-    return get_nprocs();
-}
-
 
 
 
@@ -12,8 +12,7 @@
 //------------------------------------------------------------------------------
 
 #include "Mutex.h"
-
-#include <pthread.h>
+#include "Thread.h"
 
 
 
@@ -43,8 +42,9 @@
 // Exported Function and Class Declarations
 //------------------------------------------------------------------------------
 
-// Encapsulates thread execution for a producer or snapshot worker.
-class WorkerThread
+// Encapsulates thread execution for a producer or snapshot worker.  Adds to
+// the aqosa thread the ability to stop the worker and to pin it to a CPU.
+class WorkerThread : public aqosa::Thread
 {
 protected:
 
@@ -60,6 +60,10 @@ public:
     WorkerThread(const WorkerThread& other);
     WorkerThread& operator=(const WorkerThread& other);
 
+    // Sets the CPU that this thread is pinned to when it next starts, or -1
+    // to leave the thread's placement to the scheduler.
+    void setAffinity(int cpu) { m_cpu = cpu; }
+
     // Starts this thread of execution.
     void start(void);
 
@@ -89,9 +93,6 @@ protected:
     // Unlocks this thread's mutex.
     void unlock(void);
 
-    // Runs this thread.  Override in sub-classes to perform thread operations.
-    virtual void run(void) = 0;
-
 public:
 
     // Aborts this thread if it has been stopped.  Only call from within run().
@@ -103,19 +104,16 @@ public:
 
 private:
 
-    // The thread entry-point function where 'pt' is the WorkerThread object.
-    static void *threadEntry(void *pt);
+    // Pins this thread to its CPU then runs it until it returns or aborts.
+    virtual void entry(void);
 
-    // Set to true if this thread has started.
-    bool m_started;
-    
-    // The handle for this thread.
-    pthread_t m_thread;
-    
     // Set to true if the thread is to stop; protected by m_lock.
     bool m_stop;
     bool m_stopImmediate;
 
+    // The CPU this thread is pinned to, or -1 if it is not pinned.
+    int m_cpu;
+
     // Protects m_stop for this thread.  Can also be used by sub-classes to protect
     // their internal data by using the lock() and unlock() methods.
     Mutex m_lock;
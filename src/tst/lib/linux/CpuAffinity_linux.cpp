@@ -0,0 +1,127 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "CpuAffinity.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The directory holding the topology of each CPU.
+#define SYSFS_CPU_DIR                   "/sys/devices/system/cpu"
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Reads the topology attribute 'name' of CPU 'cpu' into 'value'.  Returns
+// false if the attribute cannot be read.
+static bool readTopology(int cpu, const char *name, int& value);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static bool readTopology(int cpu, const char *name, int& value)
+{
+    char path[128];
+    snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/topology/%s", cpu, name);
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    bool ok = fscanf(fp, "%d", &value) == 1;
+    fclose(fp);
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+bool CpuAffinity::pinCurrentThread(int cpu)
+{
+    if (cpu < 0)
+    {
+        return true;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+//------------------------------------------------------------------------------
+std::vector<CpuAffinity::Cpu> CpuAffinity::topology(void)
+{
+    vector<Cpu> cpus;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+    {
+        return cpus;
+    }
+
+    for (int i = 0; i < CPU_SETSIZE; ++i)
+    {
+        if (CPU_ISSET(i, &set))
+        {
+            // Without the topology each CPU is treated as its own core.
+            Cpu cpu;
+            cpu.id = i;
+            if (!readTopology(i, "physical_package_id", cpu.socket)
+                || !readTopology(i, "core_id", cpu.core))
+            {
+                cpu.socket = 0;
+                cpu.core = i;
+            }
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+
+
+
+//=============================== End of File ==================================
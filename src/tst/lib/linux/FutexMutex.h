@@ -0,0 +1,122 @@
+#ifndef FUTEXMUTEX_H
+#define FUTEXMUTEX_H
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <linux/futex.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Exported Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Encapsulates a mutex built directly on the Linux futex system call, using
+// the three state design from Ulrich Drepper's "Futexes Are Tricky".  An
+// uncontended lock or unlock is a single atomic operation and only a
+// contended one enters the kernel.
+class FutexMutex
+{
+public:
+
+    // Constructs new mutex.
+    FutexMutex(void)
+        : m_state(UNLOCKED)
+    {
+    }
+
+    // Destroys this mutex.
+    virtual ~FutexMutex(void)
+    {
+    }
+
+    // Not implmented - cannot be copied or assigned.
+    FutexMutex(const FutexMutex& other);
+    FutexMutex& operator=(const FutexMutex& other);
+
+    // Locks this mutex.
+    void lock(void)
+    {
+        uint32_t c = __sync_val_compare_and_swap(&m_state, UNLOCKED, LOCKED);
+        if (c != UNLOCKED)
+        {
+            if (c != CONTENDED)
+            {
+                c = __sync_lock_test_and_set(&m_state, CONTENDED);
+            }
+            while (c != UNLOCKED)
+            {
+                syscall(SYS_futex, &m_state, FUTEX_WAIT_PRIVATE, CONTENDED, NULL, NULL, 0);
+                c = __sync_lock_test_and_set(&m_state, CONTENDED);
+            }
+        }
+    }
+
+    // Unlocks this mutex.
+    void unlock(void)
+    {
+        if (__sync_fetch_and_sub(&m_state, 1) != LOCKED)
+        {
+            __sync_lock_release(&m_state);
+            syscall(SYS_futex, &m_state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+        }
+    }
+
+private:
+
+    // The states of the mutex.
+    enum
+    {
+        // Not locked.
+        UNLOCKED = 0,
+
+        // Locked with no other thread waiting.
+        LOCKED = 1,
+
+        // Locked and another thread may be waiting.
+        CONTENDED = 2
+    };
+
+    // The mutex state.
+    volatile uint32_t m_state;
+
+};
+
+
+
+
+#endif
+//=============================== End of File ==================================
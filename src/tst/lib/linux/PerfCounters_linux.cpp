@@ -0,0 +1,232 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PerfCounters.h"
+
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The raw event for loads that hit a modified line in another core on Intel
+// CPUs since Nehalem: MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM, renamed XSNP_FWD on
+// later cores.
+#define INTEL_HITM_EVENT                0x04d2
+
+// The file describing the CPUs.
+#define PROC_CPUINFO                    "/proc/cpuinfo"
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+// The layout read from a counter opened with the enabled and running times.
+struct CounterValue
+{
+    uint64_t value;
+    uint64_t timeEnabled;
+    uint64_t timeRunning;
+};
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Opens a disabled counter of 'type' and 'config' for the calling thread.
+// Returns the file descriptor, or -1 if it cannot be opened.
+static int openCounter(uint32_t type, uint64_t config);
+
+// Returns true if the CPU is made by Intel.
+static bool isIntelCpu(void);
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+// The raw event counted for HITM.
+static uint64_t HitmEvent = PERF_COUNTERS_HITM_AUTO;
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int openCounter(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+//------------------------------------------------------------------------------
+static bool isIntelCpu(void)
+{
+    FILE *fp = fopen(PROC_CPUINFO, "r");
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    bool intel = false;
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (strncmp(line, "vendor_id", 9) == 0)
+        {
+            intel = strstr(line, "GenuineIntel") != NULL;
+            break;
+        }
+    }
+    fclose(fp);
+    return intel;
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::setHitmEvent(uint64_t rawEvent)
+{
+    HitmEvent = rawEvent;
+}
+
+//------------------------------------------------------------------------------
+size_t PerfCounters::open(void)
+{
+    close();
+
+    m_handle[CounterCycles] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    m_handle[CounterInstructions] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    m_handle[CounterLlcMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    m_handle[CounterBranchMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+
+    uint64_t hitm = HitmEvent;
+    if (hitm == PERF_COUNTERS_HITM_AUTO)
+    {
+        hitm = isIntelCpu() ? INTEL_HITM_EVENT : 0;
+    }
+    if (hitm != 0)
+    {
+        m_handle[CounterHitm] = openCounter(PERF_TYPE_RAW, hitm);
+    }
+
+    size_t count = 0;
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        if (m_handle[i] >= 0)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::close(void)
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        if (m_handle[i] >= 0)
+        {
+            ::close(m_handle[i]);
+            m_handle[i] = -1;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::start(void)
+{
+    // PERF_EVENT_IOC_RESET clears the count but not the enabled and running
+    // times, so the interval is measured from a reading of all three.
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        CounterValue v;
+        m_started[i] = m_handle[i] >= 0 && read(m_handle[i], &v, sizeof(v)) == (ssize_t)sizeof(v);
+        if (m_started[i])
+        {
+            m_startValue[i] = v.value;
+            m_startEnabled[i] = v.timeEnabled;
+            m_startRunning[i] = v.timeRunning;
+        }
+    }
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        if (m_started[i])
+        {
+            ioctl(m_handle[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::stop(void)
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        if (m_started[i])
+        {
+            ioctl(m_handle[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        CounterValue v;
+        if (m_started[i] && read(m_handle[i], &v, sizeof(v)) == (ssize_t)sizeof(v))
+        {
+            uint64_t value = v.value - m_startValue[i];
+            uint64_t enabled = v.timeEnabled - m_startEnabled[i];
+            uint64_t running = v.timeRunning - m_startRunning[i];
+
+            // Scale up a counter that was multiplexed with others during the
+            // interval.
+            if (running > 0 && running < enabled)
+            {
+                value = (uint64_t)((double)value * (double)enabled / (double)running);
+            }
+            m_total[i] += value;
+            m_counted[i] = true;
+        }
+        m_started[i] = false;
+    }
+}
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,147 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "CpuAffinity.h"
+
+#include <Windows.h>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The number of CPUs that can be described by an affinity mask.
+#define MASK_BITS                       (sizeof(DWORD_PTR) * 8)
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+bool CpuAffinity::pinCurrentThread(int cpu)
+{
+    if (cpu < 0)
+    {
+        return true;
+    }
+    if ((size_t)cpu >= MASK_BITS)
+    {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+}
+
+//------------------------------------------------------------------------------
+std::vector<CpuAffinity::Cpu> CpuAffinity::topology(void)
+{
+    vector<Cpu> cpus;
+
+    DWORD_PTR processMask;
+    DWORD_PTR systemMask;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+    {
+        return cpus;
+    }
+
+    // Without the topology each CPU is treated as its own core.
+    int socketOf[MASK_BITS];
+    int coreOf[MASK_BITS];
+    for (size_t i = 0; i < MASK_BITS; ++i)
+    {
+        socketOf[i] = 0;
+        coreOf[i] = (int)i;
+    }
+
+    DWORD len = 0;
+    GetLogicalProcessorInformation(NULL, &len);
+    if (len > 0)
+    {
+        vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (GetLogicalProcessorInformation(&info[0], &len))
+        {
+            int socket = 0;
+            int core = 0;
+            for (size_t i = 0; i < info.size(); ++i)
+            {
+                int *dst;
+                int value;
+                if (info[i].Relationship == RelationProcessorPackage)
+                {
+                    dst = socketOf;
+                    value = socket++;
+                }
+                else if (info[i].Relationship == RelationProcessorCore)
+                {
+                    dst = coreOf;
+                    value = core++;
+                }
+                else
+                {
+                    continue;
+                }
+                for (size_t j = 0; j < MASK_BITS; ++j)
+                {
+                    if (info[i].ProcessorMask & ((DWORD_PTR)1 << j))
+                    {
+                        dst[j] = value;
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < MASK_BITS; ++i)
+    {
+        if (processMask & ((DWORD_PTR)1 << i))
+        {
+            Cpu cpu;
+            cpu.id = (int)i;
+            cpu.socket = socketOf[i];
+            cpu.core = coreOf[i];
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,83 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PerfCounters.h"
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+// Windows does not give user mode access to the hardware counters, so no
+// counter is ever opened.
+
+//------------------------------------------------------------------------------
+void PerfCounters::setHitmEvent(uint64_t rawEvent)
+{
+}
+
+//------------------------------------------------------------------------------
+size_t PerfCounters::open(void)
+{
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::close(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::start(void)
+{
+}
+
+//------------------------------------------------------------------------------
+void PerfCounters::stop(void)
+{
+}
+
+
+
+
+//=============================== End of File ==================================
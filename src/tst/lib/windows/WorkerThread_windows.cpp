@@ -0,0 +1,82 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "WorkerThread.h"
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Variable Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void WorkerThread::yieldMs(unsigned int ms)
+{
+    Sleep(ms);
+}
+
+//------------------------------------------------------------------------------
+int WorkerThread::numberOfProcessors(void)
+{
+    BOOL isWow64 = FALSE;
+
+    if (!IsWow64Process(GetCurrentProcess(), &isWow64))
+    {
+        isWow64 = FALSE;
+    }
+
+    SYSTEM_INFO info;
+    if (isWow64)
+    {
+        GetNativeSystemInfo(&info);
+    }
+    else
+    {
+        GetSystemInfo(&info);
+    }
+    return (int)info.dwNumberOfProcessors;
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,148 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "CpuAffinity.h"
+
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Returns a topology of two sockets, each with two cores of two SMT siblings,
+// numbered the way Linux numbers them: the first sibling of every core comes
+// before any second sibling.
+static vector<CpuAffinity::Cpu> twoSocketTopology(void);
+
+// Returns the CPUs given to the first 'count' threads by 'affinity'.
+static string placement(const CpuAffinity& affinity, size_t count);
+
+
+
+
+//------------------------------------------------------------------------------
+// Test Cases
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtCpuAffinity);
+
+//------------------------------------------------------------------------------
+static vector<CpuAffinity::Cpu> twoSocketTopology(void)
+{
+    vector<CpuAffinity::Cpu> cpus;
+    for (int id = 0; id < 8; ++id)
+    {
+        CpuAffinity::Cpu cpu;
+        cpu.id = id;
+        cpu.socket = (id / 2) % 2;
+        cpu.core = id % 2;
+        cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+//------------------------------------------------------------------------------
+static string placement(const CpuAffinity& affinity, size_t count)
+{
+    ostringstream ss;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ss << (i == 0 ? "" : ",") << affinity.cpu(i);
+    }
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+TEST(given_NonePolicy_when_Placed_then_ThreadsNotPinned)
+{
+    CpuAffinity affinity("none", twoSocketTopology());
+    REQUIRE(affinity.policy() == CpuAffinity::PolicyNone);
+    REQUIRE(placement(affinity, 2) == "-1,-1");
+    REQUIRE(affinity.socketCount() == 2);
+    REQUIRE(affinity.coreCount() == 4);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_CompactPolicy_when_Placed_then_SocketFilledBeforeSiblingsUsed)
+{
+    CpuAffinity affinity("compact", twoSocketTopology());
+    REQUIRE(affinity.policy() == CpuAffinity::PolicyCompact);
+    REQUIRE(placement(affinity, 9) == "0,1,2,3,4,5,6,7,0");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ScatterPolicy_when_Placed_then_SocketsAlternate)
+{
+    CpuAffinity affinity("scatter", twoSocketTopology());
+    REQUIRE(affinity.policy() == CpuAffinity::PolicyScatter);
+    REQUIRE(placement(affinity, 8) == "0,2,1,3,4,6,5,7");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_SmtPolicy_when_Placed_then_SiblingsPaired)
+{
+    CpuAffinity affinity("smt", twoSocketTopology());
+    REQUIRE(affinity.policy() == CpuAffinity::PolicySmt);
+    REQUIRE(placement(affinity, 8) == "0,4,1,5,2,6,3,7");
+    REQUIRE(affinity.description() == "2 socket(s), 4 core(s), 8 CPU(s); affinity smt: 0,4,1,5,2,6,3,7");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_CpuList_when_Placed_then_ListUsedInOrder)
+{
+    CpuAffinity affinity("3,1", twoSocketTopology());
+    REQUIRE(affinity.policy() == CpuAffinity::PolicyList);
+    REQUIRE(placement(affinity, 3) == "3,1,3");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_InvalidPolicy_when_Constructed_then_Exception)
+{
+    REQUIRE_EXCEPTION(CpuAffinity("packed", twoSocketTopology()), invalid_argument);
+    REQUIRE_EXCEPTION(CpuAffinity("1,8", twoSocketTopology()), invalid_argument);
+    REQUIRE_EXCEPTION(CpuAffinity("1,,2", twoSocketTopology()), invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_ThisMachine_when_TopologyRead_then_CpusAvailable)
+{
+    vector<CpuAffinity::Cpu> cpus = CpuAffinity::topology();
+    REQUIRE(cpus.size() > 0);
+    REQUIRE(CpuAffinity::pinCurrentThread(-1));
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,138 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "PerfCounters.h"
+
+#include <string>
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Test Cases
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtPerfCounters);
+
+//------------------------------------------------------------------------------
+TEST(given_ClosedCounters_when_Measured_then_NothingCounted)
+{
+    PerfCounters counters;
+    counters.start();
+    counters.stop();
+
+    REQUIRE(!counters.hasTotals());
+    REQUIRE(!counters.isOpen(PerfCounters::CounterCycles));
+    REQUIRE(counters.total(PerfCounters::CounterCycles) == 0);
+    REQUIRE(counters.summary(100) == "");
+}
+
+//------------------------------------------------------------------------------
+TEST(given_OpenCounters_when_WorkMeasured_then_EachOpenCounterCounts)
+{
+    PerfCounters counters;
+    size_t count = counters.open();
+
+    counters.start();
+    volatile unsigned int sum = 0;
+    for (unsigned int i = 0; i < 100000; ++i)
+    {
+        sum = sum + i;
+    }
+    counters.stop();
+
+    // Counters are only available where the kernel and CPU provide them.
+    size_t counted = 0;
+    for (int i = 0; i < PerfCounters::COUNTER_COUNT; ++i)
+    {
+        PerfCounters::Counter counter = (PerfCounters::Counter)i;
+        REQUIRE(counters.hasTotal(counter) == counters.isOpen(counter));
+        counted += counters.hasTotal(counter) ? 1 : 0;
+    }
+    REQUIRE(counted == count);
+    if (counters.isOpen(PerfCounters::CounterInstructions))
+    {
+        REQUIRE(counters.total(PerfCounters::CounterInstructions) > 100000);
+    }
+
+    counters.close();
+    REQUIRE(!counters.isOpen(PerfCounters::CounterCycles));
+    REQUIRE(counters.hasTotals() == (count > 0));
+}
+
+//------------------------------------------------------------------------------
+TEST(given_OpenCounters_when_Copied_then_CopyClosedWithSameTotals)
+{
+    PerfCounters a;
+    size_t count = a.open();
+    a.start();
+    a.stop();
+
+    PerfCounters b(a);
+    REQUIRE(!b.isOpen(PerfCounters::CounterCycles));
+    REQUIRE(b.hasTotals() == (count > 0));
+    for (int i = 0; i < PerfCounters::COUNTER_COUNT; ++i)
+    {
+        PerfCounters::Counter counter = (PerfCounters::Counter)i;
+        REQUIRE(b.total(counter) == a.total(counter));
+    }
+
+    b.add(a);
+    for (int i = 0; i < PerfCounters::COUNTER_COUNT; ++i)
+    {
+        PerfCounters::Counter counter = (PerfCounters::Counter)i;
+        REQUIRE(b.total(counter) == 2 * a.total(counter));
+    }
+
+    b.clear();
+    REQUIRE(!b.hasTotals());
+    REQUIRE(a.isOpen(PerfCounters::CounterCycles) == (a.hasTotal(PerfCounters::CounterCycles)));
+}
+
+//------------------------------------------------------------------------------
+TEST(given_Counter_when_Named_then_ShortNameReturned)
+{
+    REQUIRE(string(PerfCounters::name(PerfCounters::CounterCycles)) == "cycles");
+    REQUIRE(string(PerfCounters::name(PerfCounters::CounterLlcMisses)) == "llc-misses");
+    REQUIRE(string(PerfCounters::name(PerfCounters::CounterHitm)) == "hitm");
+    REQUIRE(string(PerfCounters::name(PerfCounters::COUNTER_COUNT)) == "");
+}
+
+
+
+
+//=============================== End of File ==================================
@@ -0,0 +1,104 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "DisruptorRing.h"
+#include "VyukovRing.h"
+
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// The page size used by the test rings is 1 << RING_PAGE_SHIFT bytes.
+#define RING_PAGE_SHIFT                 8
+#define RING_PAGE_SIZE                  (1 << RING_PAGE_SHIFT)
+
+// The number of pages in the test rings.
+#define RING_PAGE_COUNT                 2
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+// Claims more than a page from 'ring' then claims every page.  The oversized
+// claim must fail without taking a page.
+template<typename T> static void claimLargerThanPage(T& ring);
+
+
+
+
+//------------------------------------------------------------------------------
+// Test Cases
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtReferenceRings);
+
+//------------------------------------------------------------------------------
+TEST(given_VyukovRing_when_ClaimLargerThanPage_then_ClaimFailsAndNoPageTaken)
+{
+    VyukovRing ring(RING_PAGE_SHIFT, RING_PAGE_COUNT);
+    claimLargerThanPage(ring);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_DisruptorRing_when_ClaimLargerThanPage_then_ClaimFailsAndNoPageTaken)
+{
+    DisruptorRing ring(RING_PAGE_SHIFT, RING_PAGE_COUNT);
+    claimLargerThanPage(ring);
+}
+
+
+
+
+//------------------------------------------------------------------------------
+// Function and Class Implementation
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<typename T> static void claimLargerThanPage(T& ring)
+{
+    AQWriterItem item;
+    REQUIRE(!ring.claim(item, RING_PAGE_SIZE + 1));
+    REQUIRE(!item.isAllocated());
+
+    for (int i = 0; i < RING_PAGE_COUNT; ++i)
+    {
+        AQWriterItem full;
+        REQUIRE(ring.claim(full, RING_PAGE_SIZE));
+        REQUIRE(full.isAllocated());
+        REQUIRE(full.size() == RING_PAGE_SIZE);
+        REQUIRE(ring.commit(full));
+    }
+
+    REQUIRE(!ring.claim(item, 1));
+}
+
+
+
+
+//=============================== End of File ==================================
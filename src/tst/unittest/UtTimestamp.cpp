@@ -0,0 +1,132 @@
+//==============================================================================
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0.If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Main.h"
+
+#include "Timestamp.h"
+
+using namespace aqosa;
+using namespace std;
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Macros
+//------------------------------------------------------------------------------
+
+// How long each test reads timestamps for; long enough to cover the initial
+// calibration and several renewals of the anchor.
+#define TIMESTAMP_TEST_NS               350000000ULL
+
+// The largest difference permitted between a timestamp and CLOCK_REALTIME.
+#define TIMESTAMP_TOLERANCE_NS          250000ULL
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Type Definitions
+//------------------------------------------------------------------------------
+
+
+
+
+//------------------------------------------------------------------------------
+// Private Function and Class Declarations
+//------------------------------------------------------------------------------
+
+#ifndef _WIN32
+
+// Reads the clock 'clk' in nanoseconds.
+static uint64_t clockNs(clockid_t clk);
+
+#endif
+
+
+
+
+//------------------------------------------------------------------------------
+// Test Cases
+//------------------------------------------------------------------------------
+
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+TEST_SUITE(UtTimestamp);
+
+//------------------------------------------------------------------------------
+static uint64_t clockNs(clockid_t clk)
+{
+    struct timespec ts;
+    clock_gettime(clk, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+TEST(given_TimestampsReadContinuously_when_AnchorRenewed_then_NeverDecrease)
+{
+    uint64_t endNs = clockNs(CLOCK_MONOTONIC) + TIMESTAMP_TEST_NS;
+    uint64_t prev = Timestamp::now();
+    uint64_t decreaseCount = 0;
+    uint64_t readCount = 0;
+    while (clockNs(CLOCK_MONOTONIC) < endNs)
+    {
+        uint64_t ts = Timestamp::now();
+        if (ts < prev)
+        {
+            decreaseCount++;
+        }
+        prev = ts;
+        readCount++;
+    }
+    REQUIRE(readCount > 0);
+    REQUIRE(decreaseCount == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_TimestampsReadContinuously_when_ComparedWithRealtimeClock_then_Agree)
+{
+    uint64_t endNs = clockNs(CLOCK_MONOTONIC) + TIMESTAMP_TEST_NS;
+    uint64_t disagreeCount = 0;
+    while (clockNs(CLOCK_MONOTONIC) < endNs)
+    {
+        uint64_t before = clockNs(CLOCK_REALTIME);
+        uint64_t ts = Timestamp::now();
+        uint64_t after = clockNs(CLOCK_REALTIME);
+        if (ts + TIMESTAMP_TOLERANCE_NS < before || ts > after + TIMESTAMP_TOLERANCE_NS)
+        {
+            disagreeCount++;
+        }
+    }
+    REQUIRE(disagreeCount == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(given_IdleLongerThanAnchorPeriod_when_Now_then_AgreesWithRealtimeClock)
+{
+    Timestamp::now();
+    struct timespec sleep = { 0, 250000000 };
+    nanosleep(&sleep, NULL);
+
+    uint64_t before = clockNs(CLOCK_REALTIME);
+    uint64_t ts = Timestamp::now();
+    uint64_t after = clockNs(CLOCK_REALTIME);
+    REQUIRE(ts + TIMESTAMP_TOLERANCE_NS >= before);
+    REQUIRE(ts <= after + TIMESTAMP_TOLERANCE_NS);
+}
+
+#endif
+
+
+
+
+//=============================== End of File ==================================